@@ -0,0 +1,99 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include "shm_ring.h"
+
+/**
+ * 本机输出的示例读取程序：映射mqtt_sender写入的共享内存环，打印每条消息及其从写入到读取的延迟。
+ *
+ * 有新消息时读取不经过系统调用；没有新消息时默认短暂休眠，--spin时一直轮询以获得最低延迟。
+ * 写入端重启（文件被替换）后自动重新映射。
+ */
+
+static std::atomic<bool> g_running(true);
+
+static void signalHandler(int) {
+    g_running = false;
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [path] [--spin] [--quiet]" << std::endl
+              << "  path     shared memory ring written by mqtt_sender (default /dev/shm/mqtt_sender)" << std::endl
+              << "  --spin   busy-poll instead of sleeping while idle" << std::endl
+              << "  --quiet  only print a summary every second" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = ShmRing::Config().path;
+    bool spin = false;
+    bool quiet = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--spin") == 0) {
+            spin = true;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (argv[i][0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    ShmRingReader reader(path);
+    while (g_running && !reader.open()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    std::cout << "Reading " << path << std::endl;
+
+    ShmRingReader::Message message;
+    uint64_t received = 0;
+    uint64_t latency_total = 0;
+    auto last_report = std::chrono::steady_clock::now();
+    while (g_running) {
+        if (reader.poll(message)) {
+            uint64_t latency = nowNs() - message.ts_ns;
+            received++;
+            latency_total += latency;
+            if (!quiet) {
+                std::cout << "#" << message.sequence << " " << message.topic << " " << message.payload
+                          << " (" << latency / 1000.0 << " us)" << std::endl;
+            }
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_report >= std::chrono::seconds(1)) {
+            last_report = now;
+            if (quiet && received > 0) {
+                std::cout << "Received: " << received << ", Lost: " << reader.getLostCount()
+                          << ", Avg latency: " << latency_total / received / 1000.0 << " us" << std::endl;
+            }
+            // 写入端停止或重启后重新映射，从新文件的最新消息开始读取
+            if (reader.isClosed()) {
+                std::cout << "Writer closed, waiting for " << path << std::endl;
+                while (g_running && (!reader.open() || reader.isClosed())) {
+                    std::this_thread::sleep_for(std::chrono::seconds(1));
+                }
+            }
+        }
+
+        if (!spin) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    std::cout << "Received: " << received << ", Lost: " << reader.getLostCount() << std::endl;
+    return 0;
+}
@@ -0,0 +1,98 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class Arena
+ * @brief 处理流水线暂存内存的bump-pointer分配器
+ *
+ * 分配只移动当前块内的偏移，释放为空操作；一批消息处理完、交给发布后调用reset()整体回收。
+ * 重置后保留已申请的块，之后按同样大小的批次处理时不再向堆申请内存，
+ * 统计中的heap_blocks在稳态下保持不变。不是线程安全的，每个线程使用自己的实例。
+ */
+class Arena {
+public:
+    struct Statistics {
+        uint64_t allocations = 0;       // 从arena分配的次数
+        uint64_t bytes = 0;             // 从arena分配的字节数
+        uint64_t heap_blocks = 0;       // 向堆申请的块数
+        uint64_t resets = 0;
+        size_t peak = 0;                // 一批中使用的最大字节数
+    };
+
+    explicit Arena(size_t block_size = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief 分配size字节，按alignment对齐；当前块不够时换到下一个足够大的块，没有时向堆申请
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief 回收本批的全部分配，保留已申请的块
+     */
+    void reset();
+
+    /**
+     * @brief 本批已使用的字节数（含对齐填充）
+     */
+    size_t used() const;
+
+    const Statistics& statistics() const;
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    size_t block_size_;
+    std::vector<Block> blocks_;
+    size_t current_;            // 正在使用的块
+    size_t offset_;             // 当前块内的偏移
+    size_t used_;
+    Statistics stats_;
+};
+
+/**
+ * @brief 从Arena分配的STL分配器，deallocate为空操作；容器不能在所属arena重置后使用
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena& arena) noexcept : arena_(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    Arena* arena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena_ == other.arena(); }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena_ != other.arena(); }
+
+private:
+    Arena* arena_;
+};
+
+// 从arena分配的暂存字符串
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+#endif // ARENA_H
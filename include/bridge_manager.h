@@ -0,0 +1,170 @@
+#ifndef BRIDGE_MANAGER_H
+#define BRIDGE_MANAGER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "capture.h"
+#include "mqtt_connection_pool.h"
+#include "priority_lanes.h"
+#include "rate_limiter.h"
+#include "shm_ring.h"
+#include "udp_event_loop.h"
+#include "udp_to_mqtt_forwarder.h"
+
+/**
+ * @class BridgeManager
+ * @brief 在一个进程中运行多个UDP->MQTT桥接
+ *
+ * 所有桥接共享一个MQTT发布连接池、一个UDP接收事件循环和一个全局限流桶，
+ * 每个桥接是一个独立的UdpToMqttForwarder，分别保存自己的统计。
+ *
+ * 反应器模式（reactors > 0）：启动reactors个事件循环，每个MQTT连接由其中一个驱动（不启动网络线程），
+ * 桥接的接收套接字注册到其连接所在的事件循环，接收、处理和发布都在同一个线程中完成。
+ *
+ * 启用工作线程池时，各桥接的处理流水线在共享的工作线程中并行执行，按保序键恢复顺序后继续发布。
+ * 启用优先级通道时，各桥接的消息先按主题或字段分类进入共享的通道，由通道的发布线程按优先级发布。
+ * 启用本机输出时，各桥接发布的消息同时写入一个共享内存环，同一主机上的消费者不经过MQTT直接读取。
+ *
+ * 快速启动（startup_buffer > 0）：连接池只发起连接，桥接立即加入组播组并缓冲消息，
+ * 各连接收到CONNACK后发布缓冲的消息；全部连接建立后调用就绪回调。
+ */
+class BridgeManager {
+public:
+    struct Config {
+        std::string mqtt_client_id;
+        std::string mqtt_broker;
+        int mqtt_port = 1883;
+        size_t pool_size = 1;                               // MQTT发布连接数
+        int spin_us = 0;                                    // 接收事件循环阻塞前的轮询时长（微秒），仅启动时生效
+        size_t reactors = 0;                                // 反应器数，0为单个接收事件循环加libmosquitto网络线程
+        WorkerPool::Config workers;                         // 处理流水线工作线程池，各桥接共享
+        PriorityLanes::Config lanes;                        // 优先级通道，各桥接共享
+        ShmRing::Config local_output;                       // 本机共享内存输出，各桥接共享
+        size_t startup_buffer = 0;                          // 快速启动：连接建立前各桥接最多缓冲的消息数，0为先连接再启动桥接
+        int drain_timeout_ms = 5000;                        // 停止时等待在途消息确认的最长时间（从停止开始计算）
+        std::vector<UdpToMqttForwarder::Config> bridges;    // 名称在数组内唯一
+    };
+
+    explicit BridgeManager(const Config& config);
+    ~BridgeManager();
+
+    /**
+     * @brief 启动事件循环、建立连接池并启动全部桥接
+     * @return true 全部启动成功，false 有桥接启动失败（已启动的会被停止）
+     */
+    bool start();
+
+    /**
+     * @brief 排空后停止：先停止全部桥接的接收，再发布各内部队列中的消息，
+     *        等待连接池的在途消息被确认（最多drain_timeout_ms），然后正常断开连接池并停止事件循环
+     *
+     * 输出排空（已送达）和放弃（截止时未确认或发布失败）的消息数。
+     */
+    void stop();
+
+    /**
+     * @brief 检查是否有桥接在运行
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief 运行中应用新配置
+     *
+     * 按名称匹配桥接：已有的桥接调用UdpToMqttForwarder::reload()，新增的启动，删除的停止。
+     * broker/端口/客户端ID/连接数/反应器数、工作线程池或优先级通道设置变化时重建连接池并重启全部桥接。
+     * @return true 已应用，false 有桥接应用失败
+     */
+    bool reload(const Config& config);
+
+    /**
+     * @brief 录制各桥接收到的报文，需在start()之前调用；重载后新建的桥接同样录制
+     */
+    void setCapture(std::shared_ptr<CaptureWriter> capture);
+
+    /**
+     * @brief 回放模式：桥接不创建UDP套接字，由replay()送入录制的报文，需在start()之前调用
+     */
+    void setReplayMode(bool replay);
+
+    /**
+     * @brief 把抓包文件中的报文按通道（桥接名称）送入对应桥接
+     * @param reader 已打开的抓包文件
+     * @param speed 回放速度倍数：1为原速，2为两倍速，0为不等待（最快）
+     * @param keep_running 变为false时提前结束
+     * @return 送入的报文数；没有对应桥接的报文跳过
+     */
+    uint64_t replay(CaptureReader& reader, double speed, const std::atomic<bool>& keep_running);
+
+    /**
+     * @brief 设置就绪回调：全部桥接已启动且全部MQTT连接已建立时调用一次（重启全部桥接后再次调用）
+     *
+     * 回调可能在MQTT网络线程中执行，需在start()之前调用。
+     */
+    void setReadyCallback(std::function<void()> callback);
+
+    /**
+     * @brief 检查是否已就绪（全部桥接在接收且全部MQTT连接已建立）
+     */
+    bool isReady() const;
+
+    /**
+     * @brief 按桥接输出一行统计
+     */
+    void logStatistics() const;
+
+    /**
+     * @brief 获取运行中的桥接数
+     */
+    size_t bridgeCount() const;
+
+    /**
+     * @brief 获取当前配置
+     */
+    const Config& getConfig() const;
+
+private:
+    Config config_;
+    bool running_;
+
+    std::vector<std::shared_ptr<UdpEventLoop>> event_loops_;    // 非反应器模式下只有一个
+    std::unique_ptr<MqttConnectionPool> pool_;
+    std::shared_ptr<TokenBucket> global_bucket_;
+    std::shared_ptr<WorkerPool> workers_;
+    std::shared_ptr<PriorityLanes> lanes_;
+    std::shared_ptr<ShmRing> local_output_;
+    std::vector<std::unique_ptr<UdpToMqttForwarder>> bridges_;
+    std::shared_ptr<CaptureWriter> capture_;
+    bool replay_mode_;
+    std::function<void()> ready_callback_;
+    std::atomic<bool> ready_;
+
+    /**
+     * @brief 创建并启动一个桥接，使用共享的连接、事件循环（反应器模式下为连接所在的）、全局桶、工作线程池和优先级通道
+     */
+    std::unique_ptr<UdpToMqttForwarder> startBridge(const UdpToMqttForwarder::Config& config);
+
+    /**
+     * @brief 全部连接已建立时报告就绪（只报告一次），在start()结束时和各连接收到CONNACK时调用
+     */
+    void checkReady();
+
+    /**
+     * @brief 停止并释放全部事件循环
+     */
+    void stopEventLoops();
+
+    /**
+     * @brief 取生效的全局限速（各桥接相同），未启用限流时为不限
+     */
+    static RateLimiter::Limit globalLimit(const Config& config);
+
+    /**
+     * @brief 按配置创建共享的全局限流桶，不限速时返回空
+     */
+    static std::shared_ptr<TokenBucket> makeGlobalBucket(const Config& config);
+};
+
+#endif // BRIDGE_MANAGER_H
@@ -0,0 +1,124 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <netinet/in.h>
+
+/**
+ * 抓包文件格式（本机字节序，用于在同类主机上回放）：
+ *
+ *   文件头16字节：魔数"UDPCAP01"、u32版本(1)、u32记录头长度(40)
+ *   记录：u32负载长度、u8类型、u8保留、u16通道、u16地址族、u16端口（网络字节序）、
+ *         16字节地址、u64接收时间（Unix纪元纳秒）、u32保留，随后是负载，补齐到8字节
+ *
+ * 类型0为报文；类型1为通道定义，负载是桥接名称，后续报文记录按通道号引用。
+ */
+
+/**
+ * @class CaptureWriter
+ * @brief 把收到的报文追加到内存映射的抓包文件
+ *
+ * 文件按块预先扩展并映射，追加一条记录只是一次memcpy；写满时再扩展一块。
+ * 关闭时截断到实际长度。可被多个接收器共享，追加时加锁。
+ */
+class CaptureWriter {
+public:
+    explicit CaptureWriter(const std::string& path);
+    ~CaptureWriter();
+
+    /**
+     * @brief 创建（覆盖）抓包文件并写入文件头
+     */
+    bool open();
+
+    /**
+     * @brief 截断到实际长度并关闭文件
+     */
+    void close();
+
+    /**
+     * @brief 取得桥接名称对应的通道号，首次使用时写入通道定义
+     */
+    uint16_t channel(const std::string& name);
+
+    /**
+     * @brief 追加一条报文记录，写入失败后不再记录
+     */
+    void append(uint16_t channel, const struct sockaddr_storage& source, uint64_t rx_ts_ns,
+                const char* data, size_t len);
+
+    uint64_t getRecordCount() const;
+
+private:
+    static const size_t CHUNK_SIZE = 16 * 1024 * 1024;
+
+    std::string path_;
+    int fd_;
+    char* map_;
+    size_t mapped_;
+    size_t used_;
+    bool failed_;
+    uint64_t records_;
+    std::map<std::string, uint16_t> channels_;
+    mutable std::mutex mutex_;
+
+    // 确保映射区还能写入bytes字节，不足时扩展文件并重新映射
+    bool reserve(size_t bytes);
+
+    void write(uint8_t type, uint16_t channel, const struct sockaddr_storage* source, uint64_t rx_ts_ns,
+               const char* data, size_t len);
+};
+
+/**
+ * @class CaptureReader
+ * @brief 只读映射抓包文件，按顺序读出报文记录
+ */
+class CaptureReader {
+public:
+    struct Record {
+        std::string_view channel;           // 记录时的桥接名称
+        struct sockaddr_storage source;
+        uint64_t rx_ts_ns;
+        const char* data;                   // 指向映射区，读取器关闭前有效
+        size_t len;
+    };
+
+    explicit CaptureReader(const std::string& path);
+    ~CaptureReader();
+
+    /**
+     * @brief 打开并映射文件，检查文件头
+     */
+    bool open();
+
+    void close();
+
+    /**
+     * @brief 读出下一条报文记录
+     * @return false 已读完或文件损坏（见isCorrupt）
+     */
+    bool next(Record& record);
+
+    /**
+     * @brief 从头重新读取
+     */
+    void rewind();
+
+    bool isCorrupt() const;
+
+private:
+    std::string path_;
+    int fd_;
+    const char* map_;
+    size_t size_;
+    size_t offset_;
+    bool corrupt_;
+    std::map<uint16_t, std::string> channels_;
+};
+
+#endif // CAPTURE_H
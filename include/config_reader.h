@@ -1,7 +1,21 @@
 #ifndef CONFIG_READER_H
 #define CONFIG_READER_H
 
+#include <map>
 #include <string>
+#include <vector>
+#include "bridge_manager.h"
+#include "conflator.h"
+#include "deduplicator.h"
+#include "mqtt_to_udp_forwarder.h"
+#include "pipeline.h"
+#include "priority_lanes.h"
+#include "rate_limiter.h"
+#include "shm_ring.h"
+#include "sink.h"
+#include "thread_tuning.h"
+#include "udp_to_mqtt_forwarder.h"
+#include "worker_pool.h"
 
 class ConfigReader {
 public:
@@ -12,10 +26,35 @@ public:
     int getPort() const;
     std::string getTopic() const;
     int getQos() const;
+    bool getRetain() const;
     std::string getClientId() const;
+    size_t getPoolSize() const;
     std::string getMulticastAddr() const;
     int getMulticastPort() const;
     std::string getInterface() const;
+    Deduplicator::Config getDedupConfig() const;
+    Conflator::Config getConflationConfig() const;
+    RateLimiter::Config getRateLimitConfig() const;
+    MqttToUdpForwarder::Config getReverseConfig() const;
+
+    // 周期统计日志间隔（秒），0表示关闭
+    int getStatsInterval() const;
+
+    // 各类线程的CPU亲和性和实时优先级（仅启动时生效）
+    ThreadTuning::Config getThreadConfig() const;
+
+    // Prometheus指标HTTP端口（0表示关闭）和绑定地址
+    int getMetricsPort() const;
+    std::string getMetricsBind() const;
+
+    // 就绪文件路径（为空表示不写），全部桥接就绪后创建、退出时删除
+    std::string getReadyFile() const;
+
+    // 汇总mqtt/udp/dedup/pipeline/conflation/rate_limit各段，得到转发器的完整配置
+    UdpToMqttForwarder::Config getForwarderConfig() const;
+
+    // 全部桥接及共享连接设置；未配置bridges数组时只有一个按顶层设置的桥接
+    BridgeManager::Config getBridgeManagerConfig() const;
 
 private:
     std::string config_file_;
@@ -23,12 +62,74 @@ private:
     int port_;
     std::string topic_;
     int qos_;
+    bool retain_;
     std::string client_id_;
+    size_t pool_size_;
+
+    // Per-topic publish settings from "mqtt.routes"; override qos/retain of bridges publishing that topic
+    struct PublishRoute {
+        int qos;
+        bool retain;
+    };
+    std::map<std::string, PublishRoute> routes_;
 
     // UDP multicast settings
     std::string multicast_addr_;
     int multicast_port_;
     std::string interface_;
+    UdpReceiver::JoinOptions join_;
+    UdpReceiver::ReceiveOptions receive_;
+
+    // Duplicate suppression settings
+    Deduplicator::Config dedup_;
+
+    // Filter/transform pipeline stages
+    RuntimePipeline::Config pipeline_;
+
+    // Last-value conflation settings
+    Conflator::Config conflation_;
+
+    // Output sinks fed alongside MQTT (record file, UDP mirror)
+    std::vector<Sink::Config> sinks_;
+
+    // Token-bucket rate limit settings
+    RateLimiter::Config rate_limit_;
+
+    // MQTT -> UDP reverse bridge settings
+    MqttToUdpForwarder::Config reverse_;
+
+    // Periodic per-bridge statistics logging
+    int stats_interval_s_;
+
+    // Thread pinning/priority and low-latency receive
+    ThreadTuning::Config threads_;
+    int spin_us_;
+
+    // Reactor threads driving both UDP receive and MQTT I/O (0: off)
+    size_t reactors_;
+
+    // Worker pool running pipeline stages off the receive thread, shared by all bridges
+    WorkerPool::Config workers_;
+
+    // Priority lanes between receive and publish, shared by all bridges
+    PriorityLanes::Config lanes_;
+
+    // Shared memory ring for same-host consumers, shared by all bridges
+    ShmRing::Config local_output_;
+
+    // Fast start: buffer while MQTT connects (0: connect first), readiness file
+    size_t startup_buffer_;
+    std::string ready_file_;
+
+    // Graceful shutdown: how long to wait for in-flight acknowledgements
+    int drain_timeout_ms_;
+
+    // Prometheus metrics endpoint
+    int metrics_port_;
+    std::string metrics_bind_;
+
+    // Bridges from the optional "bridges" array
+    std::vector<UdpToMqttForwarder::Config> bridges_;
 };
 
 #endif // CONFIG_READER_H
@@ -0,0 +1,37 @@
+#ifndef CONFIG_WATCHER_H
+#define CONFIG_WATCHER_H
+
+#include <string>
+
+/**
+ * @class ConfigWatcher
+ * @brief 使用inotify监视配置文件变化
+ *
+ * 监视配置文件所在目录而不是文件本身，这样编辑器“写临时文件再rename”的保存方式也能被检测到。
+ * 非阻塞，由主循环定期调用poll()。
+ */
+class ConfigWatcher {
+public:
+    explicit ConfigWatcher(const std::string& config_file);
+    ~ConfigWatcher();
+
+    /**
+     * @brief 开始监视
+     * @return true 成功，false inotify不可用
+     */
+    bool start();
+
+    /**
+     * @brief 检查自上次调用以来配置文件是否被修改
+     * @return true 文件被写入或替换
+     */
+    bool poll();
+
+private:
+    std::string directory_;
+    std::string file_name_;
+    int inotify_fd_;
+    int watch_fd_;
+};
+
+#endif // CONFIG_WATCHER_H
@@ -0,0 +1,106 @@
+#ifndef CONFLATOR_H
+#define CONFLATOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Conflator
+ * @brief 按键保留最新值的消息合并器（last-value conflation）
+ *
+ * 每个键（消息中的某个JSON字段）在扁平哈希表中占一个槽位，新消息覆盖旧值并标记为脏。
+ * 发布线程按固定周期，或在发布端空闲时立即，把所有脏键的最新值发布出去。
+ * 发布期间到达的更新继续在槽位中合并，因此输出速率取决于键的数量而不是输入速率。
+ */
+class Conflator {
+public:
+    // 发布回调函数类型
+    using PublishCallback = std::function<void(const std::string&)>;
+
+    struct Config {
+        bool enabled = false;
+        std::string key_field = "sensor.id";    // 合并键字段路径
+        int interval_ms = 100;                  // 发布周期
+        bool publish_when_idle = true;          // 发布端空闲时立即发布新值，不等待周期
+        size_t max_keys = 4096;                 // 最大键数量，超出的新键不参与合并
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    explicit Conflator(const Config& config);
+    ~Conflator();
+
+    /**
+     * @brief 启动发布线程
+     */
+    bool start(PublishCallback callback);
+
+    /**
+     * @brief 停止发布线程，停止前发布所有尚未发布的值
+     */
+    void stop();
+
+    /**
+     * @brief 写入一条消息
+     * @return true 已进入合并表，false 消息没有合并键或表已满，调用者应直接发布
+     */
+    bool update(const std::string& message);
+
+    /**
+     * @brief 把所有脏键的最新值交给回调，返回发布数量
+     * 同一时刻只能有一个线程调用（启动后由发布线程调用）
+     */
+    size_t flush(const PublishCallback& callback);
+
+    /**
+     * @brief 获取被后续更新覆盖、未发布就被合并掉的消息数
+     */
+    uint64_t getConflatedCount() const;
+
+    /**
+     * @brief 清零合并计数
+     */
+    void resetStatistics();
+
+    /**
+     * @brief 获取当前键数量
+     */
+    size_t keyCount() const;
+
+private:
+    struct Entry {
+        uint64_t hash = 0;
+        bool used = false;
+        bool dirty = false;
+        std::string key;
+        std::string payload;
+    };
+
+    std::string key_field_;
+    int interval_ms_;
+    bool publish_when_idle_;
+    size_t max_keys_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Entry> entries_;
+    size_t mask_;
+    size_t key_count_;
+    std::vector<uint32_t> dirty_;
+    std::vector<std::string> batch_;
+
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> conflated_count_;
+    std::thread publish_thread_;
+
+    void publishLoop(PublishCallback callback);
+};
+
+#endif // CONFLATOR_H
@@ -0,0 +1,69 @@
+#ifndef DEDUPLICATOR_H
+#define DEDUPLICATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class Deduplicator
+ * @brief 基于时间窗口的重复消息过滤器
+ *
+ * 使用固定容量的开放寻址哈希表，槽位记录键的哈希值和写入时的时间桶编号。
+ * 超出时间窗口的槽位视为空闲，可被直接复用；探测范围内全部占用时覆盖最旧的槽位，
+ * 因此无论输入速率多高，内存占用都保持不变。
+ *
+ * 非线程安全，只应在接收线程中调用。
+ */
+class Deduplicator {
+public:
+    struct Config {
+        bool enabled = false;
+        std::string key_field;      // 去重键字段路径（如 "id"），为空或字段不存在时对整个payload做哈希
+        int window_ms = 2000;       // 去重时间窗口
+        size_t capacity = 65536;    // 槽位数量，向上取整为2的幂
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    explicit Deduplicator(const Config& config);
+
+    /**
+     * @brief 检查消息是否在时间窗口内出现过，未出现过则记录下来
+     * @return true 重复消息，false 首次出现
+     */
+    bool isDuplicate(const char* data, size_t len);
+
+    /**
+     * @brief 同上，使用调用者给出的时间（毫秒，单调时钟）
+     */
+    bool isDuplicate(const char* data, size_t len, uint64_t now_ms);
+
+    /**
+     * @brief 获取因探测范围已满而被提前淘汰的记录数
+     */
+    uint64_t getEvictionCount() const;
+
+    size_t capacity() const;
+
+private:
+    struct Slot {
+        uint64_t hash;
+        uint32_t bucket;    // 写入时的时间桶编号，0表示从未使用
+    };
+
+    static const int BUCKETS_PER_WINDOW = 8;
+    static const size_t MAX_PROBE = 16;
+
+    std::string key_field_;
+    uint64_t bucket_ms_;
+    std::vector<Slot> slots_;
+    size_t mask_;
+    uint64_t eviction_count_;
+
+    uint64_t computeKey(const char* data, size_t len) const;
+};
+
+#endif // DEDUPLICATOR_H
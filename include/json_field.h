@@ -0,0 +1,26 @@
+#ifndef JSON_FIELD_H
+#define JSON_FIELD_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 在JSON文本中按路径查找字段（不构建DOM，不分配内存）
+ *
+ * 用于热路径上提取去重键、路由键等字段。路径使用点号分隔，
+ * 例如 "id" 或 "sensor.id"，只支持对象成员，不支持数组下标。
+ *
+ * @param json JSON文本
+ * @param path 点号分隔的字段路径
+ * @param value 输出：字段的原始文本。字符串返回引号内的内容（不解码转义），
+ *              数字/布尔/null返回字面量，对象/数组返回包含括号的完整片段
+ * @return true 找到字段，false 未找到或JSON格式不正确
+ */
+bool findJsonField(std::string_view json, std::string_view path, std::string_view& value);
+
+/**
+ * @brief 与findJsonField相同，但字符串值保留引号，返回的片段可以直接拼接到其他JSON中
+ */
+bool findJsonFieldRaw(std::string_view json, std::string_view path, std::string_view& value);
+
+#endif // JSON_FIELD_H
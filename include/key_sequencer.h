@@ -0,0 +1,96 @@
+#ifndef KEY_SEQUENCER_H
+#define KEY_SEQUENCER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class KeySequencer
+ * @brief 按键恢复顺序：并行处理完成的消息按同一键的提交顺序放行
+ *
+ * 接收线程按到达顺序为每条消息调用begin()取得该键的序号，处理完成后（任意线程）调用complete()交回放行动作。
+ * 序号之前的消息都已放行时立即在调用线程中执行，否则暂存，等前面的消息完成后由完成它的线程依次执行。
+ * 同一键的动作不会并发执行，不同键之间互不等待。
+ *
+ * 键的状态在全部放行后保留，持续使用的键不会反复建表；每个分片的键数超过上限时才清理空闲的键。
+ * 暂存的动作放在按序号取模的环形槽中，稳态下begin()和complete()不向堆申请内存。
+ */
+class KeySequencer {
+    struct Entry;
+
+public:
+    // 放行动作类型
+    using Action = std::function<void()>;
+
+    // 序号凭证，只在对应的complete()之前有效
+    struct Ticket {
+        Entry* entry = nullptr;
+        uint64_t sequence = 0;
+    };
+
+    KeySequencer();
+
+    /**
+     * @brief 为一条消息取得序号，同一键的调用必须按期望的放行顺序进行（通常在接收线程中）
+     */
+    Ticket begin(std::string_view key);
+
+    /**
+     * @brief 交回已处理完成的消息的放行动作，可在任意线程调用
+     */
+    void complete(const Ticket& ticket, Action action);
+
+    /**
+     * @brief 已取得序号但尚未放行的消息数
+     */
+    size_t pending() const;
+
+    /**
+     * @brief 等待所有已取得序号的消息放行
+     */
+    void waitIdle();
+
+private:
+    struct Slot {
+        Action action;
+        bool ready = false;
+    };
+
+    struct Entry {
+        std::mutex* mutex = nullptr;    // 所属分片的锁
+        uint64_t next_sequence = 0;     // 下一个begin()分配的序号
+        uint64_t next_release = 0;      // 下一个应放行的序号
+        std::vector<Slot> slots;        // 已完成待放行的动作，按序号对容量（2的幂）取模存放
+        bool releasing = false;         // 有线程正在执行该键的动作
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        std::string probe;              // 查找用的键缓冲，复用容量
+    };
+
+    static const size_t SHARDS = 16;
+    static const size_t MAX_KEYS_PER_SHARD = 4096;  // 超过时清理空闲的键
+    static const size_t INITIAL_SLOTS = 8;
+    std::array<Shard, SHARDS> shards_;
+
+    std::atomic<size_t> pending_;
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+
+    Shard& shardFor(std::string_view key);
+
+    // 扩大环形槽使其能容纳offset（相对next_release）处的序号，已暂存的动作按新容量重新放置
+    static void growSlots(Entry& entry, uint64_t offset);
+};
+
+#endif // KEY_SEQUENCER_H
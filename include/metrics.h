@@ -0,0 +1,188 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * 指标子系统
+ *
+ * 计数器和直方图按线程分片：每个分片独占一条缓存行，线程第一次使用时分配固定的分片，
+ * 热路径上只对自己的分片做一次relaxed原子加，不加锁、不与其他线程争用缓存行。
+ * 抓取时把各分片相加。注册表只在注册和抓取时加锁，热路径从不访问注册表。
+ */
+
+namespace metrics {
+
+// 分片数，线程数超过时多个线程共用一个分片（仍然正确，只是可能争用）
+constexpr size_t SHARDS = 16;
+
+/**
+ * @brief 当前线程使用的分片编号
+ */
+inline size_t shardIndex() {
+    static std::atomic<size_t> next_shard{0};
+    thread_local size_t index = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return index;
+}
+
+} // namespace metrics
+
+/**
+ * @class Counter
+ * @brief 单调递增计数器（按线程分片）
+ */
+class Counter {
+public:
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    void add(uint64_t n = 1) {
+        cells_[metrics::shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    Counter& operator++() {
+        add(1);
+        return *this;
+    }
+
+    uint64_t value() const {
+        uint64_t sum = 0;
+        for (const auto& cell : cells_) {
+            sum += cell.value.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    // 清零（用于resetStatistics，Prometheus会按计数器重置处理）
+    void reset() {
+        for (auto& cell : cells_) {
+            cell.value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value{0};
+    };
+    Cell cells_[metrics::SHARDS];
+};
+
+/**
+ * @class Gauge
+ * @brief 瞬时值（队列深度、在途消息数等），单个原子变量
+ */
+class alignas(64) Gauge {
+public:
+    Gauge() = default;
+    Gauge(const Gauge&) = delete;
+    Gauge& operator=(const Gauge&) = delete;
+
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+/**
+ * @class Histogram
+ * @brief 固定桶边界的直方图（按线程分片），以纳秒记录，导出时换算为秒
+ */
+class Histogram {
+public:
+    // 默认桶边界（纳秒）：100us ~ 2.5s
+    static std::vector<uint64_t> latencyBuckets();
+
+    explicit Histogram(std::vector<uint64_t> bounds_ns = latencyBuckets());
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void observe(uint64_t value_ns) {
+        size_t bucket = 0;
+        while (bucket < bounds_.size() && value_ns > bounds_[bucket]) {
+            ++bucket;
+        }
+        Shard& shard = shards_[metrics::shardIndex()];
+        shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        shard.sum_ns.fetch_add(value_ns, std::memory_order_relaxed);
+    }
+
+    struct Snapshot {
+        std::vector<uint64_t> bounds_ns;
+        std::vector<uint64_t> cumulative;   // 每个边界的累计计数，最后一项为+Inf
+        uint64_t sum_ns = 0;
+        uint64_t count = 0;
+    };
+
+    Snapshot snapshot() const;
+
+private:
+    static constexpr size_t MAX_BUCKETS = 24;
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> buckets[MAX_BUCKETS + 1] = {};
+        std::atomic<uint64_t> sum_ns{0};
+    };
+
+    std::vector<uint64_t> bounds_;
+    Shard shards_[metrics::SHARDS];
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief 指标注册表，按Prometheus文本格式导出
+ *
+ * 注册表只保存弱引用，指标由使用它的组件持有，组件销毁后对应的序列在下次抓取时移除。
+ * 名称和标签相同的指标只创建一次，重复注册返回同一个对象（重载重建组件时序列保持连续）。
+ * 同一名称以不同类型注册时输出错误，返回不导出的独立指标。
+ */
+class MetricsRegistry {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * @brief 进程内共享的注册表
+     */
+    static MetricsRegistry& global();
+
+    std::shared_ptr<Counter> counter(const std::string& name, const std::string& help,
+                                     const Labels& labels = {});
+    std::shared_ptr<Gauge> gauge(const std::string& name, const std::string& help,
+                                 const Labels& labels = {});
+    std::shared_ptr<Histogram> histogram(const std::string& name, const std::string& help,
+                                         const Labels& labels = {});
+
+    /**
+     * @brief 按Prometheus文本格式（0.0.4）输出全部指标
+     */
+    std::string render();
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Family {
+        std::string help;
+        Type type = Type::Counter;
+        // 键为格式化后的标签，如 {bridge="radar"}
+        std::map<std::string, std::weak_ptr<void>> series;
+    };
+
+    std::mutex mutex_;
+    std::map<std::string, Family> families_;
+
+    template <typename T>
+    std::shared_ptr<T> getOrCreate(const std::string& name, const std::string& help, Type type,
+                                   const Labels& labels);
+
+    static std::string formatLabels(const Labels& labels);
+};
+
+#endif // METRICS_H
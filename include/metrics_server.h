@@ -0,0 +1,58 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include "metrics.h"
+
+/**
+ * @class MetricsServer
+ * @brief 极简HTTP服务，在GET /metrics上以Prometheus文本格式导出指标
+ *
+ * 单线程依次处理请求，只用于本机抓取，默认绑定127.0.0.1。
+ */
+class MetricsServer {
+public:
+    /**
+     * @param registry 导出的注册表
+     * @param port 监听端口，0表示由系统分配
+     * @param bind_addr 绑定地址
+     */
+    MetricsServer(MetricsRegistry& registry, int port, const std::string& bind_addr = "127.0.0.1");
+    ~MetricsServer();
+
+    /**
+     * @brief 开始监听并启动服务线程
+     * @return true 启动成功，false 启动失败
+     */
+    bool start();
+
+    /**
+     * @brief 停止服务
+     */
+    void stop();
+
+    bool isRunning() const;
+
+    /**
+     * @brief 实际监听的端口（port为0时由系统分配）
+     */
+    int getPort() const;
+
+private:
+    MetricsRegistry& registry_;
+    int port_;
+    std::string bind_addr_;
+    int listen_fd_;
+    std::atomic<bool> running_;
+    std::thread server_thread_;
+
+    // 服务线程主函数
+    void serveLoop();
+
+    // 处理一个连接：读取请求行并写回响应
+    void handleConnection(int fd);
+};
+
+#endif // METRICS_SERVER_H
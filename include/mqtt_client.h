@@ -2,26 +2,143 @@
 #define MQTT_CLIENT_H
 
 #include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <condition_variable>
 #include <mosquitto.h>
+#include "metrics.h"
+#include "udp_event_loop.h"
 
 class MqttClient {
 public:
+    // 订阅消息回调函数类型：(topic, payload)
+    using MessageCallback = std::function<void(const std::string&, const std::string&)>;
+    // 连接建立（收到CONNACK，包括自动重连）回调，在网络线程（反应器模式下为事件循环线程）中执行
+    using ConnectCallback = std::function<void()>;
+
     MqttClient(const std::string& client_id, const std::string& broker, int port);
     ~MqttClient();
 
+    // connect()等待CONNACK的最长时间
+    static constexpr int CONNECT_TIMEOUT_MS = 500;
+
+    // 发起连接并等待CONNACK（收到即返回，最多CONNECT_TIMEOUT_MS）
     bool connect();
-    bool publish(const std::string& topic, const std::string& message, int qos = 1);
+    // 只发起连接，不等待CONNACK；连接建立后通过isConnected()和连接回调得知
+    bool connectAsync();
+    // 等待CONNACK，已连接时立即返回
+    bool waitConnected(std::chrono::milliseconds timeout);
+    bool isConnected() const;
+    // QoS0走快速路径：不记录发布时间、不计入在途和确认延迟，也不逐条输出日志；QoS1/2完整跟踪到broker确认。
+    // libmosquitto对QoS0同样分配mid并在写出后回调，mid与QoS1/2共用，QoS0仍按mid记录一次状态（一次原子交换），
+    // 否则它的回调无法与同一mid上的QoS1/2确认区分
+    bool publish(const std::string& topic, const std::string& message, int qos = 1, bool retain = false);
+    // 已连接时先发送DISCONNECT，等网络线程写出已排队的报文后退出；未连接时直接停止网络线程
     void disconnect();
 
+    // 等待在途的QoS1/2消息被确认、已排队的报文写出，最多等到deadline；返回仍未确认的消息数（0为全部送达）
+    int64_t drain(std::chrono::steady_clock::time_point deadline);
+    // 已发布但尚未被broker确认的QoS1/2消息数
+    int64_t getInflightCount() const;
+    // 累计因主动断开而放弃（不再等待确认）的QoS1/2消息数
+    int64_t getAbandonedCount() const;
+
+    // 设置订阅消息回调，需在connect()之前调用
+    void setMessageCallback(MessageCallback callback);
+
+    // 反应器模式：不启动libmosquitto网络线程，由事件循环驱动连接的读写、保活和重连，
+    // 回调在事件循环线程中执行。需在connect()之前调用
+    void setEventLoop(std::shared_ptr<UdpEventLoop> loop);
+
+    // 驱动本连接的事件循环，未使用反应器模式时为空
+    std::shared_ptr<UdpEventLoop> getEventLoop() const;
+
+    // 增加连接建立回调，返回编号；已连接时不会补发，调用方注册后需自行检查isConnected()
+    int addConnectListener(ConnectCallback callback);
+    // 移除连接建立回调；返回后该回调不会再执行（正在执行时等待其完成），不能在回调中调用
+    void removeConnectListener(int id);
+
+    // 订阅主题；未连接时记录下来，连接（包括自动重连）成功后订阅
+    bool subscribe(const std::string& topic, int qos = 1);
+
+    // 检查主题是否匹配订阅过滤器（支持+和#通配符）
+    static bool topicMatches(const std::string& filter, const std::string& topic);
+
 private:
     struct mosquitto* mosq_;
     std::string broker_;
     int port_;
-    bool connected_;
+    std::atomic<bool> connected_;
+    std::mutex connect_mutex_;
+    std::condition_variable connect_cv_;
+    std::atomic<bool> ever_connected_;
+    bool network_tuned_;    // 只在网络线程中访问（connect()启动线程前重置）
+
+    // 发布确认延迟：按mid低位记录发布时间（在途消息超过槽数时部分样本会被覆盖）
+    static constexpr size_t PUBLISH_SLOTS = 4096;
+    std::unique_ptr<std::atomic<uint64_t>[]> publish_times_;
+    std::shared_ptr<Histogram> publish_latency_;
+    std::shared_ptr<Gauge> inflight_;
+    std::atomic<int64_t> inflight_count_;   // 本实例的在途数（inflight_按客户端ID共享）
+    std::atomic<int64_t> abandoned_count_;
+
+    // 在途计数按mid（16位，不会超过65535条在途）记录每条发布的状态，与延迟采样的槽数无关
+    enum MidState : uint8_t {
+        MID_IDLE = 0,
+        MID_AWAITING_ACK,       // QoS 1/2已发布，等待确认
+        MID_SENT_QOS0,          // QoS0已交给libmosquitto，等待写出回调
+        MID_CALLED_BACK,        // 回调先于发布方记录到达
+        MID_ABANDONED,          // 主动断开时仍未确认，已从在途数中扣除，之后的确认不再计数
+    };
+    static constexpr size_t MID_STATES = 65536;
+    std::unique_ptr<std::atomic<uint8_t>[]> mid_states_;
+    std::shared_ptr<Counter> reconnects_;
+
+    MessageCallback message_callback_;
+    std::mutex listeners_mutex_;
+    // drain()等待时由确认回调唤醒
+    std::mutex drain_mutex_;
+    std::condition_variable drain_cv_;
+    std::atomic<bool> draining_;
+    std::vector<std::pair<int, ConnectCallback>> connect_listeners_;
+    int next_listener_id_;
+    // 连接回调在listeners_mutex_之外执行；执行期间notifying_为true，移除回调时等待其结束
+    std::condition_variable listeners_cv_;
+    bool notifying_;
+    std::mutex subscriptions_mutex_;
+    std::vector<std::pair<std::string, int>> subscriptions_;
+
+    // 反应器模式：以下状态只在事件循环线程中访问（connect()注册tick之前除外）
+    std::shared_ptr<UdpEventLoop> loop_;
+    int tick_id_;
+    int socket_fd_;         // 已注册到事件循环的套接字
+    bool want_write_;       // 注册时是否关注可写
+    bool reconnect_failing_; // 重连失败只输出一次，直到再次成功
+    std::chrono::steady_clock::time_point next_misc_;
+
+    // 反应器模式的连接：异步连接后注册tick，握手由事件循环完成
+    bool connectReactor();
+    // 更新连接状态并唤醒waitConnected()
+    void setConnected(bool connected);
+    // 发布成功后记录mid的状态，QoS 1/2计入在途；回调已先到达时返回false
+    bool recordPublished(int mid, int qos);
+    // 主动断开时把未确认的消息移出在途计数，在途指标归零
+    void abandonInflight();
+    // 套接字就绪：读取/写出报文
+    void onSocketEvent(uint32_t events);
+    // 每轮事件后：每秒一次保活和断线重连，并同步套接字注册
+    void onTick();
+    // 套接字变化（断开、重连）时重新注册，按是否有待写数据切换EPOLLOUT
+    void syncSocket();
 
     static void on_connect_callback(struct mosquitto* mosq, void* obj, int result);
     static void on_publish_callback(struct mosquitto* mosq, void* obj, int mid);
     static void on_disconnect_callback(struct mosquitto* mosq, void* obj, int rc);
+    static void on_message_callback(struct mosquitto* mosq, void* obj, const struct mosquitto_message* message);
 };
 
 #endif // MQTT_CLIENT_H
@@ -0,0 +1,96 @@
+#ifndef MQTT_CONNECTION_POOL_H
+#define MQTT_CONNECTION_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mqtt_client.h"
+
+/**
+ * @class MqttConnectionPool
+ * @brief 多个转发器共享的MQTT发布连接池
+ *
+ * 池中每个连接有独立的网络线程（反应器模式下由分配到的事件循环驱动），
+ * 转发器按轮询方式分配连接，连接的建立和断开由连接池统一管理。
+ */
+class MqttConnectionPool {
+public:
+    /**
+     * @brief 构造函数
+     * @param client_id 客户端ID，池大小大于1时依次加后缀"_0"、"_1"...
+     * @param broker MQTT broker地址
+     * @param port MQTT broker端口
+     * @param size 连接数（至少为1）
+     */
+    MqttConnectionPool(const std::string& client_id, const std::string& broker, int port, size_t size);
+    ~MqttConnectionPool();
+
+    /**
+     * @brief 反应器模式：第i个连接由loops[i % N]驱动，需在connect()之前调用
+     */
+    void setEventLoops(const std::vector<std::shared_ptr<UdpEventLoop>>& loops);
+
+    /**
+     * @brief 建立池中的全部连接
+     *
+     * 各连接同时发起，再一起等待CONNACK，总耗时取决于最慢的一个连接。
+     * @param wait false时只发起连接不等待CONNACK（快速启动），连接建立后由连接回调通知
+     * @return true 全部连接成功（或已发起），false 有连接失败（已建立的连接会被断开）
+     */
+    bool connect(bool wait = true);
+
+    /**
+     * @brief 检查池中的连接是否都已建立
+     */
+    bool isConnected() const;
+
+    /**
+     * @brief 设置连接建立回调，池中任一连接收到CONNACK（包括重连）时调用；传入空回调时移除
+     *
+     * 回调在该连接的网络线程中执行，移除时等待正在执行的回调完成。
+     */
+    void setConnectCallback(MqttClient::ConnectCallback callback);
+
+    /**
+     * @brief 断开池中的全部连接
+     */
+    void disconnect();
+
+    /**
+     * @brief 等待池中各连接的在途消息被确认，共用同一个截止时间
+     * @return 截止时仍未确认的消息总数
+     */
+    int64_t drain(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief 池中各连接尚未被确认的QoS1/2消息总数
+     */
+    int64_t getInflightCount() const;
+
+    /**
+     * @brief 池中各连接累计因主动断开而放弃的QoS1/2消息总数
+     */
+    int64_t getAbandonedCount() const;
+
+    /**
+     * @brief 按轮询方式分配一个连接
+     */
+    std::shared_ptr<MqttClient> acquire();
+
+    size_t size() const;
+    const std::string& getBroker() const;
+    int getPort() const;
+    const std::string& getClientId() const;
+
+private:
+    std::string client_id_;
+    std::string broker_;
+    int port_;
+    std::vector<std::shared_ptr<MqttClient>> clients_;
+    std::atomic<size_t> next_;
+    std::vector<int> listener_ids_;     // 与clients_一一对应，未设置回调时为空
+};
+
+#endif // MQTT_CONNECTION_POOL_H
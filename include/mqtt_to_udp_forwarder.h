@@ -0,0 +1,126 @@
+#ifndef MQTT_TO_UDP_FORWARDER_H
+#define MQTT_TO_UDP_FORWARDER_H
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "metrics.h"
+#include "mqtt_client.h"
+#include "udp_sender.h"
+
+/**
+ * @class MqttToUdpForwarder
+ * @brief 反向转发器：订阅MQTT主题，把收到的消息作为UDP组播报文发出
+ *
+ * libmosquitto回调线程只负责把消息放入队列，发送线程每次取走队列中的全部消息，
+ * 通过sendmmsg批量发出。使用独立的MQTT客户端，与正向转发互不影响。
+ */
+class MqttToUdpForwarder {
+public:
+    struct Config {
+        bool enabled = false;
+        std::string topic = "command";      // 订阅主题（支持通配符）
+        int qos = 1;
+        std::string multicast_addr = "239.255.0.2";
+        int multicast_port = 5556;
+        std::string interface;              // 出口网卡地址（IP_MULTICAST_IF）
+        int ttl = 1;
+        bool loopback = false;              // 是否回环到本机，默认关闭以免被本机正向转发器收到
+        size_t queue_size = 10000;          // 发送队列上限，满时丢弃新消息
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief 构造函数
+     * @param mqtt_client_id MQTT客户端ID（需与正向转发器不同）
+     * @param mqtt_broker MQTT broker地址
+     * @param mqtt_port MQTT broker端口
+     * @param config 反向转发配置
+     */
+    MqttToUdpForwarder(const std::string& mqtt_client_id,
+                       const std::string& mqtt_broker,
+                       int mqtt_port,
+                       const Config& config);
+
+    ~MqttToUdpForwarder();
+
+    /**
+     * @brief 启动反向转发器
+     * @return true 启动成功，false 启动失败
+     */
+    bool start();
+
+    /**
+     * @brief 停止反向转发器，停止前发送队列中剩余的消息
+     */
+    void stop();
+
+    /**
+     * @brief 检查反向转发器是否运行中
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief 检查反向配置是否会与正向转发形成环路
+     * @param config 反向配置
+     * @param forward_topic 正向转发发布的MQTT主题
+     * @param forward_addr 正向转发接收的组播地址
+     * @param forward_port 正向转发接收的端口
+     * @return true 会形成环路
+     */
+    static bool createsLoop(const Config& config, const std::string& forward_topic,
+                            const std::string& forward_addr, int forward_port);
+
+    /**
+     * @brief 获取从MQTT收到的消息数
+     */
+    uint64_t getReceivedMessageCount() const;
+
+    /**
+     * @brief 获取成功发出的UDP报文数
+     */
+    uint64_t getSentMessageCount() const;
+
+    /**
+     * @brief 获取发送失败或因队列满被丢弃的消息数
+     */
+    uint64_t getFailedMessageCount() const;
+
+    /**
+     * @brief 获取sendmmsg调用次数（用于观察批量效果）
+     */
+    uint64_t getSendBatchCount() const;
+
+private:
+    std::unique_ptr<MqttClient> mqtt_client_;
+    std::unique_ptr<UdpSender> udp_sender_;
+    Config config_;
+
+    std::atomic<bool> running_;
+    std::shared_ptr<Counter> received_count_;
+    std::shared_ptr<Counter> dropped_count_;
+    std::shared_ptr<Gauge> queue_depth_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<std::string> queue_;
+    std::thread send_thread_;
+
+    /**
+     * @brief MQTT消息回调（libmosquitto网络线程中调用）
+     */
+    void onMqttMessageReceived(const std::string& topic, const std::string& payload);
+
+    /**
+     * @brief 发送线程主函数
+     */
+    void sendLoop();
+};
+
+#endif // MQTT_TO_UDP_FORWARDER_H
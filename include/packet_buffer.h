@@ -0,0 +1,117 @@
+#ifndef PACKET_BUFFER_H
+#define PACKET_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <netinet/in.h>
+
+class PacketBufferPool;
+
+/**
+ * @class PacketBuffer
+ * @brief 由PacketRef引用计数的报文缓冲，内容在交给各输出端后不再修改
+ */
+class PacketBuffer {
+public:
+    std::string data;                       // 报文内容，回收后保留容量
+    struct sockaddr_storage source;         // 发送方地址
+    uint64_t rx_ts_ns;                      // 接收时间（Unix纪元纳秒）
+
+private:
+    friend class PacketRef;
+    friend class PacketBufferPool;
+
+    explicit PacketBuffer(PacketBufferPool* pool) : rx_ts_ns(0), refs_(0), pool_(pool) {}
+
+    std::atomic<uint32_t> refs_;
+    PacketBufferPool* pool_;
+};
+
+/**
+ * @class PacketRef
+ * @brief PacketBuffer的共享引用，复制只增加引用计数；最后一个引用释放时缓冲回到所属的池
+ */
+class PacketRef {
+public:
+    PacketRef() noexcept : buffer_(nullptr) {}
+    PacketRef(const PacketRef& other) noexcept;
+    PacketRef(PacketRef&& other) noexcept;
+    PacketRef& operator=(const PacketRef& other) noexcept;
+    PacketRef& operator=(PacketRef&& other) noexcept;
+    ~PacketRef();
+
+    const PacketBuffer* get() const noexcept { return buffer_; }
+    const PacketBuffer* operator->() const noexcept { return buffer_; }
+    const PacketBuffer& operator*() const noexcept { return *buffer_; }
+    explicit operator bool() const noexcept { return buffer_ != nullptr; }
+
+    /**
+     * @brief 释放引用
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief 当前的引用数（只用于统计和测试）
+     */
+    uint32_t useCount() const noexcept;
+
+private:
+    friend class PacketBufferPool;
+
+    explicit PacketRef(PacketBuffer* buffer) noexcept;
+
+    PacketBuffer* buffer_;
+};
+
+/**
+ * @class PacketBufferPool
+ * @brief 报文缓冲池：取出的缓冲在最后一个引用释放后放回空闲列表，稳态下不再向堆申请
+ *
+ * 线程安全。池必须在它分配的全部引用释放之后才能销毁。
+ */
+class PacketBufferPool {
+public:
+    /**
+     * @param max_free 空闲列表最多保留的缓冲数，超出的直接释放
+     */
+    explicit PacketBufferPool(size_t max_free = 4096);
+    ~PacketBufferPool();
+
+    PacketBufferPool(const PacketBufferPool&) = delete;
+    PacketBufferPool& operator=(const PacketBufferPool&) = delete;
+
+    /**
+     * @brief 取出一个缓冲并复制报文内容，返回唯一的引用
+     */
+    PacketRef acquire(const char* data, size_t len, const struct sockaddr_storage& source, uint64_t rx_ts_ns);
+
+    /**
+     * @brief 向堆申请过的缓冲数
+     */
+    uint64_t getAllocatedCount() const;
+
+    /**
+     * @brief 从空闲列表复用的次数
+     */
+    uint64_t getReusedCount() const;
+
+    size_t getFreeCount() const;
+
+private:
+    friend class PacketRef;
+
+    // 最后一个引用释放时调用
+    void recycle(PacketBuffer* buffer);
+
+    size_t max_free_;
+    std::vector<PacketBuffer*> free_;
+    mutable std::mutex mutex_;
+    std::atomic<uint64_t> allocated_count_;
+    std::atomic<uint64_t> reused_count_;
+};
+
+#endif // PACKET_BUFFER_H
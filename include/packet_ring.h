@@ -0,0 +1,110 @@
+#ifndef PACKET_RING_H
+#define PACKET_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/if_packet.h>
+#include <netinet/in.h>
+
+/**
+ * @class PacketRing
+ * @brief AF_PACKET TPACKET_V3内存映射环形缓冲区，直接读取指定组播组和端口的UDP报文
+ *
+ * 内核把报文按块写入与用户态共享的环形缓冲区，块写满或超时后整块交给用户态，
+ * 一次唤醒处理一整块报文，不经过UDP套接字队列，也没有每个报文一次的recvmsg和拷贝。
+ * 经典BPF过滤器在内核中只放行目的地址和端口匹配的UDP报文（IP分片不放行），
+ * 用户态在环内原地解析IP/UDP头，回调得到指向环内负载的指针。
+ *
+ * 只读取网卡收到的报文（忽略本机发出的），需要CAP_NET_RAW。
+ */
+class PacketRing {
+public:
+    struct Config {
+        size_t block_size = 1 << 20;    // 每块字节数，必须是页大小的整数倍；超过块大小的报文被截断
+        size_t block_count = 64;        // 块数，环形缓冲区总大小为block_size * block_count
+        int block_timeout_ms = 10;      // 块未写满时最多等待多久交给用户态
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    // 环内的一个UDP报文，回调返回前有效
+    struct Frame {
+        const char* data;               // UDP负载，指向环形缓冲区
+        size_t len;
+        struct sockaddr_storage source; // 发送者地址和端口
+        uint64_t rx_ts_ns;              // 内核收到报文的时间（Unix纪元纳秒）
+        bool truncated;                 // 报文超过块大小，只有一部分在环内
+    };
+
+    explicit PacketRing(const Config& config);
+    ~PacketRing();
+
+    /**
+     * @brief 创建环形缓冲区、安装过滤器并绑定到网卡
+     * @param group 组地址和目的端口（AF_INET或AF_INET6）
+     * @param ifindex 网卡索引，0表示所有网卡
+     */
+    bool open(const struct sockaddr_storage& group, unsigned int ifindex);
+
+    void close();
+
+    /**
+     * @brief 可读时有块交给用户态，用于poll/epoll
+     */
+    int fd() const;
+
+    /**
+     * @brief 处理所有已交给用户态的块，对每个报文调用callback(const Frame&)，处理完的块归还内核
+     * @return 处理的报文数
+     */
+    template <typename Callback>
+    size_t drain(Callback&& callback);
+
+    /**
+     * @brief 自上次调用以来因环形缓冲区满被内核丢弃的报文数
+     */
+    uint64_t takeDrops();
+
+private:
+    Config config_;
+    int fd_;
+    char* map_;
+    size_t map_size_;
+    size_t current_;    // 下一个要处理的块
+
+    // 安装只放行组地址和目的端口的BPF过滤器
+    bool attachFilter(const struct sockaddr_storage& group);
+
+    // 在原处解析一个报文的IP/UDP头，不是UDP报文时返回false
+    static bool parseFrame(const struct tpacket3_hdr* packet, Frame& frame);
+};
+
+template <typename Callback>
+size_t PacketRing::drain(Callback&& callback) {
+    size_t processed = 0;
+    while (map_) {
+        auto* block = reinterpret_cast<struct tpacket_block_desc*>(map_ + current_ * config_.block_size);
+        if ((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) {
+            break;
+        }
+
+        const char* cursor = reinterpret_cast<const char*>(block) + block->hdr.bh1.offset_to_first_pkt;
+        for (uint32_t i = 0; i < block->hdr.bh1.num_pkts; ++i) {
+            auto* packet = reinterpret_cast<const struct tpacket3_hdr*>(cursor);
+            Frame frame;
+            if (parseFrame(packet, frame)) {
+                callback(frame);
+                processed++;
+            }
+            cursor += packet->tp_next_offset;
+        }
+
+        // 整块处理完后归还内核
+        __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        current_ = (current_ + 1) % config_.block_count;
+    }
+    return processed;
+}
+
+#endif // PACKET_RING_H
@@ -0,0 +1,185 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <cstdint>
+#include <string>
+#include "arena.h"
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief 在处理流水线中传递的消息及其接收信息
+ */
+struct PipelineMessage {
+    std::string payload;
+    uint64_t rx_ts_ns = 0;      // 接收时间（Unix纪元纳秒）
+    std::string source;         // 发送者地址，未知时为空
+    Arena* arena = nullptr;     // 阶段的暂存内存，为空时从堆分配
+};
+
+/**
+ * @brief 字段谓词：字段存在（并且在指定了值时等于该值）即匹配
+ *
+ * 字段按findJsonField的路径规则查找，字符串比较引号内的内容。
+ */
+struct FieldMatch {
+    std::string field;
+    bool compare_value = false;
+    std::string value;
+
+    bool operator()(const PipelineMessage& message) const;
+};
+
+/**
+ * @brief 过滤阶段：谓词匹配的消息被丢弃
+ */
+template <typename Predicate>
+struct DropIf {
+    Predicate predicate;
+
+    bool operator()(PipelineMessage& message) const {
+        return !predicate(message);
+    }
+};
+
+/**
+ * @brief 过滤阶段：只保留谓词匹配的消息
+ */
+template <typename Predicate>
+struct KeepIf {
+    Predicate predicate;
+
+    bool operator()(PipelineMessage& message) const {
+        return predicate(message);
+    }
+};
+
+/**
+ * @brief 字段投影：只保留列出的字段，按列出顺序重新组成对象
+ *
+ * 字段值按原文复制，不重新序列化；输出对象的键为字段路径。
+ * 缺少的字段跳过，非对象消息原样通过。消息带有arena时在arena中拼接，再复制回payload（复用其容量）。
+ */
+struct ProjectFields {
+    std::vector<std::string> fields;
+
+    bool operator()(PipelineMessage& message) const;
+};
+
+/**
+ * @brief 字段注入：在对象的右括号前拼接接收时间、发送者地址和固定字段
+ *
+ * 原有内容留在原处，注入的字段直接写到右括号的位置，再接回右括号，
+ * 不解析也不重新序列化原有内容；payload预留了空间时不分配内存。
+ * 字段名为空的项不注入，发送者未知时不注入source_field，非对象消息原样通过。
+ */
+struct EnrichFields {
+    std::string timestamp_field;
+    std::string source_field;
+    std::vector<std::pair<std::string, std::string>> constants;     // 字段名 -> JSON值原文
+
+    bool operator()(PipelineMessage& message) const;
+
+private:
+    void appendFields(PipelineMessage& message, bool empty) const;
+};
+
+/**
+ * @class Pipeline
+ * @brief 编译期组合的处理流水线
+ *
+ * 每个阶段是一个以PipelineMessage&调用、返回false表示丢弃的函数对象，
+ * 按模板参数顺序依次执行，遇到丢弃立即结束。阶段类型在编译期确定，
+ * 整条流水线可以内联为一次调用，没有虚函数分派。
+ *
+ * 例如：makePipeline(DropIf<FieldMatch>{{"test", false, ""}}, ProjectFields{{"id", "value"}})
+ */
+template <typename... Stages>
+class Pipeline {
+public:
+    explicit Pipeline(Stages... stages) : stages_(std::move(stages)...) {}
+
+    /**
+     * @brief 依次执行各阶段
+     * @return true 消息应继续转发，false 消息被丢弃
+     */
+    bool apply(PipelineMessage& message) const {
+        return std::apply([&message](const Stages&... stage) { return (stage(message) && ...); }, stages_);
+    }
+
+private:
+    std::tuple<Stages...> stages_;
+};
+
+template <typename... Stages>
+Pipeline<Stages...> makePipeline(Stages... stages) {
+    return Pipeline<Stages...>(std::move(stages)...);
+}
+
+/**
+ * @class RuntimePipeline
+ * @brief 按配置文件组合的处理流水线
+ *
+ * 使用与Pipeline相同的阶段类型，阶段保存在std::variant中，
+ * 执行时按类型直接分派到对应阶段，不经过虚函数或std::function。
+ */
+class RuntimePipeline {
+public:
+    struct Stage {
+        enum class Type {
+            DropIf,     // 字段匹配时丢弃
+            KeepIf,     // 只保留字段匹配的消息
+            Project,    // 字段投影
+            Enrich      // 注入接收时间、发送者地址和固定字段
+        };
+
+        Type type = Type::DropIf;
+        std::string field;                  // DropIf/KeepIf：字段路径
+        bool compare_value = false;         // DropIf/KeepIf：为true时还要求字段值等于equals
+        std::string equals;
+        std::vector<std::string> fields;    // Project：保留的字段
+        std::string timestamp_field;        // Enrich：接收时间字段名，为空不注入
+        std::string source_field;           // Enrich：发送者地址字段名，为空不注入
+        std::vector<std::pair<std::string, std::string>> constants;    // Enrich：固定字段（JSON值原文）
+
+        bool operator==(const Stage& other) const;
+        bool operator!=(const Stage& other) const { return !(*this == other); }
+    };
+
+    struct Config {
+        std::vector<Stage> stages;          // 为空时不处理消息
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    explicit RuntimePipeline(const Config& config);
+
+    /**
+     * @brief 依次执行各阶段
+     * @return true 消息应继续转发，false 消息被丢弃
+     */
+    bool apply(PipelineMessage& message) const;
+
+    size_t size() const;
+
+    /**
+     * @brief 是否有阶段需要发送者地址（调用方可以据此省去格式化地址）
+     */
+    bool usesSource() const;
+
+    /**
+     * @brief 解析配置文件中的阶段类型名（drop_if/keep_if/project/enrich）
+     */
+    static bool parseType(const std::string& name, Stage::Type& type);
+
+private:
+    using AnyStage = std::variant<DropIf<FieldMatch>, KeepIf<FieldMatch>, ProjectFields, EnrichFields>;
+
+    std::vector<AnyStage> stages_;
+    bool uses_source_;
+};
+
+#endif // PIPELINE_H
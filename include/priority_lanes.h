@@ -0,0 +1,156 @@
+#ifndef PRIORITY_LANES_H
+#define PRIORITY_LANES_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "metrics.h"
+
+/**
+ * @class PriorityLanes
+ * @brief 接收与发布之间的多优先级队列，命令类消息不必排在大批遥测数据之后
+ *
+ * 各桥接把待发布的消息按路由（MQTT主题）或JSON字段分类放入通道，由一个发布线程按策略取出：
+ *   - Strict：总是先发布优先级最高（配置中靠前）的非空通道
+ *   - Weighted：按权重轮流发布，每轮每个通道最多weight条，低优先级通道不会饿死
+ * 未匹配任何通道的消息进入最后一个通道。通道满时丢弃新消息。
+ * 停止时先按优先级发布剩余消息，之后送入的消息在调用线程中直接发布。
+ * 每个通道导出排队时延直方图、深度和丢弃数（lane标签）。
+ */
+class PriorityLanes {
+public:
+    // 发布回调函数类型
+    using PublishCallback = std::function<void(const std::string&)>;
+
+    enum class Policy {
+        Strict,
+        Weighted
+    };
+
+    struct Lane {
+        std::string name;
+        std::vector<std::string> topics;    // 发布到这些主题的消息进入本通道
+        std::string field;                  // JSON字段路径（点号分隔），为空时不按字段分类
+        std::vector<std::string> values;    // 字段取这些值之一时进入本通道；为空时只要有该字段即可
+        int weight = 1;                     // Weighted策略下每轮最多发布的条数
+        size_t capacity = 10000;            // 通道最多排队的消息数
+
+        bool operator==(const Lane& other) const;
+        bool operator!=(const Lane& other) const { return !(*this == other); }
+    };
+
+    struct Config {
+        bool enabled = false;
+        Policy policy = Policy::Strict;
+        std::vector<Lane> lanes;            // 按优先级从高到低
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    explicit PriorityLanes(const Config& config);
+    ~PriorityLanes();
+
+    /**
+     * @brief 启动发布线程
+     */
+    bool start();
+
+    bool isRunning() const;
+
+    /**
+     * @brief 停止发布线程，停止前按优先级发布各通道中剩余的消息
+     */
+    void stop();
+
+    /**
+     * @brief 注册一个消息来源（桥接），消息出队时调用其发布回调
+     * @return 来源编号，用于enqueue()和removeSource()
+     */
+    int addSource(PublishCallback callback);
+
+    /**
+     * @brief 取消注册来源，返回后其回调不再执行，队列中剩余的该来源消息被丢弃
+     */
+    void removeSource(int id);
+
+    /**
+     * @brief 分类后放入通道；已停止时在调用线程中直接发布
+     * @param source addSource()返回的编号
+     * @param route 消息的路由（MQTT主题）
+     * @return true 已入队（或已直接发布），false 通道已满，消息被丢弃
+     */
+    bool enqueue(int source, const std::string& route, const std::string& message);
+
+    /**
+     * @brief 按主题和JSON字段选择通道，返回通道下标
+     */
+    size_t classify(const std::string& route, const std::string& message) const;
+
+    /**
+     * @brief 解析策略名（"strict"/"weighted"）
+     */
+    static bool parsePolicy(const std::string& name, Policy& policy);
+
+    /**
+     * @brief 检查配置：至少一个通道、名称唯一、权重和容量为正
+     */
+    static bool validate(const Config& config, std::string& error);
+
+    size_t laneCount() const;
+    const std::string& laneName(size_t lane) const;
+    size_t getDepth(size_t lane) const;
+    uint64_t getDroppedCount(size_t lane) const;
+
+    /**
+     * @brief 通道的平均排队时延（纳秒），没有消息出队过时为0
+     */
+    uint64_t getAverageDelay(size_t lane) const;
+
+private:
+    struct Item {
+        int source;
+        std::string message;
+        uint64_t enqueue_ns;
+    };
+
+    struct LaneState {
+        Lane config;
+        std::deque<Item> queue;
+        std::shared_ptr<Histogram> delay;
+        std::shared_ptr<Gauge> depth;
+        std::shared_ptr<Counter> dropped;
+    };
+
+    Policy policy_;
+    std::vector<LaneState> lanes_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    size_t queued_;             // 各通道排队总数，受queue_mutex_保护
+    size_t current_;            // Weighted策略当前轮到的通道
+    int credit_;                // 当前通道本轮剩余可发布条数
+
+    // 分发期间持有，保证removeSource()之后回调不再执行
+    std::mutex sources_mutex_;
+    std::map<int, PublishCallback> sources_;
+    int next_source_;
+
+    std::atomic<bool> running_;
+    std::thread publish_thread_;
+
+    // 按策略选出下一个要发布的通道，调用方持有queue_mutex_且queued_ > 0
+    size_t nextLane();
+
+    void publishLoop();
+};
+
+#endif // PRIORITY_LANES_H
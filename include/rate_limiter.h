@@ -0,0 +1,168 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @class TokenBucket
+ * @brief 无锁令牌桶（GCRA实现）
+ *
+ * 只保存一个原子的“理论到达时间”(TAT)，每次取令牌为一次load加一次CAS，
+ * 多个线程可以同时使用同一个桶。
+ */
+class alignas(64) TokenBucket {
+public:
+    /**
+     * @param rate 每秒令牌数
+     * @param burst 桶容量（允许的突发消息数，至少为1）
+     */
+    TokenBucket(double rate, double burst);
+
+    /**
+     * @brief 预约一个令牌
+     * @param now_ns 当前时间（纳秒，单调时钟）
+     * @param max_wait_ns 可接受的最长等待时间，0表示不等待
+     * @return 需要等待的纳秒数（0表示立即可用），超过max_wait_ns时不预约并返回-1
+     */
+    int64_t reserve(uint64_t now_ns, uint64_t max_wait_ns);
+
+    /**
+     * @brief 归还一次预约（上级桶拒绝时使用）
+     */
+    void refund();
+
+private:
+    uint64_t interval_ns_;      // 每个令牌的间隔
+    uint64_t tolerance_ns_;     // 突发容忍度
+    std::atomic<uint64_t> tat_;
+};
+
+/**
+ * @class RateLimiter
+ * @brief 分级限流器：全局桶 + 按路由（MQTT主题）的桶
+ *
+ * 消息需要同时通过路由桶和全局桶。超限的消息按策略丢弃、延迟到预约的令牌时间发布，
+ * 或放入有界缓冲队列，由缓冲线程在令牌可用时按原顺序发布。
+ * 调用线程从不休眠：多个桥接共享同一个接收事件循环，在其中等待会拖住所有桥接，
+ * 延迟和缓冲的消息都由缓冲线程发布。
+ */
+class RateLimiter {
+public:
+    // 发布回调函数类型
+    using PublishCallback = std::function<void(const std::string&)>;
+
+    enum class Policy {
+        Drop,       // 超限直接丢弃
+        Delay,      // 预约令牌，由缓冲线程在令牌时间发布；需等待超过max_delay_ms则丢弃
+        Spool       // 放入缓冲队列，队列满则丢弃
+    };
+
+    enum class Result {
+        Admitted,   // 可以立即发布
+        Dropped,    // 已丢弃
+        Spooled     // 已放入缓冲队列（或延迟队列），稍后由缓冲线程发布
+    };
+
+    struct Limit {
+        double rate = 0;    // 每秒消息数，<=0表示不限
+        double burst = 0;   // 突发容量，<=0时取rate
+
+        bool operator==(const Limit& other) const { return rate == other.rate && burst == other.burst; }
+        bool operator!=(const Limit& other) const { return !(*this == other); }
+    };
+
+    struct Config {
+        bool enabled = false;
+        Limit global;
+        std::map<std::string, Limit> routes;    // 键为MQTT主题
+        Policy policy = Policy::Drop;
+        int max_delay_ms = 100;
+        size_t spool_size = 10000;
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @param config 限流配置
+     * @param route 本转发器的路由（MQTT主题），用于选择路由桶
+     * @param global 共享的全局桶，为空时按config.global创建
+     */
+    RateLimiter(const Config& config, const std::string& route,
+                std::shared_ptr<TokenBucket> global = nullptr);
+    ~RateLimiter();
+
+    /**
+     * @brief 启动缓冲线程（Spool和Delay策略需要）
+     */
+    bool start(PublishCallback callback);
+
+    /**
+     * @brief 停止缓冲线程，停止前发布队列中剩余的消息
+     */
+    void stop();
+
+    /**
+     * @brief 为一条消息申请发布许可
+     */
+    Result acquire(const std::string& message);
+
+    /**
+     * @brief 按配置创建全局桶，未配置全局限速时返回空
+     */
+    static std::shared_ptr<TokenBucket> makeBucket(const Limit& limit);
+
+    /**
+     * @brief 解析策略名（"drop"/"delay"/"spool"）
+     */
+    static bool parsePolicy(const std::string& name, Policy& policy);
+
+    uint64_t getDroppedCount() const;
+    uint64_t getDelayedCount() const;
+    uint64_t getSpooledCount() const;
+
+    /**
+     * @brief 缓冲队列中等待发布的消息数
+     */
+    size_t getSpoolDepth() const;
+    void resetStatistics();
+
+private:
+    std::shared_ptr<TokenBucket> global_;
+    std::shared_ptr<TokenBucket> route_;
+    Policy policy_;
+    uint64_t max_delay_ns_;
+    size_t spool_size_;
+
+    std::mutex spool_mutex_;
+    std::condition_variable spool_cv_;
+    // 排队的消息；due_ns为0时到达队首再预约令牌（Spool），否则已预约，到该时间发布（Delay）
+    struct Spooled {
+        uint64_t due_ns;
+        std::string message;
+    };
+    std::deque<Spooled> spool_;
+    std::atomic<size_t> spool_depth_;
+
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> dropped_count_;
+    std::atomic<uint64_t> delayed_count_;
+    std::atomic<uint64_t> spooled_count_;
+    std::thread spool_thread_;
+
+    // 依次预约路由桶和全局桶，返回需等待的纳秒数，-1表示超出等待上限
+    int64_t reserve(uint64_t max_wait_ns);
+
+    void spoolLoop(PublishCallback callback);
+};
+
+#endif // RATE_LIMITER_H
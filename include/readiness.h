@@ -0,0 +1,49 @@
+#ifndef READINESS_H
+#define READINESS_H
+
+#include <mutex>
+#include <string>
+
+/**
+ * @class Readiness
+ * @brief 向服务管理器报告就绪和停止状态，用于滚动重启时判断新进程何时可以接替旧进程
+ *
+ * 两种方式可同时使用：
+ *   - systemd（Type=notify）：环境变量NOTIFY_SOCKET指定的Unix数据报套接字，发送sd_notify格式的状态，
+ *     以'@'开头的路径为抽象命名空间
+ *   - 就绪文件：就绪时写入进程号（先写临时文件再rename，读取方看到的总是完整内容），停止时删除
+ *
+ * 线程安全；stopping()之后不再报告就绪。
+ */
+class Readiness {
+public:
+    /**
+     * @param ready_file 就绪文件路径，为空时不写文件
+     */
+    explicit Readiness(const std::string& ready_file = "");
+
+    /**
+     * @brief 报告就绪：发送"READY=1"和状态说明，写入就绪文件
+     * @return false 配置了就绪文件但写入失败
+     */
+    bool ready(const std::string& status);
+
+    /**
+     * @brief 报告开始停止：发送"STOPPING=1"，删除就绪文件
+     */
+    void stopping();
+
+    /**
+     * @brief 按sd_notify协议向NOTIFY_SOCKET发送状态（多个"KEY=VALUE"以换行分隔）
+     * @return true 已发送，false 未设置NOTIFY_SOCKET或发送失败
+     */
+    static bool notify(const std::string& state);
+
+private:
+    std::string ready_file_;
+    std::mutex mutex_;
+    bool file_written_;
+    bool stopping_;
+};
+
+#endif // READINESS_H
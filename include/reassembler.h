@@ -0,0 +1,121 @@
+#ifndef REASSEMBLER_H
+#define REASSEMBLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class Reassembler
+ * @brief 把分片发送的大消息重新组装成完整消息
+ *
+ * 分片格式：每个报文以12字节头开始（网络字节序），之后是本分片的数据：
+ *   0-1  魔数 'M' 'F'
+ *   2    版本号（1）
+ *   3    保留（0）
+ *   4-7  消息ID（同一发送者内唯一）
+ *   8-9  分片序号（从0开始）
+ *   10-11 分片总数（1-65535）
+ *
+ * 按（发送者，消息ID）组装，重组表的消息数和单条消息大小都有上限；分片按收到的顺序存放，
+ * 占用的内存只与已收到的分片有关，与报文头声明的分片总数无关（分片总数超过max_message_size的直接丢弃）；
+ * 超时未收齐的消息被丢弃，表满时丢弃最早开始的消息。不带分片头的报文原样通过。
+ *
+ * 非线程安全，只应在接收线程中调用。
+ */
+class Reassembler {
+public:
+    struct Config {
+        bool enabled = false;
+        size_t max_messages = 1024;         // 同时组装中的消息数上限
+        size_t max_message_size = 1048576;  // 组装后单条消息的大小上限
+        int timeout_ms = 1000;              // 从第一个分片到达起的组装时限
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    enum class Result {
+        Passthrough,    // 不是分片报文，按原样处理
+        Pending,        // 已记录，消息尚未收齐
+        Complete,       // 消息已收齐，完整内容写入message
+        Dropped         // 分片头无效、与已有分片不一致或超出大小上限
+    };
+
+    static const size_t HEADER_SIZE = 12;
+
+    explicit Reassembler(const Config& config);
+
+    /**
+     * @brief 处理一个报文
+     * @param source 发送者标识（由调用方根据源地址和端口计算）
+     * @param message 消息收齐时写入完整内容
+     */
+    Result add(uint64_t source, const char* data, size_t len, std::string& message);
+
+    /**
+     * @brief 同上，使用调用者给出的时间（毫秒，单调时钟）
+     */
+    Result add(uint64_t source, const char* data, size_t len, std::string& message, uint64_t now_ms);
+
+    /**
+     * @brief 把一条消息切分成带分片头的报文，每个报文不超过max_datagram字节
+     * @return 分片列表，可直接交给UdpSender::sendBatch；max_datagram过小或分片数超过65535时返回空
+     */
+    static std::vector<std::string> fragment(uint32_t message_id, const std::string& message,
+                                             size_t max_datagram);
+
+    uint64_t getCompletedCount() const;
+
+    /**
+     * @brief 获取丢弃的消息数（超时、表满淘汰、分片无效或超出大小上限）
+     */
+    uint64_t getDroppedCount() const;
+
+    size_t pendingCount() const;
+
+private:
+    struct Key {
+        uint64_t source;
+        uint32_t message_id;
+
+        bool operator==(const Key& other) const {
+            return source == other.source && message_id == other.message_id;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return static_cast<size_t>(key.source * 0x9E3779B97F4A7C15ULL ^ key.message_id);
+        }
+    };
+
+    struct Entry {
+        Key key;
+        uint64_t started_ms;
+        uint16_t count;
+        uint16_t received;
+        size_t bytes;
+        std::map<uint16_t, std::string> fragments;  // 已收到的分片，按分片序号排列
+    };
+
+    Config config_;
+
+    // 按开始时间排列，表头最早，超时检查和淘汰都从表头进行
+    std::list<Entry> entries_;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+
+    uint64_t completed_count_;
+    uint64_t dropped_count_;
+
+    // 丢弃已超时的消息
+    void expire(uint64_t now_ms);
+
+    void erase(std::list<Entry>::iterator it);
+};
+
+#endif // REASSEMBLER_H
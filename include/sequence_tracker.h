@@ -0,0 +1,158 @@
+#ifndef SEQUENCE_TRACKER_H
+#define SEQUENCE_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/socket.h>
+
+/**
+ * @class SequenceTracker
+ * @brief 按发送者跟踪消息序号，检测丢包（序号缺口）、重复和乱序
+ *
+ * 发送者状态保存在固定容量的开放寻址表中，每个槽位记录最大序号和其下64个序号的接收位图，
+ * 探测范围内全部占用时覆盖最久未活动的发送者，内存占用不随发送者数量增长。
+ *
+ * 可选的重排缓冲：出现缺口时暂存后续消息，缺口补齐后按序号放行；
+ * 超过reorder_window_ms仍未补齐则跳过缺口，保证每条消息的额外延迟有上限。
+ * 暂存的消息保留各自的接收时间和来源地址，放行时原样交回。
+ *
+ * 非线程安全，只应在接收线程中调用。
+ */
+class SequenceTracker {
+public:
+    struct Config {
+        bool enabled = false;
+        std::string seq_field = "seq";      // 序号字段路径，值为非负整数；没有该字段的消息不跟踪
+        size_t max_sources = 1024;          // 跟踪的发送者数量，向上取整为2的幂
+        int reorder_window_ms = 0;          // 大于0时启用重排缓冲，为最长等待时间
+        size_t reorder_max_messages = 256;  // 每个发送者最多暂存的消息数
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    enum class Result {
+        Untracked,      // 没有序号字段
+        InOrder,        // 序号连续（或该发送者的第一条消息）
+        Gap,            // 序号跳跃，中间的消息尚未收到
+        Reordered,      // 迟到的消息，补上了之前的缺口
+        Duplicate,      // 已收到过的序号
+        Reset           // 序号大幅回退，视为发送者重启
+    };
+
+    // 放行的消息及其接收时间（Unix纪元纳秒）和来源地址
+    struct Released {
+        std::string message;
+        uint64_t rx_ts_ns;
+        struct sockaddr_storage src_addr;
+    };
+
+    struct Statistics {
+        uint64_t tracked = 0;       // 带序号的消息数
+        uint64_t missing = 0;       // 检测到缺口时缺少的消息数
+        uint64_t reordered = 0;     // 迟到的消息数（missing - reordered 为实际丢失数）
+        uint64_t duplicates = 0;
+        uint64_t resets = 0;
+    };
+
+    explicit SequenceTracker(const Config& config);
+
+    /**
+     * @brief 记录一条消息并返回分类
+     */
+    Result track(uint64_t source, const char* data, size_t len, uint64_t now_ms);
+
+    /**
+     * @brief 记录一条消息，并把可以放行的消息按序号追加到release
+     *
+     * 未启用重排缓冲时消息总是立即放行；启用时重复消息被丢弃，缺口之后的消息暂存。
+     * rx_ts_ns和src_addr随消息保存，放行时原样带出。
+     */
+    void add(uint64_t source, const char* data, size_t len, uint64_t rx_ts_ns,
+             const struct sockaddr_storage& src_addr, uint64_t now_ms, std::vector<Released>& release);
+
+    /**
+     * @brief 放行等待超过重排窗口的消息，以及因发送者被淘汰而留下的消息
+     */
+    void flush(uint64_t now_ms, std::vector<Released>& release);
+
+    /**
+     * @brief 下一次需要调用flush的时间，没有暂存消息时返回0
+     */
+    uint64_t nextDeadline() const;
+
+    bool reordering() const;
+
+    size_t heldCount() const;
+
+    const Statistics& statistics() const;
+
+private:
+    struct Source {
+        uint64_t key;
+        uint64_t highest;       // 收到的最大序号
+        uint64_t window;        // 位i表示序号highest-i已收到
+        uint64_t next;          // 重排缓冲下一个应放行的序号
+        uint64_t last_ms;
+        bool used;
+    };
+
+    struct Held {
+        uint64_t arrived_ms;
+        Released released;
+    };
+
+    // 暂存消息的到达记录；接收时间单调递增，队首即最早到达的消息
+    struct Arrival {
+        uint64_t arrived_ms;
+        uint64_t source;
+        uint64_t seq;
+    };
+
+    static const size_t MAX_PROBE = 16;
+    static const uint64_t RESET_DISTANCE = 1024;
+
+    Config config_;
+    std::vector<Source> slots_;
+    size_t mask_;
+    Statistics stats_;
+
+    // 重排缓冲：发送者 -> 按序号排列的暂存消息
+    std::unordered_map<uint64_t, std::map<uint64_t, Held>> held_;
+    size_t held_count_;
+
+    // 按到达顺序排列的暂存记录，已放行的消息留在队列中，到达队首时丢弃
+    std::deque<Arrival> arrivals_;
+
+    // 被淘汰的发送者留下的暂存消息，在下一次flush时放行
+    std::vector<Released> orphaned_;
+
+    // 查找或分配发送者槽位，fresh表示新分配
+    Source& lookup(uint64_t source, uint64_t now_ms, bool& fresh);
+
+    // 查找已有的发送者槽位，不存在时返回nullptr
+    Source* find(uint64_t source);
+
+    Result classify(Source& slot, uint64_t seq, bool fresh);
+
+    // 放行从slot.next开始连续的暂存消息（不删除空的映射项）
+    void releaseContiguous(Source& slot, std::map<uint64_t, Held>& held, std::vector<Released>& release);
+
+    // 放行一个发送者的全部暂存消息
+    void releaseAll(uint64_t source, std::vector<Released>& release);
+
+    // 找到到达记录对应的仍在暂存的消息，已放行时返回nullptr
+    std::map<uint64_t, Held>* heldFor(const Arrival& arrival);
+
+    // 丢弃队首已放行的到达记录
+    void pruneArrivals();
+
+    static bool parseSequence(const char* data, size_t len, const std::string& field, uint64_t& seq);
+};
+
+#endif // SEQUENCE_TRACKER_H
@@ -0,0 +1,144 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * 共享内存环文件格式（本机字节序，只在同一主机上使用）：
+ *
+ *   文件头64字节：魔数"SHMRING1"、u32槽位数、u32槽位长度、atomic u64已写入的最大序号、
+ *                atomic u32状态（1为写入中，2为已关闭）、其余保留
+ *   槽位：atomic u64状态序号、u64写入时间（Unix纪元纳秒）、u32主题长度、u32负载长度，随后是主题和负载
+ *
+ * 序号从1开始，第n条消息写入第n % 槽位数个槽位。写入时状态序号先置为2n-1（奇数表示正在写），
+ * 写完置为2n；读取方读到2n后复制内容，再确认状态序号没有变化，否则说明被覆盖。
+ */
+
+/**
+ * @class ShmRing
+ * @brief 写入端：把转发的消息写入/dev/shm下内存映射的广播环，供同一主机上的消费者直接读取
+ *
+ * 一个写入端、任意多个读取端；读取端只读映射、互不影响，也不影响写入端。写入端从不等待读取端，
+ * 读取落后超过一圈的读取端丢失被覆盖的消息并自行计数。可被多个转发器共享，写入时加锁。
+ */
+class ShmRing {
+public:
+    struct Config {
+        bool enabled = false;
+        std::string path = "/dev/shm/mqtt_sender";
+        size_t slots = 4096;            // 槽位数
+        size_t slot_size = 2048;        // 每个槽位的字节数（含32字节槽位头），64的整数倍
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    explicit ShmRing(const Config& config);
+    ~ShmRing();
+
+    /**
+     * @brief 创建新的环文件并映射（替换同名文件，已打开旧文件的读取端看到它被关闭）
+     */
+    bool open();
+
+    /**
+     * @brief 标记为已关闭并解除映射，文件保留
+     */
+    void close();
+
+    /**
+     * @brief 写入一条消息
+     * @return false 未打开，或主题加负载超过槽位容量（计入丢弃数）
+     */
+    bool write(std::string_view topic, std::string_view payload, uint64_t ts_ns);
+
+    /**
+     * @brief 槽位能容纳的主题加负载的最大字节数
+     */
+    size_t capacity() const;
+
+    uint64_t getWrittenCount() const;
+    uint64_t getDroppedCount() const;
+
+    /**
+     * @brief 检查配置：槽位数至少为1，槽位长度为64的整数倍且大于槽位头
+     */
+    static bool validate(const Config& config, std::string& error);
+
+private:
+    Config config_;
+    int fd_;
+    char* map_;
+    size_t size_;
+    uint64_t sequence_;
+    std::mutex mutex_;
+
+    std::atomic<uint64_t> written_count_;
+    std::atomic<uint64_t> dropped_count_;
+};
+
+/**
+ * @class ShmRingReader
+ * @brief 读取端：只读映射ShmRing写入的环文件，不需要系统调用即可读取新消息
+ *
+ * 不依赖MQTT和其他模块，可以单独编译到消费者程序中（只需shm_ring.h和shm_ring.cpp），
+ * 示例见examples/shm_reader.cpp。
+ */
+class ShmRingReader {
+public:
+    struct Message {
+        uint64_t sequence;
+        uint64_t ts_ns;
+        std::string_view topic;         // 指向读取端的内部缓冲，下一次poll()前有效
+        std::string_view payload;
+    };
+
+    explicit ShmRingReader(const std::string& path);
+    ~ShmRingReader();
+
+    /**
+     * @brief 只读映射环文件并检查文件头，之后从最新的消息开始读取
+     */
+    bool open();
+
+    void close();
+
+    /**
+     * @brief 读取下一条消息
+     * @return false 没有新消息
+     */
+    bool poll(Message& message);
+
+    /**
+     * @brief 跳到最新写入的消息之后，只读取之后的消息
+     */
+    void seekToLatest();
+
+    /**
+     * @brief 写入端已关闭（或已用新文件替换），应重新open()
+     */
+    bool isClosed() const;
+
+    /**
+     * @brief 因读取落后被覆盖而丢失的消息数
+     */
+    uint64_t getLostCount() const;
+
+private:
+    std::string path_;
+    int fd_;
+    const char* map_;
+    size_t size_;
+    uint32_t slots_;
+    uint32_t slot_size_;
+    uint64_t next_;                 // 下一个要读取的序号
+    uint64_t lost_;
+    std::string buffer_;
+};
+
+#endif // SHM_RING_H
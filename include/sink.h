@@ -0,0 +1,217 @@
+#ifndef SINK_H
+#define SINK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "capture.h"
+#include "metrics.h"
+#include "packet_buffer.h"
+#include "udp_sender.h"
+
+/**
+ * @class Sink
+ * @brief 与MQTT发布并列的报文输出端，每个输出端有自己的队列、背压策略和投递线程
+ *
+ * 接收到的报文只复制一次到引用计数的PacketBuffer，各输出端的队列保存同一缓冲的引用；
+ * 投递线程每次最多取出MAX_BATCH条一起投递，最后一个输出端投递完成后缓冲回到池中。
+ * 队列满时按策略处理：
+ *   - Block：等待队列有空位（会阻塞接收线程，由内核接收缓冲吸收突发）
+ *   - DropNewest：丢弃新报文
+ *   - DropOldest：丢弃队列中最早的报文，为新报文腾出空位
+ * 导出投递数、丢弃数、失败数和队列深度（bridge、sink标签）。
+ */
+class Sink {
+public:
+    enum class Type {
+        Record,     // 追加到录制文件（与--record相同的格式，可用--replay回放）
+        Mirror      // 原样发送到UDP单播（或组播）地址
+    };
+
+    enum class Policy {
+        Block,
+        DropNewest,
+        DropOldest
+    };
+
+    struct Config {
+        Type type = Type::Record;
+        std::string name;                   // 为空时使用类型名
+        std::string path;                   // Record：录制文件路径
+        std::string host;                   // Mirror：目标IPv4地址
+        int port = 0;                       // Mirror：目标端口
+        size_t capacity = 10000;            // 队列最多排队的报文数
+        Policy policy = Policy::DropNewest;
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief 按类型创建输出端
+     * @param bridge 所属桥接名称，用于录制通道名和指标标签
+     */
+    static std::unique_ptr<Sink> create(const Config& config, const std::string& bridge);
+
+    /**
+     * @brief 派生类在析构时调用stop()，保证投递线程不会在派生部分销毁后继续投递
+     */
+    virtual ~Sink();
+
+    /**
+     * @brief 打开输出（录制文件、发送套接字）并启动投递线程
+     */
+    bool start();
+
+    /**
+     * @brief 停止投递线程，停止前投递队列中剩余的报文，然后关闭输出
+     */
+    void stop();
+
+    /**
+     * @brief 把报文引用放入队列
+     * @return false 报文被丢弃（队列满且策略为DropNewest，或已停止）
+     */
+    bool offer(const PacketRef& packet);
+
+    const std::string& name() const;
+    size_t getDepth() const;
+    uint64_t getDeliveredCount() const;
+    uint64_t getDroppedCount() const;
+    uint64_t getFailedCount() const;
+
+    /**
+     * @brief 解析类型名（"record"/"mirror"）
+     */
+    static bool parseType(const std::string& name, Type& type);
+
+    /**
+     * @brief 解析策略名（"block"/"drop_newest"/"drop_oldest"）
+     */
+    static bool parsePolicy(const std::string& name, Policy& policy);
+
+    /**
+     * @brief 检查配置：容量为正，Record有路径，Mirror有地址和端口
+     */
+    static bool validate(const Config& config, std::string& error);
+
+    static const size_t MAX_BATCH = 64;
+
+protected:
+    Sink(const Config& config, const std::string& bridge);
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    /**
+     * @brief 在投递线程中投递一批报文
+     * @return 成功投递的条数，其余计入失败数
+     */
+    virtual size_t deliver(const PacketRef* packets, size_t count) = 0;
+
+    const Config& config() const;
+    const std::string& bridge() const;
+
+private:
+    Config config_;
+    std::string bridge_;
+    std::string name_;
+
+    std::deque<PacketRef> queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    std::shared_ptr<Counter> delivered_count_;
+    std::shared_ptr<Counter> dropped_count_;
+    std::shared_ptr<Counter> failed_count_;
+    std::shared_ptr<Gauge> depth_;
+
+    void deliverLoop();
+};
+
+/**
+ * @class RecordSink
+ * @brief 把报文追加到录制文件，通道名为所属桥接名称
+ */
+class RecordSink : public Sink {
+public:
+    RecordSink(const Config& config, const std::string& bridge);
+    ~RecordSink() override;
+
+protected:
+    bool open() override;
+    void close() override;
+    size_t deliver(const PacketRef* packets, size_t count) override;
+
+private:
+    CaptureWriter writer_;
+    uint16_t channel_;
+};
+
+/**
+ * @class MirrorSink
+ * @brief 把报文原样发送到另一个UDP地址，一批报文一次sendmmsg
+ */
+class MirrorSink : public Sink {
+public:
+    MirrorSink(const Config& config, const std::string& bridge);
+    ~MirrorSink() override;
+
+protected:
+    bool open() override;
+    void close() override;
+    size_t deliver(const PacketRef* packets, size_t count) override;
+
+private:
+    UdpSender sender_;
+    std::string_view views_[MAX_BATCH];
+};
+
+/**
+ * @class FanOut
+ * @brief 把一份报文交给多个输出端：复制一次到池中的缓冲，各输出端共享引用
+ *
+ * 增加输出端不增加复制；缓冲在最后一个输出端释放后回到池中复用。
+ */
+class FanOut {
+public:
+    FanOut(const std::vector<Sink::Config>& sinks, const std::string& bridge);
+    ~FanOut();
+
+    /**
+     * @brief 启动全部输出端，有失败时停止已启动的
+     */
+    bool start();
+
+    /**
+     * @brief 停止全部输出端（各自投递完剩余报文）
+     */
+    void stop();
+
+    /**
+     * @brief 复制报文到池中的缓冲，交给每个输出端
+     */
+    void dispatch(const std::string& data, const struct sockaddr_storage& source, uint64_t rx_ts_ns);
+
+    size_t sinkCount() const;
+    const Sink& sink(size_t index) const;
+    const PacketBufferPool& pool() const;
+
+private:
+    // 输出端在池之前销毁，保证全部引用先释放
+    PacketBufferPool pool_;
+    std::vector<std::unique_ptr<Sink>> sinks_;
+};
+
+#endif // SINK_H
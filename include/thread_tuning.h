@@ -0,0 +1,72 @@
+#ifndef THREAD_TUNING_H
+#define THREAD_TUNING_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class ThreadTuning
+ * @brief 按线程角色设置CPU亲和性和SCHED_FIFO实时优先级
+ *
+ * 启动时用configure()设置一次进程内的各角色设置，各线程在自己的入口处调用apply()：
+ *   - Receive：UDP接收事件循环线程（包括反应器线程）和独立接收线程
+ *   - Publish：合并器和限流缓冲的发布线程
+ *   - Network：libmosquitto的网络线程（由mosquitto_loop_start创建，在首次连接回调中设置；反应器模式下没有）
+ * 设置失败（例如缺少CAP_SYS_NICE）只输出警告，线程按普通调度继续运行。
+ */
+class ThreadTuning {
+public:
+    enum class Role {
+        Receive,
+        Publish,
+        Network
+    };
+
+    struct Settings {
+        std::vector<int> cpus;      // 允许运行的CPU核，为空时不限制
+        int priority = 0;           // SCHED_FIFO优先级（1-99），0保持普通调度
+
+        bool enabled() const { return !cpus.empty() || priority > 0; }
+
+        bool operator==(const Settings& other) const;
+        bool operator!=(const Settings& other) const { return !(*this == other); }
+    };
+
+    struct Config {
+        Settings receive;
+        Settings publish;
+        Settings network;
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief 设置各角色的调整，之后启动的线程生效（已运行的线程不变）
+     */
+    static void configure(const Config& config);
+
+    /**
+     * @brief 按角色调整调用线程，并把线程名设为name（最多15个字符）
+     * @param slot 同一角色有多个线程时的编号：配置了多个CPU时只绑定到第slot % N个，-1为绑定到全部
+     * @return true 没有需要调整的项或全部成功，false 有调整失败
+     */
+    static bool apply(Role role, const std::string& name, int slot = -1);
+
+    /**
+     * @brief 按给定设置调整调用线程
+     */
+    static bool apply(const Settings& settings, const std::string& name);
+
+    /**
+     * @brief 检查设置是否有效：CPU编号非负且小于CPU_SETSIZE，优先级在0-99之间
+     */
+    static bool validate(const Settings& settings, std::string& error);
+
+private:
+    static std::mutex mutex_;
+    static Config config_;
+};
+
+#endif // THREAD_TUNING_H
@@ -0,0 +1,118 @@
+#ifndef UDP_EVENT_LOOP_H
+#define UDP_EVENT_LOOP_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class UdpEventLoop
+ * @brief 基于epoll的接收事件循环，多个UDP接收器共用一个线程
+ *
+ * 每个套接字注册一个就绪回调，回调在循环线程中执行。
+ * remove()返回后保证该套接字的回调不再执行；回调内部也可以调用add()/modify()/remove()。
+ *
+ * 反应器模式下MQTT连接的套接字也注册到这里（可读/可写），每轮事件处理完后执行tick回调
+ * （检查待写数据、保活和重连），接收到发布在同一个线程中完成，没有跨线程交接。
+ *
+ * 低延迟模式（spin_us > 0）：处理完事件后先以零超时轮询spin_us微秒，
+ * 期间没有新事件才回到阻塞等待，以一个CPU核的占用换取唤醒延迟。
+ */
+class UdpEventLoop {
+public:
+    // 套接字可读回调函数类型
+    using ReadyCallback = std::function<void()>;
+
+    // 套接字就绪回调函数类型，参数为epoll事件（EPOLLIN/EPOLLOUT/EPOLLERR...）
+    using EventCallback = std::function<void(uint32_t)>;
+
+    /**
+     * @param spin_us 阻塞等待前的轮询时长（微秒），0为不轮询
+     * @param slot 多个反应器时的编号（线程名后缀，按编号从receive.cpus中选一个核），-1为单个事件循环
+     */
+    explicit UdpEventLoop(int spin_us = 0, int slot = -1);
+    ~UdpEventLoop();
+
+    /**
+     * @brief 启动事件循环线程
+     * @return true 启动成功，false 启动失败
+     */
+    bool start();
+
+    /**
+     * @brief 停止事件循环线程
+     */
+    void stop();
+
+    /**
+     * @brief 检查事件循环是否运行中
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief 注册套接字（水平触发），可读时在循环线程中调用callback
+     * @param fd 非阻塞套接字
+     * @param callback 可读回调
+     * @return true 注册成功
+     */
+    bool add(int fd, ReadyCallback callback);
+
+    /**
+     * @brief 按事件掩码注册套接字（水平触发），就绪时在循环线程中调用callback(events)
+     * @param fd 非阻塞套接字
+     * @param events EPOLLIN/EPOLLOUT的组合
+     */
+    bool add(int fd, uint32_t events, EventCallback callback);
+
+    /**
+     * @brief 修改已注册套接字关注的事件
+     */
+    bool modify(int fd, uint32_t events);
+
+    /**
+     * @brief 取消注册套接字，返回后回调不再执行
+     */
+    void remove(int fd);
+
+    /**
+     * @brief 注册tick回调：每轮事件处理完后（至少每秒一次）在循环线程中执行
+     * @return tick编号，用于removeTick()
+     */
+    int addTick(ReadyCallback callback);
+
+    /**
+     * @brief 取消tick回调，返回后不再执行；不能在tick回调内部调用
+     */
+    void removeTick(int id);
+
+    /**
+     * @brief 唤醒阻塞中的epoll_wait，使tick回调尽快执行
+     */
+    void wake();
+
+private:
+    int epoll_fd_;
+    int wake_fd_;       // eventfd，用于唤醒epoll_wait以便退出
+    int spin_us_;
+    int slot_;
+    std::atomic<bool> running_;
+    std::thread loop_thread_;
+
+    // 分发期间持有，保证remove()之后回调不再执行；可重入，回调内部可以增删套接字
+    std::recursive_mutex handlers_mutex_;
+    // 分发时复制一份引用，回调内部remove()自身不会销毁正在执行的回调
+    std::unordered_map<int, std::shared_ptr<EventCallback>> handlers_;
+    std::vector<std::pair<int, ReadyCallback>> ticks_;
+    int next_tick_id_;
+
+    // 事件循环线程主函数
+    void run();
+};
+
+#endif // UDP_EVENT_LOOP_H
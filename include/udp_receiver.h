@@ -5,34 +5,229 @@
 #include <thread>
 #include <atomic>
 #include <functional>
+#include <memory>
+#include <vector>
+#include <netinet/in.h>
+#include "capture.h"
+#include "metrics.h"
+#include "packet_ring.h"
+#include "reassembler.h"
+#include "sequence_tracker.h"
+
+class UdpEventLoop;
 
 class UdpReceiver {
 public:
     // 接收回调函数类型
     using ReceiveCallback = std::function<void(const std::string&)>;
 
+    // 一条消息的接收信息，只在回调期间有效
+    struct MessageInfo {
+        uint64_t rx_ts_ns;                      // 内核收到报文的时间（Unix纪元纳秒，SO_TIMESTAMPNS）
+        const struct sockaddr_storage* source;  // 发送者地址（经过重排缓冲的消息同样是它自己的）
+    };
+
+    // 带接收信息的回调函数类型
+    using MessageCallback = std::function<void(const std::string&, const MessageInfo&)>;
+
+    // 接收统计指标，为空的项不统计
+    struct Metrics {
+        std::shared_ptr<Counter> rx_packets;
+        std::shared_ptr<Counter> rx_bytes;
+        std::shared_ptr<Counter> kernel_drops;  // 接收缓冲区满被内核丢弃的报文数
+        std::shared_ptr<Counter> truncated;     // 超过max_datagram_size被截断而丢弃的报文数
+        std::shared_ptr<Counter> reassembled;   // 组装完成的分片消息数
+        std::shared_ptr<Counter> reassembly_dropped;  // 超时、淘汰或无效而丢弃的分片消息数
+        std::shared_ptr<Counter> seq_tracked;   // 带序号的消息数
+        std::shared_ptr<Counter> seq_missing;   // 序号缺口中缺少的消息数
+        std::shared_ptr<Counter> seq_reordered; // 迟到（乱序）的消息数
+        std::shared_ptr<Counter> seq_duplicates;    // 序号重复的消息数
+        std::shared_ptr<Counter> seq_resets;    // 发送者序号回退（重启）次数
+    };
+
+    // 报文接收方式
+    struct ReceiveOptions {
+        enum class Backend {
+            Socket,     // UDP套接字（recvmsg）
+            PacketRing  // AF_PACKET TPACKET_V3环形缓冲区，需要CAP_NET_RAW
+        };
+
+        Backend backend = Backend::Socket;
+        PacketRing::Config ring;            // PacketRing：环形缓冲区大小
+        size_t max_datagram_size = 65507;   // 单个报文的最大长度（最大65535），超过的报文被丢弃并计数
+        bool gro = false;                   // 启用UDP_GRO，一次系统调用接收内核合并的多个报文
+        Reassembler::Config framing;        // 多报文消息的分片重组
+        SequenceTracker::Config sequence;   // 按发送者的序号跟踪和重排
+        int busy_poll_us = 0;               // SO_BUSY_POLL：阻塞接收时先忙轮询网卡队列的时长（微秒），0为不启用
+
+        bool operator==(const ReceiveOptions& other) const;
+        bool operator!=(const ReceiveOptions& other) const { return !(*this == other); }
+    };
+
+    // 组播加入方式
+    struct JoinOptions {
+        std::vector<std::string> interfaces;        // 在多个网卡上加入，为空时使用构造参数interface（IPv6为网卡名或索引）
+        std::vector<std::string> sources;           // 源特定组播：只接收这些发送者
+        std::vector<std::string> exclude_sources;   // 任意源加入，但屏蔽这些发送者（不能与sources同时使用）
+        bool bind_group = true;                     // 绑定组地址而不是INADDR_ANY
+
+        bool operator==(const JoinOptions& other) const;
+        bool operator!=(const JoinOptions& other) const { return !(*this == other); }
+    };
+
+    // multicast_addr可以是IPv4或IPv6组地址；IPv4的interface为网卡地址，IPv6为网卡名（如eth0）或索引
     UdpReceiver(const std::string& multicast_addr, int port, const std::string& interface = "");
     ~UdpReceiver();
 
     // 启动接收线程
     bool start(ReceiveCallback callback = nullptr);
 
+    // 注册到共享的事件循环接收，不创建单独的线程
+    bool start(UdpEventLoop& loop, ReceiveCallback callback = nullptr);
+
+    // 同上，回调同时得到接收时间和发送者地址
+    bool start(MessageCallback callback);
+    bool start(UdpEventLoop& loop, MessageCallback callback);
+
+    // 回放模式：不创建套接字，报文由inject()送入，经过与接收相同的分片重组、序号跟踪和回调
+    bool startReplay(MessageCallback callback);
+
+    // 回放模式下送入一个报文，rx_ts_ns为录制时的接收时间
+    void inject(const char* data, int len, const struct sockaddr_storage& src_addr, uint64_t rx_ts_ns);
+
     // 停止接收
     void stop();
 
     // 检查是否正在运行
     bool isRunning() const;
 
+    // 设置接收统计指标，需在start()之前调用
+    void setMetrics(const Metrics& metrics);
+
+    // 设置组播加入方式（多网卡、源过滤），需在start()之前调用
+    void setJoinOptions(const JoinOptions& options);
+
+    // 设置报文大小上限、GRO和分片重组，需在start()之前调用
+    void setReceiveOptions(const ReceiveOptions& options);
+
+    // 把收到的每个报文（GRO合并的按分段）连同接收时间和来源追加到抓包文件，需在start()之前调用
+    void setCapture(std::shared_ptr<CaptureWriter> capture, uint16_t channel);
+
+    // 格式化报文来源：IPv4为addr:port，IPv6为[addr]:port
+    static std::string formatSource(const struct sockaddr_storage& src_addr);
+
+    // 格式化到调用方的缓冲区（不分配内存），返回写入的长度（不含结尾的'\0'）；缓冲区太小时截断
+    static size_t formatSource(const struct sockaddr_storage& src_addr, char* buffer, size_t size);
+
+    // 解析配置文件中的接收方式名（socket/packet_ring）
+    static bool parseBackend(const std::string& name, ReceiveOptions::Backend& backend);
+
 private:
     std::string multicast_addr_;
     int port_;
     std::string interface_;
     int socket_fd_;
+    int family_;        // AF_INET或AF_INET6，由组地址决定
     std::atomic<bool> running_;
     std::thread receive_thread_;
 
+    // 事件循环模式下使用的循环和回调
+    UdpEventLoop* event_loop_;
+    MessageCallback callback_;
+
+    Metrics metrics_;
+    uint32_t kernel_drops_seen_;
+    JoinOptions join_;
+    ReceiveOptions options_;
+
+    // 接收缓冲区，按max_datagram_size分配（启用GRO时为64KB）
+    std::vector<char> buffer_;
+
+    // 启用分片重组时使用
+    std::unique_ptr<Reassembler> reassembler_;
+    uint64_t reassembly_dropped_seen_;
+
+    // 启用序号跟踪时使用；事件循环模式下用timerfd按重排窗口放行暂存消息
+    std::unique_ptr<SequenceTracker> sequence_;
+    SequenceTracker::Statistics sequence_seen_;
+    int timer_fd_;
+
+    // 当前处理的报文的接收时间（Unix纪元纳秒），随报文交给回调
+    uint64_t rx_ts_ns_;
+
+    // 交给回调的报文缓冲，跨报文复用容量，稳态下不再分配内存
+    std::string message_buffer_;
+
+    // PacketRing接收方式：环形缓冲区，以及在用户态按源过滤时使用的地址
+    // （组播加入仍由UDP套接字完成，但环形缓冲区读到的是网卡上该组的全部报文）
+    std::unique_ptr<PacketRing> ring_;
+    std::vector<struct sockaddr_storage> ring_sources_;
+    std::vector<struct sockaddr_storage> ring_excluded_;
+
+    // 录制模式下的抓包文件和本接收器的通道号
+    std::shared_ptr<CaptureWriter> capture_;
+    uint16_t capture_channel_;
+
+    // 接收一个报文（启用GRO时可能是内核合并的多个报文）并更新统计，返回值同recvfrom；
+    // segment_size为合并报文中每段的长度，0表示未合并；报文被截断时丢弃并返回0
+    int receiveOne(char* buffer, int size, struct sockaddr_storage& src_addr, int& segment_size);
+
+    // 按GRO分段拆开，经过分片重组后交给handleMessage
+    void deliver(const char* data, int len, int segment_size, const struct sockaddr_storage& src_addr,
+                 const MessageCallback& callback);
+
+    // 创建套接字、绑定端口并加入组播组
+    bool openSocket();
+
+    // 按接收方式创建分片重组器和序号跟踪器
+    void initProcessing();
+
+    // 创建环形缓冲区并绑定到配置的网卡（多个或未指定网卡时绑定全部网卡）
+    bool openRing();
+
+    // 处理环形缓冲区中已交给用户态的报文
+    void drainRing(const MessageCallback& callback);
+
+    // 按sources/exclude_sources检查环形缓冲区读到的报文的发送者
+    bool ringSourceAllowed(const struct sockaddr_storage& src_addr) const;
+
+    // 接收报文的描述符：套接字或环形缓冲区
+    int receiveFd() const;
+
+    // IPv4：绑定端口并在各网卡上加入组
+    bool bindAndJoin4(const struct in_addr& group);
+
+    // IPv6：绑定端口并在各网卡上加入组
+    bool bindAndJoin6(const struct in6_addr& group);
+
+    // 在一个网卡上加入组播组，按源列表加入或屏蔽
+    bool joinGroup(const struct in_addr& group, const struct in_addr& iface);
+
+    // 在一个网卡（索引，0由系统选择）上加入IPv6组播组，按源列表加入或屏蔽
+    bool joinGroup6(const struct in6_addr& group, unsigned int ifindex);
+
     // 接收线程主函数
-    void receiveLoop(ReceiveCallback callback);
+    void receiveLoop(MessageCallback callback);
+
+    // 事件循环回调：读取套接字中已到达的报文
+    void drain();
+
+    // 经过序号跟踪（和重排缓冲）后交给handleMessage
+    void dispatch(const char* data, int len, const struct sockaddr_storage& src_addr,
+                  const MessageCallback& callback);
+
+    // 放行重排窗口已到期的消息
+    void flushSequence(const MessageCallback& callback);
+
+    // 把序号统计的增量加到指标上
+    void syncSequenceMetrics();
+
+    // 按下一个重排期限设置timerfd，0表示停止
+    void armSequenceTimer(uint64_t deadline);
+
+    // 打印并回调一条报文；rx_ts_ns为该报文的接收时间（经过重排缓冲的报文不是当前报文）
+    void handleMessage(const char* data, int len, const struct sockaddr_storage& src_addr, uint64_t rx_ts_ns,
+                       const MessageCallback& callback);
 
     // 解析并打印JSON
     void parseAndPrintJson(const std::string& json_str);
@@ -0,0 +1,68 @@
+#ifndef UDP_SENDER_H
+#define UDP_SENDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct iovec;
+
+/**
+ * @class UdpSender
+ * @brief UDP组播发送器，使用sendmmsg批量发送
+ *
+ * 目标也可以是单播地址（例如报文镜像），此时组播相关的选项不起作用。
+ */
+class UdpSender {
+public:
+    /**
+     * @param multicast_addr 目标组播地址
+     * @param port 目标端口
+     * @param interface 出口网卡地址（IP_MULTICAST_IF，为空则由系统选择）
+     * @param ttl 组播TTL
+     * @param loopback 是否把发出的报文回环给本机（关闭可避免本机转发器再次接收形成环路）
+     */
+    UdpSender(const std::string& multicast_addr, int port, const std::string& interface = "",
+              int ttl = 1, bool loopback = false);
+    ~UdpSender();
+
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    /**
+     * @brief 批量发送，每次系统调用最多发送MAX_BATCH条
+     * @return 成功发送的报文数
+     */
+    size_t sendBatch(const std::vector<std::string>& messages, size_t count);
+
+    /**
+     * @brief 同上，直接发送调用方持有的内容，不复制
+     */
+    size_t sendBatch(const std::string_view* messages, size_t count);
+
+    uint64_t getSentCount() const;
+    uint64_t getFailedCount() const;
+    uint64_t getSyscallCount() const;
+
+    static const size_t MAX_BATCH = 64;
+
+private:
+    std::string multicast_addr_;
+    int port_;
+    std::string interface_;
+    int ttl_;
+    bool loopback_;
+    int socket_fd_;
+
+    std::atomic<uint64_t> sent_count_;
+    std::atomic<uint64_t> failed_count_;
+    std::atomic<uint64_t> syscall_count_;
+
+    // 发送一批已填好的iovec（每条报文一个，最多MAX_BATCH条），返回成功发送的条数
+    size_t sendIovecs(struct iovec* iovecs, size_t count);
+};
+
+#endif // UDP_SENDER_H
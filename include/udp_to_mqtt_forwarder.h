@@ -4,17 +4,58 @@
 #include <string>
 #include <memory>
 #include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "capture.h"
+#include "conflator.h"
+#include "deduplicator.h"
+#include "key_sequencer.h"
+#include "metrics.h"
 #include "mqtt_client.h"
+#include "pipeline.h"
+#include "priority_lanes.h"
+#include "rate_limiter.h"
+#include "shm_ring.h"
+#include "sink.h"
+#include "udp_event_loop.h"
 #include "udp_receiver.h"
+#include "worker_pool.h"
 
 /**
  * @class UdpToMqttForwarder
  * @brief 将UDP组播消息转发到MQTT的转发器类
  * 
  * 此类集成了UdpReceiver和MqttClient，可以接收UDP组播消息并将其发布到MQTT broker
+ *
+ * 可在运行中重载的设置（MQTT客户端、主题、去重、处理流水线、限流）保存在不可变的快照中，
+ * 转发路径每次读取当前快照；reload()构造新快照后原子替换，旧快照在最后一个使用者释放后销毁。
  */
 class UdpToMqttForwarder {
 public:
+    /**
+     * @brief 转发器完整配置
+     */
+    struct Config {
+        std::string name;                   // 桥接名称，用于日志和统计
+        std::string mqtt_client_id;
+        std::string mqtt_broker;
+        int mqtt_port = 1883;
+        std::string mqtt_topic;
+        int mqtt_qos = 1;                   // 0为不等确认的快速路径
+        bool mqtt_retain = false;
+        std::string multicast_addr;
+        int multicast_port = 5555;
+        std::string interface;
+        UdpReceiver::JoinOptions join;      // 多网卡加入和源过滤
+        UdpReceiver::ReceiveOptions receive;    // 报文大小上限、GRO和分片重组
+        Deduplicator::Config dedup;
+        RuntimePipeline::Config pipeline;   // 去重之后执行的过滤/投影/注入阶段
+        Conflator::Config conflation;
+        RateLimiter::Config rate_limit;
+        std::vector<Sink::Config> sinks;    // 接收到的报文同时交给这些输出端（录制文件、UDP镜像）
+    };
+
     /**
      * @brief 构造函数
      * @param mqtt_client_id MQTT客户端ID
@@ -34,6 +75,14 @@ public:
                        const std::string& multicast_addr,
                        int multicast_port,
                        const std::string& interface = "");
+
+    /**
+     * @brief 按完整配置构造，等价于构造后依次调用setDeduplication/setPipeline/setConflation/setRateLimit/setSinks
+     * @param config 转发器配置
+     * @param global_bucket 多个转发器共享的全局限流桶（可选）
+     */
+    explicit UdpToMqttForwarder(const Config& config,
+                                std::shared_ptr<TokenBucket> global_bucket = nullptr);
     
     ~UdpToMqttForwarder();
 
@@ -44,10 +93,25 @@ public:
     bool start();
 
     /**
-     * @brief 停止转发器
+     * @brief 停止转发器，先排空再断开
+     *
+     * 依次停止接收、发布各内部队列（合并表、限流缓冲、优先级通道等）中的消息；自己管理的MQTT连接
+     * 还等待在途的QoS1/2消息被确认（最多到排空截止时间），然后正常断开，并输出排空和放弃的消息数。
      */
     void stop();
 
+    /**
+     * @brief 停止接收新报文，已接收的消息照常处理和发布，之后仍需调用stop()
+     *
+     * 多个桥接共享连接时先停止全部桥接的接收，再逐个排空。
+     */
+    void stopIngest();
+
+    /**
+     * @brief 设置stop()等待在途消息确认的最长时间（从stop()开始计算），默认5000毫秒
+     */
+    void setDrainTimeout(int timeout_ms);
+
     /**
      * @brief 检查转发器是否运行中
      * @return true 运行中，false 未运行
@@ -66,27 +130,331 @@ public:
      */
     uint64_t getFailedMessageCount() const;
 
+    /**
+     * @brief 获取被去重过滤掉的消息数
+     * @return 重复消息计数
+     */
+    uint64_t getDuplicateMessageCount() const;
+
+    /**
+     * @brief 获取按发送者的序号统计（缺口、乱序、重复、重启），未启用序号跟踪时全为0
+     */
+    SequenceTracker::Statistics getSequenceStatistics() const;
+
+    /**
+     * @brief 获取所有线程的流水线暂存arena累计统计（分配次数、向堆申请的块数、重置次数），peak不统计
+     *
+     * 只覆盖流水线阶段的暂存内存：稳态转发时heap_blocks不再增长，说明arena已足够大。
+     * 发布路径（优先级通道、MQTT客户端）的分配不在统计之内。
+     */
+    static Arena::Statistics getArenaStatistics();
+
+    /**
+     * @brief 启用重复消息过滤，需在start()之前调用
+     * @param config 去重配置，enabled为false时关闭去重
+     */
+    void setDeduplication(const Deduplicator::Config& config);
+
+    /**
+     * @brief 获取被处理流水线丢弃的消息数
+     * @return 过滤消息计数
+     */
+    uint64_t getFilteredMessageCount() const;
+
+    /**
+     * @brief 设置去重之后执行的处理流水线，需在start()之前调用
+     * @param config 流水线配置，stages为空时不处理消息
+     */
+    void setPipeline(const RuntimePipeline::Config& config);
+
+    /**
+     * @brief 获取在合并模式下被更新值覆盖而未单独发布的消息数
+     * @return 合并消息计数
+     */
+    uint64_t getConflatedMessageCount() const;
+
+    /**
+     * @brief 启用按键合并（只发布每个键的最新值），需在start()之前调用
+     * @param config 合并配置，enabled为false时关闭合并
+     */
+    void setConflation(const Conflator::Config& config);
+
+    /**
+     * @brief 把接收到的每个报文（去重之前）同时交给这些输出端，需在start()之前调用
+     *
+     * 报文只复制一次到引用计数的缓冲，由各输出端的投递线程共享，不影响MQTT发布路径。
+     * @param sinks 输出端配置，为空时不启用
+     */
+    void setSinks(const std::vector<Sink::Config>& sinks);
+
+    /**
+     * @brief 获取输出端（统计用），未配置输出端时为nullptr
+     */
+    const FanOut* getFanOut() const;
+
+    /**
+     * @brief 获取因超出限速而被丢弃的消息数
+     * @return 限流丢弃计数
+     */
+    uint64_t getRateLimitedMessageCount() const;
+
+    /**
+     * @brief 启用限流，需在start()之前调用
+     * @param config 限流配置，路由桶按本转发器的MQTT主题选择
+     * @param global_bucket 多个转发器共享的全局桶（可选，为空则按config.global单独创建）
+     */
+    void setRateLimit(const RateLimiter::Config& config,
+                      std::shared_ptr<TokenBucket> global_bucket = nullptr);
+
+    /**
+     * @brief 使用外部管理的MQTT连接（如连接池），需在start()之前调用
+     *
+     * 转发器不再负责该连接的建立和断开，重载时也忽略broker/端口/客户端ID的变化。
+     * @param client 已由调用方管理的MQTT客户端
+     */
+    void setMqttClient(std::shared_ptr<MqttClient> client);
+
+    /**
+     * @brief 快速启动：start()不等待MQTT连接建立，立即加入组播组开始接收，需在start()之前调用
+     *
+     * 收到CONNACK之前要发布的消息按顺序缓冲（最多buffer_size条，超出的计入失败），
+     * 连接建立后在网络线程中立即按顺序发布，之后的消息直接发布。
+     * @param buffer_size 连接建立前最多缓冲的消息数，0为关闭快速启动（等待连接建立后再接收）
+     */
+    void setFastStart(size_t buffer_size);
+
+    /**
+     * @brief 在共享的事件循环中接收UDP报文，不再单独创建接收线程，需在start()之前调用
+     * @param loop 已启动的事件循环
+     */
+    void setEventLoop(std::shared_ptr<UdpEventLoop> loop);
+
+    /**
+     * @brief 把收到的报文录制到抓包文件（通道名为桥接名称），需在start()之前调用
+     * @param capture 已打开的抓包文件，可被多个转发器共享
+     */
+    void setCapture(std::shared_ptr<CaptureWriter> capture);
+
+    /**
+     * @brief 经共享的优先级通道发布消息（按本桥接的主题或消息字段分类），需在start()之前调用
+     * @param lanes 已启动的优先级通道，可被多个转发器共享
+     */
+    void setPriorityLanes(std::shared_ptr<PriorityLanes> lanes);
+
+    /**
+     * @brief 把发布到MQTT的消息同时写入本机共享内存环，供同一主机上的消费者读取，需在start()之前调用
+     * @param ring 已打开的共享内存环，可被多个转发器共享
+     */
+    void setLocalOutput(std::shared_ptr<ShmRing> ring);
+
+    /**
+     * @brief 在共享的工作线程池中执行处理流水线，按保序键恢复顺序后发布，需在start()之前调用
+     * @param workers 已启动的工作线程池，可被多个转发器共享
+     */
+    void setWorkerPool(std::shared_ptr<WorkerPool> workers);
+
+    /**
+     * @brief 回放模式：start()不创建UDP套接字，报文由replay()送入，需在start()之前调用
+     */
+    void setReplayMode(bool replay);
+
+    /**
+     * @brief 回放模式下送入一条录制的报文，经过与实时接收相同的处理后转发
+     *
+     * 只应在一个线程中调用，且不能与reload()并发。
+     */
+    void replay(const CaptureReader::Record& record);
+
+    /**
+     * @brief 获取桥接名称
+     */
+    std::string getName() const;
+
+    /**
+     * @brief 运行中应用新配置，不中断转发
+     *
+     * 主题、QoS、去重、处理流水线和限流设置通过快照替换立即生效；只有组播地址/端口/网卡/加入方式/接收方式变化时才重建UDP接收器，
+     * 只有broker/端口/客户端ID变化时才建立新的MQTT连接（新连接成功后再替换旧连接）。
+     * 合并设置不支持热重载，变化时给出提示并保持原设置。
+     * @param config 新配置
+     * @param global_bucket 共享的全局限流桶（可选）
+     * @return true 已应用，false 新MQTT连接失败，保持原配置
+     */
+    bool reload(const Config& config, std::shared_ptr<TokenBucket> global_bucket = nullptr);
+
+    /**
+     * @brief 获取当前生效的配置
+     */
+    Config getConfig() const;
+
     /**
      * @brief 重置统计计数
      */
     void resetStatistics();
 
 private:
-    std::unique_ptr<MqttClient> mqtt_client_;
+    /**
+     * @brief 可重载设置的不可变快照
+     */
+    struct Snapshot {
+        Config config;
+        std::shared_ptr<MqttClient> mqtt_client;
+        std::shared_ptr<Deduplicator> deduplicator;
+        std::shared_ptr<const RuntimePipeline> pipeline;
+        std::shared_ptr<RateLimiter> rate_limiter;
+        bool owns_client = true;        // false表示连接由外部（连接池）管理
+    };
+
+    // 只能通过std::atomic_load/std::atomic_store访问
+    std::shared_ptr<const Snapshot> snapshot_;
+
+    // 串行化start/stop/reload/set*等控制操作
+    std::mutex control_mutex_;
+
     std::unique_ptr<UdpReceiver> udp_receiver_;
-    
-    std::string mqtt_topic_;
-    int mqtt_qos_;
+    std::shared_ptr<UdpEventLoop> event_loop_;
+    std::shared_ptr<CaptureWriter> capture_;
+    uint16_t capture_channel_;
+    std::shared_ptr<PriorityLanes> lanes_;
+    int lane_source_;           // 在优先级通道中注册的来源编号，未注册时为-1
+    std::shared_ptr<ShmRing> local_output_;
+    std::shared_ptr<WorkerPool> workers_;
+    std::unique_ptr<KeySequencer> sequencer_;
+
+    /**
+     * @brief 交给工作线程处理的一条消息，放行后回到空闲列表，复用暂存消息的容量
+     */
+    struct WorkItem {
+        std::shared_ptr<const Snapshot> snapshot;
+        PipelineMessage staged;
+        KeySequencer::Ticket ticket;
+        bool keep = false;
+    };
+
+    // 空闲的WorkItem；使用中的由放行动作持有，stop()等待全部放行后才会析构
+    std::mutex work_items_mutex_;
+    std::vector<std::unique_ptr<WorkItem>> free_work_items_;
+    bool replay_mode_;
+    std::unique_ptr<Conflator> conflator_;
+    std::unique_ptr<FanOut> fan_out_;
     
     std::atomic<bool> running_;
-    std::atomic<uint64_t> forwarded_count_;
-    std::atomic<uint64_t> failed_count_;
+
+    // 快速启动：CONNACK之前的消息缓冲在startup_buffer_中，由连接回调按顺序发布
+    size_t startup_capacity_;                   // 0为关闭快速启动
+    std::atomic<bool> awaiting_connack_;
+    std::mutex startup_mutex_;                  // 保护startup_buffer_和flushing_startup_，发布时不持有
+    bool flushing_startup_;                     // 正在发布缓冲的消息，期间新消息继续追加到缓冲
+    std::deque<std::string> startup_buffer_;
+    std::shared_ptr<MqttClient> listener_client_;   // 注册了连接回调的客户端
+    int connect_listener_;                      // 连接回调编号，未注册时为-1
+
+    int drain_timeout_ms_;
+
+    // 统计计数器在全局指标注册表中注册，按桥接名称加标签
+    std::shared_ptr<Counter> forwarded_count_;
+    std::shared_ptr<Counter> failed_count_;
+    std::shared_ptr<Counter> duplicate_count_;
+    std::shared_ptr<Counter> filtered_count_;
+    std::shared_ptr<Counter> rate_limited_count_;
+    std::shared_ptr<Gauge> queue_depth_;
+    std::shared_ptr<Gauge> startup_depth_;
+    UdpReceiver::Metrics receiver_metrics_;
+
+    // 当前使用的共享全局限流桶
+    std::shared_ptr<TokenBucket> global_bucket_;
+
+    // 日志前缀，多桥接时带上桥接名称
+    std::string log_tag_;
+
+    /**
+     * @brief 丢弃日志限速：第一次丢弃时输出，之后每秒最多一行，汇总期间的丢弃数
+     */
+    struct DropLog {
+        std::atomic<uint64_t> next_ns{0};   // 下一次允许输出的时间（steady_clock纳秒）
+        std::atomic<uint64_t> pending{0};   // 上次输出以来的丢弃数
+    };
+    DropLog rate_limit_drops_;
+    DropLog lane_drops_;
+    DropLog worker_drops_;
+    DropLog startup_drops_;
+
+    /**
+     * @brief 记录一次丢弃，按限速输出汇总；reason为丢弃原因，total_name和total为对应的累计计数
+     */
+    void logDrop(DropLog& log, const char* reason, const char* total_name, uint64_t total);
 
     /**
      * @brief UDP接收回调函数
-     * 当收到UDP消息时调用此函数
+     * 当收到UDP消息时调用此函数，info为接收时间和发送者地址
+     */
+    void onUdpMessageReceived(const std::string& message, const UdpReceiver::MessageInfo& info);
+
+    /**
+     * @brief 把流水线处理交给工作线程池，处理完成后按保序键的接收顺序转发
+     */
+    void submitToWorkers(const std::shared_ptr<const Snapshot>& snapshot, const std::string& message,
+                         const UdpReceiver::MessageInfo& info);
+
+    /**
+     * @brief 从空闲列表取出一个WorkItem，没有时新建
+     */
+    WorkItem* acquireWorkItem();
+
+    /**
+     * @brief 放行后把WorkItem放回空闲列表
+     */
+    void recycleWorkItem(WorkItem* item);
+
+    /**
+     * @brief 经过合并（启用时）和限流后发布一条消息
+     */
+    void forwardMessage(const Snapshot& snapshot, const std::string& message);
+
+    /**
+     * @brief 经过限流后发布一条消息
+     */
+    void publishMessage(const Snapshot& snapshot, const std::string& message);
+
+    /**
+     * @brief 发布一条消息到MQTT，启用优先级通道时先放入通道排队
+     */
+    void publishToMqtt(const Snapshot& snapshot, const std::string& message);
+
+    /**
+     * @brief 发布一条消息到MQTT，快速启动时连接建立前先缓冲
+     */
+    void sendToMqtt(const Snapshot& snapshot, const std::string& message);
+
+    /**
+     * @brief 直接发布一条消息到MQTT并更新统计
+     */
+    void publishNow(const Snapshot& snapshot, const std::string& message);
+
+    /**
+     * @brief 连接建立后按顺序发布缓冲的消息，结束缓冲（可重复调用）
+     */
+    void flushStartupBuffer();
+
+    /**
+     * @brief 移除连接回调；仍未连接时丢弃缓冲的消息并计入失败
+     */
+    void endStartupBuffering();
+
+    /**
+     * @brief 启动限流器（Spool策略的缓冲线程）
+     */
+    void startRateLimiter(RateLimiter& rate_limiter);
+
+    /**
+     * @brief 启动UDP接收器
+     */
+    bool startReceiver(UdpReceiver& receiver);
+
+    /**
+     * @brief 按桥接名称创建（或取得已有的）统计指标
      */
-    void onUdpMessageReceived(const std::string& message);
+    void initMetrics(const std::string& name);
 };
 
 #endif // UDP_TO_MQTT_FORWARDER_H
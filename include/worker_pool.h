@@ -0,0 +1,103 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "metrics.h"
+
+/**
+ * @class WorkerPool
+ * @brief 接收与发布之间执行处理流水线的工作线程池（work-stealing）
+ *
+ * 每个工作线程有自己的任务队列：从队首取自己的任务，自己的队列空时从其他线程的队尾偷取。
+ * 接收线程提交的任务轮流分配到各队列，工作线程中提交的任务放入自己的队列。
+ * 提交只取目标队列的锁，有工作线程在等待时才取全局的idle_mutex_唤醒它，多个接收线程提交时互不串行。
+ * 任务在哪个线程、以什么顺序完成都不确定，需要保持顺序的调用方用KeySequencer按键恢复顺序。
+ */
+class WorkerPool {
+public:
+    // 任务类型
+    using Task = std::function<void()>;
+
+    struct Config {
+        bool enabled = false;
+        size_t threads = 0;             // 工作线程数，0为CPU核数
+        std::string key_field;          // 保序键字段路径（点号分隔），同一键的消息按接收顺序发布；为空时每个桥接整体保序
+        size_t queue_size = 10000;      // 每个桥接最多未发布的消息数，超出时丢弃新消息
+
+        bool operator==(const Config& other) const;
+        bool operator!=(const Config& other) const { return !(*this == other); }
+    };
+
+    explicit WorkerPool(const Config& config);
+    ~WorkerPool();
+
+    /**
+     * @brief 启动工作线程
+     */
+    bool start();
+
+    /**
+     * @brief 停止工作线程，停止前执行完队列中剩余的任务
+     */
+    void stop();
+
+    bool isRunning() const;
+
+    /**
+     * @brief 提交任务；已停止时在调用线程中直接执行
+     */
+    void submit(Task task);
+
+    const Config& getConfig() const;
+    size_t threadCount() const;
+    uint64_t getExecutedCount() const;
+
+    /**
+     * @brief 从其他线程队列偷取的任务数
+     */
+    uint64_t getStolenCount() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    Config config_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> next_worker_;
+
+    // 各队列中的任务总数。等待的工作线程先增加sleepers_再检查pending_，
+    // 提交方先增加pending_再检查sleepers_，两者至少有一方看到对方，不会丢失唤醒
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    std::atomic<size_t> pending_;
+    std::atomic<size_t> sleepers_;
+
+    std::atomic<bool> running_;
+    std::atomic<size_t> submitting_;    // 已通过运行状态检查、尚未放入队列的提交数
+    bool draining_;                     // 停止中：不再有新任务进入队列，队列空后退出（idle_mutex_保护）
+
+    std::shared_ptr<Counter> executed_count_;
+    std::shared_ptr<Counter> stolen_count_;
+
+    // 从自己的队首取任务，没有时从其他队列的队尾偷取
+    bool take(size_t index, Task& task);
+
+    // 有工作线程在等待时唤醒一个
+    void wake();
+
+    void workerLoop(size_t index);
+};
+
+#endif // WORKER_POOL_H
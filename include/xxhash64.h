@@ -0,0 +1,16 @@
+#ifndef XXHASH64_H
+#define XXHASH64_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 计算XXH64哈希值（与官方xxHash的XXH64算法输出一致）
+ * @param data 输入数据
+ * @param len 数据长度
+ * @param seed 种子（默认0）
+ * @return 64位哈希值
+ */
+uint64_t xxhash64(const void* data, size_t len, uint64_t seed = 0);
+
+#endif // XXHASH64_H
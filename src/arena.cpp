@@ -0,0 +1,60 @@
+#include "arena.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+Arena::Arena(size_t block_size)
+    : block_size_(block_size > 0 ? block_size : 4096), current_(0), offset_(0), used_(0) {
+}
+
+Arena::~Arena() {
+    for (auto& block : blocks_) {
+        std::free(block.data);
+    }
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    // 先在当前块内对齐分配，放不下时依次尝试之后已申请的块
+    while (current_ < blocks_.size()) {
+        Block& block = blocks_[current_];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        size_t aligned = ((base + offset_ + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+        if (aligned + size <= block.size) {
+            used_ += aligned + size - offset_;
+            offset_ = aligned + size;
+            stats_.allocations++;
+            stats_.bytes += size;
+            stats_.peak = std::max(stats_.peak, used_);
+            return block.data + aligned;
+        }
+        current_++;
+        offset_ = 0;
+    }
+
+    // 超过块大小的请求单独申请一块，重置后同样保留复用
+    size_t capacity = std::max(block_size_, size + alignment);
+    char* data = static_cast<char*>(std::malloc(capacity));
+    if (!data) {
+        throw std::bad_alloc();
+    }
+    blocks_.push_back(Block{data, capacity});
+    stats_.heap_blocks++;
+    current_ = blocks_.size() - 1;
+    offset_ = 0;
+    return allocate(size, alignment);
+}
+
+void Arena::reset() {
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+    stats_.resets++;
+}
+
+size_t Arena::used() const {
+    return used_;
+}
+
+const Arena::Statistics& Arena::statistics() const {
+    return stats_;
+}
@@ -0,0 +1,434 @@
+#include "bridge_manager.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <thread>
+
+BridgeManager::BridgeManager(const Config& config)
+    : config_(config), running_(false), replay_mode_(false), ready_(false) {
+}
+
+BridgeManager::~BridgeManager() {
+    stop();
+}
+
+bool BridgeManager::start() {
+    if (running_) {
+        std::cerr << "Bridge manager is already running" << std::endl;
+        return false;
+    }
+
+    std::cout << "Starting " << config_.bridges.size() << " bridge(s)..." << std::endl;
+
+    // 反应器模式下每个反应器至少有一个MQTT连接
+    size_t loop_count = config_.reactors > 0 ? config_.reactors : 1;
+    for (size_t i = 0; i < loop_count; ++i) {
+        auto loop = std::make_shared<UdpEventLoop>(config_.spin_us, config_.reactors > 0 ? static_cast<int>(i) : -1);
+        if (!loop->start()) {
+            stopEventLoops();
+            return false;
+        }
+        event_loops_.push_back(loop);
+    }
+
+    pool_ = std::make_unique<MqttConnectionPool>(config_.mqtt_client_id, config_.mqtt_broker, config_.mqtt_port,
+                                                 std::max(config_.pool_size, config_.reactors));
+    if (config_.reactors > 0) {
+        pool_->setEventLoops(event_loops_);
+    }
+    // 快速启动时不等待CONNACK，桥接先开始接收
+    bool fast_start = config_.startup_buffer > 0;
+    if (!pool_->connect(!fast_start)) {
+        std::cerr << "Failed to connect to MQTT broker" << std::endl;
+        pool_.reset();
+        stopEventLoops();
+        return false;
+    }
+
+    global_bucket_ = makeGlobalBucket(config_);
+    if (config_.workers.enabled) {
+        workers_ = std::make_shared<WorkerPool>(config_.workers);
+        workers_->start();
+    }
+    if (config_.lanes.enabled) {
+        lanes_ = std::make_shared<PriorityLanes>(config_.lanes);
+        lanes_->start();
+    }
+    running_ = true;
+
+    if (config_.local_output.enabled) {
+        local_output_ = std::make_shared<ShmRing>(config_.local_output);
+        if (!local_output_->open()) {
+            stop();
+            return false;
+        }
+    }
+
+    for (const auto& bridge_config : config_.bridges) {
+        auto bridge = startBridge(bridge_config);
+        if (!bridge) {
+            std::cerr << "Failed to start bridge " << bridge_config.name << std::endl;
+            stop();
+            return false;
+        }
+        bridges_.push_back(std::move(bridge));
+    }
+
+    std::cout << "All bridges started (" << bridges_.size() << " bridge(s), "
+              << pool_->size() << " MQTT connection(s)";
+    if (config_.reactors > 0) {
+        std::cout << ", " << config_.reactors << " reactor(s)";
+    }
+    std::cout << ")" << std::endl;
+
+    // 之后收到的CONNACK由连接回调检查，已经建立的在这里检查
+    ready_ = false;
+    pool_->setConnectCallback([this]() { this->checkReady(); });
+    checkReady();
+    return true;
+}
+
+void BridgeManager::stop() {
+    if (!running_) {
+        return;
+    }
+
+    // 返回后连接回调不再执行
+    pool_->setConnectCallback(nullptr);
+    ready_ = false;
+
+    // 排空：先停止全部桥接的接收，之后只处理已接收的消息；截止时间从这里开始计算
+    auto drain_start = std::chrono::steady_clock::now();
+    for (auto& bridge : bridges_) {
+        bridge->stopIngest();
+    }
+    uint64_t forwarded_before = 0;
+    uint64_t failed_before = 0;
+    for (const auto& bridge : bridges_) {
+        forwarded_before += bridge->getForwardedMessageCount();
+        failed_before += bridge->getFailedMessageCount();
+    }
+    int64_t inflight_before = pool_->getInflightCount();
+    int64_t abandoned_before = pool_->getAbandonedCount();
+
+    // 先按优先级发布通道中剩余的消息，之后各桥接停止时送出的消息直接发布
+    if (lanes_) {
+        lanes_->stop();
+    }
+
+    // 再停止各桥接（合并器、限流缓冲），最后断开共享连接
+    uint64_t forwarded_after = 0;
+    uint64_t failed_after = 0;
+    for (auto& bridge : bridges_) {
+        bridge->stop();
+        forwarded_after += bridge->getForwardedMessageCount();
+        failed_after += bridge->getFailedMessageCount();
+    }
+    bridges_.clear();
+    lanes_.reset();
+
+    // 标记为已关闭，读取端据此得知写入端已停止
+    if (local_output_) {
+        local_output_->close();
+        local_output_.reset();
+    }
+
+    // 各桥接停止时已等待自己的消息处理完成
+    if (workers_) {
+        workers_->stop();
+        workers_.reset();
+    }
+
+    // 等待在途消息确认后正常断开
+    int64_t unacknowledged = pool_->drain(drain_start + std::chrono::milliseconds(config_.drain_timeout_ms));
+    // 排空期间被放弃的消息计入未确认，而不是送达
+    unacknowledged += pool_->getAbandonedCount() - abandoned_before;
+    int64_t published = static_cast<int64_t>(forwarded_after - forwarded_before);
+    uint64_t failed = failed_after - failed_before;
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - drain_start).count();
+    std::cout << "[Drain] " << std::max<int64_t>(inflight_before + published - unacknowledged, 0)
+              << " message(s) drained, " << unacknowledged + static_cast<int64_t>(failed) << " abandoned ("
+              << unacknowledged << " unacknowledged, " << failed << " failed) in " << elapsed << " ms" << std::endl;
+
+    pool_->disconnect();
+    pool_.reset();
+    stopEventLoops();
+    global_bucket_.reset();
+
+    running_ = false;
+}
+
+bool BridgeManager::isRunning() const {
+    for (const auto& bridge : bridges_) {
+        if (bridge->isRunning()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BridgeManager::reload(const Config& config) {
+    if (!running_) {
+        config_ = config;
+        return true;
+    }
+
+    // 连接设置变化：重建连接池并重启全部桥接
+    if (config.mqtt_client_id != config_.mqtt_client_id ||
+        config.mqtt_broker != config_.mqtt_broker ||
+        config.mqtt_port != config_.mqtt_port ||
+        config.pool_size != config_.pool_size ||
+        config.reactors != config_.reactors) {
+        std::cout << "[Reload] MQTT connection settings changed, restarting all bridges" << std::endl;
+        stop();
+        config_ = config;
+        return start();
+    }
+
+    // 工作线程池、通道或本机输出设置变化：各桥接都持有它们，一起重启
+    if (config.workers != config_.workers || config.lanes != config_.lanes ||
+        config.local_output != config_.local_output) {
+        std::cout << "[Reload] Worker pool, priority lane or local output settings changed, restarting all bridges"
+                  << std::endl;
+        stop();
+        config_ = config;
+        return start();
+    }
+
+    // 全局限速变化时换新桶，各桥接的限流器随之重建
+    if (globalLimit(config) != globalLimit(config_)) {
+        global_bucket_ = makeGlobalBucket(config);
+    }
+
+    bool ok = true;
+    std::set<std::string> names;
+    for (const auto& bridge_config : config.bridges) {
+        names.insert(bridge_config.name);
+    }
+
+    // 停止配置中已删除的桥接
+    for (auto it = bridges_.begin(); it != bridges_.end();) {
+        if (names.count((*it)->getName()) == 0) {
+            std::cout << "[Reload] Removing bridge " << (*it)->getName() << std::endl;
+            (*it)->stop();
+            it = bridges_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const auto& bridge_config : config.bridges) {
+        UdpToMqttForwarder* existing = nullptr;
+        for (auto& bridge : bridges_) {
+            if (bridge->getName() == bridge_config.name) {
+                existing = bridge.get();
+                break;
+            }
+        }
+
+        if (existing) {
+            ok = existing->reload(bridge_config, global_bucket_) && ok;
+            continue;
+        }
+
+        std::cout << "[Reload] Adding bridge " << bridge_config.name << std::endl;
+        auto bridge = startBridge(bridge_config);
+        if (!bridge) {
+            std::cerr << "[Reload] Failed to start bridge " << bridge_config.name << std::endl;
+            ok = false;
+            continue;
+        }
+        bridges_.push_back(std::move(bridge));
+    }
+
+    config_ = config;
+    return ok;
+}
+
+void BridgeManager::setCapture(std::shared_ptr<CaptureWriter> capture) {
+    capture_ = capture;
+}
+
+void BridgeManager::setReplayMode(bool replay) {
+    replay_mode_ = replay;
+}
+
+uint64_t BridgeManager::replay(CaptureReader& reader, double speed, const std::atomic<bool>& keep_running) {
+    uint64_t replayed = 0;
+    uint64_t skipped = 0;
+    uint64_t first_ts_ns = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    // 通道名到桥接的查找结果按上一条记录缓存，同一通道连续出现时不再查找
+    std::string_view last_channel;
+    UdpToMqttForwarder* target = nullptr;
+
+    CaptureReader::Record record;
+    while (keep_running.load() && reader.next(record)) {
+        if (record.channel.data() != last_channel.data()) {
+            last_channel = record.channel;
+            target = nullptr;
+            for (auto& bridge : bridges_) {
+                std::string name = bridge->getName();
+                if (record.channel == (name.empty() ? "default" : name)) {
+                    target = bridge.get();
+                    break;
+                }
+            }
+        }
+        if (!target) {
+            skipped++;
+            continue;
+        }
+
+        // 按录制时的间隔（除以速度倍数）送入
+        if (speed > 0) {
+            if (first_ts_ns == 0) {
+                first_ts_ns = record.rx_ts_ns;
+            }
+            if (record.rx_ts_ns > first_ts_ns) {
+                auto offset = std::chrono::nanoseconds(
+                    static_cast<int64_t>(static_cast<double>(record.rx_ts_ns - first_ts_ns) / speed));
+                std::this_thread::sleep_until(start + offset);
+            }
+        }
+
+        target->replay(record);
+        replayed++;
+    }
+
+    if (reader.isCorrupt()) {
+        std::cerr << "[Replay] Capture file is truncated or corrupt, stopped early" << std::endl;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[Replay] " << replayed << " datagrams in " << elapsed << " s ("
+              << (elapsed > 0 ? static_cast<uint64_t>(replayed / elapsed) : replayed) << " datagrams/s)";
+    if (skipped > 0) {
+        std::cout << ", " << skipped << " skipped (no matching bridge)";
+    }
+    std::cout << std::endl;
+    return replayed;
+}
+
+void BridgeManager::logStatistics() const {
+    uint64_t forwarded = 0;
+    uint64_t failed = 0;
+    for (const auto& bridge : bridges_) {
+        std::string name = bridge->getName();
+        std::cout << "[Stats] " << (name.empty() ? "default" : name)
+                  << ": Forwarded: " << bridge->getForwardedMessageCount()
+                  << ", Failed: " << bridge->getFailedMessageCount()
+                  << ", Duplicates: " << bridge->getDuplicateMessageCount()
+                  << ", Filtered: " << bridge->getFilteredMessageCount()
+                  << ", Conflated: " << bridge->getConflatedMessageCount()
+                  << ", Rate limited: " << bridge->getRateLimitedMessageCount() << std::endl;
+        if (bridge->getConfig().receive.sequence.enabled) {
+            SequenceTracker::Statistics seq = bridge->getSequenceStatistics();
+            std::cout << "[Stats] " << (name.empty() ? "default" : name)
+                      << ": Sequence: Missing: " << seq.missing << ", Reordered: " << seq.reordered
+                      << ", Duplicates: " << seq.duplicates << ", Resets: " << seq.resets << std::endl;
+        }
+        if (const FanOut* fan_out = bridge->getFanOut()) {
+            for (size_t i = 0; i < fan_out->sinkCount(); ++i) {
+                const Sink& sink = fan_out->sink(i);
+                std::cout << "[Stats] " << (name.empty() ? "default" : name) << ": Sink " << sink.name()
+                          << ": Delivered: " << sink.getDeliveredCount() << ", Dropped: " << sink.getDroppedCount()
+                          << ", Failed: " << sink.getFailedCount() << ", Depth: " << sink.getDepth() << std::endl;
+            }
+            std::cout << "[Stats] " << (name.empty() ? "default" : name)
+                      << ": Packet buffers: Allocated: " << fan_out->pool().getAllocatedCount()
+                      << ", Reused: " << fan_out->pool().getReusedCount() << std::endl;
+        }
+        forwarded += bridge->getForwardedMessageCount();
+        failed += bridge->getFailedMessageCount();
+    }
+    if (bridges_.size() > 1) {
+        std::cout << "[Stats] total: Forwarded: " << forwarded << ", Failed: " << failed << std::endl;
+    }
+    Arena::Statistics arena = UdpToMqttForwarder::getArenaStatistics();
+    if (arena.resets > 0) {
+        std::cout << "[Stats] arena: Allocations: " << arena.allocations << ", Heap blocks: " << arena.heap_blocks
+                  << ", Resets: " << arena.resets << std::endl;
+    }
+    if (workers_) {
+        std::cout << "[Stats] workers: Executed: " << workers_->getExecutedCount()
+                  << ", Stolen: " << workers_->getStolenCount() << std::endl;
+    }
+    if (lanes_) {
+        for (size_t i = 0; i < lanes_->laneCount(); ++i) {
+            std::cout << "[Stats] lane " << lanes_->laneName(i) << ": Depth: " << lanes_->getDepth(i)
+                      << ", Dropped: " << lanes_->getDroppedCount(i)
+                      << ", Avg delay: " << lanes_->getAverageDelay(i) / 1000.0 << " us" << std::endl;
+        }
+    }
+    if (local_output_) {
+        std::cout << "[Stats] local output: Written: " << local_output_->getWrittenCount()
+                  << ", Dropped: " << local_output_->getDroppedCount() << std::endl;
+    }
+}
+
+void BridgeManager::setReadyCallback(std::function<void()> callback) {
+    ready_callback_ = callback;
+}
+
+bool BridgeManager::isReady() const {
+    return ready_;
+}
+
+void BridgeManager::checkReady() {
+    if (!pool_->isConnected() || ready_.exchange(true)) {
+        return;
+    }
+
+    std::cout << "All bridges ready (" << pool_->size() << " MQTT connection(s) up)" << std::endl;
+    if (ready_callback_) {
+        ready_callback_();
+    }
+}
+
+size_t BridgeManager::bridgeCount() const {
+    return bridges_.size();
+}
+
+const BridgeManager::Config& BridgeManager::getConfig() const {
+    return config_;
+}
+
+std::unique_ptr<UdpToMqttForwarder> BridgeManager::startBridge(const UdpToMqttForwarder::Config& config) {
+    auto bridge = std::make_unique<UdpToMqttForwarder>(config, global_bucket_);
+    std::shared_ptr<MqttClient> client = pool_->acquire();
+    bridge->setMqttClient(client);
+    bridge->setEventLoop(client->getEventLoop() ? client->getEventLoop() : event_loops_.front());
+    bridge->setCapture(capture_);
+    bridge->setWorkerPool(workers_);
+    bridge->setPriorityLanes(lanes_);
+    bridge->setLocalOutput(local_output_);
+    bridge->setReplayMode(replay_mode_);
+    bridge->setFastStart(config_.startup_buffer);
+    bridge->setDrainTimeout(config_.drain_timeout_ms);
+    if (!bridge->start()) {
+        return nullptr;
+    }
+    return bridge;
+}
+
+void BridgeManager::stopEventLoops() {
+    for (auto& loop : event_loops_) {
+        loop->stop();
+    }
+    event_loops_.clear();
+}
+
+RateLimiter::Limit BridgeManager::globalLimit(const Config& config) {
+    if (config.bridges.empty() || !config.bridges.front().rate_limit.enabled) {
+        return RateLimiter::Limit();
+    }
+    return config.bridges.front().rate_limit.global;
+}
+
+std::shared_ptr<TokenBucket> BridgeManager::makeGlobalBucket(const Config& config) {
+    return RateLimiter::makeBucket(globalLimit(config));
+}
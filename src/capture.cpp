@@ -0,0 +1,317 @@
+#include "capture.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[8] = {'U', 'D', 'P', 'C', 'A', 'P', '0', '1'};
+static const uint32_t VERSION = 1;
+static const size_t FILE_HEADER_SIZE = 16;
+static const size_t RECORD_HEADER_SIZE = 40;
+
+static const uint8_t TYPE_DATAGRAM = 0;
+static const uint8_t TYPE_CHANNEL = 1;
+
+// 记录头各字段的偏移
+static const size_t OFF_LENGTH = 0;
+static const size_t OFF_TYPE = 4;
+static const size_t OFF_CHANNEL = 6;
+static const size_t OFF_FAMILY = 8;
+static const size_t OFF_PORT = 10;
+static const size_t OFF_ADDR = 12;
+static const size_t OFF_TIMESTAMP = 28;
+
+static size_t padded(size_t len) {
+    return (len + 7) & ~static_cast<size_t>(7);
+}
+
+CaptureWriter::CaptureWriter(const std::string& path)
+    : path_(path), fd_(-1), map_(nullptr), mapped_(0), used_(0), failed_(false), records_(0) {
+}
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Failed to create capture file " << path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    used_ = 0;
+    records_ = 0;
+    failed_ = false;
+    channels_.clear();
+    if (!reserve(FILE_HEADER_SIZE)) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    uint32_t header_size = RECORD_HEADER_SIZE;
+    memcpy(map_, MAGIC, sizeof(MAGIC));
+    memcpy(map_ + 8, &VERSION, sizeof(VERSION));
+    memcpy(map_ + 12, &header_size, sizeof(header_size));
+    used_ = FILE_HEADER_SIZE;
+
+    std::cout << "Recording received datagrams to " << path_ << std::endl;
+    return true;
+}
+
+void CaptureWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (fd_ < 0) {
+        return;
+    }
+
+    if (map_) {
+        munmap(map_, mapped_);
+        map_ = nullptr;
+        mapped_ = 0;
+    }
+    if (ftruncate(fd_, static_cast<off_t>(used_)) < 0) {
+        std::cerr << "Failed to truncate capture file " << path_ << ": " << strerror(errno) << std::endl;
+    }
+    ::close(fd_);
+    fd_ = -1;
+
+    std::cout << "Capture " << path_ << " closed (" << records_ << " datagrams, " << used_ << " bytes)" << std::endl;
+}
+
+uint16_t CaptureWriter::channel(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = channels_.find(name);
+    if (it != channels_.end()) {
+        return it->second;
+    }
+
+    uint16_t id = static_cast<uint16_t>(channels_.size());
+    channels_.emplace(name, id);
+    write(TYPE_CHANNEL, id, nullptr, 0, name.data(), name.size());
+    return id;
+}
+
+void CaptureWriter::append(uint16_t channel, const struct sockaddr_storage& source, uint64_t rx_ts_ns,
+                           const char* data, size_t len) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write(TYPE_DATAGRAM, channel, &source, rx_ts_ns, data, len);
+    if (!failed_) {
+        records_++;
+    }
+}
+
+uint64_t CaptureWriter::getRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+}
+
+bool CaptureWriter::reserve(size_t bytes) {
+    if (used_ + bytes <= mapped_) {
+        return true;
+    }
+
+    size_t size = mapped_;
+    while (size < used_ + bytes) {
+        size += CHUNK_SIZE;
+    }
+
+    if (ftruncate(fd_, static_cast<off_t>(size)) < 0) {
+        std::cerr << "Failed to extend capture file " << path_ << ", recording stopped: "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (map_) {
+        munmap(map_, mapped_);
+        map_ = nullptr;
+        mapped_ = 0;
+    }
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "Failed to map capture file " << path_ << ", recording stopped: "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+    map_ = static_cast<char*>(map);
+    mapped_ = size;
+    return true;
+}
+
+void CaptureWriter::write(uint8_t type, uint16_t channel, const struct sockaddr_storage* source,
+                          uint64_t rx_ts_ns, const char* data, size_t len) {
+    if (fd_ < 0 || failed_) {
+        return;
+    }
+
+    size_t total = RECORD_HEADER_SIZE + padded(len);
+    if (!reserve(total)) {
+        failed_ = true;
+        return;
+    }
+
+    char* record = map_ + used_;
+    memset(record, 0, RECORD_HEADER_SIZE);
+    uint32_t length = static_cast<uint32_t>(len);
+    memcpy(record + OFF_LENGTH, &length, sizeof(length));
+    record[OFF_TYPE] = static_cast<char>(type);
+    memcpy(record + OFF_CHANNEL, &channel, sizeof(channel));
+
+    if (source) {
+        uint16_t family = source->ss_family;
+        memcpy(record + OFF_FAMILY, &family, sizeof(family));
+        if (source->ss_family == AF_INET6) {
+            const auto& sin6 = reinterpret_cast<const struct sockaddr_in6&>(*source);
+            memcpy(record + OFF_PORT, &sin6.sin6_port, sizeof(sin6.sin6_port));
+            memcpy(record + OFF_ADDR, &sin6.sin6_addr, sizeof(sin6.sin6_addr));
+        } else if (source->ss_family == AF_INET) {
+            const auto& sin = reinterpret_cast<const struct sockaddr_in&>(*source);
+            memcpy(record + OFF_PORT, &sin.sin_port, sizeof(sin.sin_port));
+            memcpy(record + OFF_ADDR, &sin.sin_addr, sizeof(sin.sin_addr));
+        }
+    }
+    memcpy(record + OFF_TIMESTAMP, &rx_ts_ns, sizeof(rx_ts_ns));
+
+    memcpy(record + RECORD_HEADER_SIZE, data, len);
+    memset(record + RECORD_HEADER_SIZE + len, 0, padded(len) - len);
+    used_ += total;
+}
+
+CaptureReader::CaptureReader(const std::string& path)
+    : path_(path), fd_(-1), map_(nullptr), size_(0), offset_(0), corrupt_(false) {
+}
+
+CaptureReader::~CaptureReader() {
+    close();
+}
+
+bool CaptureReader::open() {
+    fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open capture file " << path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0 || static_cast<size_t>(st.st_size) < FILE_HEADER_SIZE) {
+        std::cerr << "Capture file " << path_ << " is empty or unreadable" << std::endl;
+        close();
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "Failed to map capture file " << path_ << ": " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    map_ = static_cast<const char*>(map);
+
+    // 回放按顺序读取
+    madvise(const_cast<char*>(map_), size_, MADV_SEQUENTIAL);
+
+    uint32_t version;
+    uint32_t header_size;
+    memcpy(&version, map_ + 8, sizeof(version));
+    memcpy(&header_size, map_ + 12, sizeof(header_size));
+    if (memcmp(map_, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION || header_size != RECORD_HEADER_SIZE) {
+        std::cerr << "Not a capture file (or unsupported version): " << path_ << std::endl;
+        close();
+        return false;
+    }
+
+    rewind();
+    return true;
+}
+
+void CaptureReader::close() {
+    if (map_) {
+        munmap(const_cast<char*>(map_), size_);
+        map_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+bool CaptureReader::next(Record& record) {
+    while (map_ && offset_ + RECORD_HEADER_SIZE <= size_) {
+        const char* header = map_ + offset_;
+        uint32_t length;
+        uint16_t channel;
+        memcpy(&length, header + OFF_LENGTH, sizeof(length));
+        memcpy(&channel, header + OFF_CHANNEL, sizeof(channel));
+        uint8_t type = static_cast<uint8_t>(header[OFF_TYPE]);
+        uint16_t family;
+        memcpy(&family, header + OFF_FAMILY, sizeof(family));
+
+        // 录制没有正常关闭时，文件末尾是预先扩展的全零区域
+        if (type == TYPE_DATAGRAM && family == AF_UNSPEC) {
+            return false;
+        }
+
+        size_t total = RECORD_HEADER_SIZE + padded(length);
+        if (total > size_ - offset_) {
+            // 最后一条记录不完整（例如录制进程被强制结束）
+            corrupt_ = true;
+            return false;
+        }
+        const char* data = header + RECORD_HEADER_SIZE;
+        offset_ += total;
+
+        if (type == TYPE_CHANNEL) {
+            channels_[channel] = std::string(data, length);
+            continue;
+        }
+        if (type != TYPE_DATAGRAM) {
+            corrupt_ = true;
+            return false;
+        }
+
+        auto it = channels_.find(channel);
+        record.channel = it != channels_.end() ? std::string_view(it->second) : std::string_view();
+
+        memset(&record.source, 0, sizeof(record.source));
+        if (family == AF_INET6) {
+            auto& sin6 = reinterpret_cast<struct sockaddr_in6&>(record.source);
+            sin6.sin6_family = AF_INET6;
+            memcpy(&sin6.sin6_port, header + OFF_PORT, sizeof(sin6.sin6_port));
+            memcpy(&sin6.sin6_addr, header + OFF_ADDR, sizeof(sin6.sin6_addr));
+        } else if (family == AF_INET) {
+            auto& sin = reinterpret_cast<struct sockaddr_in&>(record.source);
+            sin.sin_family = AF_INET;
+            memcpy(&sin.sin_port, header + OFF_PORT, sizeof(sin.sin_port));
+            memcpy(&sin.sin_addr, header + OFF_ADDR, sizeof(sin.sin_addr));
+        } else {
+            corrupt_ = true;
+            return false;
+        }
+
+        memcpy(&record.rx_ts_ns, header + OFF_TIMESTAMP, sizeof(record.rx_ts_ns));
+        record.data = data;
+        record.len = length;
+        return true;
+    }
+    return false;
+}
+
+void CaptureReader::rewind() {
+    offset_ = FILE_HEADER_SIZE;
+    corrupt_ = false;
+    channels_.clear();
+}
+
+bool CaptureReader::isCorrupt() const {
+    return corrupt_;
+}
@@ -2,9 +2,161 @@
 #include <fstream>
 #include <iostream>
 #include <nlohmann/json.hpp>
+#include <set>
+
+static void readStringList(const nlohmann::json& j, const char* key, std::vector<std::string>& out) {
+    if (j.contains(key) && j[key].is_array()) {
+        out = j[key].get<std::vector<std::string>>();
+    }
+}
+
+static void readJoinOptions(const nlohmann::json& u, UdpReceiver::JoinOptions& join) {
+    readStringList(u, "interfaces", join.interfaces);
+    readStringList(u, "sources", join.sources);
+    readStringList(u, "exclude_sources", join.exclude_sources);
+    if (u.contains("bind_group")) join.bind_group = u["bind_group"].get<bool>();
+}
+
+// "cpus"可以是单个CPU编号或编号数组
+static void readThreadSettings(const nlohmann::json& t, ThreadTuning::Settings& settings) {
+    if (t.contains("cpus")) {
+        settings.cpus.clear();
+        if (t["cpus"].is_array()) {
+            for (const auto& cpu : t["cpus"]) settings.cpus.push_back(cpu.get<int>());
+        } else {
+            settings.cpus.push_back(t["cpus"].get<int>());
+        }
+    }
+    if (t.contains("priority")) settings.priority = t["priority"].get<int>();
+}
+
+static bool readReceiveOptions(const nlohmann::json& u, UdpReceiver::ReceiveOptions& receive) {
+    if (u.contains("backend")) {
+        std::string backend = u["backend"].get<std::string>();
+        if (!UdpReceiver::parseBackend(backend, receive.backend)) {
+            std::cerr << "Invalid receive backend: " << backend << " (expected socket/packet_ring)" << std::endl;
+            return false;
+        }
+    }
+    if (u.contains("ring") && u["ring"].is_object()) {
+        auto& r = u["ring"];
+        if (r.contains("block_size")) receive.ring.block_size = r["block_size"].get<size_t>();
+        if (r.contains("block_count")) receive.ring.block_count = r["block_count"].get<size_t>();
+        if (r.contains("block_timeout_ms")) receive.ring.block_timeout_ms = r["block_timeout_ms"].get<int>();
+    }
+    if (u.contains("max_datagram_size")) receive.max_datagram_size = u["max_datagram_size"].get<size_t>();
+    if (u.contains("gro")) receive.gro = u["gro"].get<bool>();
+    if (u.contains("framing") && u["framing"].is_object()) {
+        auto& f = u["framing"];
+        if (f.contains("enabled")) receive.framing.enabled = f["enabled"].get<bool>();
+        if (f.contains("max_messages")) receive.framing.max_messages = f["max_messages"].get<size_t>();
+        if (f.contains("max_message_size")) receive.framing.max_message_size = f["max_message_size"].get<size_t>();
+        if (f.contains("timeout_ms")) receive.framing.timeout_ms = f["timeout_ms"].get<int>();
+    }
+    if (u.contains("sequence") && u["sequence"].is_object()) {
+        auto& q = u["sequence"];
+        if (q.contains("enabled")) receive.sequence.enabled = q["enabled"].get<bool>();
+        if (q.contains("seq_field")) receive.sequence.seq_field = q["seq_field"].get<std::string>();
+        if (q.contains("max_sources")) receive.sequence.max_sources = q["max_sources"].get<size_t>();
+        if (q.contains("reorder_window_ms")) receive.sequence.reorder_window_ms = q["reorder_window_ms"].get<int>();
+        if (q.contains("reorder_max_messages")) receive.sequence.reorder_max_messages = q["reorder_max_messages"].get<size_t>();
+    }
+    return true;
+}
+
+static void readDedupConfig(const nlohmann::json& d, Deduplicator::Config& dedup) {
+    if (d.contains("enabled")) dedup.enabled = d["enabled"].get<bool>();
+    if (d.contains("key_field")) dedup.key_field = d["key_field"].get<std::string>();
+    if (d.contains("window_ms")) dedup.window_ms = d["window_ms"].get<int>();
+    if (d.contains("capacity")) dedup.capacity = d["capacity"].get<size_t>();
+}
+
+static void readConflationConfig(const nlohmann::json& c, Conflator::Config& conflation) {
+    if (c.contains("enabled")) conflation.enabled = c["enabled"].get<bool>();
+    if (c.contains("key_field")) conflation.key_field = c["key_field"].get<std::string>();
+    if (c.contains("interval_ms")) conflation.interval_ms = c["interval_ms"].get<int>();
+    if (c.contains("publish_when_idle")) conflation.publish_when_idle = c["publish_when_idle"].get<bool>();
+    if (c.contains("max_keys")) conflation.max_keys = c["max_keys"].get<size_t>();
+}
+
+// 读取pipeline数组；未知的阶段类型返回false
+static bool readPipelineConfig(const nlohmann::json& p, RuntimePipeline::Config& pipeline) {
+    pipeline.stages.clear();
+    for (auto& st : p) {
+        RuntimePipeline::Stage stage;
+        std::string type = st.contains("type") ? st["type"].get<std::string>() : "";
+        if (!RuntimePipeline::parseType(type, stage.type)) {
+            std::cerr << "Invalid pipeline stage type: \"" << type
+                      << "\" (expected drop_if/keep_if/project/enrich)" << std::endl;
+            return false;
+        }
+        if (st.contains("field")) stage.field = st["field"].get<std::string>();
+        if (st.contains("equals")) {
+            // 数字/布尔按字面量比较，字符串按引号内的内容比较
+            stage.compare_value = true;
+            stage.equals = st["equals"].is_string() ? st["equals"].get<std::string>() : st["equals"].dump();
+        }
+        readStringList(st, "fields", stage.fields);
+        if (stage.type == RuntimePipeline::Stage::Type::Enrich) {
+            // 默认注入接收时间和发送者地址，设为空字符串可关闭其中一项
+            stage.timestamp_field = "_rx_ts_ns";
+            stage.source_field = "_src";
+        }
+        if (st.contains("timestamp_field")) stage.timestamp_field = st["timestamp_field"].get<std::string>();
+        if (st.contains("source_field")) stage.source_field = st["source_field"].get<std::string>();
+        if (st.contains("add") && st["add"].is_object()) {
+            for (auto it = st["add"].begin(); it != st["add"].end(); ++it) {
+                stage.constants.emplace_back(it.key(), it.value().dump());
+            }
+        }
+
+        bool is_filter = stage.type == RuntimePipeline::Stage::Type::DropIf ||
+                         stage.type == RuntimePipeline::Stage::Type::KeepIf;
+        if (is_filter && stage.field.empty()) {
+            std::cerr << "Pipeline stage \"" << type << "\" needs a \"field\"" << std::endl;
+            return false;
+        }
+        pipeline.stages.push_back(stage);
+    }
+    return true;
+}
+
+// 读取sinks数组；未知的类型或策略、不完整的输出端返回false
+static bool readSinksConfig(const nlohmann::json& a, std::vector<Sink::Config>& sinks) {
+    sinks.clear();
+    for (auto& o : a) {
+        Sink::Config sink;
+        std::string type = o.contains("type") ? o["type"].get<std::string>() : "";
+        if (!Sink::parseType(type, sink.type)) {
+            std::cerr << "Invalid sink type: \"" << type << "\" (expected record/mirror)" << std::endl;
+            return false;
+        }
+        if (o.contains("name")) sink.name = o["name"].get<std::string>();
+        if (o.contains("path")) sink.path = o["path"].get<std::string>();
+        if (o.contains("host")) sink.host = o["host"].get<std::string>();
+        if (o.contains("port")) sink.port = o["port"].get<int>();
+        if (o.contains("capacity")) sink.capacity = o["capacity"].get<size_t>();
+        if (o.contains("policy")) {
+            std::string policy = o["policy"].get<std::string>();
+            if (!Sink::parsePolicy(policy, sink.policy)) {
+                std::cerr << "Invalid sink policy: " << policy << " (expected block/drop_newest/drop_oldest)" << std::endl;
+                return false;
+            }
+        }
+        std::string error;
+        if (!Sink::validate(sink, error)) {
+            std::cerr << "Invalid " << type << " sink: " << error << std::endl;
+            return false;
+        }
+        sinks.push_back(sink);
+    }
+    return true;
+}
 
 ConfigReader::ConfigReader(const std::string& config_file)
-    : config_file_(config_file), port_(1883), qos_(1), multicast_addr_("224.0.0.1"), multicast_port_(5555), interface_("") {
+    : config_file_(config_file), port_(1883), qos_(1), retain_(false), pool_size_(1), multicast_addr_("224.0.0.1"), multicast_port_(5555), interface_(""),
+      stats_interval_s_(0), spin_us_(0), reactors_(0), startup_buffer_(0),
+      drain_timeout_ms_(5000), metrics_port_(0), metrics_bind_("127.0.0.1") {
 }
 
 bool ConfigReader::load() {
@@ -29,7 +181,18 @@ bool ConfigReader::load() {
         if (m.contains("port")) port_ = m["port"].get<int>();
         if (m.contains("topic")) topic_ = m["topic"].get<std::string>();
         if (m.contains("qos")) qos_ = m["qos"].get<int>();
+        if (m.contains("retain")) retain_ = m["retain"].get<bool>();
         if (m.contains("client_id")) client_id_ = m["client_id"].get<std::string>();
+        if (m.contains("pool_size")) pool_size_ = m["pool_size"].get<size_t>();
+        routes_.clear();
+        if (m.contains("routes") && m["routes"].is_object()) {
+            for (auto& route : m["routes"].items()) {
+                PublishRoute settings = {qos_, retain_};
+                if (route.value().contains("qos")) settings.qos = route.value()["qos"].get<int>();
+                if (route.value().contains("retain")) settings.retain = route.value()["retain"].get<bool>();
+                routes_[route.key()] = settings;
+            }
+        }
     }
 
 
@@ -40,6 +203,10 @@ bool ConfigReader::load() {
         if (u.contains("multicast_addr")) multicast_addr_ = u["multicast_addr"].get<std::string>();
         if (u.contains("multicast_port")) multicast_port_ = u["multicast_port"].get<int>();
         if (u.contains("interface")) interface_ = u["interface"].get<std::string>();
+        readJoinOptions(u, join_);
+        if (!readReceiveOptions(u, receive_)) {
+            return false;
+        }
     }
 
     if (j.contains("multicast") && j["multicast"].is_object()) {
@@ -48,12 +215,297 @@ bool ConfigReader::load() {
         if (mm.contains("port")) multicast_port_ = mm["port"].get<int>();
     }
 
+    // Optional thread pinning / SCHED_FIFO priority per thread role
+    if (j.contains("threads") && j["threads"].is_object()) {
+        auto& t = j["threads"];
+        if (t.contains("receive")) readThreadSettings(t["receive"], threads_.receive);
+        if (t.contains("publish")) readThreadSettings(t["publish"], threads_.publish);
+        if (t.contains("network")) readThreadSettings(t["network"], threads_.network);
+        for (const auto* settings : {&threads_.receive, &threads_.publish, &threads_.network}) {
+            std::string error;
+            if (!ThreadTuning::validate(*settings, error)) {
+                std::cerr << "Invalid threads configuration: " << error << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // Optional low-latency receive: SO_BUSY_POLL on every socket plus a spinning event loop.
+    // Read before the bridges array so that every bridge inherits it.
+    if (j.contains("low_latency") && j["low_latency"].is_object()) {
+        auto& ll = j["low_latency"];
+        bool enabled = false;
+        int busy_poll_us = 50;
+        int spin_us = 100;
+        if (ll.contains("enabled")) enabled = ll["enabled"].get<bool>();
+        if (ll.contains("busy_poll_us")) busy_poll_us = ll["busy_poll_us"].get<int>();
+        if (ll.contains("spin_us")) spin_us = ll["spin_us"].get<int>();
+        if (busy_poll_us < 0 || spin_us < 0) {
+            std::cerr << "\"busy_poll_us\" and \"spin_us\" must not be negative" << std::endl;
+            return false;
+        }
+        receive_.busy_poll_us = enabled ? busy_poll_us : 0;
+        spin_us_ = enabled ? spin_us : 0;
+    }
+
+    // Optional single-threaded reactors: MQTT connections driven from the UDP event loops
+    if (j.contains("reactor") && j["reactor"].is_object()) {
+        auto& r = j["reactor"];
+        bool enabled = false;
+        int count = 1;
+        if (r.contains("enabled")) enabled = r["enabled"].get<bool>();
+        if (r.contains("count")) count = r["count"].get<int>();
+        if (count < 1) {
+            std::cerr << "\"reactor.count\" must be at least 1" << std::endl;
+            return false;
+        }
+        reactors_ = enabled ? static_cast<size_t>(count) : 0;
+    }
+
+    // Optional worker pool: pipeline stages run on work-stealing threads, per-key order restored before publish
+    if (j.contains("workers") && j["workers"].is_object()) {
+        auto& w = j["workers"];
+        workers_ = WorkerPool::Config();
+        if (w.contains("enabled")) workers_.enabled = w["enabled"].get<bool>();
+        if (w.contains("threads")) workers_.threads = w["threads"].get<size_t>();
+        if (w.contains("key_field")) workers_.key_field = w["key_field"].get<std::string>();
+        if (w.contains("queue_size")) workers_.queue_size = w["queue_size"].get<size_t>();
+        if (workers_.queue_size == 0) {
+            std::cerr << "\"workers.queue_size\" must be at least 1" << std::endl;
+            return false;
+        }
+    }
+
+    // Optional priority lanes: classify by topic or JSON field, publish by strict priority or weight
+    if (j.contains("priority") && j["priority"].is_object()) {
+        auto& p = j["priority"];
+        lanes_ = PriorityLanes::Config();
+        if (p.contains("enabled")) lanes_.enabled = p["enabled"].get<bool>();
+        if (p.contains("policy")) {
+            std::string policy = p["policy"].get<std::string>();
+            if (!PriorityLanes::parsePolicy(policy, lanes_.policy)) {
+                std::cerr << "Invalid priority policy: " << policy << " (expected strict/weighted)" << std::endl;
+                return false;
+            }
+        }
+        if (p.contains("lanes") && p["lanes"].is_array()) {
+            for (const auto& l : p["lanes"]) {
+                PriorityLanes::Lane lane;
+                if (l.contains("name")) lane.name = l["name"].get<std::string>();
+                if (l.contains("topics")) lane.topics = l["topics"].get<std::vector<std::string>>();
+                if (l.contains("field")) lane.field = l["field"].get<std::string>();
+                if (l.contains("values")) lane.values = l["values"].get<std::vector<std::string>>();
+                if (l.contains("weight")) lane.weight = l["weight"].get<int>();
+                if (l.contains("capacity")) lane.capacity = l["capacity"].get<size_t>();
+                lanes_.lanes.push_back(lane);
+            }
+        }
+        std::string error;
+        if (lanes_.enabled && !PriorityLanes::validate(lanes_, error)) {
+            std::cerr << "Invalid priority configuration: " << error << std::endl;
+            return false;
+        }
+    }
+
+    // Optional local output: shared memory broadcast ring read directly by consumers on this host
+    if (j.contains("local_output") && j["local_output"].is_object()) {
+        auto& o = j["local_output"];
+        local_output_ = ShmRing::Config();
+        if (o.contains("enabled")) local_output_.enabled = o["enabled"].get<bool>();
+        if (o.contains("path")) local_output_.path = o["path"].get<std::string>();
+        if (o.contains("slots")) local_output_.slots = o["slots"].get<size_t>();
+        if (o.contains("slot_size")) local_output_.slot_size = o["slot_size"].get<size_t>();
+        std::string error;
+        if (local_output_.enabled && !ShmRing::validate(local_output_, error)) {
+            std::cerr << "Invalid local_output configuration: " << error << std::endl;
+            return false;
+        }
+    }
+
+    // Optional fast start: join multicast groups and buffer while MQTT connects, report readiness
+    if (j.contains("startup") && j["startup"].is_object()) {
+        auto& s = j["startup"];
+        bool fast = false;
+        size_t buffer_size = 10000;
+        if (s.contains("fast")) fast = s["fast"].get<bool>();
+        if (s.contains("buffer_size")) buffer_size = s["buffer_size"].get<size_t>();
+        if (s.contains("ready_file")) ready_file_ = s["ready_file"].get<std::string>();
+        if (fast && buffer_size == 0) {
+            std::cerr << "\"startup.buffer_size\" must be at least 1" << std::endl;
+            return false;
+        }
+        startup_buffer_ = fast ? buffer_size : 0;
+    }
+
+    // Optional graceful shutdown: drain queues and wait for in-flight acknowledgements up to a deadline
+    if (j.contains("shutdown") && j["shutdown"].is_object()) {
+        auto& s = j["shutdown"];
+        if (s.contains("drain_timeout_ms")) drain_timeout_ms_ = s["drain_timeout_ms"].get<int>();
+        if (drain_timeout_ms_ < 0) {
+            std::cerr << "\"shutdown.drain_timeout_ms\" must not be negative" << std::endl;
+            return false;
+        }
+    }
+
+    // Optional duplicate suppression section
+    if (j.contains("dedup") && j["dedup"].is_object()) {
+        readDedupConfig(j["dedup"], dedup_);
+    }
+
+    // Optional filter/transform pipeline, applied after dedup
+    if (j.contains("pipeline") && j["pipeline"].is_array()) {
+        if (!readPipelineConfig(j["pipeline"], pipeline_)) {
+            return false;
+        }
+    }
+
+    // Optional last-value conflation section
+    if (j.contains("conflation") && j["conflation"].is_object()) {
+        readConflationConfig(j["conflation"], conflation_);
+    }
+
+    // Optional output sinks: every received datagram is also handed to these (record file, UDP mirror)
+    if (j.contains("sinks") && j["sinks"].is_array()) {
+        if (!readSinksConfig(j["sinks"], sinks_)) {
+            return false;
+        }
+    }
+
+    // Optional rate limit section: global bucket plus per-topic buckets
+    if (j.contains("rate_limit") && j["rate_limit"].is_object()) {
+        auto& r = j["rate_limit"];
+        auto readLimit = [](const nlohmann::json& l, RateLimiter::Limit& limit) {
+            if (l.contains("rate")) limit.rate = l["rate"].get<double>();
+            if (l.contains("burst")) limit.burst = l["burst"].get<double>();
+        };
+        if (r.contains("enabled")) rate_limit_.enabled = r["enabled"].get<bool>();
+        if (r.contains("global")) readLimit(r["global"], rate_limit_.global);
+        if (r.contains("routes") && r["routes"].is_object()) {
+            for (auto it = r["routes"].begin(); it != r["routes"].end(); ++it) {
+                readLimit(it.value(), rate_limit_.routes[it.key()]);
+            }
+        }
+        if (r.contains("policy")) {
+            std::string policy = r["policy"].get<std::string>();
+            if (!RateLimiter::parsePolicy(policy, rate_limit_.policy)) {
+                std::cerr << "Invalid rate_limit policy: " << policy
+                          << " (expected drop/delay/spool)" << std::endl;
+                return false;
+            }
+        }
+        if (r.contains("max_delay_ms")) rate_limit_.max_delay_ms = r["max_delay_ms"].get<int>();
+        if (r.contains("spool_size")) rate_limit_.spool_size = r["spool_size"].get<size_t>();
+    }
+
+    // Optional reverse bridge section (MQTT subscription -> UDP multicast)
+    if (j.contains("reverse") && j["reverse"].is_object()) {
+        auto& rv = j["reverse"];
+        if (rv.contains("enabled")) reverse_.enabled = rv["enabled"].get<bool>();
+        if (rv.contains("topic")) reverse_.topic = rv["topic"].get<std::string>();
+        if (rv.contains("qos")) reverse_.qos = rv["qos"].get<int>();
+        if (rv.contains("multicast_addr")) reverse_.multicast_addr = rv["multicast_addr"].get<std::string>();
+        if (rv.contains("multicast_port")) reverse_.multicast_port = rv["multicast_port"].get<int>();
+        if (rv.contains("interface")) reverse_.interface = rv["interface"].get<std::string>();
+        if (rv.contains("ttl")) reverse_.ttl = rv["ttl"].get<int>();
+        if (rv.contains("loopback")) reverse_.loopback = rv["loopback"].get<bool>();
+        if (rv.contains("queue_size")) reverse_.queue_size = rv["queue_size"].get<size_t>();
+    }
+
+    // Optional metrics section
+    if (j.contains("metrics") && j["metrics"].is_object()) {
+        auto& mt = j["metrics"];
+        if (mt.contains("log_interval_s")) stats_interval_s_ = mt["log_interval_s"].get<int>();
+        if (mt.contains("port")) metrics_port_ = mt["port"].get<int>();
+        if (mt.contains("bind")) metrics_bind_ = mt["bind"].get<std::string>();
+    }
+
+    // Optional bridges array: each entry is one UDP feed -> MQTT topic, sharing the mqtt connection.
+    // Entries inherit the top-level settings and may override topic/qos/retain/multicast/dedup/pipeline/conflation/sinks.
+    bridges_.clear();
+    if (j.contains("bridges") && j["bridges"].is_array()) {
+        std::set<std::string> names;
+        std::set<std::string> record_paths;
+        for (auto& b : j["bridges"]) {
+            UdpToMqttForwarder::Config bridge = getForwarderConfig();
+            if (b.contains("name")) bridge.name = b["name"].get<std::string>();
+            if (b.contains("topic")) bridge.mqtt_topic = b["topic"].get<std::string>();
+            if (b.contains("qos")) bridge.mqtt_qos = b["qos"].get<int>();
+            if (b.contains("retain")) bridge.mqtt_retain = b["retain"].get<bool>();
+            if (b.contains("multicast_addr")) bridge.multicast_addr = b["multicast_addr"].get<std::string>();
+            if (b.contains("multicast_port")) bridge.multicast_port = b["multicast_port"].get<int>();
+            if (b.contains("interface")) bridge.interface = b["interface"].get<std::string>();
+            readJoinOptions(b, bridge.join);
+            if (!readReceiveOptions(b, bridge.receive)) {
+                return false;
+            }
+            if (b.contains("dedup") && b["dedup"].is_object()) readDedupConfig(b["dedup"], bridge.dedup);
+            if (b.contains("conflation") && b["conflation"].is_object()) readConflationConfig(b["conflation"], bridge.conflation);
+            if (b.contains("pipeline") && b["pipeline"].is_array() && !readPipelineConfig(b["pipeline"], bridge.pipeline)) {
+                return false;
+            }
+            if (b.contains("sinks") && b["sinks"].is_array() && !readSinksConfig(b["sinks"], bridge.sinks)) {
+                return false;
+            }
+
+            if (bridge.name.empty() || !names.insert(bridge.name).second) {
+                std::cerr << "Each bridge needs a unique name (got \"" << bridge.name << "\")" << std::endl;
+                return false;
+            }
+            if (bridge.mqtt_topic.empty()) {
+                std::cerr << "Missing topic for bridge " << bridge.name << std::endl;
+                return false;
+            }
+            for (const auto& sink : bridge.sinks) {
+                if (sink.type == Sink::Type::Record && !record_paths.insert(sink.path).second) {
+                    std::cerr << "Record sink path " << sink.path << " is used by more than one bridge" << std::endl;
+                    return false;
+                }
+            }
+            bridges_.push_back(bridge);
+        }
+    }
+
     // validation
-    if (broker_.empty() || topic_.empty()) {
+    if (broker_.empty() || (topic_.empty() && bridges_.empty())) {
         std::cerr << "Missing required mqtt configuration (broker/topic)" << std::endl;
         return false;
     }
 
+    for (const auto& bridge : getBridgeManagerConfig().bridges) {
+        if (bridge.mqtt_qos < 0 || bridge.mqtt_qos > 2) {
+            std::cerr << "\"qos\" must be 0, 1 or 2 (topic " << bridge.mqtt_topic << ")" << std::endl;
+            return false;
+        }
+        if (!bridge.join.sources.empty() && !bridge.join.exclude_sources.empty()) {
+            std::cerr << "\"sources\" and \"exclude_sources\" cannot be combined (group "
+                      << bridge.multicast_addr << ")" << std::endl;
+            return false;
+        }
+        if (bridge.receive.max_datagram_size == 0 || bridge.receive.max_datagram_size > 65535) {
+            std::cerr << "\"max_datagram_size\" must be between 1 and 65535 (group "
+                      << bridge.multicast_addr << ")" << std::endl;
+            return false;
+        }
+        if (bridge.receive.backend == UdpReceiver::ReceiveOptions::Backend::PacketRing &&
+            (bridge.receive.ring.block_size == 0 || bridge.receive.ring.block_size % 4096 != 0 ||
+             bridge.receive.ring.block_count == 0 || bridge.receive.ring.block_timeout_ms < 0)) {
+            std::cerr << "\"ring.block_size\" must be a multiple of 4096 and \"ring.block_count\" at least 1 (group "
+                      << bridge.multicast_addr << ")" << std::endl;
+            return false;
+        }
+    }
+
+    if (reverse_.enabled) {
+        for (const auto& bridge : getBridgeManagerConfig().bridges) {
+            if (MqttToUdpForwarder::createsLoop(reverse_, bridge.mqtt_topic, bridge.multicast_addr,
+                                                bridge.multicast_port)) {
+                std::cerr << "Reverse bridge would loop with the forward path (reverse.topic \""
+                          << reverse_.topic << "\" vs mqtt.topic \"" << bridge.mqtt_topic << "\")" << std::endl;
+                return false;
+            }
+        }
+    }
+
     return true;
 }
 
@@ -73,10 +525,38 @@ int ConfigReader::getQos() const {
     return qos_;
 }
 
+bool ConfigReader::getRetain() const {
+    return retain_;
+}
+
 std::string ConfigReader::getClientId() const {
     return client_id_;
 }
 
+size_t ConfigReader::getPoolSize() const {
+    return pool_size_;
+}
+
+int ConfigReader::getStatsInterval() const {
+    return stats_interval_s_;
+}
+
+ThreadTuning::Config ConfigReader::getThreadConfig() const {
+    return threads_;
+}
+
+int ConfigReader::getMetricsPort() const {
+    return metrics_port_;
+}
+
+std::string ConfigReader::getMetricsBind() const {
+    return metrics_bind_;
+}
+
+std::string ConfigReader::getReadyFile() const {
+    return ready_file_;
+}
+
 
 std::string ConfigReader::getMulticastAddr() const {
     return multicast_addr_;
@@ -89,3 +569,71 @@ int ConfigReader::getMulticastPort() const {
 std::string ConfigReader::getInterface() const {
     return interface_;
 }
+
+Deduplicator::Config ConfigReader::getDedupConfig() const {
+    return dedup_;
+}
+
+Conflator::Config ConfigReader::getConflationConfig() const {
+    return conflation_;
+}
+
+RateLimiter::Config ConfigReader::getRateLimitConfig() const {
+    return rate_limit_;
+}
+
+MqttToUdpForwarder::Config ConfigReader::getReverseConfig() const {
+    return reverse_;
+}
+
+UdpToMqttForwarder::Config ConfigReader::getForwarderConfig() const {
+    UdpToMqttForwarder::Config config;
+    config.mqtt_client_id = client_id_;
+    config.mqtt_broker = broker_;
+    config.mqtt_port = port_;
+    config.mqtt_topic = topic_;
+    config.mqtt_qos = qos_;
+    config.mqtt_retain = retain_;
+    config.multicast_addr = multicast_addr_;
+    config.multicast_port = multicast_port_;
+    config.interface = interface_;
+    config.join = join_;
+    config.receive = receive_;
+    config.dedup = dedup_;
+    config.pipeline = pipeline_;
+    config.conflation = conflation_;
+    config.rate_limit = rate_limit_;
+    config.sinks = sinks_;
+    return config;
+}
+
+BridgeManager::Config ConfigReader::getBridgeManagerConfig() const {
+    BridgeManager::Config config;
+    config.mqtt_client_id = client_id_;
+    config.mqtt_broker = broker_;
+    config.mqtt_port = port_;
+    config.pool_size = pool_size_;
+    config.spin_us = spin_us_;
+    config.reactors = reactors_;
+    config.workers = workers_;
+    config.lanes = lanes_;
+    config.local_output = local_output_;
+    config.startup_buffer = startup_buffer_;
+    config.drain_timeout_ms = drain_timeout_ms_;
+    if (bridges_.empty()) {
+        // 未配置bridges数组时，按顶层mqtt/multicast设置运行单个桥接
+        config.bridges.push_back(getForwarderConfig());
+    } else {
+        config.bridges = bridges_;
+    }
+
+    // mqtt.routes中按主题设置的QoS/retain优先于桥接自己的设置
+    for (auto& bridge : config.bridges) {
+        auto route = routes_.find(bridge.mqtt_topic);
+        if (route != routes_.end()) {
+            bridge.mqtt_qos = route->second.qos;
+            bridge.mqtt_retain = route->second.retain;
+        }
+    }
+    return config;
+}
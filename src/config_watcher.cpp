@@ -0,0 +1,67 @@
+#include "config_watcher.h"
+#include <iostream>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+ConfigWatcher::ConfigWatcher(const std::string& config_file)
+    : inotify_fd_(-1), watch_fd_(-1) {
+    size_t slash = config_file.find_last_of('/');
+    if (slash == std::string::npos) {
+        directory_ = ".";
+        file_name_ = config_file;
+    } else {
+        directory_ = slash == 0 ? "/" : config_file.substr(0, slash);
+        file_name_ = config_file.substr(slash + 1);
+    }
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+    }
+}
+
+bool ConfigWatcher::start() {
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        std::cerr << "Failed to initialize inotify: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    watch_fd_ = inotify_add_watch(inotify_fd_, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (watch_fd_ < 0) {
+        std::cerr << "Failed to watch " << directory_ << ": " << strerror(errno) << std::endl;
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+        return false;
+    }
+
+    return true;
+}
+
+bool ConfigWatcher::poll() {
+    if (inotify_fd_ < 0) {
+        return false;
+    }
+
+    bool changed = false;
+    alignas(struct inotify_event) char buffer[4096];
+
+    while (true) {
+        ssize_t len = read(inotify_fd_, buffer, sizeof(buffer));
+        if (len <= 0) {
+            break;
+        }
+
+        for (char* p = buffer; p < buffer + len;) {
+            struct inotify_event* event = reinterpret_cast<struct inotify_event*>(p);
+            if (event->len > 0 && file_name_ == event->name) {
+                changed = true;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    return changed;
+}
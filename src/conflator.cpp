@@ -0,0 +1,175 @@
+#include "conflator.h"
+#include "json_field.h"
+#include "thread_tuning.h"
+#include "xxhash64.h"
+#include <chrono>
+#include <iostream>
+#include <tuple>
+
+bool Conflator::Config::operator==(const Config& other) const {
+    return std::tie(enabled, key_field, interval_ms, publish_when_idle, max_keys) ==
+           std::tie(other.enabled, other.key_field, other.interval_ms, other.publish_when_idle, other.max_keys);
+}
+
+Conflator::Conflator(const Config& config)
+    : key_field_(config.key_field),
+      interval_ms_(config.interval_ms),
+      publish_when_idle_(config.publish_when_idle),
+      max_keys_(config.max_keys > 0 ? config.max_keys : 1),
+      key_count_(0),
+      running_(false),
+      conflated_count_(0) {
+    // 负载因子不超过0.5，保证线性探测足够短
+    size_t capacity = 16;
+    while (capacity < max_keys_ * 2) {
+        capacity <<= 1;
+    }
+    entries_.resize(capacity);
+    mask_ = capacity - 1;
+    dirty_.reserve(max_keys_);
+
+    if (interval_ms_ <= 0 && !publish_when_idle_) {
+        // 两种触发方式都关闭时退化为空闲发布，避免值永远不被发出
+        publish_when_idle_ = true;
+    }
+}
+
+Conflator::~Conflator() {
+    stop();
+}
+
+bool Conflator::start(PublishCallback callback) {
+    if (running_) {
+        std::cerr << "Conflator is already running" << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    publish_thread_ = std::thread(&Conflator::publishLoop, this, callback);
+    return true;
+}
+
+void Conflator::stop() {
+    if (!running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+
+    if (publish_thread_.joinable()) {
+        publish_thread_.join();
+    }
+}
+
+bool Conflator::update(const std::string& message) {
+    std::string_view key;
+    if (!findJsonField(message, key_field_, key)) {
+        return false;
+    }
+
+    uint64_t hash = xxhash64(key.data(), key.size());
+    bool notify = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        size_t index = hash & mask_;
+        while (entries_[index].used &&
+               (entries_[index].hash != hash || entries_[index].key != key)) {
+            index = (index + 1) & mask_;
+        }
+
+        Entry& entry = entries_[index];
+        if (!entry.used) {
+            if (key_count_ >= max_keys_) {
+                return false;
+            }
+            entry.used = true;
+            entry.hash = hash;
+            entry.key.assign(key.data(), key.size());
+            key_count_++;
+        }
+
+        // assign复用槽位中已有的缓冲区
+        entry.payload.assign(message);
+        if (entry.dirty) {
+            conflated_count_++;
+        } else {
+            entry.dirty = true;
+            dirty_.push_back(static_cast<uint32_t>(index));
+            notify = publish_when_idle_ && dirty_.size() == 1;
+        }
+    }
+
+    if (notify) {
+        cv_.notify_one();
+    }
+    return true;
+}
+
+size_t Conflator::flush(const PublishCallback& callback) {
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        count = dirty_.size();
+        if (batch_.size() < count) {
+            batch_.resize(count);
+        }
+        // 交换而不是拷贝：槽位拿到上一批次的缓冲区继续复用
+        for (size_t i = 0; i < count; ++i) {
+            Entry& entry = entries_[dirty_[i]];
+            batch_[i].swap(entry.payload);
+            entry.dirty = false;
+        }
+        dirty_.clear();
+    }
+
+    // 发布在锁外进行，期间到达的更新继续合并
+    for (size_t i = 0; i < count; ++i) {
+        callback(batch_[i]);
+    }
+    return count;
+}
+
+uint64_t Conflator::getConflatedCount() const {
+    return conflated_count_;
+}
+
+void Conflator::resetStatistics() {
+    conflated_count_ = 0;
+}
+
+size_t Conflator::keyCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return key_count_;
+}
+
+void Conflator::publishLoop(PublishCallback callback) {
+    ThreadTuning::apply(ThreadTuning::Role::Publish, "conflator");
+
+    auto interval = std::chrono::milliseconds(interval_ms_ > 0 ? interval_ms_ : 1000);
+    auto next_tick = std::chrono::steady_clock::now() + interval;
+
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_until(lock, next_tick, [this] {
+                return !running_ || (publish_when_idle_ && !dirty_.empty());
+            });
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_tick) {
+            next_tick = now + interval;
+        }
+
+        flush(callback);
+    }
+
+    // 退出前发布剩余的值
+    flush(callback);
+}
@@ -0,0 +1,91 @@
+#include "deduplicator.h"
+#include "json_field.h"
+#include "xxhash64.h"
+#include <chrono>
+#include <tuple>
+
+bool Deduplicator::Config::operator==(const Config& other) const {
+    return std::tie(enabled, key_field, window_ms, capacity) ==
+           std::tie(other.enabled, other.key_field, other.window_ms, other.capacity);
+}
+
+Deduplicator::Deduplicator(const Config& config)
+    : key_field_(config.key_field), eviction_count_(0) {
+    int window_ms = config.window_ms > 0 ? config.window_ms : 1;
+    bucket_ms_ = static_cast<uint64_t>(window_ms) / BUCKETS_PER_WINDOW;
+    if (bucket_ms_ == 0) {
+        bucket_ms_ = 1;
+    }
+
+    size_t capacity = 64;
+    while (capacity < config.capacity) {
+        capacity <<= 1;
+    }
+    slots_.assign(capacity, Slot{0, 0});
+    mask_ = capacity - 1;
+}
+
+bool Deduplicator::isDuplicate(const char* data, size_t len) {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    uint64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    return isDuplicate(data, len, now_ms);
+}
+
+bool Deduplicator::isDuplicate(const char* data, size_t len, uint64_t now_ms) {
+    uint64_t hash = computeKey(data, len);
+    // +1 保证有效桶编号不为0
+    uint32_t current = static_cast<uint32_t>(now_ms / bucket_ms_) + 1;
+
+    size_t index = hash & mask_;
+    Slot* free_slot = nullptr;
+    Slot* oldest_slot = nullptr;
+
+    for (size_t i = 0; i < MAX_PROBE; ++i) {
+        Slot& slot = slots_[(index + i) & mask_];
+        bool alive = slot.bucket != 0 &&
+                     static_cast<uint32_t>(current - slot.bucket) < BUCKETS_PER_WINDOW;
+
+        if (!alive) {
+            if (!free_slot) {
+                free_slot = &slot;
+            }
+            continue;
+        }
+
+        if (slot.hash == hash) {
+            return true;
+        }
+
+        if (!oldest_slot || static_cast<uint32_t>(current - slot.bucket) >
+                                static_cast<uint32_t>(current - oldest_slot->bucket)) {
+            oldest_slot = &slot;
+        }
+    }
+
+    if (!free_slot) {
+        // 探测范围内都是有效记录，淘汰最旧的一条
+        free_slot = oldest_slot;
+        eviction_count_++;
+    }
+    free_slot->hash = hash;
+    free_slot->bucket = current;
+    return false;
+}
+
+uint64_t Deduplicator::getEvictionCount() const {
+    return eviction_count_;
+}
+
+size_t Deduplicator::capacity() const {
+    return slots_.size();
+}
+
+uint64_t Deduplicator::computeKey(const char* data, size_t len) const {
+    if (!key_field_.empty()) {
+        std::string_view value;
+        if (findJsonField(std::string_view(data, len), key_field_, value)) {
+            return xxhash64(value.data(), value.size());
+        }
+    }
+    return xxhash64(data, len);
+}
@@ -0,0 +1,169 @@
+#include "json_field.h"
+
+namespace {
+
+void skipWhitespace(std::string_view json, size_t& pos) {
+    while (pos < json.size()) {
+        char c = json[pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            break;
+        }
+        ++pos;
+    }
+}
+
+// pos指向起始引号，返回后pos指向结束引号之后
+bool skipString(std::string_view json, size_t& pos) {
+    ++pos;
+    while (pos < json.size()) {
+        char c = json[pos];
+        if (c == '\\') {
+            pos += 2;
+            continue;
+        }
+        ++pos;
+        if (c == '"') {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 跳过任意一个JSON值，返回后pos指向该值之后
+bool skipValue(std::string_view json, size_t& pos) {
+    skipWhitespace(json, pos);
+    if (pos >= json.size()) {
+        return false;
+    }
+
+    char c = json[pos];
+    if (c == '"') {
+        return skipString(json, pos);
+    }
+
+    if (c == '{' || c == '[') {
+        // 只需匹配括号深度，字符串内的括号单独跳过
+        int depth = 0;
+        while (pos < json.size()) {
+            c = json[pos];
+            if (c == '"') {
+                if (!skipString(json, pos)) {
+                    return false;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                --depth;
+                if (depth == 0) {
+                    ++pos;
+                    return true;
+                }
+            }
+            ++pos;
+        }
+        return false;
+    }
+
+    // 数字、true、false、null
+    size_t start = pos;
+    while (pos < json.size()) {
+        c = json[pos];
+        if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            break;
+        }
+        ++pos;
+    }
+    return pos > start;
+}
+
+// 定位字段值，返回值在json中的起止位置（字符串包含引号）
+bool locateValue(std::string_view json, std::string_view path, size_t& start, size_t& end) {
+    size_t pos = 0;
+
+    while (true) {
+        size_t dot = path.find('.');
+        std::string_view segment = path.substr(0, dot);
+        bool last = (dot == std::string_view::npos);
+
+        skipWhitespace(json, pos);
+        if (pos >= json.size() || json[pos] != '{') {
+            return false;
+        }
+        ++pos;
+
+        while (true) {
+            skipWhitespace(json, pos);
+            if (pos >= json.size() || json[pos] != '"') {
+                return false;
+            }
+
+            size_t key_start = pos + 1;
+            if (!skipString(json, pos)) {
+                return false;
+            }
+            std::string_view key = json.substr(key_start, pos - key_start - 1);
+
+            skipWhitespace(json, pos);
+            if (pos >= json.size() || json[pos] != ':') {
+                return false;
+            }
+            ++pos;
+            skipWhitespace(json, pos);
+
+            if (key == segment) {
+                break;
+            }
+
+            if (!skipValue(json, pos)) {
+                return false;
+            }
+            skipWhitespace(json, pos);
+            if (pos >= json.size() || json[pos] != ',') {
+                return false;
+            }
+            ++pos;
+        }
+
+        if (!last) {
+            // 进入嵌套对象继续查找下一段
+            path = path.substr(dot + 1);
+            continue;
+        }
+
+        start = pos;
+        if (!skipValue(json, pos)) {
+            return false;
+        }
+        end = pos;
+        return true;
+    }
+}
+
+} // namespace
+
+bool findJsonField(std::string_view json, std::string_view path, std::string_view& value) {
+    size_t start;
+    size_t end;
+    if (!locateValue(json, path, start, end)) {
+        return false;
+    }
+
+    if (json[start] == '"') {
+        value = json.substr(start + 1, end - start - 2);
+    } else {
+        value = json.substr(start, end - start);
+    }
+    return true;
+}
+
+bool findJsonFieldRaw(std::string_view json, std::string_view path, std::string_view& value) {
+    size_t start;
+    size_t end;
+    if (!locateValue(json, path, start, end)) {
+        return false;
+    }
+    value = json.substr(start, end - start);
+    return true;
+}
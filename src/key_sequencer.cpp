@@ -0,0 +1,106 @@
+#include "key_sequencer.h"
+
+KeySequencer::KeySequencer() : pending_(0) {
+}
+
+KeySequencer::Ticket KeySequencer::begin(std::string_view key) {
+    Shard& shard = shardFor(key);
+    Ticket ticket;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.probe.assign(key.data(), key.size());
+    auto it = shard.entries.find(shard.probe);
+    if (it == shard.entries.end()) {
+        // 键太多时清理全部放行且没有线程在执行动作的键，没有未完成的凭证指向它们
+        if (shard.entries.size() >= MAX_KEYS_PER_SHARD) {
+            for (auto idle = shard.entries.begin(); idle != shard.entries.end();) {
+                const Entry& entry = idle->second;
+                if (entry.next_release == entry.next_sequence && !entry.releasing) {
+                    idle = shard.entries.erase(idle);
+                } else {
+                    ++idle;
+                }
+            }
+        }
+        it = shard.entries.emplace(shard.probe, Entry()).first;
+        it->second.mutex = &shard.mutex;
+    }
+
+    // unordered_map的元素引用在插入和删除其他元素后仍然有效，有未完成凭证的键不会被清理
+    ticket.entry = &it->second;
+    ticket.sequence = ticket.entry->next_sequence++;
+    pending_++;
+    return ticket;
+}
+
+void KeySequencer::complete(const Ticket& ticket, Action action) {
+    Entry& entry = *ticket.entry;
+    size_t released = 0;
+
+    {
+        std::unique_lock<std::mutex> lock(*entry.mutex);
+        uint64_t offset = ticket.sequence - entry.next_release;
+        if (offset >= entry.slots.size()) {
+            growSlots(entry, offset);
+        }
+        Slot& slot = entry.slots[ticket.sequence & (entry.slots.size() - 1)];
+        slot.action = std::move(action);
+        slot.ready = true;
+        if (entry.releasing) {
+            return;
+        }
+
+        // 依次执行已就绪的连续序号，执行时不持锁，其他线程交回的动作由本线程继续执行
+        entry.releasing = true;
+        while (true) {
+            Slot& head = entry.slots[entry.next_release & (entry.slots.size() - 1)];
+            if (!head.ready) {
+                break;
+            }
+            Action next = std::move(head.action);
+            head.action = nullptr;
+            head.ready = false;
+            entry.next_release++;
+
+            lock.unlock();
+            next();
+            released++;
+            lock.lock();
+        }
+        entry.releasing = false;
+    }
+
+    if (released > 0 && pending_.fetch_sub(released) == released) {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_cv_.notify_all();
+    }
+}
+
+size_t KeySequencer::pending() const {
+    return pending_;
+}
+
+void KeySequencer::waitIdle() {
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cv_.wait(lock, [this] { return pending_ == 0; });
+}
+
+KeySequencer::Shard& KeySequencer::shardFor(std::string_view key) {
+    return shards_[std::hash<std::string_view>()(key) % SHARDS];
+}
+
+void KeySequencer::growSlots(Entry& entry, uint64_t offset) {
+    size_t capacity = entry.slots.empty() ? INITIAL_SLOTS : entry.slots.size();
+    while (capacity <= offset) {
+        capacity *= 2;
+    }
+
+    std::vector<Slot> slots(capacity);
+    for (uint64_t sequence = entry.next_release; sequence < entry.next_release + entry.slots.size(); ++sequence) {
+        Slot& old = entry.slots[sequence & (entry.slots.size() - 1)];
+        if (old.ready) {
+            slots[sequence & (capacity - 1)] = std::move(old);
+        }
+    }
+    entry.slots.swap(slots);
+}
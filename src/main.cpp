@@ -1,16 +1,54 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include "bridge_manager.h"
 #include "config_reader.h"
-#include "udp_to_mqtt_forwarder.h"
+#include "config_watcher.h"
+#include "metrics_server.h"
+#include "mqtt_to_udp_forwarder.h"
+#include "readiness.h"
+#include "thread_tuning.h"
 #include <csignal>
 #include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [config.json] [--record FILE | --replay FILE [--speed X]]" << std::endl
+              << "  --record FILE  record every received datagram to FILE while forwarding" << std::endl
+              << "  --replay FILE  forward the datagrams recorded in FILE instead of listening on UDP" << std::endl
+              << "  --speed X      replay speed multiplier (default 1, 0 = as fast as possible)" << std::endl;
+}
 
 int main(int argc, char* argv[]) {
     // 默认配置文件
     std::string config_file = "config.json";
-    if (argc > 1) {
-        config_file = argv[1];
+    std::string record_file;
+    std::string replay_file;
+    double replay_speed = 1.0;
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--record") == 0 && has_value) {
+            record_file = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && has_value) {
+            replay_file = argv[++i];
+        } else if (strcmp(argv[i], "--speed") == 0 && has_value) {
+            char* end = nullptr;
+            replay_speed = strtod(argv[++i], &end);
+            if (*end != '\0' || replay_speed < 0) {
+                std::cerr << "Invalid replay speed: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (argv[i][0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            config_file = argv[i];
+        }
+    }
+    if (!record_file.empty() && !replay_file.empty()) {
+        std::cerr << "--record and --replay cannot be combined" << std::endl;
+        return 1;
     }
 
     std::cout << "Loading configuration from: " << config_file << std::endl;
@@ -20,50 +58,192 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    // 从配置中读取MQTT和UDP组播相关字段
+    // 从配置中读取MQTT相关字段
     std::string broker = config.getBroker();
     int port = config.getPort();
-    std::string topic = config.getTopic();
-    int qos = config.getQos();
     std::string client_id = config.getClientId();
 
-    // UDP multicast settings from config
-    std::string multicast_addr = config.getMulticastAddr();
-    int multicast_port = config.getMulticastPort();
-    std::string interface = config.getInterface();
-
+    BridgeManager::Config bridges_config = config.getBridgeManagerConfig();
     std::cout << "MQTT broker: " << broker << ":" << port << std::endl;
-    std::cout << "MQTT topic: " << topic << " qos=" << qos << std::endl;
-    std::cout << "UDP multicast: " << multicast_addr << ":" << multicast_port << std::endl;
-    if (!interface.empty()) {
-        std::cout << "Network interface: " << interface << std::endl;
+    for (const auto& bridge : bridges_config.bridges) {
+        std::cout << "Bridge " << (bridge.name.empty() ? "default" : bridge.name) << ": UDP multicast "
+                  << bridge.multicast_addr << ":" << bridge.multicast_port
+                  << (bridge.interface.empty() ? "" : " via " + bridge.interface)
+                  << " -> MQTT topic " << bridge.mqtt_topic << " qos=" << bridge.mqtt_qos
+                  << (bridge.mqtt_retain ? " retain" : "") << std::endl;
+    }
+
+    // 线程的CPU亲和性和实时优先级，在创建各线程之前设置
+    ThreadTuning::configure(config.getThreadConfig());
+
+    // 可选的Prometheus指标端点（仅启动时读取，修改端口需重启）
+    std::unique_ptr<MetricsServer> metrics_server;
+    if (config.getMetricsPort() > 0) {
+        metrics_server = std::make_unique<MetricsServer>(MetricsRegistry::global(), config.getMetricsPort(),
+                                                         config.getMetricsBind());
+        if (!metrics_server->start()) {
+            std::cerr << "Metrics endpoint disabled" << std::endl;
+            metrics_server.reset();
+        }
     }
 
-    // 创建并启动转发器
-    UdpToMqttForwarder forwarder(client_id, broker, port, topic, qos, multicast_addr, multicast_port, interface);
-    if (!forwarder.start()) {
+    // 录制模式：各桥接收到的报文写入同一个抓包文件
+    std::shared_ptr<CaptureWriter> capture;
+    if (!record_file.empty()) {
+        capture = std::make_shared<CaptureWriter>(record_file);
+        if (!capture->open()) {
+            return 1;
+        }
+    }
+
+    // 回放模式：先打开抓包文件，桥接不创建UDP套接字
+    std::unique_ptr<CaptureReader> replay_reader;
+    if (!replay_file.empty()) {
+        replay_reader = std::make_unique<CaptureReader>(replay_file);
+        if (!replay_reader->open()) {
+            return 1;
+        }
+
+        // 输出端不参与回放：录制输出端可能正是被回放的文件
+        for (auto& bridge : bridges_config.bridges) {
+            if (!bridge.sinks.empty()) {
+                std::cout << "Output sinks of bridge " << (bridge.name.empty() ? "default" : bridge.name)
+                          << " are disabled while replaying" << std::endl;
+                bridge.sinks.clear();
+            }
+        }
+    }
+
+    // 全部桥接在接收且MQTT连接已建立后通知服务管理器并写入就绪文件，滚动重启时据此停止旧进程
+    Readiness readiness(config.getReadyFile());
+
+    // 创建并启动全部桥接（共享MQTT连接池和UDP接收事件循环）
+    BridgeManager bridges(bridges_config);
+    bridges.setCapture(capture);
+    bridges.setReplayMode(replay_reader != nullptr);
+    if (!replay_reader) {
+        bridges.setReadyCallback([&readiness]() { readiness.ready("Forwarding"); });
+    }
+    if (!bridges.start()) {
         std::cerr << "Failed to start UDP->MQTT forwarder" << std::endl;
         return 1;
     }
 
-    // 运行直到用户中断（SIGINT/SIGTERM）
+    // 运行直到用户中断（SIGINT/SIGTERM），SIGHUP或配置文件变化时重载配置
     static std::atomic<bool> keepRunning{true};
+    static std::atomic<bool> reloadRequested{false};
 
     auto signalHandler = [](int signum) {
-        (void)signum;
+        if (signum == SIGHUP) {
+            reloadRequested.store(true);
+            return;
+        }
         keepRunning.store(false);
     };
 
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+    std::signal(SIGHUP, signalHandler);
+
+    // 回放完成（或被中断）后输出统计并退出，不启动反向转发和配置监视
+    if (replay_reader) {
+        bridges.replay(*replay_reader, replay_speed, keepRunning);
+        bridges.logStatistics();
+        bridges.stop();
+        if (metrics_server) {
+            metrics_server->stop();
+        }
+        std::cout << "Exiting" << std::endl;
+        return 0;
+    }
+
+    // 可选的反向转发（MQTT -> UDP组播），使用独立的客户端ID
+    std::unique_ptr<MqttToUdpForwarder> reverse_forwarder;
+    MqttToUdpForwarder::Config reverse_config = config.getReverseConfig();
+    if (reverse_config.enabled) {
+        reverse_forwarder = std::make_unique<MqttToUdpForwarder>(client_id + "_reverse", broker, port, reverse_config);
+        if (!reverse_forwarder->start()) {
+            std::cerr << "Failed to start MQTT->UDP forwarder" << std::endl;
+            bridges.stop();
+            if (capture) {
+                capture->close();
+            }
+            return 1;
+        }
+    }
+
+    int stats_interval_s = config.getStatsInterval();
+
+    // 重新读取配置文件并应用到运行中的转发器，加载失败时保持当前配置
+    auto reloadConfiguration = [&]() {
+        std::cout << "Reloading configuration from: " << config_file << std::endl;
+        ConfigReader next(config_file);
+        if (!next.load()) {
+            std::cerr << "Failed to reload configuration, keeping current settings" << std::endl;
+            return;
+        }
+
+        const BridgeManager::Config& current = bridges.getConfig();
+        bool broker_changed = next.getBroker() != current.mqtt_broker ||
+                              next.getPort() != current.mqtt_port ||
+                              next.getClientId() != current.mqtt_client_id;
+        bridges.reload(next.getBridgeManagerConfig());
+        stats_interval_s = next.getStatsInterval();
+
+        // 反向转发只在其配置或broker变化时重建
+        MqttToUdpForwarder::Config next_reverse = next.getReverseConfig();
+        if (next_reverse != reverse_config || broker_changed) {
+            if (reverse_forwarder) {
+                reverse_forwarder->stop();
+                reverse_forwarder.reset();
+            }
+            if (next_reverse.enabled) {
+                reverse_forwarder = std::make_unique<MqttToUdpForwarder>(
+                    next.getClientId() + "_reverse", next.getBroker(), next.getPort(), next_reverse);
+                if (!reverse_forwarder->start()) {
+                    std::cerr << "Failed to restart MQTT->UDP forwarder" << std::endl;
+                    reverse_forwarder.reset();
+                }
+            }
+            reverse_config = next_reverse;
+        }
+    };
+
+    ConfigWatcher watcher(config_file);
+    if (!watcher.start()) {
+        std::cerr << "Config file watching disabled, use SIGHUP to reload" << std::endl;
+    }
 
     std::cout << "Forwarder running. Press Ctrl+C to stop..." << std::endl;
-    // 主线程等待，直到接收到终止信号或内部转发器停止
-    while (keepRunning.load() && forwarder.isRunning()) {
+    // 主线程等待，直到接收到终止信号或全部桥接停止
+    auto last_stats = std::chrono::steady_clock::now();
+    while (keepRunning.load() && bridges.isRunning()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        bool file_changed = watcher.poll();
+        if (reloadRequested.exchange(false) || file_changed) {
+            reloadConfiguration();
+        }
+
+        // 周期输出各桥接统计
+        auto now = std::chrono::steady_clock::now();
+        if (stats_interval_s > 0 && now - last_stats >= std::chrono::seconds(stats_interval_s)) {
+            bridges.logStatistics();
+            last_stats = now;
+        }
     }
 
-    forwarder.stop();
+    readiness.stopping();
+    if (reverse_forwarder) {
+        reverse_forwarder->stop();
+    }
+    bridges.stop();
+    if (capture) {
+        capture->close();
+    }
+    if (metrics_server) {
+        metrics_server->stop();
+    }
     std::cout << "Exiting" << std::endl;
     return 0;
 }
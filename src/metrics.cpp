@@ -0,0 +1,198 @@
+#include "metrics.h"
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+std::vector<uint64_t> Histogram::latencyBuckets() {
+    return {100000ULL, 250000ULL, 500000ULL,
+            1000000ULL, 2500000ULL, 5000000ULL,
+            10000000ULL, 25000000ULL, 50000000ULL,
+            100000000ULL, 250000000ULL, 500000000ULL,
+            1000000000ULL, 2500000000ULL};
+}
+
+Histogram::Histogram(std::vector<uint64_t> bounds_ns)
+    : bounds_(std::move(bounds_ns)) {
+    if (bounds_.size() > MAX_BUCKETS) {
+        bounds_.resize(MAX_BUCKETS);
+    }
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snap;
+    snap.bounds_ns = bounds_;
+    snap.cumulative.assign(bounds_.size() + 1, 0);
+
+    std::vector<uint64_t> counts(bounds_.size() + 1, 0);
+    for (const auto& shard : shards_) {
+        for (size_t i = 0; i <= bounds_.size(); ++i) {
+            counts[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        snap.sum_ns += shard.sum_ns.load(std::memory_order_relaxed);
+    }
+
+    uint64_t running = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        running += counts[i];
+        snap.cumulative[i] = running;
+    }
+    snap.count = running;
+    return snap;
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<Counter> MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                                  const Labels& labels) {
+    return getOrCreate<Counter>(name, help, Type::Counter, labels);
+}
+
+std::shared_ptr<Gauge> MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                                              const Labels& labels) {
+    return getOrCreate<Gauge>(name, help, Type::Gauge, labels);
+}
+
+std::shared_ptr<Histogram> MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                                      const Labels& labels) {
+    return getOrCreate<Histogram>(name, help, Type::Histogram, labels);
+}
+
+template <typename T>
+std::shared_ptr<T> MetricsRegistry::getOrCreate(const std::string& name, const std::string& help,
+                                                Type type, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 只剩已销毁组件的序列时按本次注册重新设置；仍在使用的名称类型不同时返回不导出的独立指标，
+    // 避免把已有的对象当作另一种类型使用
+    Family& family = families_[name];
+    bool alive = false;
+    for (const auto& series : family.series) {
+        if (!series.second.expired()) {
+            alive = true;
+            break;
+        }
+    }
+    if (!alive) {
+        family.series.clear();
+        family.help = help;
+        family.type = type;
+    } else if (family.type != type) {
+        std::cerr << "Metric " << name << " is already registered with a different type, not exported" << std::endl;
+        return std::make_shared<T>();
+    }
+
+    std::string key = formatLabels(labels);
+    auto& slot = family.series[key];
+    if (auto existing = slot.lock()) {
+        return std::static_pointer_cast<T>(existing);
+    }
+
+    auto metric = std::make_shared<T>();
+    slot = metric;
+    return metric;
+}
+
+std::string MetricsRegistry::formatLabels(const Labels& labels) {
+    if (labels.empty()) {
+        return "";
+    }
+
+    std::string out = "{";
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (i > 0) {
+            out += ",";
+        }
+        out += labels[i].first + "=\"";
+        // 转义反斜杠、双引号和换行
+        for (char c : labels[i].second) {
+            if (c == '\\' || c == '"') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+        out += "\"";
+    }
+    out += "}";
+    return out;
+}
+
+// 在标签集合末尾追加一个标签（用于直方图的le）
+static std::string appendLabel(const std::string& labels, const std::string& extra) {
+    if (labels.empty()) {
+        return "{" + extra + "}";
+    }
+    return labels.substr(0, labels.size() - 1) + "," + extra + "}";
+}
+
+static std::string formatSeconds(uint64_t ns) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", static_cast<double>(ns) / 1e9);
+    return buf;
+}
+
+std::string MetricsRegistry::render() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+
+    for (auto family_it = families_.begin(); family_it != families_.end();) {
+        const std::string& name = family_it->first;
+        Family& family = family_it->second;
+
+        // 先移除已销毁组件的序列
+        for (auto it = family.series.begin(); it != family.series.end();) {
+            if (it->second.expired()) {
+                it = family.series.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (family.series.empty()) {
+            family_it = families_.erase(family_it);
+            continue;
+        }
+
+        const char* type = family.type == Type::Counter ? "counter"
+                         : family.type == Type::Gauge ? "gauge" : "histogram";
+        out << "# HELP " << name << " " << family.help << "\n";
+        out << "# TYPE " << name << " " << type << "\n";
+
+        for (const auto& series : family.series) {
+            auto metric = series.second.lock();
+            if (!metric) {
+                continue;
+            }
+
+            const std::string& labels = series.first;
+            switch (family.type) {
+                case Type::Counter:
+                    out << name << labels << " " << std::static_pointer_cast<Counter>(metric)->value() << "\n";
+                    break;
+                case Type::Gauge:
+                    out << name << labels << " " << std::static_pointer_cast<Gauge>(metric)->value() << "\n";
+                    break;
+                case Type::Histogram: {
+                    Histogram::Snapshot snap = std::static_pointer_cast<Histogram>(metric)->snapshot();
+                    for (size_t i = 0; i < snap.bounds_ns.size(); ++i) {
+                        out << name << "_bucket"
+                            << appendLabel(labels, "le=\"" + formatSeconds(snap.bounds_ns[i]) + "\"")
+                            << " " << snap.cumulative[i] << "\n";
+                    }
+                    out << name << "_bucket" << appendLabel(labels, "le=\"+Inf\"") << " " << snap.count << "\n";
+                    out << name << "_sum" << labels << " " << formatSeconds(snap.sum_ns) << "\n";
+                    out << name << "_count" << labels << " " << snap.count << "\n";
+                    break;
+                }
+            }
+        }
+        ++family_it;
+    }
+
+    return out.str();
+}
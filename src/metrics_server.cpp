@@ -0,0 +1,155 @@
+#include "metrics_server.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+MetricsServer::MetricsServer(MetricsRegistry& registry, int port, const std::string& bind_addr)
+    : registry_(registry), port_(port), bind_addr_(bind_addr), listen_fd_(-1), running_(false) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    if (running_) {
+        std::cerr << "Metrics server is already running" << std::endl;
+        return false;
+    }
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "Failed to create metrics socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    if (inet_pton(AF_INET, bind_addr_.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "Invalid metrics bind address: " << bind_addr_ << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd_, 8) < 0) {
+        std::cerr << "Failed to listen on " << bind_addr_ << ":" << port_
+                  << " for metrics: " << strerror(errno) << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    if (getsockname(listen_fd_, (struct sockaddr*)&addr, &len) == 0) {
+        port_ = ntohs(addr.sin_port);
+    }
+
+    running_ = true;
+    server_thread_ = std::thread(&MetricsServer::serveLoop, this);
+
+    std::cout << "Metrics endpoint: http://" << bind_addr_ << ":" << port_ << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+
+    if (server_thread_.joinable()) {
+        server_thread_.join();
+    }
+
+    close(listen_fd_);
+    listen_fd_ = -1;
+}
+
+bool MetricsServer::isRunning() const {
+    return running_;
+}
+
+int MetricsServer::getPort() const {
+    return port_;
+}
+
+void MetricsServer::serveLoop() {
+    while (running_) {
+        // 超时返回以便检查running_
+        struct pollfd pfd;
+        pfd.fd = listen_fd_;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, 500) <= 0) {
+            continue;
+        }
+
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+
+        handleConnection(fd);
+        close(fd);
+    }
+}
+
+void MetricsServer::handleConnection(int fd) {
+    // 慢客户端不能卡住服务线程
+    struct timeval tv;
+    tv.tv_sec = 2;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    // 只需要请求行，读到第一个换行即可
+    std::string request;
+    char buffer[1024];
+    while (request.find('\n') == std::string::npos && request.size() < 8192) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return;
+        }
+        request.append(buffer, n);
+    }
+
+    std::string status;
+    std::string content_type = "text/plain; charset=utf-8";
+    std::string body;
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0) {
+        status = "200 OK";
+        content_type = "text/plain; version=0.0.4; charset=utf-8";
+        body = registry_.render();
+    } else if (request.compare(0, 4, "GET ") == 0) {
+        status = "404 Not Found";
+        body = "not found\n";
+    } else {
+        status = "405 Method Not Allowed";
+        body = "method not allowed\n";
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\n"
+                           "Content-Type: " + content_type + "\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+
+    size_t offset = 0;
+    while (offset < response.size()) {
+        ssize_t n = send(fd, response.data() + offset, response.size() - offset, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return;
+        }
+        offset += n;
+    }
+}
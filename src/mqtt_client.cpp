@@ -1,11 +1,32 @@
 #include "mqtt_client.h"
+#include "thread_tuning.h"
+#include <algorithm>
 #include <iostream>
 #include <cstring>
 #include <thread>
 #include <chrono>
+#include <sys/epoll.h>
 
 MqttClient::MqttClient(const std::string& client_id, const std::string& broker, int port)
-    : broker_(broker), port_(port), connected_(false) {
+    : broker_(broker), port_(port), connected_(false), ever_connected_(false), network_tuned_(false),
+      publish_times_(new std::atomic<uint64_t>[PUBLISH_SLOTS]), inflight_count_(0), abandoned_count_(0),
+      mid_states_(new std::atomic<uint8_t>[MID_STATES]), draining_(false),
+      next_listener_id_(0), notifying_(false), tick_id_(-1), socket_fd_(-1), want_write_(false), reconnect_failing_(false) {
+
+    for (size_t i = 0; i < PUBLISH_SLOTS; ++i) {
+        publish_times_[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < MID_STATES; ++i) {
+        mid_states_[i].store(MID_IDLE, std::memory_order_relaxed);
+    }
+
+    // 同一客户端ID重建（如重载）时沿用同一组指标
+    MetricsRegistry::Labels labels = {{"client", client_id}};
+    MetricsRegistry& registry = MetricsRegistry::global();
+    publish_latency_ = registry.histogram("mqtt_publish_latency_seconds",
+                                          "Time from publish call to broker acknowledgement (QoS 1/2)", labels);
+    inflight_ = registry.gauge("mqtt_inflight_messages", "Published QoS 1/2 messages not yet acknowledged", labels);
+    reconnects_ = registry.counter("mqtt_reconnects_total", "Reconnections after the first successful connect", labels);
     
     // 初始化mosquitto库
     mosquitto_lib_init();
@@ -22,9 +43,13 @@ MqttClient::MqttClient(const std::string& client_id, const std::string& broker,
     mosquitto_connect_callback_set(mosq_, on_connect_callback);
     mosquitto_publish_callback_set(mosq_, on_publish_callback);
     mosquitto_disconnect_callback_set(mosq_, on_disconnect_callback);
+    mosquitto_message_callback_set(mosq_, on_message_callback);
 }
 
 MqttClient::~MqttClient() {
+    if (loop_) {
+        disconnect();
+    }
     if (mosq_) {
         mosquitto_destroy(mosq_);
     }
@@ -32,7 +57,21 @@ MqttClient::~MqttClient() {
 }
 
 bool MqttClient::connect() {
+    if (!connectAsync()) {
+        return false;
+    }
+
+    // 等待连接建立
+    return waitConnected(std::chrono::milliseconds(CONNECT_TIMEOUT_MS));
+}
+
+bool MqttClient::connectAsync() {
+    if (loop_) {
+        return connectReactor();
+    }
+
     // 启动网络循环（先启动线程，再异步连接）
+    network_tuned_ = false;
     int rc = mosquitto_loop_start(mosq_);
     if (rc != MOSQ_ERR_SUCCESS) {
         std::cerr << "Failed to start loop: " << mosquitto_strerror(rc) << std::endl;
@@ -47,63 +86,402 @@ bool MqttClient::connect() {
         mosquitto_loop_stop(mosq_, true);
         return false;
     }
-    
-    // 等待连接建立
-    int retry = 0;
-    while (!connected_ && retry < 5) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        retry++;
-    }
-    
+    return true;
+}
+
+bool MqttClient::waitConnected(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(connect_mutex_);
+    return connect_cv_.wait_for(lock, timeout, [this]() { return connected_.load(); });
+}
+
+bool MqttClient::isConnected() const {
     return connected_;
 }
 
-bool MqttClient::publish(const std::string& topic, const std::string& message, int qos) {
+int MqttClient::addConnectListener(ConnectCallback callback) {
+    std::lock_guard<std::mutex> lock(listeners_mutex_);
+    int id = next_listener_id_++;
+    connect_listeners_.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void MqttClient::removeConnectListener(int id) {
+    std::unique_lock<std::mutex> lock(listeners_mutex_);
+    for (auto it = connect_listeners_.begin(); it != connect_listeners_.end(); ++it) {
+        if (it->first == id) {
+            connect_listeners_.erase(it);
+            break;
+        }
+    }
+    // 回调可能正在使用调用方的对象，等本轮通知结束
+    listeners_cv_.wait(lock, [this] { return !notifying_; });
+}
+
+void MqttClient::setConnected(bool connected) {
+    {
+        std::lock_guard<std::mutex> lock(connect_mutex_);
+        connected_ = connected;
+    }
+    if (connected) {
+        connect_cv_.notify_all();
+    }
+}
+
+bool MqttClient::publish(const std::string& topic, const std::string& message, int qos, bool retain) {
     if (!connected_) {
         std::cerr << "Not connected to broker" << std::endl;
         return false;
     }
+
+    // QoS0快速路径：没有确认可等，直接交给libmosquitto写出（反应器模式下在本线程写入套接字缓冲区）；
+    // 写出回调与QoS1/2的确认共用mid，仍记录mid的状态，回调据此不把它当作确认
+    if (qos == 0) {
+        int mid;
+        int rc = mosquitto_publish(mosq_, &mid, topic.c_str(), message.length(), message.c_str(), 0, retain);
+        if (rc != MOSQ_ERR_SUCCESS) {
+            std::cerr << "Failed to publish: " << mosquitto_strerror(rc) << std::endl;
+            return false;
+        }
+        recordPublished(mid, 0);
+        if (loop_ && mosquitto_want_write(mosq_)) {
+            loop_->wake();
+        }
+        return true;
+    }
     
     int mid;
+    uint64_t start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
     int rc = mosquitto_publish(mosq_, &mid, topic.c_str(), 
-                               message.length(), message.c_str(), qos, false);
+                               message.length(), message.c_str(), qos, retain);
     
     if (rc != MOSQ_ERR_SUCCESS) {
         std::cerr << "Failed to publish: " << mosquitto_strerror(rc) << std::endl;
         return false;
     }
+
+    // 按mid低位记录发布时间，确认回调中计算延迟（在途超过槽数时部分样本被覆盖）；
+    // 回调先于这里执行时该条不计延迟，也不计入在途
+    std::atomic<uint64_t>& slot = publish_times_[mid & (PUBLISH_SLOTS - 1)];
+    slot.store(start_ns, std::memory_order_relaxed);
+    if (!recordPublished(mid, qos)) {
+        slot.compare_exchange_strong(start_ns, 0, std::memory_order_relaxed);
+    }
+
+    // 反应器模式下报文已直接写入套接字；没写完（或从其他线程发布）时唤醒事件循环关注可写
+    if (loop_ && mosquitto_want_write(mosq_)) {
+        loop_->wake();
+    }
     
     std::cout << "Message published successfully (mid: " << mid << ")" << std::endl;
     return true;
 }
 
+bool MqttClient::recordPublished(int mid, int qos) {
+    std::atomic<uint8_t>& state = mid_states_[mid & (MID_STATES - 1)];
+    uint8_t previous = state.exchange(qos > 0 ? MID_AWAITING_ACK : MID_SENT_QOS0);
+    if (previous == MID_CALLED_BACK) {
+        state.store(MID_IDLE);
+        return false;
+    }
+
+    // 同一mid的上一条QoS 1/2一直没有确认（断线后丢失）时，沿用它的在途计数
+    int64_t delta = (qos > 0 ? 1 : 0) - (previous == MID_AWAITING_ACK ? 1 : 0);
+    if (delta != 0) {
+        inflight_->add(delta);
+        inflight_count_ += delta;
+    }
+    return true;
+}
+
+void MqttClient::abandonInflight() {
+    int64_t abandoned = 0;
+    for (size_t i = 0; i < MID_STATES; ++i) {
+        uint8_t expected = MID_AWAITING_ACK;
+        if (mid_states_[i].compare_exchange_strong(expected, MID_ABANDONED)) {
+            abandoned++;
+        }
+    }
+    if (abandoned > 0) {
+        inflight_->add(-abandoned);
+        inflight_count_ -= abandoned;
+        abandoned_count_ += abandoned;
+    }
+}
+
 void MqttClient::disconnect() {
+    if (loop_) {
+        // 先从事件循环摘除，返回后循环线程不再访问本连接
+        if (tick_id_ >= 0) {
+            loop_->removeTick(tick_id_);
+            tick_id_ = -1;
+        }
+        if (socket_fd_ >= 0) {
+            loop_->remove(socket_fd_);
+            socket_fd_ = -1;
+        }
+        if (mosq_) {
+            mosquitto_disconnect(mosq_);
+        }
+        setConnected(false);
+        abandonInflight();
+        return;
+    }
+
     if (mosq_) {
-        mosquitto_loop_stop(mosq_, true);
-        mosquitto_disconnect(mosq_);
+        if (connected_) {
+            // 网络线程写出DISCONNECT（及之前排队的报文）后自行退出，不强制取消
+            mosquitto_disconnect(mosq_);
+            mosquitto_loop_stop(mosq_, false);
+        } else {
+            mosquitto_loop_stop(mosq_, true);
+            mosquitto_disconnect(mosq_);
+        }
+    }
+    setConnected(false);
+    abandonInflight();
+}
+
+int64_t MqttClient::drain(std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(drain_mutex_);
+    draining_ = true;
+    while (true) {
+        bool idle = inflight_count_ <= 0 && !(mosq_ && mosquitto_want_write(mosq_));
+        auto now = std::chrono::steady_clock::now();
+        if (idle || now >= deadline) {
+            break;
+        }
+        // 确认回调会唤醒；QoS0报文没有确认，按是否还有待写数据每10毫秒检查一次
+        drain_cv_.wait_until(lock, std::min(deadline, now + std::chrono::milliseconds(10)));
     }
-    connected_ = false;
+    draining_ = false;
+    return inflight_count_ > 0 ? inflight_count_.load() : 0;
+}
+
+int64_t MqttClient::getInflightCount() const {
+    return inflight_count_;
+}
+
+int64_t MqttClient::getAbandonedCount() const {
+    return abandoned_count_;
+}
+
+void MqttClient::setMessageCallback(MessageCallback callback) {
+    message_callback_ = callback;
+}
+
+void MqttClient::setEventLoop(std::shared_ptr<UdpEventLoop> loop) {
+    loop_ = loop;
+}
+
+std::shared_ptr<UdpEventLoop> MqttClient::getEventLoop() const {
+    return loop_;
+}
+
+bool MqttClient::connectReactor() {
+    // 没有网络线程，不做Network角色的线程调整（事件循环线程按Receive角色调整）
+    network_tuned_ = true;
+
+    // 异步连接只发起TCP连接并排队CONNECT报文，握手由事件循环完成
+    int rc = mosquitto_connect_async(mosq_, broker_.c_str(), port_, 60);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        std::cerr << "Failed to connect async: " << mosquitto_strerror(rc) << std::endl;
+        return false;
+    }
+
+    next_misc_ = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    tick_id_ = loop_->addTick([this]() { onTick(); });
+    loop_->wake();
+    return true;
+}
+
+void MqttClient::onSocketEvent(uint32_t events) {
+    if (events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+        mosquitto_loop_read(mosq_, 1);
+    }
+    if ((events & EPOLLOUT) && mosquitto_socket(mosq_) >= 0) {
+        mosquitto_loop_write(mosq_, 1);
+    }
+    syncSocket();
+}
+
+void MqttClient::onTick() {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= next_misc_) {
+        next_misc_ = now + std::chrono::seconds(1);
+
+        // 与libmosquitto网络线程的默认行为一致：断开后每秒重连一次
+        if (mosquitto_socket(mosq_) < 0) {
+            int rc = mosquitto_reconnect_async(mosq_);
+            if (rc != MOSQ_ERR_SUCCESS && !reconnect_failing_) {
+                std::cerr << "Failed to reconnect (retrying every second): " << mosquitto_strerror(rc) << std::endl;
+            }
+            reconnect_failing_ = rc != MOSQ_ERR_SUCCESS;
+        }
+
+        // 保活（PINGREQ）和超时检查
+        mosquitto_loop_misc(mosq_);
+    }
+    syncSocket();
+}
+
+void MqttClient::syncSocket() {
+    int sock = mosquitto_socket(mosq_);
+
+    // 连接断开时libmosquitto已关闭套接字，重连后是新的套接字
+    if (sock != socket_fd_) {
+        if (socket_fd_ >= 0) {
+            loop_->remove(socket_fd_);
+            socket_fd_ = -1;
+        }
+        if (sock >= 0) {
+            want_write_ = mosquitto_want_write(mosq_);
+            if (loop_->add(sock, EPOLLIN | (want_write_ ? EPOLLOUT : 0u),
+                           [this](uint32_t events) { onSocketEvent(events); })) {
+                socket_fd_ = sock;
+            }
+        }
+        return;
+    }
+
+    if (socket_fd_ >= 0) {
+        bool want_write = mosquitto_want_write(mosq_);
+        if (want_write != want_write_ && loop_->modify(socket_fd_, EPOLLIN | (want_write ? EPOLLOUT : 0u))) {
+            want_write_ = want_write;
+        }
+    }
+}
+
+bool MqttClient::subscribe(const std::string& topic, int qos) {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    subscriptions_.emplace_back(topic, qos);
+
+    if (!connected_) {
+        return true;
+    }
+
+    int rc = mosquitto_subscribe(mosq_, nullptr, topic.c_str(), qos);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        std::cerr << "Failed to subscribe to " << topic << ": " << mosquitto_strerror(rc) << std::endl;
+        return false;
+    }
+
+    std::cout << "Subscribed to topic: " << topic << std::endl;
+    return true;
+}
+
+bool MqttClient::topicMatches(const std::string& filter, const std::string& topic) {
+    size_t f = 0;
+    size_t t = 0;
+
+    while (f < filter.size()) {
+        size_t f_end = filter.find('/', f);
+        if (f_end == std::string::npos) f_end = filter.size();
+        std::string level = filter.substr(f, f_end - f);
+
+        if (level == "#") {
+            return true;
+        }
+
+        if (t > topic.size()) {
+            return false;
+        }
+        size_t t_end = topic.find('/', t);
+        if (t_end == std::string::npos) t_end = topic.size();
+
+        if (level != "+" && level != topic.substr(t, t_end - t)) {
+            return false;
+        }
+
+        f = f_end + 1;
+        t = t_end + 1;
+    }
+
+    return t > topic.size();
 }
 
 void MqttClient::on_connect_callback(struct mosquitto* mosq, void* obj, int result) {
     MqttClient* client = static_cast<MqttClient*>(obj);
+
+    // 网络线程由mosquitto_loop_start创建，拿不到线程句柄，在其首次回调中调整
+    if (!client->network_tuned_) {
+        client->network_tuned_ = true;
+        ThreadTuning::apply(ThreadTuning::Role::Network, "mqtt-net");
+    }
     
     if (result == 0) {
         std::cout << "Connected to broker successfully" << std::endl;
-        client->connected_ = true;
+        client->setConnected(true);
+        if (client->ever_connected_.exchange(true)) {
+            client->reconnects_->add(1);
+        }
+
+        // 重新订阅（clean session下重连后订阅会丢失）
+        {
+            std::lock_guard<std::mutex> lock(client->subscriptions_mutex_);
+            for (const auto& sub : client->subscriptions_) {
+                int rc = mosquitto_subscribe(mosq, nullptr, sub.first.c_str(), sub.second);
+                if (rc != MOSQ_ERR_SUCCESS) {
+                    std::cerr << "Failed to subscribe to " << sub.first << ": " << mosquitto_strerror(rc) << std::endl;
+                }
+            }
+        }
+
+        // 按注册顺序通知（如发布连接建立前缓冲的消息）；回调可能较长，不持锁执行，
+        // 期间注册和移除回调的调用方不被阻塞（移除时等待本轮结束）
+        std::vector<std::pair<int, ConnectCallback>> listeners;
+        {
+            std::lock_guard<std::mutex> lock(client->listeners_mutex_);
+            listeners = client->connect_listeners_;
+            client->notifying_ = true;
+        }
+        for (const auto& listener : listeners) {
+            listener.second();
+        }
+        {
+            std::lock_guard<std::mutex> lock(client->listeners_mutex_);
+            client->notifying_ = false;
+        }
+        client->listeners_cv_.notify_all();
     } else {
         std::cerr << "Connection failed with code: " << result << std::endl;
-        client->connected_ = false;
+        client->setConnected(false);
     }
 }
 
 void MqttClient::on_publish_callback(struct mosquitto* mosq, void* obj, int mid) {
+    MqttClient* client = static_cast<MqttClient*>(obj);
+
+    // QoS0写出后同样会回调，不计在途和延迟；发布方还没记录时留下标记，由发布方清除
+    std::atomic<uint8_t>& state = client->mid_states_[mid & (MID_STATES - 1)];
+    uint8_t previous = state.load();
+    while (!state.compare_exchange_weak(previous, previous == MID_IDLE ? MID_CALLED_BACK : MID_IDLE)) {
+    }
+    if (previous != MID_AWAITING_ACK) {
+        return;
+    }
+
+    client->inflight_->add(-1);
+    client->inflight_count_--;
+    if (client->draining_) {
+        std::lock_guard<std::mutex> lock(client->drain_mutex_);
+        client->drain_cv_.notify_all();
+    }
+    uint64_t start_ns = client->publish_times_[mid & (PUBLISH_SLOTS - 1)].exchange(0, std::memory_order_relaxed);
+    if (start_ns != 0) {
+        uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        client->publish_latency_->observe(now_ns - start_ns);
+    }
+
     std::cout << "Message with mid " << mid << " has been published" << std::endl;
 }
 
 void MqttClient::on_disconnect_callback(struct mosquitto* mosq, void* obj, int rc) {
     MqttClient* client = static_cast<MqttClient*>(obj);
-    client->connected_ = false;
+    client->setConnected(false);
+    // 意外断开时libmosquitto保留未确认的QoS1/2消息，自动重连后重发，仍计入在途；
+    // 只有主动断开（disconnect()）才放弃它们
     
     if (rc == 0) {
         std::cout << "Disconnected successfully" << std::endl;
@@ -111,3 +489,14 @@ void MqttClient::on_disconnect_callback(struct mosquitto* mosq, void* obj, int r
         std::cerr << "Unexpected disconnect: " << mosquitto_strerror(rc) << std::endl;
     }
 }
+
+void MqttClient::on_message_callback(struct mosquitto* mosq, void* obj, const struct mosquitto_message* message) {
+    (void)mosq;
+    MqttClient* client = static_cast<MqttClient*>(obj);
+    if (!client->message_callback_) {
+        return;
+    }
+
+    std::string payload(static_cast<const char*>(message->payload), message->payloadlen);
+    client->message_callback_(message->topic, payload);
+}
@@ -0,0 +1,131 @@
+#include "mqtt_connection_pool.h"
+#include <chrono>
+#include <iostream>
+
+MqttConnectionPool::MqttConnectionPool(const std::string& client_id, const std::string& broker,
+                                       int port, size_t size)
+    : client_id_(client_id), broker_(broker), port_(port), next_(0) {
+    if (size == 0) {
+        size = 1;
+    }
+
+    // 单连接时沿用原客户端ID，与未使用连接池时保持一致
+    for (size_t i = 0; i < size; ++i) {
+        std::string id = size == 1 ? client_id : client_id + "_" + std::to_string(i);
+        clients_.push_back(std::make_shared<MqttClient>(id, broker, port));
+    }
+}
+
+MqttConnectionPool::~MqttConnectionPool() {
+    setConnectCallback(nullptr);
+    disconnect();
+}
+
+void MqttConnectionPool::setEventLoops(const std::vector<std::shared_ptr<UdpEventLoop>>& loops) {
+    if (loops.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < clients_.size(); ++i) {
+        clients_[i]->setEventLoop(loops[i % loops.size()]);
+    }
+}
+
+bool MqttConnectionPool::connect(bool wait) {
+    std::cout << "Connecting " << clients_.size() << " pooled MQTT connection(s) to "
+              << broker_ << ":" << port_ << std::endl;
+
+    // 先全部发起，握手并行进行
+    size_t failed = clients_.size();
+    for (size_t i = 0; i < clients_.size() && failed == clients_.size(); ++i) {
+        if (!clients_[i]->connectAsync()) {
+            failed = i;
+        }
+    }
+    if (wait) {
+        for (size_t i = 0; i < clients_.size() && failed == clients_.size(); ++i) {
+            if (!clients_[i]->waitConnected(std::chrono::milliseconds(MqttClient::CONNECT_TIMEOUT_MS))) {
+                failed = i;
+            }
+        }
+    }
+
+    if (failed != clients_.size()) {
+        std::cerr << "Failed to connect pooled MQTT connection " << failed << std::endl;
+        disconnect();
+        return false;
+    }
+    return true;
+}
+
+bool MqttConnectionPool::isConnected() const {
+    for (const auto& client : clients_) {
+        if (!client->isConnected()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MqttConnectionPool::setConnectCallback(MqttClient::ConnectCallback callback) {
+    for (size_t i = 0; i < listener_ids_.size(); ++i) {
+        clients_[i]->removeConnectListener(listener_ids_[i]);
+    }
+    listener_ids_.clear();
+
+    if (!callback) {
+        return;
+    }
+    for (auto& client : clients_) {
+        listener_ids_.push_back(client->addConnectListener(callback));
+    }
+}
+
+void MqttConnectionPool::disconnect() {
+    for (auto& client : clients_) {
+        client->disconnect();
+    }
+}
+
+int64_t MqttConnectionPool::drain(std::chrono::steady_clock::time_point deadline) {
+    int64_t unacknowledged = 0;
+    for (auto& client : clients_) {
+        unacknowledged += client->drain(deadline);
+    }
+    return unacknowledged;
+}
+
+int64_t MqttConnectionPool::getInflightCount() const {
+    int64_t inflight = 0;
+    for (const auto& client : clients_) {
+        inflight += client->getInflightCount();
+    }
+    return inflight;
+}
+
+int64_t MqttConnectionPool::getAbandonedCount() const {
+    int64_t abandoned = 0;
+    for (const auto& client : clients_) {
+        abandoned += client->getAbandonedCount();
+    }
+    return abandoned;
+}
+
+std::shared_ptr<MqttClient> MqttConnectionPool::acquire() {
+    return clients_[next_++ % clients_.size()];
+}
+
+size_t MqttConnectionPool::size() const {
+    return clients_.size();
+}
+
+const std::string& MqttConnectionPool::getBroker() const {
+    return broker_;
+}
+
+int MqttConnectionPool::getPort() const {
+    return port_;
+}
+
+const std::string& MqttConnectionPool::getClientId() const {
+    return client_id_;
+}
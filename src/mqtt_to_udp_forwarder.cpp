@@ -0,0 +1,167 @@
+#include "mqtt_to_udp_forwarder.h"
+#include <iostream>
+#include <vector>
+#include <tuple>
+
+bool MqttToUdpForwarder::Config::operator==(const Config& other) const {
+    return std::tie(enabled, topic, qos, multicast_addr, multicast_port, interface, ttl, loopback, queue_size) ==
+           std::tie(other.enabled, other.topic, other.qos, other.multicast_addr, other.multicast_port,
+                    other.interface, other.ttl, other.loopback, other.queue_size);
+}
+
+MqttToUdpForwarder::MqttToUdpForwarder(const std::string& mqtt_client_id,
+                                       const std::string& mqtt_broker,
+                                       int mqtt_port,
+                                       const Config& config)
+    : config_(config),
+      running_(false) {
+
+    MetricsRegistry::Labels labels = {{"topic", config.topic}};
+    MetricsRegistry& registry = MetricsRegistry::global();
+    received_count_ = registry.counter("reverse_received_messages_total", "MQTT messages received by the reverse bridge", labels);
+    dropped_count_ = registry.counter("reverse_dropped_messages_total", "Messages dropped because the send queue was full", labels);
+    queue_depth_ = registry.gauge("reverse_queue_depth", "Messages waiting to be sent as UDP multicast", labels);
+
+    mqtt_client_ = std::make_unique<MqttClient>(mqtt_client_id, mqtt_broker, mqtt_port);
+    udp_sender_ = std::make_unique<UdpSender>(config.multicast_addr, config.multicast_port,
+                                              config.interface, config.ttl, config.loopback);
+}
+
+MqttToUdpForwarder::~MqttToUdpForwarder() {
+    stop();
+}
+
+bool MqttToUdpForwarder::start() {
+    if (running_) {
+        std::cerr << "Reverse forwarder is already running" << std::endl;
+        return false;
+    }
+
+    std::cout << "Starting MQTT to UDP forwarder..." << std::endl;
+
+    if (!udp_sender_->open()) {
+        std::cerr << "Failed to open UDP sender" << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    send_thread_ = std::thread(&MqttToUdpForwarder::sendLoop, this);
+
+    mqtt_client_->setMessageCallback([this](const std::string& topic, const std::string& payload) {
+        this->onMqttMessageReceived(topic, payload);
+    });
+    mqtt_client_->subscribe(config_.topic, config_.qos);
+
+    if (!mqtt_client_->connect()) {
+        std::cerr << "Failed to connect reverse forwarder to MQTT broker" << std::endl;
+        stop();
+        return false;
+    }
+
+    std::cout << "Forwarding MQTT topic " << config_.topic << " to UDP "
+              << config_.multicast_addr << ":" << config_.multicast_port << std::endl;
+    return true;
+}
+
+void MqttToUdpForwarder::stop() {
+    if (!running_) {
+        return;
+    }
+
+    std::cout << "Stopping MQTT to UDP forwarder..." << std::endl;
+
+    // 先断开MQTT，不再有新消息进入队列
+    mqtt_client_->disconnect();
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+
+    if (send_thread_.joinable()) {
+        send_thread_.join();
+    }
+
+    udp_sender_->close();
+
+    std::cout << "MQTT to UDP forwarder stopped" << std::endl;
+    std::cout << "Reverse statistics: Received: " << received_count_->value()
+              << ", Sent: " << getSentMessageCount()
+              << ", Failed: " << getFailedMessageCount()
+              << ", Batches: " << getSendBatchCount() << std::endl;
+}
+
+bool MqttToUdpForwarder::isRunning() const {
+    return running_;
+}
+
+bool MqttToUdpForwarder::createsLoop(const Config& config, const std::string& forward_topic,
+                                     const std::string& forward_addr, int forward_port) {
+    // 订阅到正向发布的主题：组播 -> MQTT -> 组播 -> ...
+    if (MqttClient::topicMatches(config.topic, forward_topic)) {
+        return true;
+    }
+
+    // 回环发送到正向接收的组：本机正向转发器会再次收到
+    return config.loopback && config.multicast_addr == forward_addr &&
+           config.multicast_port == forward_port;
+}
+
+uint64_t MqttToUdpForwarder::getReceivedMessageCount() const {
+    return received_count_->value();
+}
+
+uint64_t MqttToUdpForwarder::getSentMessageCount() const {
+    return udp_sender_->getSentCount();
+}
+
+uint64_t MqttToUdpForwarder::getFailedMessageCount() const {
+    return udp_sender_->getFailedCount() + dropped_count_->value();
+}
+
+uint64_t MqttToUdpForwarder::getSendBatchCount() const {
+    return udp_sender_->getSyscallCount();
+}
+
+void MqttToUdpForwarder::onMqttMessageReceived(const std::string& topic, const std::string& payload) {
+    received_count_->add(1);
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (queue_.size() >= config_.queue_size) {
+            dropped_count_->add(1);
+            std::cerr << "[Reverse] Send queue full, dropping message from " << topic << std::endl;
+            return;
+        }
+        queue_.push_back(payload);
+        queue_depth_->set(queue_.size());
+    }
+    queue_cv_.notify_one();
+}
+
+void MqttToUdpForwarder::sendLoop() {
+    std::deque<std::string> pending;
+    std::vector<std::string> batch;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !queue_.empty() || !running_; });
+            if (queue_.empty()) {
+                break;
+            }
+            // 一次取走全部待发消息
+            pending.swap(queue_);
+            queue_depth_->set(0);
+        }
+
+        batch.clear();
+        while (!pending.empty()) {
+            batch.push_back(std::move(pending.front()));
+            pending.pop_front();
+        }
+
+        udp_sender_->sendBatch(batch, batch.size());
+    }
+}
@@ -0,0 +1,111 @@
+#include "packet_buffer.h"
+#include <cstring>
+#include <utility>
+
+PacketRef::PacketRef(PacketBuffer* buffer) noexcept : buffer_(buffer) {
+    buffer_->refs_.store(1, std::memory_order_relaxed);
+}
+
+PacketRef::PacketRef(const PacketRef& other) noexcept : buffer_(other.buffer_) {
+    if (buffer_) {
+        buffer_->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PacketRef::PacketRef(PacketRef&& other) noexcept : buffer_(other.buffer_) {
+    other.buffer_ = nullptr;
+}
+
+PacketRef& PacketRef::operator=(const PacketRef& other) noexcept {
+    if (buffer_ != other.buffer_) {
+        PacketRef copy(other);
+        std::swap(buffer_, copy.buffer_);
+    }
+    return *this;
+}
+
+PacketRef& PacketRef::operator=(PacketRef&& other) noexcept {
+    if (this != &other) {
+        reset();
+        buffer_ = other.buffer_;
+        other.buffer_ = nullptr;
+    }
+    return *this;
+}
+
+PacketRef::~PacketRef() {
+    reset();
+}
+
+void PacketRef::reset() noexcept {
+    if (!buffer_) {
+        return;
+    }
+    // 各输出端在不同线程中释放，最后一个释放者看到其他线程对缓冲的全部读取已完成
+    if (buffer_->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        buffer_->pool_->recycle(buffer_);
+    }
+    buffer_ = nullptr;
+}
+
+uint32_t PacketRef::useCount() const noexcept {
+    return buffer_ ? buffer_->refs_.load(std::memory_order_relaxed) : 0;
+}
+
+PacketBufferPool::PacketBufferPool(size_t max_free)
+    : max_free_(max_free), allocated_count_(0), reused_count_(0) {
+}
+
+PacketBufferPool::~PacketBufferPool() {
+    for (PacketBuffer* buffer : free_) {
+        delete buffer;
+    }
+}
+
+PacketRef PacketBufferPool::acquire(const char* data, size_t len, const struct sockaddr_storage& source,
+                                    uint64_t rx_ts_ns) {
+    PacketBuffer* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            buffer = free_.back();
+            free_.pop_back();
+        }
+    }
+    if (buffer) {
+        reused_count_++;
+    } else {
+        buffer = new PacketBuffer(this);
+        allocated_count_++;
+    }
+
+    // 复用的缓冲保留了之前的容量，同样大小的报文不再重新分配
+    buffer->data.assign(data, len);
+    memcpy(&buffer->source, &source, sizeof(source));
+    buffer->rx_ts_ns = rx_ts_ns;
+    return PacketRef(buffer);
+}
+
+void PacketBufferPool::recycle(PacketBuffer* buffer) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.size() < max_free_) {
+            free_.push_back(buffer);
+            return;
+        }
+    }
+    delete buffer;
+}
+
+uint64_t PacketBufferPool::getAllocatedCount() const {
+    return allocated_count_;
+}
+
+uint64_t PacketBufferPool::getReusedCount() const {
+    return reused_count_;
+}
+
+size_t PacketBufferPool::getFreeCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+}
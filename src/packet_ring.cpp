@@ -0,0 +1,226 @@
+#include "packet_ring.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+// 放行的报文长度上限（过滤器返回值），实际受块大小限制
+static const uint32_t SNAP_LENGTH = 0x40000;
+
+bool PacketRing::Config::operator==(const Config& other) const {
+    return std::tie(block_size, block_count, block_timeout_ms) ==
+           std::tie(other.block_size, other.block_count, other.block_timeout_ms);
+}
+
+PacketRing::PacketRing(const Config& config)
+    : config_(config), fd_(-1), map_(nullptr), map_size_(0), current_(0) {
+}
+
+PacketRing::~PacketRing() {
+    close();
+}
+
+bool PacketRing::open(const struct sockaddr_storage& group, unsigned int ifindex) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (config_.block_size == 0 || config_.block_size % page_size != 0 || config_.block_count == 0) {
+        std::cerr << "Packet ring block size must be a multiple of " << page_size << " bytes" << std::endl;
+        return false;
+    }
+
+    // 协议为0时还不接收任何报文，过滤器和环形缓冲区就绪后在bind()中指定协议
+    fd_ = socket(AF_PACKET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        std::cerr << "Failed to create packet socket (needs CAP_NET_RAW): " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(fd_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        std::cerr << "TPACKET_V3 not supported: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+#ifdef PACKET_IGNORE_OUTGOING
+    // 本机发出的报文由组播回环交给普通套接字，环形缓冲区只读取网卡收到的
+    int ignore_outgoing = 1;
+    setsockopt(fd_, SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignore_outgoing, sizeof(ignore_outgoing));
+#endif
+
+    if (!attachFilter(group)) {
+        close();
+        return false;
+    }
+
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = static_cast<unsigned int>(config_.block_size);
+    req.tp_block_nr = static_cast<unsigned int>(config_.block_count);
+    req.tp_frame_size = TPACKET_ALIGNMENT << 7;
+    req.tp_frame_nr = static_cast<unsigned int>(config_.block_size / req.tp_frame_size * config_.block_count);
+    req.tp_retire_blk_tov = static_cast<unsigned int>(config_.block_timeout_ms);
+    if (setsockopt(fd_, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        std::cerr << "Failed to create packet ring: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    map_size_ = config_.block_size * config_.block_count;
+    void* map = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "Failed to map packet ring: " << strerror(errno) << std::endl;
+        map_size_ = 0;
+        close();
+        return false;
+    }
+    map_ = static_cast<char*>(map);
+    current_ = 0;
+
+    struct sockaddr_ll addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(group.ss_family == AF_INET6 ? ETH_P_IPV6 : ETH_P_IP);
+    addr.sll_ifindex = static_cast<int>(ifindex);
+    if (bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Failed to bind packet socket: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    std::cout << "Packet ring ready: " << config_.block_count << " x " << config_.block_size << " bytes"
+              << (ifindex != 0 ? " on interface index " + std::to_string(ifindex) : " on all interfaces")
+              << std::endl;
+    return true;
+}
+
+void PacketRing::close() {
+    if (map_) {
+        munmap(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+int PacketRing::fd() const {
+    return fd_;
+}
+
+uint64_t PacketRing::takeDrops() {
+    // 内核在读取后清零统计
+    struct tpacket_stats_v3 stats;
+    socklen_t len = sizeof(stats);
+    if (fd_ < 0 || getsockopt(fd_, SOL_PACKET, PACKET_STATISTICS, &stats, &len) < 0) {
+        return 0;
+    }
+    return stats.tp_drops;
+}
+
+bool PacketRing::attachFilter(const struct sockaddr_storage& group) {
+    // SOCK_DGRAM的包套接字上过滤器从网络层头开始
+    std::vector<struct sock_filter> program;
+    if (group.ss_family == AF_INET6) {
+        const auto& sin6 = reinterpret_cast<const struct sockaddr_in6&>(group);
+        uint32_t words[4];
+        memcpy(words, &sin6.sin6_addr, sizeof(words));
+        program = {
+            BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 6),                      // 下一个头
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 11),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 24),                     // 目的地址
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohl(words[0]), 0, 9),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 28),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohl(words[1]), 0, 7),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 32),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohl(words[2]), 0, 5),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 36),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohl(words[3]), 0, 3),
+            BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 42),                     // UDP目的端口
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohs(sin6.sin6_port), 0, 1),
+            BPF_STMT(BPF_RET | BPF_K, SNAP_LENGTH),
+            BPF_STMT(BPF_RET | BPF_K, 0),
+        };
+    } else {
+        const auto& sin = reinterpret_cast<const struct sockaddr_in&>(group);
+        program = {
+            BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9),                      // 协议
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 8),
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 16),                     // 目的地址
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohl(sin.sin_addr.s_addr), 0, 6),
+            BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 6),                      // MF标志和片偏移
+            BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x3fff, 4, 0),
+            BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),                     // X = IP头长度
+            BPF_STMT(BPF_LD | BPF_H | BPF_IND, 2),                      // UDP目的端口
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohs(sin.sin_port), 0, 1),
+            BPF_STMT(BPF_RET | BPF_K, SNAP_LENGTH),
+            BPF_STMT(BPF_RET | BPF_K, 0),
+        };
+    }
+
+    struct sock_fprog fprog;
+    fprog.len = static_cast<unsigned short>(program.size());
+    fprog.filter = program.data();
+    if (setsockopt(fd_, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) < 0) {
+        std::cerr << "Failed to attach packet filter: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool PacketRing::parseFrame(const struct tpacket3_hdr* packet, Frame& frame) {
+    const uint8_t* net = reinterpret_cast<const uint8_t*>(packet) + packet->tp_net;
+    size_t captured = packet->tp_snaplen;
+    if (captured < 1) {
+        return false;
+    }
+
+    memset(&frame.source, 0, sizeof(frame.source));
+    size_t header_len;
+    uint8_t version = net[0] >> 4;
+    if (version == 4) {
+        header_len = static_cast<size_t>(net[0] & 0x0f) * 4;
+        if (captured < header_len + 8) {
+            return false;
+        }
+        auto& sin = reinterpret_cast<struct sockaddr_in&>(frame.source);
+        sin.sin_family = AF_INET;
+        memcpy(&sin.sin_addr, net + 12, sizeof(sin.sin_addr));
+        memcpy(&sin.sin_port, net + header_len, sizeof(sin.sin_port));
+    } else if (version == 6) {
+        header_len = 40;
+        if (captured < header_len + 8) {
+            return false;
+        }
+        auto& sin6 = reinterpret_cast<struct sockaddr_in6&>(frame.source);
+        sin6.sin6_family = AF_INET6;
+        memcpy(&sin6.sin6_addr, net + 8, sizeof(sin6.sin6_addr));
+        memcpy(&sin6.sin6_port, net + header_len, sizeof(sin6.sin6_port));
+    } else {
+        return false;
+    }
+
+    const uint8_t* udp = net + header_len;
+    uint16_t udp_len;
+    memcpy(&udp_len, udp + 4, sizeof(udp_len));
+    udp_len = ntohs(udp_len);
+    if (udp_len < 8) {
+        return false;
+    }
+
+    size_t payload_len = udp_len - 8;
+    size_t available = captured - header_len - 8;
+    frame.data = reinterpret_cast<const char*>(udp + 8);
+    frame.truncated = payload_len > available;
+    frame.len = frame.truncated ? available : payload_len;
+    frame.rx_ts_ns = static_cast<uint64_t>(packet->tp_sec) * 1000000000ULL + packet->tp_nsec;
+    return true;
+}
@@ -0,0 +1,191 @@
+#include "pipeline.h"
+#include "json_field.h"
+#include <cstdio>
+#include <string_view>
+#include <tuple>
+
+namespace {
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// 找到对象的右括号位置，非对象返回npos；empty表示对象没有成员
+size_t findClosingBrace(const std::string& json, bool& empty) {
+    size_t first = json.find_first_not_of(" \t\n\r");
+    size_t last = json.find_last_not_of(" \t\n\r");
+    if (first == std::string::npos || json[first] != '{' || json[last] != '}' || last == first) {
+        return std::string::npos;
+    }
+
+    size_t before = last - 1;
+    while (before > first && isWhitespace(json[before])) {
+        --before;
+    }
+    empty = (before == first);
+    return last;
+}
+
+template <typename Buffer>
+void appendKey(Buffer& out, const std::string& key) {
+    out.push_back('"');
+    out.append(key);
+    out.append("\":");
+}
+
+// 按列出顺序把找到的字段拼成新对象
+template <typename Buffer>
+void projectInto(const std::string& payload, const std::vector<std::string>& fields, Buffer& out) {
+    out.reserve(payload.size());
+    out.push_back('{');
+    for (const auto& field : fields) {
+        std::string_view value;
+        if (!findJsonFieldRaw(payload, field, value)) {
+            continue;
+        }
+        if (out.size() > 1) {
+            out.push_back(',');
+        }
+        appendKey(out, field);
+        out.append(value.data(), value.size());
+    }
+    out.push_back('}');
+}
+
+} // namespace
+
+bool FieldMatch::operator()(const PipelineMessage& message) const {
+    std::string_view found;
+    if (!findJsonField(message.payload, field, found)) {
+        return false;
+    }
+    return !compare_value || found == value;
+}
+
+bool ProjectFields::operator()(PipelineMessage& message) const {
+    bool empty;
+    if (findClosingBrace(message.payload, empty) == std::string::npos) {
+        return true;
+    }
+
+    if (message.arena) {
+        ArenaString projected{ArenaAllocator<char>(*message.arena)};
+        projectInto(message.payload, fields, projected);
+        message.payload.assign(projected.data(), projected.size());
+        return true;
+    }
+
+    std::string projected;
+    projectInto(message.payload, fields, projected);
+    message.payload = std::move(projected);
+    return true;
+}
+
+bool EnrichFields::operator()(PipelineMessage& message) const {
+    bool empty;
+    size_t brace = findClosingBrace(message.payload, empty);
+    if (brace == std::string::npos) {
+        return true;
+    }
+
+    // 只移动右括号及其后的空白：截到右括号处，直接追加注入的字段，再接回右括号，
+    // 原有内容不移动也不重新解析；调用方预留了空间时不会重新分配
+    std::string tail = message.payload.substr(brace);
+    message.payload.resize(brace);
+    appendFields(message, empty);
+    message.payload.append(tail);
+    return true;
+}
+
+void EnrichFields::appendFields(PipelineMessage& message, bool empty) const {
+    std::string& out = message.payload;
+    auto separate = [&out, &empty]() {
+        if (!empty) {
+            out.push_back(',');
+        }
+        empty = false;
+    };
+    if (!timestamp_field.empty()) {
+        separate();
+        appendKey(out, timestamp_field);
+        char digits[24];
+        int len = snprintf(digits, sizeof(digits), "%llu", static_cast<unsigned long long>(message.rx_ts_ns));
+        out.append(digits, len);
+    }
+    if (!source_field.empty() && !message.source.empty()) {
+        separate();
+        appendKey(out, source_field);
+        out.push_back('"');
+        out.append(message.source);
+        out.push_back('"');
+    }
+    for (const auto& constant : constants) {
+        separate();
+        appendKey(out, constant.first);
+        out.append(constant.second);
+    }
+}
+
+bool RuntimePipeline::Stage::operator==(const Stage& other) const {
+    return std::tie(type, field, compare_value, equals, fields, timestamp_field, source_field, constants) ==
+           std::tie(other.type, other.field, other.compare_value, other.equals, other.fields,
+                    other.timestamp_field, other.source_field, other.constants);
+}
+
+bool RuntimePipeline::Config::operator==(const Config& other) const {
+    return stages == other.stages;
+}
+
+RuntimePipeline::RuntimePipeline(const Config& config) : uses_source_(false) {
+    stages_.reserve(config.stages.size());
+    for (const auto& stage : config.stages) {
+        FieldMatch match{stage.field, stage.compare_value, stage.equals};
+        switch (stage.type) {
+        case Stage::Type::DropIf:
+            stages_.emplace_back(DropIf<FieldMatch>{match});
+            break;
+        case Stage::Type::KeepIf:
+            stages_.emplace_back(KeepIf<FieldMatch>{match});
+            break;
+        case Stage::Type::Project:
+            stages_.emplace_back(ProjectFields{stage.fields});
+            break;
+        case Stage::Type::Enrich:
+            stages_.emplace_back(EnrichFields{stage.timestamp_field, stage.source_field, stage.constants});
+            uses_source_ = uses_source_ || !stage.source_field.empty();
+            break;
+        }
+    }
+}
+
+bool RuntimePipeline::apply(PipelineMessage& message) const {
+    for (const auto& stage : stages_) {
+        if (!std::visit([&message](const auto& s) { return s(message); }, stage)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t RuntimePipeline::size() const {
+    return stages_.size();
+}
+
+bool RuntimePipeline::usesSource() const {
+    return uses_source_;
+}
+
+bool RuntimePipeline::parseType(const std::string& name, Stage::Type& type) {
+    if (name == "drop_if") {
+        type = Stage::Type::DropIf;
+    } else if (name == "keep_if") {
+        type = Stage::Type::KeepIf;
+    } else if (name == "project") {
+        type = Stage::Type::Project;
+    } else if (name == "enrich") {
+        type = Stage::Type::Enrich;
+    } else {
+        return false;
+    }
+    return true;
+}
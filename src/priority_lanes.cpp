@@ -0,0 +1,255 @@
+#include "priority_lanes.h"
+#include "json_field.h"
+#include "thread_tuning.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <tuple>
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool PriorityLanes::Lane::operator==(const Lane& other) const {
+    return std::tie(name, topics, field, values, weight, capacity) ==
+           std::tie(other.name, other.topics, other.field, other.values, other.weight, other.capacity);
+}
+
+bool PriorityLanes::Config::operator==(const Config& other) const {
+    return std::tie(enabled, policy, lanes) == std::tie(other.enabled, other.policy, other.lanes);
+}
+
+PriorityLanes::PriorityLanes(const Config& config)
+    : policy_(config.policy), queued_(0), current_(0), credit_(0), next_source_(0), running_(false) {
+    // 没有配置通道时所有消息进入同一个默认通道
+    std::vector<Lane> lanes = config.lanes;
+    if (lanes.empty()) {
+        Lane lane;
+        lane.name = "default";
+        lanes.push_back(lane);
+    }
+
+    MetricsRegistry& registry = MetricsRegistry::global();
+    for (const auto& lane : lanes) {
+        LaneState state;
+        state.config = lane;
+        MetricsRegistry::Labels labels = {{"lane", lane.name}};
+        state.delay = registry.histogram("lane_queue_delay_seconds",
+                                         "Time messages spend queued in a priority lane before publishing", labels);
+        state.depth = registry.gauge("lane_queue_depth", "Messages waiting in a priority lane", labels);
+        state.dropped = registry.counter("lane_dropped_messages_total",
+                                         "Messages dropped because the priority lane was full", labels);
+        lanes_.push_back(std::move(state));
+    }
+    credit_ = lanes_.front().config.weight;
+}
+
+PriorityLanes::~PriorityLanes() {
+    stop();
+}
+
+bool PriorityLanes::start() {
+    if (running_) {
+        return false;
+    }
+
+    running_ = true;
+    publish_thread_ = std::thread(&PriorityLanes::publishLoop, this);
+
+    std::cout << "Priority lanes started (" << (policy_ == Policy::Strict ? "strict" : "weighted") << "):";
+    for (const auto& lane : lanes_) {
+        std::cout << " " << lane.config.name;
+        if (policy_ == Policy::Weighted) {
+            std::cout << "x" << lane.config.weight;
+        }
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+void PriorityLanes::stop() {
+    if (!running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+
+    if (publish_thread_.joinable()) {
+        publish_thread_.join();
+    }
+}
+
+bool PriorityLanes::isRunning() const {
+    return running_;
+}
+
+int PriorityLanes::addSource(PublishCallback callback) {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    int id = next_source_++;
+    sources_[id] = std::move(callback);
+    return id;
+}
+
+void PriorityLanes::removeSource(int id) {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    sources_.erase(id);
+}
+
+bool PriorityLanes::enqueue(int source, const std::string& route, const std::string& message) {
+    size_t index = classify(route, message);
+    LaneState& lane = lanes_[index];
+
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (!running_) {
+            // 已停止（例如停止过程中合并器、限流缓冲送出的剩余消息）时在调用线程中直接发布
+            lock.unlock();
+            std::lock_guard<std::mutex> sources_lock(sources_mutex_);
+            auto it = sources_.find(source);
+            if (it != sources_.end()) {
+                it->second(message);
+            }
+            return true;
+        }
+        if (lane.queue.size() >= lane.config.capacity) {
+            lane.dropped->add(1);
+            return false;
+        }
+        lane.queue.push_back(Item{source, message, nowNs()});
+        queued_++;
+    }
+    lane.depth->add(1);
+    queue_cv_.notify_one();
+    return true;
+}
+
+size_t PriorityLanes::classify(const std::string& route, const std::string& message) const {
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        const Lane& lane = lanes_[i].config;
+        if (std::find(lane.topics.begin(), lane.topics.end(), route) != lane.topics.end()) {
+            return i;
+        }
+
+        std::string_view value;
+        if (!lane.field.empty() && findJsonField(message, lane.field, value)) {
+            if (lane.values.empty()) {
+                return i;
+            }
+            for (const auto& expected : lane.values) {
+                if (value == expected) {
+                    return i;
+                }
+            }
+        }
+    }
+    return lanes_.size() - 1;
+}
+
+bool PriorityLanes::parsePolicy(const std::string& name, Policy& policy) {
+    if (name == "strict") {
+        policy = Policy::Strict;
+    } else if (name == "weighted") {
+        policy = Policy::Weighted;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool PriorityLanes::validate(const Config& config, std::string& error) {
+    if (config.lanes.empty()) {
+        error = "at least one lane is required";
+        return false;
+    }
+    std::set<std::string> names;
+    for (const auto& lane : config.lanes) {
+        if (lane.name.empty() || !names.insert(lane.name).second) {
+            error = "each lane needs a unique name (got \"" + lane.name + "\")";
+            return false;
+        }
+        if (lane.weight < 1 || lane.capacity == 0) {
+            error = "lane " + lane.name + ": weight and capacity must be at least 1";
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t PriorityLanes::laneCount() const {
+    return lanes_.size();
+}
+
+const std::string& PriorityLanes::laneName(size_t lane) const {
+    return lanes_[lane].config.name;
+}
+
+size_t PriorityLanes::getDepth(size_t lane) const {
+    return static_cast<size_t>(std::max<int64_t>(lanes_[lane].depth->value(), 0));
+}
+
+uint64_t PriorityLanes::getDroppedCount(size_t lane) const {
+    return lanes_[lane].dropped->value();
+}
+
+uint64_t PriorityLanes::getAverageDelay(size_t lane) const {
+    Histogram::Snapshot snapshot = lanes_[lane].delay->snapshot();
+    return snapshot.count > 0 ? snapshot.sum_ns / snapshot.count : 0;
+}
+
+size_t PriorityLanes::nextLane() {
+    if (policy_ == Policy::Strict) {
+        for (size_t i = 0; i < lanes_.size(); ++i) {
+            if (!lanes_[i].queue.empty()) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    // 加权轮询：当前通道用完本轮配额或已空时轮到下一个通道
+    while (credit_ <= 0 || lanes_[current_].queue.empty()) {
+        current_ = (current_ + 1) % lanes_.size();
+        credit_ = lanes_[current_].config.weight;
+    }
+    credit_--;
+    return current_;
+}
+
+void PriorityLanes::publishLoop() {
+    ThreadTuning::apply(ThreadTuning::Role::Publish, "lanes");
+
+    while (true) {
+        Item item;
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return queued_ > 0 || !running_; });
+            if (queued_ == 0) {
+                break;
+            }
+
+            // 每次只取一条，之后新到的高优先级消息可以立即插到前面
+            index = nextLane();
+            item = std::move(lanes_[index].queue.front());
+            lanes_[index].queue.pop_front();
+            queued_--;
+        }
+
+        LaneState& lane = lanes_[index];
+        lane.depth->add(-1);
+        lane.delay->observe(nowNs() - item.enqueue_ns);
+
+        // 持锁发布：已取消注册的来源的消息直接丢弃
+        std::lock_guard<std::mutex> lock(sources_mutex_);
+        auto it = sources_.find(item.source);
+        if (it != sources_.end()) {
+            it->second(item.message);
+        }
+    }
+}
@@ -0,0 +1,272 @@
+#include "rate_limiter.h"
+#include "thread_tuning.h"
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <tuple>
+
+namespace {
+
+uint64_t nowNs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+} // namespace
+
+bool RateLimiter::Config::operator==(const Config& other) const {
+    return std::tie(enabled, global, routes, policy, max_delay_ms, spool_size) ==
+           std::tie(other.enabled, other.global, other.routes, other.policy, other.max_delay_ms, other.spool_size);
+}
+
+TokenBucket::TokenBucket(double rate, double burst)
+    : tat_(0) {
+    interval_ns_ = static_cast<uint64_t>(1e9 / rate);
+    if (interval_ns_ == 0) {
+        interval_ns_ = 1;
+    }
+    if (burst < 1) {
+        burst = 1;
+    }
+    tolerance_ns_ = static_cast<uint64_t>((burst - 1) * static_cast<double>(interval_ns_));
+}
+
+int64_t TokenBucket::reserve(uint64_t now_ns, uint64_t max_wait_ns) {
+    uint64_t tat = tat_.load(std::memory_order_relaxed);
+    while (true) {
+        uint64_t base = tat > now_ns ? tat : now_ns;
+        // 令牌在 base - tolerance 时刻可用
+        uint64_t allowed_at = base > tolerance_ns_ ? base - tolerance_ns_ : 0;
+        uint64_t wait = allowed_at > now_ns ? allowed_at - now_ns : 0;
+        if (wait > max_wait_ns) {
+            return -1;
+        }
+        if (tat_.compare_exchange_weak(tat, base + interval_ns_, std::memory_order_relaxed)) {
+            return static_cast<int64_t>(wait);
+        }
+    }
+}
+
+void TokenBucket::refund() {
+    tat_.fetch_sub(interval_ns_, std::memory_order_relaxed);
+}
+
+RateLimiter::RateLimiter(const Config& config, const std::string& route,
+                         std::shared_ptr<TokenBucket> global)
+    : global_(global ? global : makeBucket(config.global)),
+      policy_(config.policy),
+      max_delay_ns_(static_cast<uint64_t>(config.max_delay_ms > 0 ? config.max_delay_ms : 0) * 1000000ULL),
+      spool_size_(config.spool_size),
+      spool_depth_(0),
+      running_(false),
+      dropped_count_(0),
+      delayed_count_(0),
+      spooled_count_(0) {
+    auto it = config.routes.find(route);
+    if (it != config.routes.end()) {
+        route_ = makeBucket(it->second);
+    }
+}
+
+RateLimiter::~RateLimiter() {
+    stop();
+}
+
+bool RateLimiter::start(PublishCallback callback) {
+    if (running_) {
+        std::cerr << "Rate limiter is already running" << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    if (policy_ == Policy::Spool || policy_ == Policy::Delay) {
+        spool_thread_ = std::thread(&RateLimiter::spoolLoop, this, callback);
+    }
+    return true;
+}
+
+void RateLimiter::stop() {
+    if (!running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(spool_mutex_);
+        running_ = false;
+    }
+    spool_cv_.notify_all();
+
+    if (spool_thread_.joinable()) {
+        spool_thread_.join();
+    }
+}
+
+RateLimiter::Result RateLimiter::acquire(const std::string& message) {
+    switch (policy_) {
+    case Policy::Drop:
+        if (reserve(0) < 0) {
+            dropped_count_++;
+            return Result::Dropped;
+        }
+        return Result::Admitted;
+
+    case Policy::Delay: {
+        if (!running_) {
+            return Result::Admitted;
+        }
+        // 令牌在调用线程中预约，等待交给缓冲线程；前面还有延迟的消息时同样排队，保证发布顺序
+        bool queued = spool_depth_.load(std::memory_order_acquire) > 0;
+        uint64_t now = nowNs();
+        int64_t wait = reserve(max_delay_ns_);
+        if (wait < 0) {
+            dropped_count_++;
+            return Result::Dropped;
+        }
+        if (wait == 0 && !queued) {
+            return Result::Admitted;
+        }
+        {
+            std::lock_guard<std::mutex> lock(spool_mutex_);
+            spool_.push_back(Spooled{now + static_cast<uint64_t>(wait), message});
+            spool_depth_.fetch_add(1, std::memory_order_release);
+        }
+        delayed_count_++;
+        spool_cv_.notify_one();
+        return Result::Spooled;
+    }
+
+    case Policy::Spool:
+        // 已停止（例如配置重载后被替换）时不再缓冲，避免消息滞留在队列中
+        if (!running_) {
+            return Result::Admitted;
+        }
+        // 队列非空时新消息也必须排队，保证发布顺序
+        if (spool_depth_.load(std::memory_order_acquire) == 0 && reserve(0) >= 0) {
+            return Result::Admitted;
+        }
+        {
+            std::lock_guard<std::mutex> lock(spool_mutex_);
+            if (spool_.size() >= spool_size_) {
+                dropped_count_++;
+                return Result::Dropped;
+            }
+            spool_.push_back(Spooled{0, message});
+            spool_depth_.fetch_add(1, std::memory_order_release);
+        }
+        spooled_count_++;
+        spool_cv_.notify_one();
+        return Result::Spooled;
+    }
+
+    return Result::Admitted;
+}
+
+std::shared_ptr<TokenBucket> RateLimiter::makeBucket(const Limit& limit) {
+    if (limit.rate <= 0) {
+        return nullptr;
+    }
+    return std::make_shared<TokenBucket>(limit.rate, limit.burst > 0 ? limit.burst : limit.rate);
+}
+
+bool RateLimiter::parsePolicy(const std::string& name, Policy& policy) {
+    if (name == "drop") {
+        policy = Policy::Drop;
+    } else if (name == "delay") {
+        policy = Policy::Delay;
+    } else if (name == "spool") {
+        policy = Policy::Spool;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+uint64_t RateLimiter::getDroppedCount() const {
+    return dropped_count_;
+}
+
+uint64_t RateLimiter::getDelayedCount() const {
+    return delayed_count_;
+}
+
+uint64_t RateLimiter::getSpooledCount() const {
+    return spooled_count_;
+}
+
+size_t RateLimiter::getSpoolDepth() const {
+    return spool_depth_;
+}
+
+void RateLimiter::resetStatistics() {
+    dropped_count_ = 0;
+    delayed_count_ = 0;
+    spooled_count_ = 0;
+}
+
+int64_t RateLimiter::reserve(uint64_t max_wait_ns) {
+    uint64_t now = nowNs();
+
+    int64_t route_wait = 0;
+    if (route_) {
+        route_wait = route_->reserve(now, max_wait_ns);
+        if (route_wait < 0) {
+            return -1;
+        }
+    }
+
+    int64_t global_wait = 0;
+    if (global_) {
+        global_wait = global_->reserve(now, max_wait_ns);
+        if (global_wait < 0) {
+            if (route_) {
+                route_->refund();
+            }
+            return -1;
+        }
+    }
+
+    return route_wait > global_wait ? route_wait : global_wait;
+}
+
+void RateLimiter::spoolLoop(PublishCallback callback) {
+    ThreadTuning::apply(ThreadTuning::Role::Publish, "rate-spool");
+
+    std::string message;
+
+    while (true) {
+        bool draining = false;
+        uint64_t due_ns = 0;
+        {
+            std::unique_lock<std::mutex> lock(spool_mutex_);
+            spool_cv_.wait(lock, [this] { return !spool_.empty() || !running_; });
+            if (spool_.empty()) {
+                break;
+            }
+            draining = !running_;
+            due_ns = spool_.front().due_ns;
+        }
+
+        // 停止时剩余消息不再限速，直接发布
+        if (!draining) {
+            int64_t wait = 0;
+            if (due_ns == 0) {
+                wait = reserve(std::numeric_limits<uint64_t>::max());
+            } else {
+                uint64_t now = nowNs();
+                wait = due_ns > now ? static_cast<int64_t>(due_ns - now) : 0;
+            }
+            if (wait > 0) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(spool_mutex_);
+            message.swap(spool_.front().message);
+            spool_.pop_front();
+        }
+        callback(message);
+        // 发布完成后才减少深度，避免新消息越过正在发布的缓冲消息
+        spool_depth_.fetch_sub(1, std::memory_order_release);
+    }
+}
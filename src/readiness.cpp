@@ -0,0 +1,96 @@
+#include "readiness.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+Readiness::Readiness(const std::string& ready_file)
+    : ready_file_(ready_file), file_written_(false), stopping_(false) {
+}
+
+bool Readiness::ready(const std::string& status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return true;
+    }
+    notify("READY=1\nSTATUS=" + status + "\nMAINPID=" + std::to_string(getpid()));
+
+    if (ready_file_.empty()) {
+        return true;
+    }
+
+    // 先写临时文件再rename，读取方不会看到写了一半的文件
+    std::string temp = ready_file_ + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        file << getpid() << "\n";
+        if (!file) {
+            std::cerr << "Failed to write readiness file " << temp << std::endl;
+            return false;
+        }
+    }
+    if (rename(temp.c_str(), ready_file_.c_str()) != 0) {
+        std::cerr << "Failed to create readiness file " << ready_file_ << ": " << strerror(errno) << std::endl;
+        unlink(temp.c_str());
+        return false;
+    }
+    file_written_ = true;
+    return true;
+}
+
+void Readiness::stopping() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return;
+    }
+    stopping_ = true;
+    notify("STOPPING=1");
+
+    if (file_written_) {
+        unlink(ready_file_.c_str());
+        file_written_ = false;
+    }
+}
+
+bool Readiness::notify(const std::string& state) {
+    const char* path = getenv("NOTIFY_SOCKET");
+    if (!path || path[0] == '\0') {
+        return false;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    size_t len = strlen(path);
+    if ((path[0] != '/' && path[0] != '@') || len >= sizeof(addr.sun_path)) {
+        std::cerr << "Unsupported NOTIFY_SOCKET: " << path << std::endl;
+        return false;
+    }
+    memcpy(addr.sun_path, path, len);
+    if (path[0] == '@') {
+        // 抽象命名空间：首字节为0，地址长度不含结尾的0
+        addr.sun_path[0] = '\0';
+    }
+    socklen_t addr_len = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + len);
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Failed to create notify socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+    ssize_t sent = sendto(fd, state.data(), state.size(), MSG_NOSIGNAL,
+                          reinterpret_cast<struct sockaddr*>(&addr), addr_len);
+    int error = errno;
+    close(fd);
+    if (sent < 0) {
+        std::cerr << "Failed to notify service manager: " << strerror(error) << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,197 @@
+#include "reassembler.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <tuple>
+
+// 分片头魔数和版本
+static const uint8_t MAGIC_0 = 'M';
+static const uint8_t MAGIC_1 = 'F';
+static const uint8_t VERSION = 1;
+
+static uint16_t readU16(const char* p) {
+    const uint8_t* b = reinterpret_cast<const uint8_t*>(p);
+    return static_cast<uint16_t>((b[0] << 8) | b[1]);
+}
+
+static uint32_t readU32(const char* p) {
+    const uint8_t* b = reinterpret_cast<const uint8_t*>(p);
+    return (static_cast<uint32_t>(b[0]) << 24) | (static_cast<uint32_t>(b[1]) << 16) |
+           (static_cast<uint32_t>(b[2]) << 8) | b[3];
+}
+
+bool Reassembler::Config::operator==(const Config& other) const {
+    return std::tie(enabled, max_messages, max_message_size, timeout_ms) ==
+           std::tie(other.enabled, other.max_messages, other.max_message_size, other.timeout_ms);
+}
+
+Reassembler::Reassembler(const Config& config)
+    : config_(config), completed_count_(0), dropped_count_(0) {
+    if (config_.max_messages == 0) {
+        config_.max_messages = 1;
+    }
+    if (config_.timeout_ms <= 0) {
+        config_.timeout_ms = 1;
+    }
+}
+
+Reassembler::Result Reassembler::add(uint64_t source, const char* data, size_t len, std::string& message) {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    uint64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    return add(source, data, len, message, now_ms);
+}
+
+Reassembler::Result Reassembler::add(uint64_t source, const char* data, size_t len,
+                                     std::string& message, uint64_t now_ms) {
+    if (len < HEADER_SIZE || static_cast<uint8_t>(data[0]) != MAGIC_0 ||
+        static_cast<uint8_t>(data[1]) != MAGIC_1) {
+        return Result::Passthrough;
+    }
+
+    expire(now_ms);
+
+    uint32_t message_id = readU32(data + 4);
+    uint16_t index = readU16(data + 8);
+    uint16_t count = readU16(data + 10);
+    const char* payload = data + HEADER_SIZE;
+    size_t payload_len = len - HEADER_SIZE;
+
+    if (static_cast<uint8_t>(data[2]) != VERSION || count == 0 || index >= count) {
+        dropped_count_++;
+        return Result::Dropped;
+    }
+
+    // 只有一个分片的消息无需进表
+    if (count == 1) {
+        if (payload_len > config_.max_message_size) {
+            dropped_count_++;
+            return Result::Dropped;
+        }
+        message.assign(payload, payload_len);
+        completed_count_++;
+        return Result::Complete;
+    }
+
+    // 每个分片至少带1字节，分片总数超过大小上限的消息不可能组装成功，不为它建表
+    if (count > config_.max_message_size) {
+        dropped_count_++;
+        return Result::Dropped;
+    }
+
+    Key key{source, message_id};
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+        // 表满时淘汰最早开始的消息
+        if (entries_.size() >= config_.max_messages) {
+            erase(entries_.begin());
+            dropped_count_++;
+        }
+
+        Entry entry;
+        entry.key = key;
+        entry.started_ms = now_ms;
+        entry.count = count;
+        entry.received = 0;
+        entry.bytes = 0;
+        entries_.push_back(std::move(entry));
+        found = index_.emplace(key, std::prev(entries_.end())).first;
+    }
+
+    auto it = found->second;
+    if (it->count != count) {
+        // 同一消息ID的分片总数不一致，整条消息作废
+        erase(it);
+        dropped_count_++;
+        return Result::Dropped;
+    }
+
+    if (it->fragments.count(index) > 0) {
+        // 重复的分片
+        return Result::Pending;
+    }
+
+    if (it->bytes + payload_len > config_.max_message_size) {
+        erase(it);
+        dropped_count_++;
+        return Result::Dropped;
+    }
+
+    it->fragments.emplace(index, std::string(payload, payload_len));
+    it->received++;
+    it->bytes += payload_len;
+
+    if (it->received < it->count) {
+        return Result::Pending;
+    }
+
+    message.clear();
+    message.reserve(it->bytes);
+    for (const auto& part : it->fragments) {
+        message.append(part.second);
+    }
+    erase(it);
+    completed_count_++;
+    return Result::Complete;
+}
+
+std::vector<std::string> Reassembler::fragment(uint32_t message_id, const std::string& message,
+                                               size_t max_datagram) {
+    std::vector<std::string> fragments;
+    if (max_datagram <= HEADER_SIZE) {
+        return fragments;
+    }
+
+    size_t chunk = max_datagram - HEADER_SIZE;
+    size_t count = message.empty() ? 1 : (message.size() + chunk - 1) / chunk;
+    if (count > 65535) {
+        return fragments;
+    }
+
+    fragments.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t offset = i * chunk;
+        size_t len = std::min(chunk, message.size() - offset);
+
+        std::string datagram;
+        datagram.reserve(HEADER_SIZE + len);
+        datagram.push_back(static_cast<char>(MAGIC_0));
+        datagram.push_back(static_cast<char>(MAGIC_1));
+        datagram.push_back(static_cast<char>(VERSION));
+        datagram.push_back(0);
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            datagram.push_back(static_cast<char>((message_id >> shift) & 0xFF));
+        }
+        datagram.push_back(static_cast<char>((i >> 8) & 0xFF));
+        datagram.push_back(static_cast<char>(i & 0xFF));
+        datagram.push_back(static_cast<char>((count >> 8) & 0xFF));
+        datagram.push_back(static_cast<char>(count & 0xFF));
+        datagram.append(message, offset, len);
+        fragments.push_back(std::move(datagram));
+    }
+    return fragments;
+}
+
+uint64_t Reassembler::getCompletedCount() const {
+    return completed_count_;
+}
+
+uint64_t Reassembler::getDroppedCount() const {
+    return dropped_count_;
+}
+
+size_t Reassembler::pendingCount() const {
+    return entries_.size();
+}
+
+void Reassembler::expire(uint64_t now_ms) {
+    while (!entries_.empty() &&
+           now_ms - entries_.front().started_ms >= static_cast<uint64_t>(config_.timeout_ms)) {
+        erase(entries_.begin());
+        dropped_count_++;
+    }
+}
+
+void Reassembler::erase(std::list<Entry>::iterator it) {
+    index_.erase(it->key);
+    entries_.erase(it);
+}
@@ -0,0 +1,298 @@
+#include "sequence_tracker.h"
+#include "json_field.h"
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+
+bool SequenceTracker::Config::operator==(const Config& other) const {
+    return std::tie(enabled, seq_field, max_sources, reorder_window_ms, reorder_max_messages) ==
+           std::tie(other.enabled, other.seq_field, other.max_sources, other.reorder_window_ms,
+                    other.reorder_max_messages);
+}
+
+SequenceTracker::SequenceTracker(const Config& config)
+    : config_(config), held_count_(0) {
+    if (config_.reorder_max_messages == 0) {
+        config_.reorder_max_messages = 1;
+    }
+
+    size_t capacity = 16;
+    while (capacity < config_.max_sources) {
+        capacity <<= 1;
+    }
+    slots_.assign(capacity, Source{0, 0, 0, 0, 0, false});
+    mask_ = capacity - 1;
+}
+
+bool SequenceTracker::parseSequence(const char* data, size_t len, const std::string& field, uint64_t& seq) {
+    std::string_view value;
+    if (!findJsonField(std::string_view(data, len), field, value) || value.empty() || value.size() > 19) {
+        return false;
+    }
+
+    seq = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        seq = seq * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return true;
+}
+
+SequenceTracker::Source& SequenceTracker::lookup(uint64_t source, uint64_t now_ms, bool& fresh) {
+    uint64_t hash = source * 0x9E3779B97F4A7C15ULL;
+    size_t index = static_cast<size_t>(hash ^ (hash >> 29)) & mask_;
+
+    Source* free_slot = nullptr;
+    Source* oldest = nullptr;
+    for (size_t i = 0; i < MAX_PROBE; ++i) {
+        Source& slot = slots_[(index + i) & mask_];
+        if (slot.used && slot.key == source) {
+            fresh = false;
+            return slot;
+        }
+        if (!slot.used) {
+            if (!free_slot) {
+                free_slot = &slot;
+            }
+        } else if (!oldest || slot.last_ms < oldest->last_ms) {
+            oldest = &slot;
+        }
+    }
+
+    // 探测范围已满：淘汰最久未活动的发送者，它暂存的消息留到下一次flush放行
+    Source* slot = free_slot;
+    if (!slot) {
+        slot = oldest;
+        releaseAll(slot->key, orphaned_);
+    }
+
+    *slot = Source{source, 0, 0, 0, now_ms, true};
+    fresh = true;
+    return *slot;
+}
+
+SequenceTracker::Source* SequenceTracker::find(uint64_t source) {
+    uint64_t hash = source * 0x9E3779B97F4A7C15ULL;
+    size_t index = static_cast<size_t>(hash ^ (hash >> 29)) & mask_;
+    for (size_t i = 0; i < MAX_PROBE; ++i) {
+        Source& slot = slots_[(index + i) & mask_];
+        if (slot.used && slot.key == source) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+SequenceTracker::Result SequenceTracker::classify(Source& slot, uint64_t seq, bool fresh) {
+    stats_.tracked++;
+
+    if (fresh) {
+        slot.highest = seq;
+        slot.window = 1;
+        return Result::InOrder;
+    }
+
+    if (seq > slot.highest) {
+        uint64_t diff = seq - slot.highest;
+        slot.window = diff >= 64 ? 1 : (slot.window << diff) | 1;
+        slot.highest = seq;
+        if (diff == 1) {
+            return Result::InOrder;
+        }
+        stats_.missing += diff - 1;
+        return Result::Gap;
+    }
+
+    uint64_t distance = slot.highest - seq;
+    if (distance >= RESET_DISTANCE) {
+        slot.highest = seq;
+        slot.window = 1;
+        stats_.resets++;
+        return Result::Reset;
+    }
+
+    if (distance < 64) {
+        uint64_t bit = 1ULL << distance;
+        if (slot.window & bit) {
+            stats_.duplicates++;
+            return Result::Duplicate;
+        }
+        slot.window |= bit;
+    }
+    // 超出位图范围的迟到消息无法判断是否重复，按迟到计
+    stats_.reordered++;
+    return Result::Reordered;
+}
+
+SequenceTracker::Result SequenceTracker::track(uint64_t source, const char* data, size_t len, uint64_t now_ms) {
+    uint64_t seq;
+    if (!parseSequence(data, len, config_.seq_field, seq)) {
+        return Result::Untracked;
+    }
+
+    bool fresh;
+    Source& slot = lookup(source, now_ms, fresh);
+    slot.last_ms = now_ms;
+    return classify(slot, seq, fresh);
+}
+
+void SequenceTracker::add(uint64_t source, const char* data, size_t len, uint64_t rx_ts_ns,
+                          const struct sockaddr_storage& src_addr, uint64_t now_ms,
+                          std::vector<Released>& release) {
+    if (!reordering()) {
+        track(source, data, len, now_ms);
+        release.push_back(Released{std::string(data, len), rx_ts_ns, src_addr});
+        return;
+    }
+
+    uint64_t seq;
+    if (!parseSequence(data, len, config_.seq_field, seq)) {
+        release.push_back(Released{std::string(data, len), rx_ts_ns, src_addr});
+        return;
+    }
+
+    bool fresh;
+    Source& slot = lookup(source, now_ms, fresh);
+    slot.last_ms = now_ms;
+    Result result = classify(slot, seq, fresh);
+
+    if (result == Result::Duplicate) {
+        return;
+    }
+
+    if (fresh || result == Result::Reset) {
+        // 发送者重启：先放行旧序列暂存的消息
+        releaseAll(source, release);
+        pruneArrivals();
+        slot.next = seq + 1;
+        release.push_back(Released{std::string(data, len), rx_ts_ns, src_addr});
+        return;
+    }
+
+    if (seq < slot.next) {
+        // 缺口已被跳过后才到达，直接放行
+        release.push_back(Released{std::string(data, len), rx_ts_ns, src_addr});
+        return;
+    }
+
+    auto it = held_.find(source);
+    if (seq == slot.next) {
+        release.push_back(Released{std::string(data, len), rx_ts_ns, src_addr});
+        slot.next++;
+        if (it != held_.end()) {
+            releaseContiguous(slot, it->second, release);
+            if (it->second.empty()) {
+                held_.erase(it);
+            }
+            pruneArrivals();
+        }
+        return;
+    }
+
+    // 缺口之后的消息：暂存等待补齐
+    auto& held = held_[source];
+    if (held.emplace(seq, Held{now_ms, Released{std::string(data, len), rx_ts_ns, src_addr}}).second) {
+        held_count_++;
+        arrivals_.push_back(Arrival{now_ms, source, seq});
+    }
+
+    // 暂存已满时跳过最早的缺口
+    if (held.size() > config_.reorder_max_messages) {
+        slot.next = held.begin()->first;
+        releaseContiguous(slot, held, release);
+        if (held.empty()) {
+            held_.erase(source);
+        }
+    }
+    pruneArrivals();
+}
+
+void SequenceTracker::flush(uint64_t now_ms, std::vector<Released>& release) {
+    for (auto& released : orphaned_) {
+        release.push_back(std::move(released));
+    }
+    orphaned_.clear();
+
+    // 按到达顺序处理超时：最早到达的消息等待超过窗口时跳过它所在发送者的缺口，直到它被放行
+    uint64_t window = static_cast<uint64_t>(config_.reorder_window_ms);
+    pruneArrivals();
+    while (!arrivals_.empty() && arrivals_.front().arrived_ms + window <= now_ms) {
+        uint64_t source = arrivals_.front().source;
+        auto it = held_.find(source);
+        Source* slot = find(source);
+        if (!slot) {
+            releaseAll(source, release);
+        } else {
+            slot->next = it->second.begin()->first;
+            releaseContiguous(*slot, it->second, release);
+            if (it->second.empty()) {
+                held_.erase(it);
+            }
+        }
+        pruneArrivals();
+    }
+}
+
+uint64_t SequenceTracker::nextDeadline() const {
+    if (!orphaned_.empty()) {
+        return 1;
+    }
+    if (arrivals_.empty()) {
+        return 0;
+    }
+    return arrivals_.front().arrived_ms + static_cast<uint64_t>(config_.reorder_window_ms);
+}
+
+bool SequenceTracker::reordering() const {
+    return config_.reorder_window_ms > 0;
+}
+
+size_t SequenceTracker::heldCount() const {
+    return held_count_;
+}
+
+const SequenceTracker::Statistics& SequenceTracker::statistics() const {
+    return stats_;
+}
+
+void SequenceTracker::releaseContiguous(Source& slot, std::map<uint64_t, Held>& held,
+                                        std::vector<Released>& release) {
+    while (!held.empty() && held.begin()->first == slot.next) {
+        release.push_back(std::move(held.begin()->second.released));
+        held.erase(held.begin());
+        held_count_--;
+        slot.next++;
+    }
+}
+
+void SequenceTracker::releaseAll(uint64_t source, std::vector<Released>& release) {
+    auto it = held_.find(source);
+    if (it == held_.end()) {
+        return;
+    }
+    for (auto& entry : it->second) {
+        release.push_back(std::move(entry.second.released));
+        held_count_--;
+    }
+    held_.erase(it);
+}
+
+std::map<uint64_t, SequenceTracker::Held>* SequenceTracker::heldFor(const Arrival& arrival) {
+    auto it = held_.find(arrival.source);
+    if (it == held_.end()) {
+        return nullptr;
+    }
+    auto entry = it->second.find(arrival.seq);
+    if (entry == it->second.end() || entry->second.arrived_ms != arrival.arrived_ms) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void SequenceTracker::pruneArrivals() {
+    while (!arrivals_.empty() && !heldFor(arrivals_.front())) {
+        arrivals_.pop_front();
+    }
+}
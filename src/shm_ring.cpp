@@ -0,0 +1,316 @@
+#include "shm_ring.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+
+static const char MAGIC[8] = {'S', 'H', 'M', 'R', 'I', 'N', 'G', '1'};
+static const size_t HEADER_SIZE = 64;
+static const size_t SLOT_HEADER_SIZE = 32;
+
+// 文件头和槽位头中原子字段的偏移
+static const size_t SLOTS_OFFSET = 8;
+static const size_t SLOT_SIZE_OFFSET = 12;
+static const size_t WRITE_SEQUENCE_OFFSET = 16;
+static const size_t STATE_OFFSET = 24;
+static const size_t SLOT_TS_OFFSET = 8;
+static const size_t SLOT_TOPIC_LEN_OFFSET = 16;
+static const size_t SLOT_PAYLOAD_LEN_OFFSET = 20;
+
+static const uint32_t STATE_OPEN = 1;
+static const uint32_t STATE_CLOSED = 2;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory ring needs lock-free 64-bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory ring needs lock-free 32-bit atomics");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "unexpected atomic layout");
+
+// 映射区中的原子字段：其他进程通过同一映射访问，只能使用无锁原子
+static std::atomic<uint64_t>* atomic64(const char* base, size_t offset) {
+    return reinterpret_cast<std::atomic<uint64_t>*>(const_cast<char*>(base + offset));
+}
+
+static std::atomic<uint32_t>* atomic32(const char* base, size_t offset) {
+    return reinterpret_cast<std::atomic<uint32_t>*>(const_cast<char*>(base + offset));
+}
+
+bool ShmRing::Config::operator==(const Config& other) const {
+    return std::tie(enabled, path, slots, slot_size) ==
+           std::tie(other.enabled, other.path, other.slots, other.slot_size);
+}
+
+ShmRing::ShmRing(const Config& config)
+    : config_(config), fd_(-1), map_(nullptr), size_(0), sequence_(0), written_count_(0), dropped_count_(0) {
+}
+
+ShmRing::~ShmRing() {
+    close();
+}
+
+bool ShmRing::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (map_) {
+        return true;
+    }
+
+    // 删除旧文件再创建新文件：已映射旧文件的读取端不会读到重新编号的内容
+    if (unlink(config_.path.c_str()) < 0 && errno != ENOENT) {
+        std::cerr << "Failed to replace shared memory ring " << config_.path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    fd_ = ::open(config_.path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Failed to create shared memory ring " << config_.path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    size_ = HEADER_SIZE + config_.slots * config_.slot_size;
+    if (ftruncate(fd_, static_cast<off_t>(size_)) < 0) {
+        std::cerr << "Failed to size shared memory ring " << config_.path << ": " << strerror(errno) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    void* map = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory ring " << config_.path << ": " << strerror(errno) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    map_ = static_cast<char*>(map);
+
+    // 文件由ftruncate清零；填好文件头后再发布状态，读取端据此判断可以使用
+    uint32_t slots = static_cast<uint32_t>(config_.slots);
+    uint32_t slot_size = static_cast<uint32_t>(config_.slot_size);
+    memcpy(map_, MAGIC, sizeof(MAGIC));
+    memcpy(map_ + SLOTS_OFFSET, &slots, sizeof(slots));
+    memcpy(map_ + SLOT_SIZE_OFFSET, &slot_size, sizeof(slot_size));
+    sequence_ = 0;
+    atomic32(map_, STATE_OFFSET)->store(STATE_OPEN, std::memory_order_release);
+
+    std::cout << "Local output ring " << config_.path << " (" << config_.slots << " slots of "
+              << config_.slot_size << " bytes)" << std::endl;
+    return true;
+}
+
+void ShmRing::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!map_) {
+        return;
+    }
+
+    atomic32(map_, STATE_OFFSET)->store(STATE_CLOSED, std::memory_order_release);
+    munmap(map_, size_);
+    map_ = nullptr;
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool ShmRing::write(std::string_view topic, std::string_view payload, uint64_t ts_ns) {
+    if (topic.size() + payload.size() > capacity()) {
+        dropped_count_++;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!map_) {
+        dropped_count_++;
+        return false;
+    }
+
+    uint64_t sequence = ++sequence_;
+    char* slot = map_ + HEADER_SIZE + (sequence % config_.slots) * config_.slot_size;
+    std::atomic<uint64_t>* state = atomic64(slot, 0);
+
+    // 奇数状态表示正在写；读取端在复制前后各读一次状态，不一致即丢弃
+    state->store(sequence * 2 - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint32_t topic_len = static_cast<uint32_t>(topic.size());
+    uint32_t payload_len = static_cast<uint32_t>(payload.size());
+    memcpy(slot + SLOT_TS_OFFSET, &ts_ns, sizeof(ts_ns));
+    memcpy(slot + SLOT_TOPIC_LEN_OFFSET, &topic_len, sizeof(topic_len));
+    memcpy(slot + SLOT_PAYLOAD_LEN_OFFSET, &payload_len, sizeof(payload_len));
+    memcpy(slot + SLOT_HEADER_SIZE, topic.data(), topic.size());
+    memcpy(slot + SLOT_HEADER_SIZE + topic.size(), payload.data(), payload.size());
+
+    state->store(sequence * 2, std::memory_order_release);
+    atomic64(map_, WRITE_SEQUENCE_OFFSET)->store(sequence, std::memory_order_release);
+    written_count_++;
+    return true;
+}
+
+size_t ShmRing::capacity() const {
+    return config_.slot_size - SLOT_HEADER_SIZE;
+}
+
+uint64_t ShmRing::getWrittenCount() const {
+    return written_count_;
+}
+
+uint64_t ShmRing::getDroppedCount() const {
+    return dropped_count_;
+}
+
+bool ShmRing::validate(const Config& config, std::string& error) {
+    if (config.path.empty()) {
+        error = "path must not be empty";
+        return false;
+    }
+    if (config.slots == 0 || config.slots > UINT32_MAX) {
+        error = "slots must be between 1 and 4294967295";
+        return false;
+    }
+    if (config.slot_size <= SLOT_HEADER_SIZE || config.slot_size % 64 != 0 || config.slot_size > UINT32_MAX) {
+        error = "slot_size must be a multiple of 64 and larger than 32";
+        return false;
+    }
+    return true;
+}
+
+ShmRingReader::ShmRingReader(const std::string& path)
+    : path_(path), fd_(-1), map_(nullptr), size_(0), slots_(0), slot_size_(0), next_(1), lost_(0) {
+}
+
+ShmRingReader::~ShmRingReader() {
+    close();
+}
+
+bool ShmRingReader::open() {
+    close();
+
+    fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open shared memory ring " << path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0 || static_cast<size_t>(st.st_size) < HEADER_SIZE) {
+        std::cerr << "Shared memory ring " << path_ << " is too small" << std::endl;
+        close();
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    void* map = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory ring " << path_ << ": " << strerror(errno) << std::endl;
+        map_ = nullptr;
+        close();
+        return false;
+    }
+    map_ = static_cast<const char*>(map);
+
+    uint32_t state = atomic32(map_, STATE_OFFSET)->load(std::memory_order_acquire);
+    memcpy(&slots_, map_ + SLOTS_OFFSET, sizeof(slots_));
+    memcpy(&slot_size_, map_ + SLOT_SIZE_OFFSET, sizeof(slot_size_));
+    if (state == 0 || memcmp(map_, MAGIC, sizeof(MAGIC)) != 0 || slots_ == 0 || slot_size_ <= SLOT_HEADER_SIZE ||
+        size_ < HEADER_SIZE + static_cast<size_t>(slots_) * slot_size_) {
+        std::cerr << "Not a shared memory ring (or not initialized yet): " << path_ << std::endl;
+        close();
+        return false;
+    }
+
+    lost_ = 0;
+    seekToLatest();
+    return true;
+}
+
+void ShmRingReader::close() {
+    if (map_) {
+        munmap(const_cast<char*>(map_), size_);
+        map_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool ShmRingReader::poll(Message& message) {
+    if (!map_) {
+        return false;
+    }
+
+    while (true) {
+        uint64_t latest = atomic64(map_, WRITE_SEQUENCE_OFFSET)->load(std::memory_order_acquire);
+        if (next_ > latest) {
+            return false;
+        }
+
+        // 落后超过一圈：跳到环中仍保留的最早消息
+        if (latest - next_ >= slots_) {
+            uint64_t oldest = latest - slots_ + 1;
+            lost_ += oldest - next_;
+            next_ = oldest;
+        }
+
+        const char* slot = map_ + HEADER_SIZE + (next_ % slots_) * slot_size_;
+        const std::atomic<uint64_t>* state = atomic64(slot, 0);
+        uint64_t before = state->load(std::memory_order_acquire);
+        if (before < next_ * 2) {
+            return false;
+        }
+
+        bool intact = before == next_ * 2;
+        if (intact) {
+            uint32_t topic_len;
+            uint32_t payload_len;
+            memcpy(&message.ts_ns, slot + SLOT_TS_OFFSET, sizeof(message.ts_ns));
+            memcpy(&topic_len, slot + SLOT_TOPIC_LEN_OFFSET, sizeof(topic_len));
+            memcpy(&payload_len, slot + SLOT_PAYLOAD_LEN_OFFSET, sizeof(payload_len));
+            size_t len = static_cast<size_t>(topic_len) + payload_len;
+            if (len > slot_size_ - SLOT_HEADER_SIZE) {
+                intact = false;
+            } else {
+                buffer_.assign(slot + SLOT_HEADER_SIZE, len);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                intact = state->load(std::memory_order_relaxed) == before;
+                message.topic = std::string_view(buffer_.data(), topic_len);
+                message.payload = std::string_view(buffer_.data() + topic_len, payload_len);
+            }
+        }
+
+        // 复制期间被写入端覆盖：这条消息已丢失，继续读下一条
+        if (!intact) {
+            lost_++;
+            next_++;
+            continue;
+        }
+
+        message.sequence = next_++;
+        return true;
+    }
+}
+
+void ShmRingReader::seekToLatest() {
+    if (map_) {
+        next_ = atomic64(map_, WRITE_SEQUENCE_OFFSET)->load(std::memory_order_acquire) + 1;
+    }
+}
+
+bool ShmRingReader::isClosed() const {
+    if (!map_ || atomic32(map_, STATE_OFFSET)->load(std::memory_order_acquire) == STATE_CLOSED) {
+        return true;
+    }
+
+    // 写入端异常退出后重新启动时用新文件替换了旧文件
+    struct stat mapped;
+    struct stat current;
+    if (fstat(fd_, &mapped) < 0 || stat(path_.c_str(), &current) < 0) {
+        return true;
+    }
+    return mapped.st_ino != current.st_ino || mapped.st_dev != current.st_dev;
+}
+
+uint64_t ShmRingReader::getLostCount() const {
+    return lost_;
+}
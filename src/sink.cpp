@@ -0,0 +1,305 @@
+#include "sink.h"
+#include "thread_tuning.h"
+#include <cstring>
+#include <iostream>
+#include <tuple>
+
+bool Sink::Config::operator==(const Config& other) const {
+    return std::tie(type, name, path, host, port, capacity, policy) ==
+           std::tie(other.type, other.name, other.path, other.host, other.port, other.capacity, other.policy);
+}
+
+std::unique_ptr<Sink> Sink::create(const Config& config, const std::string& bridge) {
+    if (config.type == Type::Mirror) {
+        return std::make_unique<MirrorSink>(config, bridge);
+    }
+    return std::make_unique<RecordSink>(config, bridge);
+}
+
+Sink::Sink(const Config& config, const std::string& bridge)
+    : config_(config), bridge_(bridge), running_(false) {
+    name_ = !config.name.empty() ? config.name : (config.type == Type::Mirror ? "mirror" : "record");
+
+    MetricsRegistry::Labels labels = {{"bridge", bridge.empty() ? "default" : bridge}, {"sink", name_}};
+    MetricsRegistry& registry = MetricsRegistry::global();
+    delivered_count_ = registry.counter("sink_delivered_messages_total", "Messages delivered by an output sink", labels);
+    dropped_count_ = registry.counter("sink_dropped_messages_total",
+                                      "Messages dropped because the sink queue was full", labels);
+    failed_count_ = registry.counter("sink_failed_messages_total", "Messages an output sink failed to deliver", labels);
+    depth_ = registry.gauge("sink_queue_depth", "Messages waiting in an output sink queue", labels);
+}
+
+Sink::~Sink() {
+}
+
+bool Sink::start() {
+    if (running_) {
+        return false;
+    }
+    if (!open()) {
+        std::cerr << "Failed to open sink " << name_ << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&Sink::deliverLoop, this);
+    std::cout << "Sink " << name_ << " started (capacity " << config_.capacity << ")" << std::endl;
+    return true;
+}
+
+void Sink::stop() {
+    if (!running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    close();
+}
+
+bool Sink::offer(const PacketRef& packet) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (config_.policy == Policy::Block) {
+            not_full_.wait(lock, [this]() { return queue_.size() < config_.capacity || !running_; });
+        }
+        if (!running_) {
+            dropped_count_->add(1);
+            return false;
+        }
+        if (queue_.size() >= config_.capacity) {
+            if (config_.policy == Policy::DropNewest) {
+                dropped_count_->add(1);
+                return false;
+            }
+            // DropOldest：释放最早的引用，为新报文腾出空位
+            queue_.pop_front();
+            dropped_count_->add(1);
+            depth_->add(-1);
+        }
+        queue_.push_back(packet);
+    }
+    depth_->add(1);
+    not_empty_.notify_one();
+    return true;
+}
+
+void Sink::deliverLoop() {
+    ThreadTuning::apply(ThreadTuning::Role::Publish, "sink-" + name_);
+
+    PacketRef batch[MAX_BATCH];
+    while (true) {
+        size_t count = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_empty_.wait(lock, [this]() { return !queue_.empty() || !running_; });
+            // 停止后先投递完队列中剩余的报文
+            if (queue_.empty()) {
+                break;
+            }
+            while (count < MAX_BATCH && !queue_.empty()) {
+                batch[count++] = std::move(queue_.front());
+                queue_.pop_front();
+            }
+        }
+        depth_->add(-static_cast<int64_t>(count));
+        not_full_.notify_all();
+
+        size_t delivered = deliver(batch, count);
+        delivered_count_->add(delivered);
+        if (delivered < count) {
+            failed_count_->add(count - delivered);
+        }
+
+        // 投递完即释放引用，最后一个释放的输出端把缓冲放回池中
+        for (size_t i = 0; i < count; ++i) {
+            batch[i].reset();
+        }
+    }
+}
+
+const std::string& Sink::name() const {
+    return name_;
+}
+
+size_t Sink::getDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+uint64_t Sink::getDeliveredCount() const {
+    return delivered_count_->value();
+}
+
+uint64_t Sink::getDroppedCount() const {
+    return dropped_count_->value();
+}
+
+uint64_t Sink::getFailedCount() const {
+    return failed_count_->value();
+}
+
+bool Sink::parseType(const std::string& name, Type& type) {
+    if (name == "record") {
+        type = Type::Record;
+    } else if (name == "mirror") {
+        type = Type::Mirror;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool Sink::parsePolicy(const std::string& name, Policy& policy) {
+    if (name == "block") {
+        policy = Policy::Block;
+    } else if (name == "drop_newest") {
+        policy = Policy::DropNewest;
+    } else if (name == "drop_oldest") {
+        policy = Policy::DropOldest;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool Sink::validate(const Config& config, std::string& error) {
+    if (config.capacity == 0) {
+        error = "capacity must be at least 1";
+        return false;
+    }
+    if (config.type == Type::Record && config.path.empty()) {
+        error = "record sink needs a path";
+        return false;
+    }
+    if (config.type == Type::Mirror && (config.host.empty() || config.port <= 0 || config.port > 65535)) {
+        error = "mirror sink needs a host and a port between 1 and 65535";
+        return false;
+    }
+    return true;
+}
+
+const Sink::Config& Sink::config() const {
+    return config_;
+}
+
+const std::string& Sink::bridge() const {
+    return bridge_;
+}
+
+RecordSink::RecordSink(const Config& config, const std::string& bridge)
+    : Sink(config, bridge), writer_(config.path), channel_(0) {
+}
+
+RecordSink::~RecordSink() {
+    stop();
+}
+
+bool RecordSink::open() {
+    if (!writer_.open()) {
+        return false;
+    }
+    channel_ = writer_.channel(bridge());
+    return true;
+}
+
+void RecordSink::close() {
+    writer_.close();
+}
+
+size_t RecordSink::deliver(const PacketRef* packets, size_t count) {
+    // 没有发送方地址的报文（地址族为AF_UNSPEC）：录制文件中地址族为0表示文件结束，改记为0.0.0.0:0
+    struct sockaddr_storage unknown;
+    memset(&unknown, 0, sizeof(unknown));
+    unknown.ss_family = AF_INET;
+
+    for (size_t i = 0; i < count; ++i) {
+        const PacketBuffer& packet = *packets[i];
+        const struct sockaddr_storage& source = packet.source.ss_family == AF_UNSPEC ? unknown : packet.source;
+        writer_.append(channel_, source, packet.rx_ts_ns, packet.data.data(), packet.data.size());
+    }
+    return count;
+}
+
+MirrorSink::MirrorSink(const Config& config, const std::string& bridge)
+    : Sink(config, bridge), sender_(config.host, config.port) {
+}
+
+MirrorSink::~MirrorSink() {
+    stop();
+}
+
+bool MirrorSink::open() {
+    return sender_.open();
+}
+
+void MirrorSink::close() {
+    sender_.close();
+}
+
+size_t MirrorSink::deliver(const PacketRef* packets, size_t count) {
+    // 直接从共享缓冲发送，不复制
+    for (size_t i = 0; i < count; ++i) {
+        views_[i] = packets[i]->data;
+    }
+    return sender_.sendBatch(views_, count);
+}
+
+FanOut::FanOut(const std::vector<Sink::Config>& sinks, const std::string& bridge) {
+    for (const auto& config : sinks) {
+        sinks_.push_back(Sink::create(config, bridge));
+    }
+}
+
+FanOut::~FanOut() {
+    stop();
+}
+
+bool FanOut::start() {
+    for (size_t i = 0; i < sinks_.size(); ++i) {
+        if (!sinks_[i]->start()) {
+            for (size_t j = 0; j < i; ++j) {
+                sinks_[j]->stop();
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+void FanOut::stop() {
+    for (auto& sink : sinks_) {
+        sink->stop();
+    }
+}
+
+void FanOut::dispatch(const std::string& data, const struct sockaddr_storage& source, uint64_t rx_ts_ns) {
+    if (sinks_.empty()) {
+        return;
+    }
+
+    PacketRef packet = pool_.acquire(data.data(), data.size(), source, rx_ts_ns);
+    for (auto& sink : sinks_) {
+        sink->offer(packet);
+    }
+}
+
+size_t FanOut::sinkCount() const {
+    return sinks_.size();
+}
+
+const Sink& FanOut::sink(size_t index) const {
+    return *sinks_[index];
+}
+
+const PacketBufferPool& FanOut::pool() const {
+    return pool_;
+}
@@ -0,0 +1,117 @@
+#include "thread_tuning.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <tuple>
+
+std::mutex ThreadTuning::mutex_;
+ThreadTuning::Config ThreadTuning::config_;
+
+bool ThreadTuning::Settings::operator==(const Settings& other) const {
+    return std::tie(cpus, priority) == std::tie(other.cpus, other.priority);
+}
+
+bool ThreadTuning::Config::operator==(const Config& other) const {
+    return std::tie(receive, publish, network) == std::tie(other.receive, other.publish, other.network);
+}
+
+void ThreadTuning::configure(const Config& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+}
+
+bool ThreadTuning::apply(Role role, const std::string& name, int slot) {
+    Settings settings;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        switch (role) {
+        case Role::Receive:
+            settings = config_.receive;
+            break;
+        case Role::Publish:
+            settings = config_.publish;
+            break;
+        case Role::Network:
+            settings = config_.network;
+            break;
+        }
+    }
+
+    // 每个反应器各占一个核
+    if (slot >= 0 && settings.cpus.size() > 1) {
+        settings.cpus = {settings.cpus[static_cast<size_t>(slot) % settings.cpus.size()]};
+    }
+    return apply(settings, name);
+}
+
+bool ThreadTuning::apply(const Settings& settings, const std::string& name) {
+    // 线程名便于在top -H、perf中区分各线程
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+
+    if (!settings.enabled()) {
+        return true;
+    }
+
+    std::string error;
+    if (!validate(settings, error)) {
+        std::cerr << "[Threads] " << name << ": " << error << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    std::string applied;
+
+    if (!settings.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : settings.cpus) {
+            CPU_SET(cpu, &set);
+        }
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0) {
+            std::cerr << "[Threads] Failed to pin " << name << " to the configured CPUs: " << strerror(rc) << std::endl;
+            ok = false;
+        } else {
+            applied += " cpus=";
+            for (size_t i = 0; i < settings.cpus.size(); ++i) {
+                applied += (i > 0 ? "," : "") + std::to_string(settings.cpus[i]);
+            }
+        }
+    }
+
+    if (settings.priority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = settings.priority;
+        int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc != 0) {
+            std::cerr << "[Threads] Failed to set SCHED_FIFO priority " << settings.priority << " for " << name
+                      << ": " << strerror(rc) << (rc == EPERM ? " (needs CAP_SYS_NICE or RLIMIT_RTPRIO)" : "")
+                      << std::endl;
+            ok = false;
+        } else {
+            applied += " SCHED_FIFO=" + std::to_string(settings.priority);
+        }
+    }
+
+    if (!applied.empty()) {
+        std::cout << "[Threads] " << name << ":" << applied << std::endl;
+    }
+    return ok;
+}
+
+bool ThreadTuning::validate(const Settings& settings, std::string& error) {
+    for (int cpu : settings.cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            error = "invalid CPU " + std::to_string(cpu);
+            return false;
+        }
+    }
+    if (settings.priority < 0 || settings.priority > 99) {
+        error = "priority must be between 0 and 99 (got " + std::to_string(settings.priority) + ")";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,225 @@
+#include "udp_event_loop.h"
+#include "thread_tuning.h"
+#include <chrono>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+UdpEventLoop::UdpEventLoop(int spin_us, int slot)
+    : epoll_fd_(-1), wake_fd_(-1), spin_us_(spin_us), slot_(slot), running_(false), next_tick_id_(0) {
+}
+
+UdpEventLoop::~UdpEventLoop() {
+    stop();
+}
+
+bool UdpEventLoop::start() {
+    if (running_) {
+        std::cerr << "UDP event loop is already running" << std::endl;
+        return false;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        std::cerr << "Failed to create epoll instance: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        std::cerr << "Failed to create eventfd: " << strerror(errno) << std::endl;
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) < 0) {
+        std::cerr << "Failed to register eventfd: " << strerror(errno) << std::endl;
+        close(wake_fd_);
+        close(epoll_fd_);
+        wake_fd_ = -1;
+        epoll_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    loop_thread_ = std::thread(&UdpEventLoop::run, this);
+
+    std::cout << "UDP event loop started" << (slot_ >= 0 ? " (reactor " + std::to_string(slot_) + ")" : "")
+              << (spin_us_ > 0 ? " (low-latency spin " + std::to_string(spin_us_) + " us)" : "")
+              << std::endl;
+    return true;
+}
+
+void UdpEventLoop::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+
+    uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) < 0) {
+        // 写失败时循环会在超时后退出
+    }
+
+    if (loop_thread_.joinable()) {
+        loop_thread_.join();
+    }
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(handlers_mutex_);
+        handlers_.clear();
+        ticks_.clear();
+    }
+
+    close(wake_fd_);
+    close(epoll_fd_);
+    wake_fd_ = -1;
+    epoll_fd_ = -1;
+
+    std::cout << "UDP event loop stopped" << std::endl;
+}
+
+bool UdpEventLoop::isRunning() const {
+    return running_;
+}
+
+bool UdpEventLoop::add(int fd, ReadyCallback callback) {
+    return add(fd, EPOLLIN, [callback](uint32_t) { callback(); });
+}
+
+bool UdpEventLoop::add(int fd, uint32_t events, EventCallback callback) {
+    if (!running_) {
+        std::cerr << "UDP event loop is not running" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(handlers_mutex_);
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        std::cerr << "Failed to register socket with event loop: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    handlers_[fd] = std::make_shared<EventCallback>(std::move(callback));
+    return true;
+}
+
+bool UdpEventLoop::modify(int fd, uint32_t events) {
+    std::lock_guard<std::recursive_mutex> lock(handlers_mutex_);
+
+    if (handlers_.count(fd) == 0 || epoll_fd_ < 0) {
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) < 0) {
+        std::cerr << "Failed to modify socket events: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void UdpEventLoop::remove(int fd) {
+    std::lock_guard<std::recursive_mutex> lock(handlers_mutex_);
+
+    // 套接字可能已被关闭（epoll自动移除），此时EPOLL_CTL_DEL失败无影响
+    if (handlers_.erase(fd) > 0 && epoll_fd_ >= 0) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+int UdpEventLoop::addTick(ReadyCallback callback) {
+    std::lock_guard<std::recursive_mutex> lock(handlers_mutex_);
+    int id = next_tick_id_++;
+    ticks_.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void UdpEventLoop::removeTick(int id) {
+    std::lock_guard<std::recursive_mutex> lock(handlers_mutex_);
+    for (auto it = ticks_.begin(); it != ticks_.end(); ++it) {
+        if (it->first == id) {
+            ticks_.erase(it);
+            return;
+        }
+    }
+}
+
+void UdpEventLoop::wake() {
+    if (wake_fd_ < 0) {
+        return;
+    }
+    uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) < 0) {
+        // 计数器已满时循环本来就会被唤醒
+    }
+}
+
+void UdpEventLoop::run() {
+    const int MAX_EVENTS = 64;
+    struct epoll_event events[MAX_EVENTS];
+
+    ThreadTuning::apply(ThreadTuning::Role::Receive,
+                        slot_ >= 0 ? "reactor-" + std::to_string(slot_) : "udp-rx-loop", slot_);
+
+    // 低延迟模式下，最近一次有事件后的spin_us内只做零超时轮询
+    auto spin = std::chrono::microseconds(spin_us_);
+    auto last_event = std::chrono::steady_clock::now();
+
+    while (running_) {
+        int timeout_ms = 1000;
+        if (spin_us_ > 0 && std::chrono::steady_clock::now() - last_event < spin) {
+            timeout_ms = 0;
+        }
+
+        int n = epoll_wait(epoll_fd_, events, MAX_EVENTS, timeout_ms);
+        if (n < 0) {
+            if (errno != EINTR) {
+                std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            }
+            continue;
+        }
+        if (n > 0 && spin_us_ > 0) {
+            last_event = std::chrono::steady_clock::now();
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t value;
+                while (read(wake_fd_, &value, sizeof(value)) > 0) {
+                }
+                continue;
+            }
+
+            // 持锁分发：已取消注册的套接字直接跳过
+            std::lock_guard<std::recursive_mutex> lock(handlers_mutex_);
+            auto it = handlers_.find(fd);
+            if (it != handlers_.end()) {
+                std::shared_ptr<EventCallback> handler = it->second;
+                (*handler)(events[i].events);
+            }
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(handlers_mutex_);
+        for (auto& tick : ticks_) {
+            tick.second();
+        }
+    }
+}
@@ -1,27 +1,306 @@
 #include "udp_receiver.h"
+#include "thread_tuning.h"
+#include "udp_event_loop.h"
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <cstring>
+#include <cerrno>
+#include <cstdlib>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <netinet/udp.h>
+#include <net/if.h>
+#include <ifaddrs.h>
+#include <poll.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <chrono>
+
+static uint64_t steadyNowMs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
+static uint64_t realtimeNowNs() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+// 解析IPv6网卡：为空返回0（由系统选择），数字按索引，否则按网卡名查找；无效时返回false
+static bool resolveInterfaceIndex(const std::string& iface, unsigned int& ifindex) {
+    if (iface.empty()) {
+        ifindex = 0;
+        return true;
+    }
+    if (iface.find_first_not_of("0123456789") == std::string::npos) {
+        ifindex = static_cast<unsigned int>(strtoul(iface.c_str(), nullptr, 10));
+        return true;
+    }
+    ifindex = if_nametoindex(iface.c_str());
+    return ifindex != 0;
+}
+
+// 查找配置了该IPv4地址的网卡索引
+static bool interfaceIndexForAddress(const std::string& address, unsigned int& ifindex) {
+    struct in_addr wanted;
+    if (inet_pton(AF_INET, address.c_str(), &wanted) != 1) {
+        return false;
+    }
+
+    struct ifaddrs* list;
+    if (getifaddrs(&list) < 0) {
+        return false;
+    }
+    ifindex = 0;
+    for (struct ifaddrs* ifa = list; ifa; ifa = ifa->ifa_next) {
+        if (ifa->ifa_addr && ifa->ifa_addr->sa_family == AF_INET &&
+            reinterpret_cast<struct sockaddr_in*>(ifa->ifa_addr)->sin_addr.s_addr == wanted.s_addr) {
+            ifindex = if_nametoindex(ifa->ifa_name);
+            break;
+        }
+    }
+    freeifaddrs(list);
+    return ifindex != 0;
+}
+
+// 解析源地址列表，用于在用户态比较报文的发送者
+static bool parseSourceList(const std::vector<std::string>& sources, int family,
+                            std::vector<struct sockaddr_storage>& parsed) {
+    parsed.clear();
+    for (const auto& source : sources) {
+        struct sockaddr_storage addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.ss_family = static_cast<sa_family_t>(family);
+        void* dst = family == AF_INET6
+            ? static_cast<void*>(&reinterpret_cast<struct sockaddr_in6&>(addr).sin6_addr)
+            : static_cast<void*>(&reinterpret_cast<struct sockaddr_in&>(addr).sin_addr);
+        if (inet_pton(family, source.c_str(), dst) != 1) {
+            std::cerr << "Invalid source address: " << source << std::endl;
+            return false;
+        }
+        parsed.push_back(addr);
+    }
+    return true;
+}
+
+// 只比较地址，不比较端口
+static bool sameAddress(const struct sockaddr_storage& a, const struct sockaddr_storage& b) {
+    if (a.ss_family != b.ss_family) {
+        return false;
+    }
+    if (a.ss_family == AF_INET6) {
+        return memcmp(&reinterpret_cast<const struct sockaddr_in6&>(a).sin6_addr,
+                      &reinterpret_cast<const struct sockaddr_in6&>(b).sin6_addr, sizeof(struct in6_addr)) == 0;
+    }
+    return reinterpret_cast<const struct sockaddr_in&>(a).sin_addr.s_addr ==
+           reinterpret_cast<const struct sockaddr_in&>(b).sin_addr.s_addr;
+}
+
+// 由源地址和端口得到分片重组使用的发送者标识
+static uint64_t sourceKey(const struct sockaddr_storage& src_addr) {
+    if (src_addr.ss_family == AF_INET6) {
+        const auto& sin6 = reinterpret_cast<const struct sockaddr_in6&>(src_addr);
+        uint64_t hi;
+        uint64_t lo;
+        memcpy(&hi, sin6.sin6_addr.s6_addr, sizeof(hi));
+        memcpy(&lo, sin6.sin6_addr.s6_addr + 8, sizeof(lo));
+        return (hi * 0x9E3779B97F4A7C15ULL) ^ lo ^ (static_cast<uint64_t>(sin6.sin6_port) << 48);
+    }
+    const auto& sin = reinterpret_cast<const struct sockaddr_in&>(src_addr);
+    return (static_cast<uint64_t>(sin.sin_addr.s_addr) << 16) | sin.sin_port;
+}
+
+std::string UdpReceiver::formatSource(const struct sockaddr_storage& src_addr) {
+    char buffer[INET6_ADDRSTRLEN + 8];
+    size_t len = formatSource(src_addr, buffer, sizeof(buffer));
+    return std::string(buffer, len);
+}
+
+size_t UdpReceiver::formatSource(const struct sockaddr_storage& src_addr, char* buffer, size_t size) {
+    char host[INET6_ADDRSTRLEN] = "";
+    int len;
+    if (src_addr.ss_family == AF_UNSPEC) {
+        // 重排窗口到期后放行的消息不再保留来源
+        len = snprintf(buffer, size, "(reorder buffer)");
+    } else if (src_addr.ss_family == AF_INET6) {
+        const auto& sin6 = reinterpret_cast<const struct sockaddr_in6&>(src_addr);
+        inet_ntop(AF_INET6, &sin6.sin6_addr, host, sizeof(host));
+        len = snprintf(buffer, size, "[%s]:%u", host, ntohs(sin6.sin6_port));
+    } else {
+        const auto& sin = reinterpret_cast<const struct sockaddr_in&>(src_addr);
+        inet_ntop(AF_INET, &sin.sin_addr, host, sizeof(host));
+        len = snprintf(buffer, size, "%s:%u", host, ntohs(sin.sin_port));
+    }
+    if (len < 0 || size == 0) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>(len), size - 1);
+}
 
 UdpReceiver::UdpReceiver(const std::string& multicast_addr, int port, const std::string& interface)
-    : multicast_addr_(multicast_addr), port_(port), interface_(interface), socket_fd_(-1), running_(false) {
+    : multicast_addr_(multicast_addr), port_(port), interface_(interface), socket_fd_(-1), family_(AF_INET), running_(false),
+      event_loop_(nullptr), kernel_drops_seen_(0), reassembly_dropped_seen_(0), timer_fd_(-1), rx_ts_ns_(0),
+      capture_channel_(0) {
 }
 
 UdpReceiver::~UdpReceiver() {
     stop();
 }
 
+// 只关心消息内容的回调包装为带接收信息的回调
+static UdpReceiver::MessageCallback withoutInfo(UdpReceiver::ReceiveCallback callback) {
+    if (!callback) {
+        return nullptr;
+    }
+    return [callback](const std::string& message, const UdpReceiver::MessageInfo&) { callback(message); };
+}
+
 bool UdpReceiver::start(ReceiveCallback callback) {
+    return start(withoutInfo(callback));
+}
+
+bool UdpReceiver::start(UdpEventLoop& loop, ReceiveCallback callback) {
+    return start(loop, withoutInfo(callback));
+}
+
+bool UdpReceiver::start(MessageCallback callback) {
+    if (running_) {
+        std::cerr << "UDP receiver is already running" << std::endl;
+        return false;
+    }
+
+    if (!openSocket()) {
+        return false;
+    }
+
+    running_ = true;
+    receive_thread_ = std::thread(&UdpReceiver::receiveLoop, this, callback);
+    
+    std::cout << "UDP receiver started on " << multicast_addr_ << ":" << port_
+              << (ring_ ? " (packet ring)" : "") << std::endl;
+    return true;
+}
+
+bool UdpReceiver::start(UdpEventLoop& loop, MessageCallback callback) {
+    if (running_) {
+        std::cerr << "UDP receiver is already running" << std::endl;
+        return false;
+    }
+
+    if (!openSocket()) {
+        return false;
+    }
+
+    // 事件循环模式使用非阻塞套接字，每次可读时读到EAGAIN为止
+    int flags = fcntl(socket_fd_, F_GETFL, 0);
+    fcntl(socket_fd_, F_SETFL, flags | O_NONBLOCK);
+
+    callback_ = callback;
+    event_loop_ = &loop;
+    running_ = true;
+    if (!loop.add(receiveFd(), [this]() { this->drain(); })) {
+        running_ = false;
+        event_loop_ = nullptr;
+        ring_.reset();
+        close(socket_fd_);
+        socket_fd_ = -1;
+        return false;
+    }
+
+    // 重排缓冲需要在没有新报文时也能按期限放行
+    if (sequence_ && sequence_->reordering()) {
+        timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        auto on_timer = [this]() {
+            uint64_t expirations;
+            while (read(timer_fd_, &expirations, sizeof(expirations)) > 0) {
+            }
+            flushSequence(callback_);
+        };
+        if (timer_fd_ >= 0 && !loop.add(timer_fd_, on_timer)) {
+            close(timer_fd_);
+            timer_fd_ = -1;
+        }
+        if (timer_fd_ < 0) {
+            std::cerr << "Failed to create reorder timer, held messages are released on the next wakeup" << std::endl;
+        }
+    }
+
+    std::cout << "UDP receiver started on " << multicast_addr_ << ":" << port_
+              << (ring_ ? " (packet ring, shared event loop)" : " (shared event loop)") << std::endl;
+    return true;
+}
+
+void UdpReceiver::initProcessing() {
+    if (options_.framing.enabled) {
+        reassembler_.reset(new Reassembler(options_.framing));
+    } else {
+        reassembler_.reset();
+    }
+    reassembly_dropped_seen_ = 0;
+
+    if (options_.sequence.enabled) {
+        sequence_.reset(new SequenceTracker(options_.sequence));
+    } else {
+        sequence_.reset();
+    }
+    sequence_seen_ = SequenceTracker::Statistics();
+}
+
+bool UdpReceiver::startReplay(MessageCallback callback) {
     if (running_) {
         std::cerr << "UDP receiver is already running" << std::endl;
         return false;
     }
 
+    initProcessing();
+    callback_ = callback;
+    running_ = true;
+    std::cout << "UDP receiver for " << multicast_addr_ << ":" << port_ << " in replay mode" << std::endl;
+    return true;
+}
+
+void UdpReceiver::inject(const char* data, int len, const struct sockaddr_storage& src_addr, uint64_t rx_ts_ns) {
+    if (!running_) {
+        return;
+    }
+
+    rx_ts_ns_ = rx_ts_ns;
+    if (metrics_.rx_packets) {
+        metrics_.rx_packets->add(1);
+    }
+    if (metrics_.rx_bytes) {
+        metrics_.rx_bytes->add(len);
+    }
+    deliver(data, len, 0, src_addr, callback_);
+
+    if (sequence_ && sequence_->reordering()) {
+        flushSequence(callback_);
+    }
+}
+
+bool UdpReceiver::openSocket() {
+    if (!join_.sources.empty() && !join_.exclude_sources.empty()) {
+        std::cerr << "Source include and exclude lists cannot be combined" << std::endl;
+        return false;
+    }
+
+    // 按组地址的格式选择协议族
+    struct in_addr group;
+    struct in6_addr group6;
+    if (inet_pton(AF_INET, multicast_addr_.c_str(), &group) == 1) {
+        family_ = AF_INET;
+    } else if (inet_pton(AF_INET6, multicast_addr_.c_str(), &group6) == 1) {
+        family_ = AF_INET6;
+    } else {
+        std::cerr << "Invalid multicast address: " << multicast_addr_ << std::endl;
+        return false;
+    }
+
     // 创建UDP套接字
-    socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    socket_fd_ = socket(family_, SOCK_DGRAM, 0);
     if (socket_fd_ < 0) {
         std::cerr << "Failed to create UDP socket" << std::endl;
         return false;
@@ -36,56 +315,308 @@ bool UdpReceiver::start(ReceiveCallback callback) {
         return false;
     }
 
-    // 绑定到指定端口
+    // 通过SO_RXQ_OVFL获取因接收缓冲区满而被内核丢弃的报文数（不支持时忽略）
+    int ovfl = 1;
+    setsockopt(socket_fd_, SOL_SOCKET, SO_RXQ_OVFL, &ovfl, sizeof(ovfl));
+    kernel_drops_seen_ = 0;
+
+    // 通过SO_TIMESTAMPNS取得内核收到报文的时间，不受接收线程调度延迟影响（不支持时回退为处理时间）
+    int timestamp = 1;
+    setsockopt(socket_fd_, SOL_SOCKET, SO_TIMESTAMPNS, &timestamp, sizeof(timestamp));
+
+    // 低延迟模式：接收时先忙轮询网卡队列，省去中断和唤醒的延迟；
+    // 超过net.core.busy_read的值需要CAP_NET_ADMIN，失败时按普通方式接收
+    if (options_.busy_poll_us > 0) {
+        int busy_poll = options_.busy_poll_us;
+        if (setsockopt(socket_fd_, SOL_SOCKET, SO_BUSY_POLL, &busy_poll, sizeof(busy_poll)) < 0) {
+            std::cerr << "Failed to enable SO_BUSY_POLL (" << strerror(errno) << "), using interrupt-driven receive"
+                      << std::endl;
+        }
+    }
+
+    // GRO合并的报文最长64KB，缓冲区按最大值分配
+    size_t buffer_size = options_.max_datagram_size;
+    if (buffer_size == 0 || buffer_size > 65535) {
+        buffer_size = 65535;
+    }
+    if (options_.gro) {
+        int gro = 1;
+        if (setsockopt(socket_fd_, IPPROTO_UDP, UDP_GRO, &gro, sizeof(gro)) < 0) {
+            std::cerr << "UDP_GRO not supported, receiving datagrams one by one: " << strerror(errno) << std::endl;
+        } else {
+            buffer_size = 65535;
+        }
+    }
+    buffer_.assign(buffer_size, 0);
+    initProcessing();
+
+    bool joined = family_ == AF_INET6 ? bindAndJoin6(group6) : bindAndJoin4(group);
+    if (!joined || (options_.backend == ReceiveOptions::Backend::PacketRing && !openRing())) {
+        close(socket_fd_);
+        socket_fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+bool UdpReceiver::openRing() {
+    struct sockaddr_storage group;
+    memset(&group, 0, sizeof(group));
+    if (family_ == AF_INET6) {
+        auto& sin6 = reinterpret_cast<struct sockaddr_in6&>(group);
+        sin6.sin6_family = AF_INET6;
+        sin6.sin6_port = htons(port_);
+        inet_pton(AF_INET6, multicast_addr_.c_str(), &sin6.sin6_addr);
+    } else {
+        auto& sin = reinterpret_cast<struct sockaddr_in&>(group);
+        sin.sin_family = AF_INET;
+        sin.sin_port = htons(port_);
+        inet_pton(AF_INET, multicast_addr_.c_str(), &sin.sin_addr);
+    }
+
+    // 只有一个网卡时绑定到该网卡，否则读取全部网卡
+    std::vector<std::string> interfaces = join_.interfaces;
+    if (interfaces.empty()) {
+        interfaces.push_back(interface_);
+    }
+    unsigned int ifindex = 0;
+    if (interfaces.size() == 1 && !interfaces.front().empty()) {
+        bool found = family_ == AF_INET6 ? resolveInterfaceIndex(interfaces.front(), ifindex)
+                                         : interfaceIndexForAddress(interfaces.front(), ifindex);
+        if (!found) {
+            std::cerr << "Cannot find network interface " << interfaces.front() << " for packet ring" << std::endl;
+            return false;
+        }
+    }
+
+    if (!parseSourceList(join_.sources, family_, ring_sources_) ||
+        !parseSourceList(join_.exclude_sources, family_, ring_excluded_)) {
+        return false;
+    }
+
+    ring_.reset(new PacketRing(options_.ring));
+    if (!ring_->open(group, ifindex)) {
+        ring_.reset();
+        return false;
+    }
+    return true;
+}
+
+int UdpReceiver::receiveFd() const {
+    return ring_ ? ring_->fd() : socket_fd_;
+}
+
+bool UdpReceiver::bindAndJoin4(const struct in_addr& group) {
+    // 只接收本套接字加入的组（默认会收到本机任意套接字加入的同端口组播）
+    int all = 0;
+    setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_ALL, &all, sizeof(all));
+
+    // 绑定到组地址，内核不再把发往该端口的单播和其他组的报文交给本套接字
     struct sockaddr_in addr;
     memset(&addr, 0, sizeof(addr));
     addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = htonl(INADDR_ANY);
-    addr.sin_port = htons(port_);
+    addr.sin_addr.s_addr = join_.bind_group ? group.s_addr : htonl(INADDR_ANY);
+    // 环形缓冲区接收时套接字只负责加入组，绑定临时端口，不排队接收报文
+    addr.sin_port = htons(options_.backend == ReceiveOptions::Backend::PacketRing ? 0 : port_);
 
     if (bind(socket_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
         std::cerr << "Failed to bind UDP socket to port " << port_ << std::endl;
-        close(socket_fd_);
-        socket_fd_ = -1;
         return false;
     }
 
-    // 加入组播组
-    struct ip_mreq mreq;
-    mreq.imr_multiaddr.s_addr = inet_addr(multicast_addr_.c_str());
-    if (mreq.imr_multiaddr.s_addr == INADDR_NONE) {
-        std::cerr << "Invalid multicast address: " << multicast_addr_ << std::endl;
-        close(socket_fd_);
-        socket_fd_ = -1;
+    // 在每个网卡上加入组播组：未指定网卡列表时使用interface，为空则由系统选择
+    std::vector<std::string> interfaces = join_.interfaces;
+    if (interfaces.empty()) {
+        interfaces.push_back(interface_);
+    }
+
+    for (const auto& iface : interfaces) {
+        struct in_addr iface_addr;
+        if (!iface.empty()) {
+            if (inet_pton(AF_INET, iface.c_str(), &iface_addr) != 1) {
+                std::cerr << "Invalid interface address: " << iface << std::endl;
+                return false;
+            }
+            std::cout << "Using network interface: " << iface << std::endl;
+        } else {
+            iface_addr.s_addr = htonl(INADDR_ANY);
+            std::cout << "Using INADDR_ANY (system will auto-select interface)" << std::endl;
+        }
+
+        if (!joinGroup(group, iface_addr)) {
+            std::cerr << "Failed to join multicast group " << multicast_addr_
+                      << (iface.empty() ? "" : " on " + iface) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool UdpReceiver::bindAndJoin6(const struct in6_addr& group) {
+    // 只收IPv6，IPv4组由单独的接收器负责
+    int v6only = 1;
+    setsockopt(socket_fd_, IPPROTO_IPV6, IPV6_V6ONLY, &v6only, sizeof(v6only));
+
+#ifdef IPV6_MULTICAST_ALL
+    int all = 0;
+    setsockopt(socket_fd_, IPPROTO_IPV6, IPV6_MULTICAST_ALL, &all, sizeof(all));
+#endif
+
+    std::vector<std::string> interfaces = join_.interfaces;
+    if (interfaces.empty()) {
+        interfaces.push_back(interface_);
+    }
+
+    std::vector<unsigned int> indexes;
+    for (const auto& iface : interfaces) {
+        unsigned int ifindex;
+        if (!resolveInterfaceIndex(iface, ifindex)) {
+            std::cerr << "Invalid network interface: " << iface << std::endl;
+            return false;
+        }
+        indexes.push_back(ifindex);
+    }
+
+    struct sockaddr_in6 addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = join_.bind_group ? group : in6addr_any;
+    addr.sin6_port = htons(options_.backend == ReceiveOptions::Backend::PacketRing ? 0 : port_);
+    // 链路本地范围的组地址绑定时需要指定网卡
+    if (join_.bind_group && IN6_IS_ADDR_MC_LINKLOCAL(&group)) {
+        addr.sin6_scope_id = indexes.front();
+    }
+
+    if (bind(socket_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        std::cerr << "Failed to bind UDP socket to port " << port_ << ": " << strerror(errno) << std::endl;
         return false;
     }
-    
-    // 设置网卡接口：如果指定了interface，则使用指定的；否则使用INADDR_ANY自动选择
-    if (!interface_.empty()) {
-        mreq.imr_interface.s_addr = inet_addr(interface_.c_str());
-        if (mreq.imr_interface.s_addr == INADDR_NONE) {
-            std::cerr << "Invalid interface address: " << interface_ << std::endl;
-            close(socket_fd_);
-            socket_fd_ = -1;
+
+    for (size_t i = 0; i < interfaces.size(); ++i) {
+        if (indexes[i] != 0) {
+            std::cout << "Using network interface: " << interfaces[i] << " (index " << indexes[i] << ")" << std::endl;
+        } else {
+            std::cout << "Using default interface (system will auto-select)" << std::endl;
+        }
+
+        if (!joinGroup6(group, indexes[i])) {
+            std::cerr << "Failed to join multicast group " << multicast_addr_
+                      << (interfaces[i].empty() ? "" : " on " + interfaces[i]) << std::endl;
             return false;
         }
-        std::cout << "Using network interface: " << interface_ << std::endl;
-    } else {
-        mreq.imr_interface.s_addr = htonl(INADDR_ANY);
-        std::cout << "Using INADDR_ANY (system will auto-select interface)" << std::endl;
     }
 
+    return true;
+}
+
+bool UdpReceiver::joinGroup(const struct in_addr& group, const struct in_addr& iface) {
+    // 源特定组播（SSM）：只接收包含列表中的发送者，其余在内核中过滤
+    if (!join_.sources.empty()) {
+        for (const auto& source : join_.sources) {
+            struct ip_mreq_source mreq;
+            memset(&mreq, 0, sizeof(mreq));
+            mreq.imr_multiaddr = group;
+            mreq.imr_interface = iface;
+            if (inet_pton(AF_INET, source.c_str(), &mreq.imr_sourceaddr) != 1) {
+                std::cerr << "Invalid source address: " << source << std::endl;
+                return false;
+            }
+            if (setsockopt(socket_fd_, IPPROTO_IP, IP_ADD_SOURCE_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+                std::cerr << "IP_ADD_SOURCE_MEMBERSHIP failed for source " << source
+                          << ": " << strerror(errno) << std::endl;
+                return false;
+            }
+            std::cout << "Joined " << multicast_addr_ << " for source " << source << std::endl;
+        }
+        return true;
+    }
+
+    struct ip_mreq mreq;
+    mreq.imr_multiaddr = group;
+    mreq.imr_interface = iface;
     if (setsockopt(socket_fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
-        std::cerr << "Failed to join multicast group" << std::endl;
-        close(socket_fd_);
-        socket_fd_ = -1;
         return false;
     }
 
-    running_ = true;
-    receive_thread_ = std::thread(&UdpReceiver::receiveLoop, this, callback);
-    
-    std::cout << "UDP receiver started on " << multicast_addr_ << ":" << port_ << std::endl;
+    // 任意源加入后屏蔽排除列表中的发送者
+    for (const auto& source : join_.exclude_sources) {
+        struct ip_mreq_source block;
+        memset(&block, 0, sizeof(block));
+        block.imr_multiaddr = group;
+        block.imr_interface = iface;
+        if (inet_pton(AF_INET, source.c_str(), &block.imr_sourceaddr) != 1) {
+            std::cerr << "Invalid source address: " << source << std::endl;
+            return false;
+        }
+        if (setsockopt(socket_fd_, IPPROTO_IP, IP_BLOCK_SOURCE, &block, sizeof(block)) < 0) {
+            std::cerr << "IP_BLOCK_SOURCE failed for source " << source
+                      << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        std::cout << "Blocked source " << source << " on " << multicast_addr_ << std::endl;
+    }
+    return true;
+}
+
+bool UdpReceiver::joinGroup6(const struct in6_addr& group, unsigned int ifindex) {
+    struct sockaddr_in6 group_addr;
+    memset(&group_addr, 0, sizeof(group_addr));
+    group_addr.sin6_family = AF_INET6;
+    group_addr.sin6_addr = group;
+
+    // 按源加入和屏蔽使用协议无关的MCAST_*接口
+    auto sourceRequest = [&](const std::string& source, struct group_source_req& req) {
+        memset(&req, 0, sizeof(req));
+        req.gsr_interface = ifindex;
+        memcpy(&req.gsr_group, &group_addr, sizeof(group_addr));
+        struct sockaddr_in6 source_addr;
+        memset(&source_addr, 0, sizeof(source_addr));
+        source_addr.sin6_family = AF_INET6;
+        if (inet_pton(AF_INET6, source.c_str(), &source_addr.sin6_addr) != 1) {
+            std::cerr << "Invalid source address: " << source << std::endl;
+            return false;
+        }
+        memcpy(&req.gsr_source, &source_addr, sizeof(source_addr));
+        return true;
+    };
+
+    if (!join_.sources.empty()) {
+        for (const auto& source : join_.sources) {
+            struct group_source_req req;
+            if (!sourceRequest(source, req)) {
+                return false;
+            }
+            if (setsockopt(socket_fd_, IPPROTO_IPV6, MCAST_JOIN_SOURCE_GROUP, &req, sizeof(req)) < 0) {
+                std::cerr << "MCAST_JOIN_SOURCE_GROUP failed for source " << source
+                          << ": " << strerror(errno) << std::endl;
+                return false;
+            }
+            std::cout << "Joined " << multicast_addr_ << " for source " << source << std::endl;
+        }
+        return true;
+    }
+
+    struct ipv6_mreq mreq;
+    mreq.ipv6mr_multiaddr = group;
+    mreq.ipv6mr_interface = ifindex;
+    if (setsockopt(socket_fd_, IPPROTO_IPV6, IPV6_JOIN_GROUP, &mreq, sizeof(mreq)) < 0) {
+        std::cerr << "IPV6_JOIN_GROUP failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    for (const auto& source : join_.exclude_sources) {
+        struct group_source_req req;
+        if (!sourceRequest(source, req)) {
+            return false;
+        }
+        if (setsockopt(socket_fd_, IPPROTO_IPV6, MCAST_BLOCK_SOURCE, &req, sizeof(req)) < 0) {
+            std::cerr << "MCAST_BLOCK_SOURCE failed for source " << source
+                      << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        std::cout << "Blocked source " << source << " on " << multicast_addr_ << std::endl;
+    }
     return true;
 }
 
@@ -96,10 +627,25 @@ void UdpReceiver::stop() {
 
     running_ = false;
 
+    if (event_loop_) {
+        event_loop_->remove(receiveFd());
+        if (timer_fd_ >= 0) {
+            event_loop_->remove(timer_fd_);
+        }
+        event_loop_ = nullptr;
+    }
+
+    if (timer_fd_ >= 0) {
+        close(timer_fd_);
+        timer_fd_ = -1;
+    }
+
     if (receive_thread_.joinable()) {
         receive_thread_.join();
     }
 
+    ring_.reset();
+
     if (socket_fd_ >= 0) {
         close(socket_fd_);
         socket_fd_ = -1;
@@ -112,25 +658,66 @@ bool UdpReceiver::isRunning() const {
     return running_;
 }
 
-void UdpReceiver::receiveLoop(ReceiveCallback callback) {
-    const int BUFFER_SIZE = 4096;
-    char buffer[BUFFER_SIZE];
+void UdpReceiver::setJoinOptions(const JoinOptions& options) {
+    join_ = options;
+}
+
+void UdpReceiver::setReceiveOptions(const ReceiveOptions& options) {
+    options_ = options;
+}
+
+void UdpReceiver::setCapture(std::shared_ptr<CaptureWriter> capture, uint16_t channel) {
+    capture_ = capture;
+    capture_channel_ = channel;
+}
+
+void UdpReceiver::setMetrics(const Metrics& metrics) {
+    metrics_ = metrics;
+}
+
+void UdpReceiver::receiveLoop(MessageCallback callback) {
+    char* buffer = buffer_.data();
+    int buffer_size = static_cast<int>(buffer_.size());
+
+    struct sockaddr_storage src_addr;
+    int segment_size;
 
-    struct sockaddr_in src_addr;
-    socklen_t src_addr_len = sizeof(src_addr);
+    ThreadTuning::apply(ThreadTuning::Role::Receive, "udp-rx");
 
     std::cout << "Listening for UDP multicast messages..." << std::endl;
 
+    // 启用重排缓冲时缩短接收超时，暂存消息最多晚一个重排窗口放行
+    int timeout_ms = 1000;
+    if (sequence_ && sequence_->reordering()) {
+        timeout_ms = std::min(timeout_ms, std::max(1, options_.sequence.reorder_window_ms / 2));
+    }
+    uint64_t next_flush_ms = 0;
+
     while (running_) {
-        // 设置接收超时，避免阻塞
-        struct timeval tv;
-        tv.tv_sec = 1;
-        tv.tv_usec = 0;
-        setsockopt(socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        int bytes_received = -1;
+        if (ring_) {
+            // 等到有块交给用户态，整块处理
+            struct pollfd pfd;
+            pfd.fd = ring_->fd();
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            poll(&pfd, 1, timeout_ms);
+            drainRing(callback);
+        } else {
+            // 设置接收超时，避免阻塞
+            struct timeval tv;
+            tv.tv_sec = timeout_ms / 1000;
+            tv.tv_usec = (timeout_ms % 1000) * 1000;
+            setsockopt(socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
 
-        memset(buffer, 0, BUFFER_SIZE);
-        int bytes_received = recvfrom(socket_fd_, buffer, BUFFER_SIZE - 1, 0,
-                                      (struct sockaddr*)&src_addr, &src_addr_len);
+            bytes_received = receiveOne(buffer, buffer_size, src_addr, segment_size);
+        }
+
+        // 持续有报文时接收不会超时，按超时间隔检查重排期限
+        if (sequence_ && sequence_->reordering() && steadyNowMs() >= next_flush_ms) {
+            flushSequence(callback);
+            next_flush_ms = steadyNowMs() + timeout_ms;
+        }
 
         if (bytes_received < 0) {
             // 超时或错误，继续循环
@@ -138,28 +725,307 @@ void UdpReceiver::receiveLoop(ReceiveCallback callback) {
         }
 
         if (bytes_received > 0) {
-            std::string message(buffer, bytes_received);
-            
-            std::cout << "\n=== Received UDP Message ===" << std::endl;
-            std::cout << "From: " << inet_ntoa(src_addr.sin_addr) << ":" 
-                      << ntohs(src_addr.sin_port) << std::endl;
-            std::cout << "Size: " << bytes_received << " bytes" << std::endl;
-            std::cout << "Raw data: " << message << std::endl;
-
-            // 尝试解析JSON
-            if (isValidJson(message)) {
-                std::cout << "\nParsed JSON:" << std::endl;
-                prettyPrintJson(message);
+            deliver(buffer, bytes_received, segment_size, src_addr, callback);
+        }
+    }
+}
+
+void UdpReceiver::drain() {
+    // 单次最多读取的报文数，避免一个繁忙的组播组占满共享的事件循环
+    const int MAX_MESSAGES_PER_WAKEUP = 64;
+    if (ring_) {
+        drainRing(callback_);
+        return;
+    }
+
+    char* buffer = buffer_.data();
+    int buffer_size = static_cast<int>(buffer_.size());
+
+    for (int i = 0; i < MAX_MESSAGES_PER_WAKEUP; ++i) {
+        struct sockaddr_storage src_addr;
+        int segment_size;
+        int bytes_received = receiveOne(buffer, buffer_size, src_addr, segment_size);
+        if (bytes_received < 0) {
+            // EAGAIN：已读完
+            break;
+        }
+
+        if (bytes_received > 0) {
+            deliver(buffer, bytes_received, segment_size, src_addr, callback_);
+        }
+    }
+
+    // 每次唤醒检查一次重排期限并重设定时器
+    if (sequence_ && sequence_->reordering()) {
+        flushSequence(callback_);
+    }
+}
+
+void UdpReceiver::drainRing(const MessageCallback& callback) {
+    size_t max_size = options_.max_datagram_size;
+    ring_->drain([&](const PacketRing::Frame& frame) {
+        if (!ringSourceAllowed(frame.source)) {
+            return;
+        }
+        if (metrics_.rx_packets) {
+            metrics_.rx_packets->add(1);
+        }
+        if (metrics_.rx_bytes) {
+            metrics_.rx_bytes->add(frame.len);
+        }
+        if (frame.truncated || frame.len > max_size) {
+            if (metrics_.truncated) {
+                metrics_.truncated->add(1);
             }
+            std::cerr << "Dropped datagram from " << formatSource(frame.source)
+                      << (frame.truncated ? " larger than the packet ring block" : " larger than max_datagram_size")
+                      << std::endl;
+            return;
+        }
+
+        // 负载直接指向环形缓冲区，不经过接收缓冲区
+        rx_ts_ns_ = frame.rx_ts_ns;
+        deliver(frame.data, static_cast<int>(frame.len), 0, frame.source, callback);
+    });
+
+    uint64_t drops = ring_->takeDrops();
+    if (drops > 0 && metrics_.kernel_drops) {
+        metrics_.kernel_drops->add(drops);
+    }
+}
 
-            // 如果提供了回调函数，调用它
-            if (callback) {
-                callback(message);
+bool UdpReceiver::ringSourceAllowed(const struct sockaddr_storage& src_addr) const {
+    if (!ring_sources_.empty()) {
+        for (const auto& source : ring_sources_) {
+            if (sameAddress(source, src_addr)) {
+                return true;
             }
+        }
+        return false;
+    }
+    for (const auto& source : ring_excluded_) {
+        if (sameAddress(source, src_addr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void UdpReceiver::deliver(const char* data, int len, int segment_size,
+                          const struct sockaddr_storage& src_addr, const MessageCallback& callback) {
+    if (segment_size <= 0 || segment_size >= len) {
+        segment_size = len;
+    }
+
+    for (int offset = 0; offset < len; offset += segment_size) {
+        int segment_len = std::min(segment_size, len - offset);
+        const char* segment = data + offset;
+
+        if (capture_) {
+            capture_->append(capture_channel_, src_addr, rx_ts_ns_, segment, segment_len);
+        }
+
+        if (!reassembler_) {
+            dispatch(segment, segment_len, src_addr, callback);
+            continue;
+        }
+
+        std::string message;
+        Reassembler::Result result = reassembler_->add(sourceKey(src_addr), segment, segment_len, message);
+
+        // 统计重组器内部累计的丢弃数（包括超时和淘汰）
+        uint64_t dropped = reassembler_->getDroppedCount();
+        if (dropped != reassembly_dropped_seen_ && metrics_.reassembly_dropped) {
+            metrics_.reassembly_dropped->add(dropped - reassembly_dropped_seen_);
+        }
+        reassembly_dropped_seen_ = dropped;
+
+        if (result == Reassembler::Result::Passthrough) {
+            dispatch(segment, segment_len, src_addr, callback);
+        } else if (result == Reassembler::Result::Complete) {
+            if (metrics_.reassembled) {
+                metrics_.reassembled->add(1);
+            }
+            dispatch(message.data(), static_cast<int>(message.size()), src_addr, callback);
+        }
+    }
+}
+
+void UdpReceiver::dispatch(const char* data, int len, const struct sockaddr_storage& src_addr,
+                           const MessageCallback& callback) {
+    if (!sequence_) {
+        handleMessage(data, len, src_addr, rx_ts_ns_, callback);
+        return;
+    }
+
+    // 未启用重排缓冲时只更新序号统计，报文原样交给回调，不复制
+    if (!sequence_->reordering()) {
+        sequence_->track(sourceKey(src_addr), data, static_cast<size_t>(len), steadyNowMs());
+        syncSequenceMetrics();
+        handleMessage(data, len, src_addr, rx_ts_ns_, callback);
+        return;
+    }
+
+    // 补齐缺口时放行的暂存消息带着各自的接收时间和来源地址
+    std::vector<SequenceTracker::Released> release;
+    sequence_->add(sourceKey(src_addr), data, len, rx_ts_ns_, src_addr, steadyNowMs(), release);
+    syncSequenceMetrics();
+
+    for (const auto& released : release) {
+        handleMessage(released.message.data(), static_cast<int>(released.message.size()), released.src_addr,
+                      released.rx_ts_ns, callback);
+    }
+}
+
+void UdpReceiver::flushSequence(const MessageCallback& callback) {
+    uint64_t deadline = sequence_->nextDeadline();
+    uint64_t now_ms = steadyNowMs();
+    if (deadline != 0 && deadline <= now_ms) {
+        std::vector<SequenceTracker::Released> release;
+        sequence_->flush(now_ms, release);
+
+        for (const auto& released : release) {
+            handleMessage(released.message.data(), static_cast<int>(released.message.size()), released.src_addr,
+                          released.rx_ts_ns, callback);
+        }
+        deadline = sequence_->nextDeadline();
+    }
+
+    armSequenceTimer(deadline);
+}
+
+void UdpReceiver::syncSequenceMetrics() {
+    const SequenceTracker::Statistics& stats = sequence_->statistics();
+    auto sync = [](const std::shared_ptr<Counter>& counter, uint64_t current, uint64_t& seen) {
+        if (counter && current != seen) {
+            counter->add(current - seen);
+        }
+        seen = current;
+    };
+    sync(metrics_.seq_tracked, stats.tracked, sequence_seen_.tracked);
+    sync(metrics_.seq_missing, stats.missing, sequence_seen_.missing);
+    sync(metrics_.seq_reordered, stats.reordered, sequence_seen_.reordered);
+    sync(metrics_.seq_duplicates, stats.duplicates, sequence_seen_.duplicates);
+    sync(metrics_.seq_resets, stats.resets, sequence_seen_.resets);
+}
+
+void UdpReceiver::armSequenceTimer(uint64_t deadline) {
+    if (timer_fd_ < 0) {
+        return;
+    }
+
+    // 期限为0表示没有暂存消息，停止定时器
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (deadline > 0) {
+        uint64_t now_ms = steadyNowMs();
+        uint64_t delay_ms = deadline > now_ms ? deadline - now_ms : 1;
+        spec.it_value.tv_sec = delay_ms / 1000;
+        spec.it_value.tv_nsec = (delay_ms % 1000) * 1000000;
+    }
+    timerfd_settime(timer_fd_, 0, &spec, nullptr);
+}
+
+int UdpReceiver::receiveOne(char* buffer, int size, struct sockaddr_storage& src_addr, int& segment_size) {
+    struct iovec iov;
+    iov.iov_base = buffer;
+    iov.iov_len = size;
+
+    // SO_RXQ_OVFL的控制消息：套接字累计的内核丢包数；UDP_GRO的控制消息：合并报文的分段长度；
+    // SO_TIMESTAMPNS的控制消息：内核接收时间
+    char control[CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct timespec))];
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &src_addr;
+    msg.msg_namelen = sizeof(src_addr);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    segment_size = 0;
+    int bytes_received = recvmsg(socket_fd_, &msg, 0);
+    if (bytes_received < 0) {
+        return bytes_received;
+    }
+
+    rx_ts_ns_ = 0;
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+            memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+            continue;
+        }
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            rx_ts_ns_ = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+            continue;
+        }
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+            uint32_t drops;
+            memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+            // 内核给出的是累计值，只累加增量（uint32回绕时差值仍然正确）
+            uint32_t delta = drops - kernel_drops_seen_;
+            kernel_drops_seen_ = drops;
+            if (delta > 0 && metrics_.kernel_drops) {
+                metrics_.kernel_drops->add(delta);
+            }
+        }
+    }
+
+    if (rx_ts_ns_ == 0) {
+        rx_ts_ns_ = realtimeNowNs();
+    }
+
+    if (metrics_.rx_packets) {
+        int segments = 1;
+        if (segment_size > 0) {
+            segments = (bytes_received + segment_size - 1) / segment_size;
+        }
+        metrics_.rx_packets->add(segments);
+    }
+    if (metrics_.rx_bytes) {
+        metrics_.rx_bytes->add(bytes_received);
+    }
 
-            std::cout << "============================\n" << std::endl;
+    // 报文比缓冲区大，截断的内容不能转发
+    if (msg.msg_flags & MSG_TRUNC) {
+        if (metrics_.truncated) {
+            metrics_.truncated->add(1);
         }
+        std::cerr << "Dropped datagram from " << formatSource(src_addr) << " larger than "
+                  << size << " bytes (max_datagram_size)" << std::endl;
+        return 0;
+    }
+
+    return bytes_received;
+}
+
+void UdpReceiver::handleMessage(const char* data, int len, const struct sockaddr_storage& src_addr,
+                                uint64_t rx_ts_ns, const MessageCallback& callback) {
+    std::string& message = message_buffer_;
+    message.assign(data, len);
+
+    std::cout << "\n=== Received UDP Message ===" << std::endl;
+    std::cout << "From: " << formatSource(src_addr) << std::endl;
+    std::cout << "Size: " << len << " bytes" << std::endl;
+    std::cout << "Raw data: " << message << std::endl;
+
+    // 尝试解析JSON
+    if (isValidJson(message)) {
+        std::cout << "\nParsed JSON:" << std::endl;
+        prettyPrintJson(message);
+    }
+
+    // 如果提供了回调函数，调用它
+    if (callback) {
+        MessageInfo info{rx_ts_ns, &src_addr};
+        callback(message, info);
     }
+
+    std::cout << "============================\n" << std::endl;
 }
 
 bool UdpReceiver::isValidJson(const std::string& str) {
@@ -240,3 +1106,25 @@ void UdpReceiver::parseAndPrintJson(const std::string& json_str) {
         std::cout << "Not a valid JSON format" << std::endl;
     }
 }
+
+bool UdpReceiver::ReceiveOptions::operator==(const ReceiveOptions& other) const {
+    return backend == other.backend && ring == other.ring && max_datagram_size == other.max_datagram_size &&
+           gro == other.gro && framing == other.framing && sequence == other.sequence &&
+           busy_poll_us == other.busy_poll_us;
+}
+
+bool UdpReceiver::parseBackend(const std::string& name, ReceiveOptions::Backend& backend) {
+    if (name == "socket") {
+        backend = ReceiveOptions::Backend::Socket;
+    } else if (name == "packet_ring") {
+        backend = ReceiveOptions::Backend::PacketRing;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool UdpReceiver::JoinOptions::operator==(const JoinOptions& other) const {
+    return interfaces == other.interfaces && sources == other.sources &&
+           exclude_sources == other.exclude_sources && bind_group == other.bind_group;
+}
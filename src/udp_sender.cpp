@@ -0,0 +1,173 @@
+#include "udp_sender.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <sys/uio.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+UdpSender::UdpSender(const std::string& multicast_addr, int port, const std::string& interface,
+                     int ttl, bool loopback)
+    : multicast_addr_(multicast_addr), port_(port), interface_(interface), ttl_(ttl),
+      loopback_(loopback), socket_fd_(-1), sent_count_(0), failed_count_(0), syscall_count_(0) {
+}
+
+UdpSender::~UdpSender() {
+    close();
+}
+
+bool UdpSender::open() {
+    if (socket_fd_ >= 0) {
+        return true;
+    }
+
+    socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_fd_ < 0) {
+        std::cerr << "Failed to create UDP send socket" << std::endl;
+        return false;
+    }
+
+    unsigned char ttl = static_cast<unsigned char>(ttl_);
+    if (setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) < 0) {
+        std::cerr << "Failed to set IP_MULTICAST_TTL" << std::endl;
+        close();
+        return false;
+    }
+
+    unsigned char loop = loopback_ ? 1 : 0;
+    if (setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0) {
+        std::cerr << "Failed to set IP_MULTICAST_LOOP" << std::endl;
+        close();
+        return false;
+    }
+
+    if (!interface_.empty()) {
+        struct in_addr iface;
+        iface.s_addr = inet_addr(interface_.c_str());
+        if (iface.s_addr == INADDR_NONE) {
+            std::cerr << "Invalid interface address: " << interface_ << std::endl;
+            close();
+            return false;
+        }
+        if (setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) < 0) {
+            std::cerr << "Failed to set IP_MULTICAST_IF to " << interface_ << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    // 连接到组播目标，之后sendmmsg无需为每条消息指定地址
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr(multicast_addr_.c_str());
+    addr.sin_port = htons(port_);
+    if (addr.sin_addr.s_addr == INADDR_NONE) {
+        std::cerr << "Invalid multicast address: " << multicast_addr_ << std::endl;
+        close();
+        return false;
+    }
+    if (connect(socket_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        std::cerr << "Failed to connect UDP send socket to " << multicast_addr_ << ":" << port_ << std::endl;
+        close();
+        return false;
+    }
+
+    std::cout << "UDP sender ready for " << multicast_addr_ << ":" << port_
+              << " (ttl=" << ttl_ << ")" << std::endl;
+    return true;
+}
+
+void UdpSender::close() {
+    if (socket_fd_ >= 0) {
+        ::close(socket_fd_);
+        socket_fd_ = -1;
+    }
+}
+
+bool UdpSender::isOpen() const {
+    return socket_fd_ >= 0;
+}
+
+size_t UdpSender::sendBatch(const std::vector<std::string>& messages, size_t count) {
+    struct iovec iovecs[MAX_BATCH];
+    size_t total_sent = 0;
+
+    for (size_t offset = 0; offset < count; offset += MAX_BATCH) {
+        size_t batch = count - offset < MAX_BATCH ? count - offset : MAX_BATCH;
+        for (size_t i = 0; i < batch; ++i) {
+            const std::string& message = messages[offset + i];
+            iovecs[i].iov_base = const_cast<char*>(message.data());
+            iovecs[i].iov_len = message.size();
+        }
+        total_sent += sendIovecs(iovecs, batch);
+    }
+    return total_sent;
+}
+
+size_t UdpSender::sendBatch(const std::string_view* messages, size_t count) {
+    struct iovec iovecs[MAX_BATCH];
+    size_t total_sent = 0;
+
+    for (size_t offset = 0; offset < count; offset += MAX_BATCH) {
+        size_t batch = count - offset < MAX_BATCH ? count - offset : MAX_BATCH;
+        for (size_t i = 0; i < batch; ++i) {
+            iovecs[i].iov_base = const_cast<char*>(messages[offset + i].data());
+            iovecs[i].iov_len = messages[offset + i].size();
+        }
+        total_sent += sendIovecs(iovecs, batch);
+    }
+    return total_sent;
+}
+
+size_t UdpSender::sendIovecs(struct iovec* iovecs, size_t count) {
+    if (socket_fd_ < 0) {
+        failed_count_ += count;
+        return 0;
+    }
+
+    struct mmsghdr msgs[MAX_BATCH];
+    size_t total_sent = 0;
+    size_t offset = 0;
+
+    memset(msgs, 0, sizeof(struct mmsghdr) * count);
+    for (size_t i = 0; i < count; ++i) {
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (offset < count) {
+        int sent = sendmmsg(socket_fd_, msgs + offset, count - offset, 0);
+        syscall_count_++;
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            // 跳过出错的第一条，继续发送剩余的
+            std::cerr << "sendmmsg failed: " << strerror(errno) << std::endl;
+            failed_count_++;
+            offset++;
+            continue;
+        }
+
+        total_sent += sent;
+        offset += sent;
+    }
+
+    sent_count_ += total_sent;
+    return total_sent;
+}
+
+uint64_t UdpSender::getSentCount() const {
+    return sent_count_;
+}
+
+uint64_t UdpSender::getFailedCount() const {
+    return failed_count_;
+}
+
+uint64_t UdpSender::getSyscallCount() const {
+    return syscall_count_;
+}
@@ -1,7 +1,67 @@
 #include "udp_to_mqtt_forwarder.h"
+#include "json_field.h"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 
+// 流水线处理前为注入字段预留的字节数
+static const size_t PIPELINE_HEADROOM = 128;
+
+// 同一原因的丢弃日志最多每秒输出一行
+static const uint64_t DROP_LOG_INTERVAL_NS = 1000000000ULL;
+
+namespace {
+
+// 每个线程一份流水线暂存区：暂存消息跨消息复用容量，阶段的临时内存从arena分配，
+// 消息交给发布后整体重置，稳态下流水线阶段不再向堆申请内存（发布路径的分配不在此列）
+struct PipelineScratch {
+    Arena arena;
+    PipelineMessage staged;
+    Arena::Statistics synced;   // 已累加到指标的统计
+};
+
+struct ArenaMetrics {
+    std::shared_ptr<Counter> allocations;
+    std::shared_ptr<Counter> heap_blocks;
+    std::shared_ptr<Counter> resets;
+};
+
+PipelineScratch& threadScratch() {
+    thread_local PipelineScratch scratch;
+    return scratch;
+}
+
+ArenaMetrics& arenaMetrics() {
+    static ArenaMetrics metrics = [] {
+        MetricsRegistry& registry = MetricsRegistry::global();
+        ArenaMetrics m;
+        m.allocations = registry.counter("pipeline_arena_allocations_total",
+                                         "Pipeline scratch allocations served from per-thread arenas");
+        m.heap_blocks = registry.counter("pipeline_arena_blocks_total",
+                                         "Memory blocks requested from the heap by pipeline stage arenas");
+        m.resets = registry.counter("pipeline_arena_resets_total", "Pipeline arena resets (one per processed message)");
+        return m;
+    }();
+    return metrics;
+}
+
+// 重置arena，并把本线程新增的统计累加到指标
+void releaseScratch(PipelineScratch& scratch) {
+    scratch.arena.reset();
+    const Arena::Statistics& stats = scratch.arena.statistics();
+    ArenaMetrics& metrics = arenaMetrics();
+    if (stats.allocations != scratch.synced.allocations) {
+        metrics.allocations->add(stats.allocations - scratch.synced.allocations);
+    }
+    if (stats.heap_blocks != scratch.synced.heap_blocks) {
+        metrics.heap_blocks->add(stats.heap_blocks - scratch.synced.heap_blocks);
+    }
+    metrics.resets->add(stats.resets - scratch.synced.resets);
+    scratch.synced = stats;
+}
+
+} // namespace
+
 UdpToMqttForwarder::UdpToMqttForwarder(const std::string& mqtt_client_id,
                                        const std::string& mqtt_broker,
                                        int mqtt_port,
@@ -10,17 +70,50 @@ UdpToMqttForwarder::UdpToMqttForwarder(const std::string& mqtt_client_id,
                                        const std::string& multicast_addr,
                                        int multicast_port,
                                        const std::string& interface)
-    : mqtt_topic_(mqtt_topic),
-      mqtt_qos_(mqtt_qos),
-      running_(false),
-      forwarded_count_(0),
-      failed_count_(0) {
-    
+    : capture_channel_(0), lane_source_(-1), replay_mode_(false), running_(false), startup_capacity_(0),
+      awaiting_connack_(false), flushing_startup_(false), connect_listener_(-1), drain_timeout_ms_(5000) {
+
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->config.mqtt_client_id = mqtt_client_id;
+    snapshot->config.mqtt_broker = mqtt_broker;
+    snapshot->config.mqtt_port = mqtt_port;
+    snapshot->config.mqtt_topic = mqtt_topic;
+    snapshot->config.mqtt_qos = mqtt_qos;
+    snapshot->config.multicast_addr = multicast_addr;
+    snapshot->config.multicast_port = multicast_port;
+    snapshot->config.interface = interface;
+
     // 创建MQTT客户端
-    mqtt_client_ = std::make_unique<MqttClient>(mqtt_client_id, mqtt_broker, mqtt_port);
-    
+    snapshot->mqtt_client = std::make_shared<MqttClient>(mqtt_client_id, mqtt_broker, mqtt_port);
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(snapshot));
+
     // 创建UDP接收器
     udp_receiver_ = std::make_unique<UdpReceiver>(multicast_addr, multicast_port, interface);
+    log_tag_ = "[Forwarder]";
+    initMetrics("");
+}
+
+UdpToMqttForwarder::UdpToMqttForwarder(const Config& config, std::shared_ptr<TokenBucket> global_bucket)
+    : UdpToMqttForwarder(config.mqtt_client_id, config.mqtt_broker, config.mqtt_port,
+                         config.mqtt_topic, config.mqtt_qos, config.multicast_addr,
+                         config.multicast_port, config.interface) {
+    auto snapshot = std::make_shared<Snapshot>(*std::atomic_load(&snapshot_));
+    snapshot->config.name = config.name;
+    snapshot->config.join = config.join;
+    snapshot->config.receive = config.receive;
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(snapshot));
+    udp_receiver_->setJoinOptions(config.join);
+    udp_receiver_->setReceiveOptions(config.receive);
+
+    if (!config.name.empty()) {
+        log_tag_ = "[Forwarder " + config.name + "]";
+        initMetrics(config.name);
+    }
+    setDeduplication(config.dedup);
+    setPipeline(config.pipeline);
+    setConflation(config.conflation);
+    setRateLimit(config.rate_limit, global_bucket);
+    setSinks(config.sinks);
 }
 
 UdpToMqttForwarder::~UdpToMqttForwarder() {
@@ -28,62 +121,197 @@ UdpToMqttForwarder::~UdpToMqttForwarder() {
 }
 
 bool UdpToMqttForwarder::start() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
     if (running_) {
         std::cerr << "Forwarder is already running" << std::endl;
         return false;
     }
 
     std::cout << "Starting UDP to MQTT forwarder..." << std::endl;
+    auto snapshot = std::atomic_load(&snapshot_);
 
-    // 连接到MQTT broker
-    std::cout << "Connecting to MQTT broker..." << std::endl;
-    if (!mqtt_client_->connect()) {
-        std::cerr << "Failed to connect to MQTT broker" << std::endl;
-        return false;
+    // 连接到MQTT broker（连接池管理的连接已由调用方建立）；快速启动时只发起连接，不等待CONNACK
+    if (snapshot->owns_client) {
+        std::cout << "Connecting to MQTT broker..." << std::endl;
+        bool connected = startup_capacity_ > 0 ? snapshot->mqtt_client->connectAsync()
+                                               : snapshot->mqtt_client->connect();
+        if (!connected) {
+            std::cerr << "Failed to connect to MQTT broker" << std::endl;
+            return false;
+        }
+        if (startup_capacity_ == 0) {
+            std::cout << "Connected to MQTT broker successfully" << std::endl;
+        }
+    }
+
+    // 先注册连接回调再检查是否已连接，不会错过两者之间到达的CONNACK
+    if (startup_capacity_ > 0) {
+        awaiting_connack_ = true;
+        listener_client_ = snapshot->mqtt_client;
+        connect_listener_ = listener_client_->addConnectListener([this]() { this->flushStartupBuffer(); });
+        if (listener_client_->isConnected()) {
+            flushStartupBuffer();
+        } else {
+            std::cout << log_tag_ << " Fast start: receiving while the MQTT connection is set up (buffering up to "
+                      << startup_capacity_ << " messages)" << std::endl;
+        }
+    }
+
+    // 优先级通道的发布线程按发布时的最新快照发布本桥接的消息
+    if (lanes_) {
+        lane_source_ = lanes_->addSource([this](const std::string& message) {
+            this->sendToMqtt(*std::atomic_load(&snapshot_), message);
+        });
     }
 
-    std::cout << "Connected to MQTT broker successfully" << std::endl;
+    // Spool策略下由限流器的缓冲线程发布超限消息
+    if (snapshot->rate_limiter) {
+        startRateLimiter(*snapshot->rate_limiter);
+    }
+
+    // 合并模式下由合并器的发布线程负责发布
+    if (conflator_) {
+        conflator_->start([this](const std::string& message) {
+            this->publishMessage(*std::atomic_load(&snapshot_), message);
+        });
+    }
 
-    // 等待连接稳定
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    // 输出端在接收器之前打开，第一个报文就能交给它们
+    bool sinks_started = !fan_out_ || fan_out_->start();
 
     // 启动UDP接收器，设置回调函数
     std::cout << "Starting UDP receiver..." << std::endl;
-    auto callback = [this](const std::string& message) {
-        this->onUdpMessageReceived(message);
-    };
-
-    if (!udp_receiver_->start(callback)) {
-        std::cerr << "Failed to start UDP receiver" << std::endl;
-        mqtt_client_->disconnect();
+    running_ = true;
+    if (!sinks_started || !startReceiver(*udp_receiver_)) {
+        std::cerr << (sinks_started ? "Failed to start UDP receiver" : "Failed to start output sinks") << std::endl;
+        running_ = false;
+        if (fan_out_) {
+            fan_out_->stop();
+        }
+        if (conflator_) {
+            conflator_->stop();
+        }
+        if (snapshot->rate_limiter) {
+            snapshot->rate_limiter->stop();
+        }
+        if (lanes_) {
+            lanes_->removeSource(lane_source_);
+            lane_source_ = -1;
+        }
+        endStartupBuffering();
+        if (snapshot->owns_client) {
+            snapshot->mqtt_client->disconnect();
+        }
         return false;
     }
 
-    running_ = true;
     std::cout << "UDP to MQTT forwarder started successfully" << std::endl;
-    std::cout << "Forwarding UDP messages to MQTT topic: " << mqtt_topic_ << std::endl;
+    std::cout << log_tag_ << " Forwarding UDP " << snapshot->config.multicast_addr << ":"
+              << snapshot->config.multicast_port << " to MQTT topic: " << snapshot->config.mqtt_topic << std::endl;
 
     return true;
 }
 
 void UdpToMqttForwarder::stop() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
     if (!running_) {
         return;
     }
 
     std::cout << "Stopping UDP to MQTT forwarder..." << std::endl;
 
-    // 停止UDP接收器
+    // 排空的截止时间从这里开始计算；之前已发布未确认的消息同样计入
+    auto drain_start = std::chrono::steady_clock::now();
+    auto snapshot = std::atomic_load(&snapshot_);
+    uint64_t forwarded_before = forwarded_count_->value();
+    uint64_t failed_before = failed_count_->value();
+    int64_t inflight_before = snapshot->owns_client ? snapshot->mqtt_client->getInflightCount() : 0;
+    int64_t abandoned_before = snapshot->owns_client ? snapshot->mqtt_client->getAbandonedCount() : 0;
+
+    // 停止UDP接收器，之后只处理已接收的消息
     udp_receiver_->stop();
 
-    // 断开MQTT连接
-    mqtt_client_->disconnect();
+    // 各输出端投递完已排队的报文
+    if (fan_out_) {
+        fan_out_->stop();
+    }
+
+    // 等待工作线程池中本桥接的消息处理完成并放行
+    if (sequencer_) {
+        sequencer_->waitIdle();
+    }
+
+    // 发布合并表中剩余的最新值
+    if (conflator_) {
+        conflator_->stop();
+    }
+
+    // 发布限流缓冲队列中剩余的消息
+    if (snapshot->rate_limiter) {
+        snapshot->rate_limiter->stop();
+    }
+
+    // 之后通道中剩余的本桥接消息不再发布
+    if (lanes_) {
+        lanes_->removeSource(lane_source_);
+        lane_source_ = -1;
+    }
+
+    // 一直没有连接上时缓冲的消息无法发布
+    endStartupBuffering();
+
+    // 等待在途消息确认后正常断开（连接池管理的连接由调用方排空和断开）
+    if (snapshot->owns_client) {
+        int64_t unacknowledged =
+            snapshot->mqtt_client->drain(drain_start + std::chrono::milliseconds(drain_timeout_ms_));
+        // 排空期间被放弃的消息（期间连接被主动断开）计入未确认，而不是送达
+        unacknowledged += snapshot->mqtt_client->getAbandonedCount() - abandoned_before;
+        int64_t published = static_cast<int64_t>(forwarded_count_->value() - forwarded_before);
+        uint64_t failed = failed_count_->value() - failed_before;
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - drain_start).count();
+        std::cout << log_tag_ << " Drain: " << std::max<int64_t>(inflight_before + published - unacknowledged, 0)
+                  << " message(s) drained, " << unacknowledged + static_cast<int64_t>(failed) << " abandoned ("
+                  << unacknowledged << " unacknowledged, " << failed << " failed) in " << elapsed << " ms"
+                  << std::endl;
+        snapshot->mqtt_client->disconnect();
+    }
 
     running_ = false;
 
     std::cout << "UDP to MQTT forwarder stopped" << std::endl;
-    std::cout << "Statistics: Forwarded: " << forwarded_count_ 
-              << ", Failed: " << failed_count_ << std::endl;
+    std::cout << log_tag_ << " Statistics: Forwarded: " << forwarded_count_->value()
+              << ", Failed: " << failed_count_->value()
+              << ", Duplicates: " << duplicate_count_->value()
+              << ", Filtered: " << filtered_count_->value()
+              << ", Conflated: " << getConflatedMessageCount()
+              << ", Rate limited: " << rate_limited_count_->value() << std::endl;
+    if (snapshot->config.receive.sequence.enabled) {
+        SequenceTracker::Statistics seq = getSequenceStatistics();
+        std::cout << log_tag_ << " Sequence: Missing: " << seq.missing << ", Reordered: " << seq.reordered
+                  << ", Duplicates: " << seq.duplicates << ", Resets: " << seq.resets << std::endl;
+    }
+}
+
+Arena::Statistics UdpToMqttForwarder::getArenaStatistics() {
+    ArenaMetrics& metrics = arenaMetrics();
+    Arena::Statistics stats;
+    stats.allocations = metrics.allocations->value();
+    stats.heap_blocks = metrics.heap_blocks->value();
+    stats.resets = metrics.resets->value();
+    return stats;
+}
+
+SequenceTracker::Statistics UdpToMqttForwarder::getSequenceStatistics() const {
+    SequenceTracker::Statistics stats;
+    stats.tracked = receiver_metrics_.seq_tracked->value();
+    stats.missing = receiver_metrics_.seq_missing->value();
+    stats.reordered = receiver_metrics_.seq_reordered->value();
+    stats.duplicates = receiver_metrics_.seq_duplicates->value();
+    stats.resets = receiver_metrics_.seq_resets->value();
+    return stats;
 }
 
 bool UdpToMqttForwarder::isRunning() const {
@@ -91,34 +319,718 @@ bool UdpToMqttForwarder::isRunning() const {
 }
 
 uint64_t UdpToMqttForwarder::getForwardedMessageCount() const {
-    return forwarded_count_;
+    return forwarded_count_->value();
 }
 
 uint64_t UdpToMqttForwarder::getFailedMessageCount() const {
-    return failed_count_;
+    return failed_count_->value();
+}
+
+uint64_t UdpToMqttForwarder::getDuplicateMessageCount() const {
+    return duplicate_count_->value();
+}
+
+void UdpToMqttForwarder::setDeduplication(const Deduplicator::Config& config) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change deduplication while forwarder is running" << std::endl;
+        return;
+    }
+
+    auto next = std::make_shared<Snapshot>(*std::atomic_load(&snapshot_));
+    next->config.dedup = config;
+    if (config.enabled) {
+        next->deduplicator = std::make_shared<Deduplicator>(config);
+        std::cout << "Deduplication enabled (key: "
+                  << (config.key_field.empty() ? "<payload hash>" : config.key_field)
+                  << ", window: " << config.window_ms << " ms, capacity: "
+                  << next->deduplicator->capacity() << ")" << std::endl;
+    } else {
+        next->deduplicator.reset();
+    }
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(next));
+}
+
+uint64_t UdpToMqttForwarder::getFilteredMessageCount() const {
+    return filtered_count_->value();
+}
+
+void UdpToMqttForwarder::setPipeline(const RuntimePipeline::Config& config) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change pipeline while forwarder is running" << std::endl;
+        return;
+    }
+
+    auto next = std::make_shared<Snapshot>(*std::atomic_load(&snapshot_));
+    next->config.pipeline = config;
+    if (!config.stages.empty()) {
+        next->pipeline = std::make_shared<RuntimePipeline>(config);
+        std::cout << "Pipeline enabled (" << config.stages.size() << " stages)" << std::endl;
+    } else {
+        next->pipeline.reset();
+    }
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(next));
+}
+
+uint64_t UdpToMqttForwarder::getConflatedMessageCount() const {
+    return conflator_ ? conflator_->getConflatedCount() : 0;
+}
+
+void UdpToMqttForwarder::setConflation(const Conflator::Config& config) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change conflation while forwarder is running" << std::endl;
+        return;
+    }
+
+    auto next = std::make_shared<Snapshot>(*std::atomic_load(&snapshot_));
+    next->config.conflation = config;
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(next));
+
+    if (config.enabled) {
+        conflator_ = std::make_unique<Conflator>(config);
+        std::cout << "Conflation enabled (key: " << config.key_field
+                  << ", interval: " << config.interval_ms << " ms"
+                  << (config.publish_when_idle ? ", publish when idle" : "")
+                  << ")" << std::endl;
+    } else {
+        conflator_.reset();
+    }
+}
+
+void UdpToMqttForwarder::setSinks(const std::vector<Sink::Config>& sinks) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change output sinks while forwarder is running" << std::endl;
+        return;
+    }
+
+    auto next = std::make_shared<Snapshot>(*std::atomic_load(&snapshot_));
+    next->config.sinks = sinks;
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(next));
+
+    if (sinks.empty()) {
+        fan_out_.reset();
+        return;
+    }
+    fan_out_ = std::make_unique<FanOut>(sinks, next->config.name);
+    std::cout << log_tag_ << " Fan-out to " << sinks.size() << " output sink(s)" << std::endl;
+}
+
+const FanOut* UdpToMqttForwarder::getFanOut() const {
+    return fan_out_.get();
+}
+
+uint64_t UdpToMqttForwarder::getRateLimitedMessageCount() const {
+    return rate_limited_count_->value();
+}
+
+void UdpToMqttForwarder::setRateLimit(const RateLimiter::Config& config,
+                                      std::shared_ptr<TokenBucket> global_bucket) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change rate limit while forwarder is running" << std::endl;
+        return;
+    }
+
+    auto next = std::make_shared<Snapshot>(*std::atomic_load(&snapshot_));
+    next->config.rate_limit = config;
+    global_bucket_ = global_bucket;
+    if (config.enabled) {
+        next->rate_limiter = std::make_shared<RateLimiter>(config, next->config.mqtt_topic, global_bucket);
+        std::cout << "Rate limit enabled for topic " << next->config.mqtt_topic << std::endl;
+    } else {
+        next->rate_limiter.reset();
+    }
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(next));
+}
+
+void UdpToMqttForwarder::setMqttClient(std::shared_ptr<MqttClient> client) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change MQTT client while forwarder is running" << std::endl;
+        return;
+    }
+
+    auto next = std::make_shared<Snapshot>(*std::atomic_load(&snapshot_));
+    next->mqtt_client = client;
+    next->owns_client = false;
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(next));
+}
+
+void UdpToMqttForwarder::stopIngest() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        udp_receiver_->stop();
+    }
+}
+
+void UdpToMqttForwarder::setDrainTimeout(int timeout_ms) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    drain_timeout_ms_ = timeout_ms;
+}
+
+void UdpToMqttForwarder::setFastStart(size_t buffer_size) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change fast start while forwarder is running" << std::endl;
+        return;
+    }
+
+    startup_capacity_ = buffer_size;
+}
+
+void UdpToMqttForwarder::setEventLoop(std::shared_ptr<UdpEventLoop> loop) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change event loop while forwarder is running" << std::endl;
+        return;
+    }
+
+    event_loop_ = loop;
+}
+
+void UdpToMqttForwarder::setCapture(std::shared_ptr<CaptureWriter> capture) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change capture while forwarder is running" << std::endl;
+        return;
+    }
+
+    capture_ = capture;
+    if (capture_) {
+        std::string name = std::atomic_load(&snapshot_)->config.name;
+        capture_channel_ = capture_->channel(name.empty() ? "default" : name);
+    }
+}
+
+void UdpToMqttForwarder::setPriorityLanes(std::shared_ptr<PriorityLanes> lanes) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change priority lanes while forwarder is running" << std::endl;
+        return;
+    }
+
+    lanes_ = lanes;
+}
+
+void UdpToMqttForwarder::setLocalOutput(std::shared_ptr<ShmRing> ring) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change local output while forwarder is running" << std::endl;
+        return;
+    }
+
+    local_output_ = ring;
+}
+
+void UdpToMqttForwarder::setWorkerPool(std::shared_ptr<WorkerPool> workers) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change worker pool while forwarder is running" << std::endl;
+        return;
+    }
+
+    workers_ = workers;
+    sequencer_ = workers_ ? std::make_unique<KeySequencer>() : nullptr;
+}
+
+void UdpToMqttForwarder::setReplayMode(bool replay) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    if (running_) {
+        std::cerr << "Cannot change replay mode while forwarder is running" << std::endl;
+        return;
+    }
+
+    replay_mode_ = replay;
+}
+
+void UdpToMqttForwarder::replay(const CaptureReader::Record& record) {
+    udp_receiver_->inject(record.data, static_cast<int>(record.len), record.source, record.rx_ts_ns);
+}
+
+std::string UdpToMqttForwarder::getName() const {
+    // 名称只在构造时设置，快照替换时保持不变
+    return std::atomic_load(&snapshot_)->config.name;
+}
+
+bool UdpToMqttForwarder::reload(const Config& config, std::shared_ptr<TokenBucket> global_bucket) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+
+    auto current = std::atomic_load(&snapshot_);
+    const Config& old = current->config;
+    auto next = std::make_shared<Snapshot>(*current);
+    next->config = config;
+
+    if (config.conflation != old.conflation) {
+        std::cerr << "[Reload] Conflation settings cannot be reloaded, restart to apply" << std::endl;
+        next->config.conflation = old.conflation;
+    }
+    if (config.sinks != old.sinks) {
+        std::cerr << "[Reload] Output sink settings cannot be reloaded, restart to apply" << std::endl;
+        next->config.sinks = old.sinks;
+    }
+
+    // 桥接名称用于匹配，不随重载变化
+    next->config.name = old.name;
+
+    // broker变化时先建立新连接，成功后再替换，失败则保持原配置
+    bool mqtt_changed = config.mqtt_client_id != old.mqtt_client_id ||
+                        config.mqtt_broker != old.mqtt_broker ||
+                        config.mqtt_port != old.mqtt_port;
+    if (mqtt_changed && !current->owns_client) {
+        // 连接池管理的连接由调用方负责重建
+        next->config.mqtt_client_id = old.mqtt_client_id;
+        next->config.mqtt_broker = old.mqtt_broker;
+        next->config.mqtt_port = old.mqtt_port;
+        mqtt_changed = false;
+    }
+    if (mqtt_changed) {
+        auto client = std::make_shared<MqttClient>(config.mqtt_client_id, config.mqtt_broker, config.mqtt_port);
+        if (running_ && !client->connect()) {
+            std::cerr << "[Reload] Failed to connect to new MQTT broker " << config.mqtt_broker << ":"
+                      << config.mqtt_port << ", keeping current configuration" << std::endl;
+            return false;
+        }
+        next->mqtt_client = client;
+    }
+
+    // 组播设置变化时重建接收器：先停旧的再启新的（避免同一报文被两个接收器各转发一次），
+    // 新接收器启动失败则恢复旧接收器并放弃本次重载
+    bool udp_changed = config.multicast_addr != old.multicast_addr ||
+                       config.multicast_port != old.multicast_port ||
+                       config.interface != old.interface ||
+                       config.join != old.join ||
+                       config.receive != old.receive;
+    if (udp_changed) {
+        auto receiver = std::make_unique<UdpReceiver>(config.multicast_addr, config.multicast_port, config.interface);
+        receiver->setJoinOptions(config.join);
+        receiver->setReceiveOptions(config.receive);
+        if (running_) {
+            udp_receiver_->stop();
+            if (!startReceiver(*receiver)) {
+                std::cerr << "[Reload] Failed to start UDP receiver on " << config.multicast_addr << ":"
+                          << config.multicast_port << ", keeping current configuration" << std::endl;
+                if (!startReceiver(*udp_receiver_)) {
+                    std::cerr << "[Reload] Failed to restart previous UDP receiver on " << old.multicast_addr
+                              << ":" << old.multicast_port << std::endl;
+                }
+                if (mqtt_changed) {
+                    next->mqtt_client->disconnect();
+                }
+                return false;
+            }
+        }
+        udp_receiver_ = std::move(receiver);
+    }
+
+    bool dedup_changed = config.dedup != old.dedup;
+    if (dedup_changed) {
+        next->deduplicator = config.dedup.enabled ? std::make_shared<Deduplicator>(config.dedup) : nullptr;
+    }
+
+    bool pipeline_changed = config.pipeline != old.pipeline;
+    if (pipeline_changed) {
+        next->pipeline = config.pipeline.stages.empty() ? nullptr : std::make_shared<RuntimePipeline>(config.pipeline);
+    }
+
+    // 路由桶按主题选择，主题变化也需要重建限流器
+    bool limiter_changed = config.rate_limit != old.rate_limit ||
+                           (config.rate_limit.enabled &&
+                            (config.mqtt_topic != old.mqtt_topic || global_bucket != global_bucket_));
+    if (limiter_changed) {
+        next->rate_limiter.reset();
+        if (config.rate_limit.enabled) {
+            next->rate_limiter = std::make_shared<RateLimiter>(config.rate_limit, config.mqtt_topic, global_bucket);
+            if (running_) {
+                startRateLimiter(*next->rate_limiter);
+            }
+        }
+    }
+    global_bucket_ = global_bucket;
+
+    // 原子替换快照，之后到达的消息使用新设置
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(next));
+
+    // 快速启动时仍在等待旧连接的CONNACK：新连接已建立，改为关注新连接并发布缓冲的消息
+    if (mqtt_changed && running_ && connect_listener_ >= 0) {
+        listener_client_->removeConnectListener(connect_listener_);
+        listener_client_ = next->mqtt_client;
+        connect_listener_ = listener_client_->addConnectListener([this]() { this->flushStartupBuffer(); });
+        flushStartupBuffer();
+    }
+
+    // 旧限流器缓冲的消息按新快照发布
+    if (limiter_changed && current->rate_limiter) {
+        current->rate_limiter->stop();
+    }
+    if (mqtt_changed && running_) {
+        current->mqtt_client->disconnect();
+    }
+
+    std::cout << "[Reload] " << log_tag_ << " Configuration applied (topic: " << config.mqtt_topic
+              << ", qos: " << config.mqtt_qos << (config.mqtt_retain ? ", retain" : "")
+              << (mqtt_changed ? ", mqtt reconnected" : "")
+              << (udp_changed ? ", udp receiver restarted" : "")
+              << (dedup_changed ? ", dedup updated" : "")
+              << (pipeline_changed ? ", pipeline updated" : "")
+              << (limiter_changed ? ", rate limit updated" : "") << ")" << std::endl;
+    return true;
+}
+
+UdpToMqttForwarder::Config UdpToMqttForwarder::getConfig() const {
+    return std::atomic_load(&snapshot_)->config;
 }
 
 void UdpToMqttForwarder::resetStatistics() {
-    forwarded_count_ = 0;
-    failed_count_ = 0;
+    forwarded_count_->reset();
+    failed_count_->reset();
+    duplicate_count_->reset();
+    filtered_count_->reset();
+    rate_limited_count_->reset();
+    if (conflator_) {
+        conflator_->resetStatistics();
+    }
     std::cout << "Statistics reset" << std::endl;
 }
 
-void UdpToMqttForwarder::onUdpMessageReceived(const std::string& message) {
+void UdpToMqttForwarder::onUdpMessageReceived(const std::string& message, const UdpReceiver::MessageInfo& info) {
     if (!running_) {
         return;
     }
 
-    std::cout << "\n[Forwarder] Received UDP message, forwarding to MQTT..." << std::endl;
+    // 输出端得到原始报文流（去重和流水线之前），共享同一份复制
+    if (fan_out_) {
+        fan_out_->dispatch(message, *info.source, info.rx_ts_ns);
+    }
+
+    auto snapshot = std::atomic_load(&snapshot_);
+
+    // 时间窗口内重复的消息直接丢弃，只计数，由周期统计输出（Duplicates）
+    if (snapshot->deduplicator && snapshot->deduplicator->isDuplicate(message.data(), message.size())) {
+        duplicate_count_->add(1);
+        return;
+    }
 
+    if (!snapshot->pipeline) {
+        forwardMessage(*snapshot, message);
+        return;
+    }
+
+    if (workers_) {
+        submitToWorkers(snapshot, message, info);
+        return;
+    }
+
+    // 去重之后执行流水线，注入的接收时间不影响去重判断；
+    // 暂存消息按线程复用并预留注入字段的空间，拼接时不再重新分配
+    PipelineScratch& scratch = threadScratch();
+    PipelineMessage& staged = scratch.staged;
+    staged.payload.reserve(message.size() + PIPELINE_HEADROOM);
+    staged.payload.assign(message);
+    staged.rx_ts_ns = info.rx_ts_ns;
+    staged.source.clear();
+    if (snapshot->pipeline->usesSource() && info.source->ss_family != AF_UNSPEC) {
+        char source[64];
+        staged.source.assign(source, UdpReceiver::formatSource(*info.source, source, sizeof(source)));
+    }
+    staged.arena = &scratch.arena;
+    if (!snapshot->pipeline->apply(staged)) {
+        filtered_count_->add(1);
+        releaseScratch(scratch);
+        return;
+    }
+    forwardMessage(*snapshot, staged.payload);
+    releaseScratch(scratch);
+}
+
+void UdpToMqttForwarder::submitToWorkers(const std::shared_ptr<const Snapshot>& snapshot, const std::string& message,
+                                         const UdpReceiver::MessageInfo& info) {
+    if (sequencer_->pending() >= workers_->getConfig().queue_size) {
+        failed_count_->add(1);
+        logDrop(worker_drops_, "worker queue full", "Failed", failed_count_->value());
+        return;
+    }
+
+    // 在接收线程中按到达顺序取得保序键的序号；没有保序键字段时整个桥接共用一个键
+    std::string_view key;
+    const std::string& key_field = workers_->getConfig().key_field;
+    if (!key_field.empty()) {
+        findJsonField(message, key_field, key);
+    }
+    KeySequencer::Ticket ticket = sequencer_->begin(key);
+
+    // 暂存消息从空闲列表复用，保留上次的容量；任务只捕获两个指针，std::function不再单独申请内存
+    WorkItem* item = acquireWorkItem();
+    item->snapshot = snapshot;
+    item->ticket = ticket;
+    item->staged.payload.reserve(message.size() + PIPELINE_HEADROOM);
+    item->staged.payload.assign(message);
+    item->staged.rx_ts_ns = info.rx_ts_ns;
+    item->staged.source.clear();
+    if (snapshot->pipeline->usesSource() && info.source->ss_family != AF_UNSPEC) {
+        char source[64];
+        item->staged.source.assign(source, UdpReceiver::formatSource(*info.source, source, sizeof(source)));
+    }
+
+    workers_->submit([this, item]() {
+        // 阶段的临时内存从本工作线程的arena分配，处理完即重置
+        PipelineScratch& scratch = threadScratch();
+        item->staged.arena = &scratch.arena;
+        item->keep = item->snapshot->pipeline->apply(item->staged);
+        item->staged.arena = nullptr;
+        releaseScratch(scratch);
+        // 放行动作可能在complete()内执行并回收item，先复制序号凭证
+        KeySequencer::Ticket ticket = item->ticket;
+        sequencer_->complete(ticket, [this, item]() {
+            if (item->keep) {
+                forwardMessage(*item->snapshot, item->staged.payload);
+            } else {
+                filtered_count_->add(1);
+            }
+            recycleWorkItem(item);
+        });
+    });
+}
+
+UdpToMqttForwarder::WorkItem* UdpToMqttForwarder::acquireWorkItem() {
+    {
+        std::lock_guard<std::mutex> lock(work_items_mutex_);
+        if (!free_work_items_.empty()) {
+            WorkItem* item = free_work_items_.back().release();
+            free_work_items_.pop_back();
+            return item;
+        }
+    }
+    return new WorkItem();
+}
+
+void UdpToMqttForwarder::recycleWorkItem(WorkItem* item) {
+    // 释放快照引用，重载后旧快照不被空闲的WorkItem留住
+    item->snapshot.reset();
+    std::lock_guard<std::mutex> lock(work_items_mutex_);
+    free_work_items_.emplace_back(item);
+}
+
+void UdpToMqttForwarder::forwardMessage(const Snapshot& snapshot, const std::string& message) {
+    // 合并模式：只更新该键的最新值，由合并器的发布线程发布
+    if (conflator_ && conflator_->update(message)) {
+        return;
+    }
+
+    std::cout << "\n" << log_tag_ << " Received UDP message, forwarding to MQTT..." << std::endl;
+    publishMessage(snapshot, message);
+}
+
+void UdpToMqttForwarder::publishMessage(const Snapshot& snapshot, const std::string& message) {
+    if (snapshot.rate_limiter) {
+        RateLimiter::Result result = snapshot.rate_limiter->acquire(message);
+        queue_depth_->set(snapshot.rate_limiter->getSpoolDepth());
+        if (result == RateLimiter::Result::Dropped) {
+            rate_limited_count_->add(1);
+            logDrop(rate_limit_drops_, "rate limit", "Rate limited", rate_limited_count_->value());
+            return;
+        }
+        if (result == RateLimiter::Result::Spooled) {
+            return;
+        }
+    }
+
+    publishToMqtt(snapshot, message);
+}
+
+void UdpToMqttForwarder::publishToMqtt(const Snapshot& snapshot, const std::string& message) {
+    // 本机消费者读取与MQTT相同的消息流；写入从不阻塞，读取端落后时自行丢失
+    if (local_output_) {
+        uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        local_output_->write(snapshot.config.mqtt_topic, message, now);
+    }
+
+    if (!lanes_) {
+        sendToMqtt(snapshot, message);
+        return;
+    }
+
+    if (!lanes_->enqueue(lane_source_, snapshot.config.mqtt_topic, message)) {
+        failed_count_->add(1);
+        logDrop(lane_drops_, "priority lane full", "Failed", failed_count_->value());
+    }
+}
+
+void UdpToMqttForwarder::sendToMqtt(const Snapshot& snapshot, const std::string& message) {
+    // 快速启动且尚未收到CONNACK：按顺序缓冲，由连接回调发布
+    if (awaiting_connack_) {
+        std::lock_guard<std::mutex> lock(startup_mutex_);
+        if (awaiting_connack_) {
+            if (startup_buffer_.size() >= startup_capacity_) {
+                failed_count_->add(1);
+                logDrop(startup_drops_, "startup buffer full", "Failed", failed_count_->value());
+                return;
+            }
+            startup_buffer_.push_back(message);
+            startup_depth_->set(startup_buffer_.size());
+            return;
+        }
+    }
+
+    publishNow(snapshot, message);
+}
+
+void UdpToMqttForwarder::publishNow(const Snapshot& snapshot, const std::string& message) {
     // 将消息发布到MQTT
-    if (mqtt_client_->publish(mqtt_topic_, message, mqtt_qos_)) {
-        forwarded_count_++;
-        std::cout << "[Forwarder] Message forwarded successfully (Total: " 
-                  << forwarded_count_ << ")" << std::endl;
+    if (snapshot.mqtt_client->publish(snapshot.config.mqtt_topic, message, snapshot.config.mqtt_qos,
+                                      snapshot.config.mqtt_retain)) {
+        forwarded_count_->add(1);
+        std::cout << log_tag_ << " Message forwarded successfully (Total: "
+                  << forwarded_count_->value() << ")" << std::endl;
     } else {
-        failed_count_++;
-        std::cerr << "[Forwarder] Failed to forward message (Failed: " 
-                  << failed_count_ << ")" << std::endl;
+        failed_count_->add(1);
+        std::cerr << log_tag_ << " Failed to forward message (Failed: "
+                  << failed_count_->value() << ")" << std::endl;
+    }
+}
+
+void UdpToMqttForwarder::logDrop(DropLog& log, const char* reason, const char* total_name, uint64_t total) {
+    log.pending.fetch_add(1, std::memory_order_relaxed);
+
+    // 丢弃发生在过载时，不逐条输出；抢到本轮输出的线程汇总期间的丢弃数
+    uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    uint64_t next_ns = log.next_ns.load(std::memory_order_relaxed);
+    if (now_ns < next_ns ||
+        !log.next_ns.compare_exchange_strong(next_ns, now_ns + DROP_LOG_INTERVAL_NS, std::memory_order_relaxed)) {
+        return;
+    }
+    std::cerr << log_tag_ << " " << log.pending.exchange(0, std::memory_order_relaxed) << " message(s) dropped ("
+              << reason << "), " << total_name << ": " << total << std::endl;
+}
+
+void UdpToMqttForwarder::flushStartupBuffer() {
+    {
+        std::lock_guard<std::mutex> lock(startup_mutex_);
+        if (!awaiting_connack_ || flushing_startup_) {
+            return;
+        }
+        flushing_startup_ = true;
     }
+
+    // 每次在锁内取走当前缓冲，在锁外发布；发布期间到达的消息仍追加到缓冲中，
+    // 下一轮再发布，直到缓冲为空才切换为直接发布，顺序不变，接收线程不会等待发布
+    std::deque<std::string> batch;
+    size_t count = 0;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(startup_mutex_);
+            if (startup_buffer_.empty()) {
+                awaiting_connack_ = false;
+                flushing_startup_ = false;
+                break;
+            }
+            batch.swap(startup_buffer_);
+            startup_depth_->set(0);
+        }
+
+        auto snapshot = std::atomic_load(&snapshot_);
+        for (const auto& message : batch) {
+            publishNow(*snapshot, message);
+        }
+        count += batch.size();
+        batch.clear();
+    }
+
+    std::cout << log_tag_ << " Connected to MQTT broker, published " << count
+              << " message(s) buffered during startup" << std::endl;
+}
+
+void UdpToMqttForwarder::endStartupBuffering() {
+    // 返回后连接回调不会再执行
+    if (connect_listener_ >= 0) {
+        listener_client_->removeConnectListener(connect_listener_);
+        connect_listener_ = -1;
+        listener_client_.reset();
+    }
+
+    std::lock_guard<std::mutex> lock(startup_mutex_);
+    if (!startup_buffer_.empty()) {
+        failed_count_->add(startup_buffer_.size());
+        std::cerr << log_tag_ << " Never connected to MQTT broker, dropped " << startup_buffer_.size()
+                  << " buffered message(s)" << std::endl;
+        startup_buffer_.clear();
+        startup_depth_->set(0);
+    }
+    awaiting_connack_ = false;
+}
+
+void UdpToMqttForwarder::startRateLimiter(RateLimiter& rate_limiter) {
+    // 缓冲消息总是按发布时的最新快照发布
+    rate_limiter.start([this, &rate_limiter](const std::string& message) {
+        this->publishToMqtt(*std::atomic_load(&snapshot_), message);
+        queue_depth_->set(rate_limiter.getSpoolDepth());
+    });
+}
+
+bool UdpToMqttForwarder::startReceiver(UdpReceiver& receiver) {
+    receiver.setMetrics(receiver_metrics_);
+    if (capture_) {
+        receiver.setCapture(capture_, capture_channel_);
+    }
+    auto callback = [this](const std::string& message, const UdpReceiver::MessageInfo& info) {
+        this->onUdpMessageReceived(message, info);
+    };
+    if (replay_mode_) {
+        return receiver.startReplay(callback);
+    }
+    if (event_loop_) {
+        return receiver.start(*event_loop_, callback);
+    }
+    return receiver.start(callback);
+}
+
+void UdpToMqttForwarder::initMetrics(const std::string& name) {
+    MetricsRegistry::Labels labels = {{"bridge", name.empty() ? "default" : name}};
+    MetricsRegistry& registry = MetricsRegistry::global();
+
+    forwarded_count_ = registry.counter("bridge_forwarded_messages_total", "Messages published to MQTT", labels);
+    failed_count_ = registry.counter("bridge_failed_messages_total", "Messages that failed to publish", labels);
+    duplicate_count_ = registry.counter("bridge_duplicate_messages_total", "Messages suppressed as duplicates", labels);
+    filtered_count_ = registry.counter("bridge_filtered_messages_total", "Messages dropped by the pipeline", labels);
+    rate_limited_count_ = registry.counter("bridge_rate_limited_messages_total", "Messages dropped by rate limiting", labels);
+    queue_depth_ = registry.gauge("bridge_queue_depth", "Messages waiting in the rate limit spool", labels);
+    startup_depth_ = registry.gauge("bridge_startup_buffer_depth",
+                                    "Messages buffered during fast start until the MQTT connection is up", labels);
+
+    receiver_metrics_.rx_packets = registry.counter("udp_rx_packets_total", "UDP datagrams received", labels);
+    receiver_metrics_.rx_bytes = registry.counter("udp_rx_bytes_total", "UDP payload bytes received", labels);
+    receiver_metrics_.kernel_drops = registry.counter("udp_kernel_drops_total",
+                                                      "Datagrams dropped by the kernel (receive buffer full)", labels);
+    receiver_metrics_.seq_tracked = registry.counter("udp_seq_tracked_total", "Messages carrying a sequence number", labels);
+    receiver_metrics_.seq_missing = registry.counter("udp_seq_missing_total",
+                                                     "Messages missing from sequence gaps", labels);
+    receiver_metrics_.seq_reordered = registry.counter("udp_seq_reordered_total",
+                                                       "Messages that arrived after a later sequence number", labels);
+    receiver_metrics_.seq_duplicates = registry.counter("udp_seq_duplicates_total",
+                                                        "Messages with an already seen sequence number", labels);
+    receiver_metrics_.seq_resets = registry.counter("udp_seq_resets_total", "Sender sequence restarts", labels);
+    receiver_metrics_.truncated = registry.counter("udp_truncated_total",
+                                                   "Datagrams dropped for exceeding max_datagram_size", labels);
+    receiver_metrics_.reassembled = registry.counter("udp_reassembled_messages_total",
+                                                     "Multi-datagram messages reassembled", labels);
+    receiver_metrics_.reassembly_dropped = registry.counter("udp_reassembly_dropped_total",
+                                                            "Fragmented messages dropped (timeout, eviction, invalid)", labels);
 }
@@ -0,0 +1,177 @@
+#include "worker_pool.h"
+#include "thread_tuning.h"
+#include <algorithm>
+#include <iostream>
+#include <tuple>
+
+// 当前线程所属的线程池和队列下标，工作线程提交的任务放入自己的队列
+static thread_local const WorkerPool* current_pool = nullptr;
+static thread_local size_t current_worker = 0;
+
+bool WorkerPool::Config::operator==(const Config& other) const {
+    return std::tie(enabled, threads, key_field, queue_size) ==
+           std::tie(other.enabled, other.threads, other.key_field, other.queue_size);
+}
+
+WorkerPool::WorkerPool(const Config& config)
+    : config_(config), next_worker_(0), pending_(0), sleepers_(0), running_(false), submitting_(0), draining_(false) {
+    size_t threads = config.threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+
+    MetricsRegistry& registry = MetricsRegistry::global();
+    executed_count_ = registry.counter("worker_tasks_total", "Pipeline tasks executed by the worker pool");
+    stolen_count_ = registry.counter("worker_steals_total", "Worker pool tasks taken from another worker's queue");
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+bool WorkerPool::start() {
+    if (running_) {
+        return false;
+    }
+
+    draining_ = false;
+    running_ = true;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        threads_.emplace_back(&WorkerPool::workerLoop, this, i);
+    }
+
+    std::cout << "Worker pool started (" << workers_.size() << " thread(s)";
+    if (!config_.key_field.empty()) {
+        std::cout << ", ordered by " << config_.key_field;
+    }
+    std::cout << ")" << std::endl;
+    return true;
+}
+
+void WorkerPool::stop() {
+    if (!running_) {
+        return;
+    }
+
+    // 之后的提交在调用线程中执行；等进行中的提交放入队列后再让工作线程收尾，停止后不会有任务滞留在队列中
+    running_ = false;
+    while (submitting_ > 0) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        draining_ = true;
+    }
+    idle_cv_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+bool WorkerPool::isRunning() const {
+    return running_;
+}
+
+void WorkerPool::submit(Task task) {
+    // 先登记再检查运行状态，与stop()先清除运行状态再等待登记清零相配合
+    submitting_++;
+    if (!running_) {
+        submitting_--;
+        task();
+        return;
+    }
+
+    size_t index = current_pool == this ? current_worker
+                                         : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    {
+        std::lock_guard<std::mutex> worker_lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    pending_++;
+    submitting_--;
+    wake();
+}
+
+void WorkerPool::wake() {
+    // 等待方在idle_mutex_下登记并检查，取得该锁时它已在等待或已看到新任务
+    if (sleepers_ > 0) {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_cv_.notify_one();
+    }
+}
+
+const WorkerPool::Config& WorkerPool::getConfig() const {
+    return config_;
+}
+
+size_t WorkerPool::threadCount() const {
+    return workers_.size();
+}
+
+uint64_t WorkerPool::getExecutedCount() const {
+    return executed_count_->value();
+}
+
+uint64_t WorkerPool::getStolenCount() const {
+    return stolen_count_->value();
+}
+
+bool WorkerPool::take(size_t index, Task& task) {
+    {
+        Worker& own = *workers_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            pending_--;
+            return true;
+        }
+    }
+
+    // 从下一个线程开始依次偷取，偷取端与队列所有者相反，减少争用
+    for (size_t offset = 1; offset < workers_.size(); ++offset) {
+        Worker& victim = *workers_[(index + offset) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            pending_--;
+            stolen_count_->add(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkerPool::workerLoop(size_t index) {
+    ThreadTuning::apply(ThreadTuning::Role::Publish, "worker-" + std::to_string(index), static_cast<int>(index));
+    current_pool = this;
+    current_worker = index;
+
+    while (true) {
+        Task task;
+        if (take(index, task)) {
+            task();
+            executed_count_->add(1);
+            continue;
+        }
+
+        // 停止后继续执行，直到所有队列为空
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        sleepers_++;
+        idle_cv_.wait(lock, [this] { return pending_ > 0 || draining_; });
+        sleepers_--;
+        if (draining_ && pending_ == 0) {
+            break;
+        }
+    }
+
+    current_pool = nullptr;
+}
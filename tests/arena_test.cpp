@@ -0,0 +1,124 @@
+#include "arena.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Arena的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 检查指针按alignment对齐
+ */
+bool isAligned(const void *pointer, size_t alignment)
+{
+    return reinterpret_cast<uintptr_t>(pointer) % alignment == 0;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 分配按要求对齐，同一批内的分配互不重叠
+ */
+TEST_CASE("ArenaAlignsAllocations", "[arena]")
+{
+    Arena arena(1024);
+
+    char *a = static_cast<char *>(arena.allocate(3, 1));
+    char *b = static_cast<char *>(arena.allocate(8, 8));
+    char *c = static_cast<char *>(arena.allocate(16, 16));
+    CHECK(isAligned(b, 8));
+    CHECK(isAligned(c, 16));
+    CHECK(b >= a + 3);
+    CHECK(c >= b + 8);
+    CHECK(arena.used() >= 27);
+
+    const Arena::Statistics &stats = arena.statistics();
+    CHECK(stats.allocations == 3);
+    CHECK(stats.bytes == 27);
+    CHECK(stats.heap_blocks == 1);
+}
+
+/**
+ * 测试2: 重置后复用已申请的块，稳态下不再向堆申请
+ */
+TEST_CASE("ArenaReusesBlocksAfterReset", "[arena]")
+{
+    Arena arena(256);
+
+    // 第一批需要多个块
+    for (int i = 0; i < 10; ++i)
+    {
+        arena.allocate(100);
+    }
+    uint64_t warmed_up = arena.statistics().heap_blocks;
+    CHECK(warmed_up > 1);
+    size_t peak = arena.statistics().peak;
+
+    for (int batch = 0; batch < 1000; ++batch)
+    {
+        arena.reset();
+        CHECK(arena.used() == 0);
+        for (int i = 0; i < 10; ++i)
+        {
+            arena.allocate(100);
+        }
+    }
+
+    CHECK(arena.statistics().heap_blocks == warmed_up);
+    CHECK(arena.statistics().resets == 1000);
+    CHECK(arena.statistics().peak == peak);
+}
+
+/**
+ * 测试3: 超过块大小的请求单独申请一块，重置后同样复用
+ */
+TEST_CASE("ArenaServesOversizedRequests", "[arena]")
+{
+    Arena arena(64);
+
+    void *large = arena.allocate(1000);
+    CHECK(large != nullptr);
+    CHECK(arena.statistics().heap_blocks == 1);
+
+    arena.reset();
+    CHECK(arena.allocate(1000) == large);
+    CHECK(arena.statistics().heap_blocks == 1);
+}
+
+/**
+ * 测试4: 作为STL分配器使用，容器的内存来自arena
+ */
+TEST_CASE("ArenaAllocatorBacksContainers", "[arena]")
+{
+    Arena arena(4096);
+
+    ArenaString text{ArenaAllocator<char>(arena)};
+    text.append("{\"id\": 1, \"value\": \"a long enough value to leave small string storage\"}");
+    CHECK(text.size() > 40);
+    CHECK(arena.statistics().allocations > 0);
+
+    std::vector<int, ArenaAllocator<int>> numbers{ArenaAllocator<int>(arena)};
+    for (int i = 0; i < 100; ++i)
+    {
+        numbers.push_back(i);
+    }
+    CHECK(numbers.back() == 99);
+    CHECK(arena.statistics().heap_blocks == 1);
+
+    CHECK(ArenaAllocator<char>(arena) == ArenaAllocator<int>(arena));
+    Arena other;
+    CHECK(ArenaAllocator<char>(arena) != ArenaAllocator<char>(other));
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
@@ -0,0 +1,202 @@
+#include "capture.h"
+#include <catch2/catch_test_macros.hpp>
+#include <arpa/inet.h>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+/**
+ * 抓包文件读写的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 测试用的临时文件路径
+ */
+std::string capturePath(const std::string &name)
+{
+    return "/tmp/capture_test_" + std::to_string(getpid()) + "_" + name + ".cap";
+}
+
+/**
+ * 构造IPv4发送者地址
+ */
+struct sockaddr_storage makeSourceV4(const char *addr, uint16_t port)
+{
+    struct sockaddr_storage source;
+    memset(&source, 0, sizeof(source));
+    auto &sin = reinterpret_cast<struct sockaddr_in &>(source);
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port);
+    inet_pton(AF_INET, addr, &sin.sin_addr);
+    return source;
+}
+
+/**
+ * 构造IPv6发送者地址
+ */
+struct sockaddr_storage makeSourceV6(const char *addr, uint16_t port)
+{
+    struct sockaddr_storage source;
+    memset(&source, 0, sizeof(source));
+    auto &sin6 = reinterpret_cast<struct sockaddr_in6 &>(source);
+    sin6.sin6_family = AF_INET6;
+    sin6.sin6_port = htons(port);
+    inet_pton(AF_INET6, addr, &sin6.sin6_addr);
+    return source;
+}
+
+/**
+ * 追加一条字符串负载的报文记录
+ */
+void appendText(CaptureWriter &writer, uint16_t channel, const struct sockaddr_storage &source,
+                uint64_t rx_ts_ns, const std::string &text)
+{
+    writer.append(channel, source, rx_ts_ns, text.data(), text.size());
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 写入的报文按顺序原样读出，包括接收时间、发送者和通道
+ */
+TEST_CASE("CaptureRoundTrip", "[capture]")
+{
+    std::string path = capturePath("roundtrip");
+    struct sockaddr_storage v4 = makeSourceV4("192.0.2.10", 5000);
+    struct sockaddr_storage v6 = makeSourceV6("fd00::7", 6000);
+
+    {
+        CaptureWriter writer(path);
+        REQUIRE(writer.open());
+        uint16_t sensors = writer.channel("sensors");
+        uint16_t events = writer.channel("events");
+        CHECK(writer.channel("sensors") == sensors);
+        CHECK(sensors != events);
+
+        appendText(writer, sensors, v4, 1000, "{\"id\":1}");
+        appendText(writer, events, v6, 2000, "event");
+        appendText(writer, sensors, v4, 3000, "");
+        CHECK(writer.getRecordCount() == 3);
+        writer.close();
+    }
+
+    CaptureReader reader(path);
+    REQUIRE(reader.open());
+
+    CaptureReader::Record record;
+    REQUIRE(reader.next(record));
+    CHECK(record.channel == "sensors");
+    CHECK(record.rx_ts_ns == 1000);
+    CHECK(std::string(record.data, record.len) == "{\"id\":1}");
+    CHECK(memcmp(&record.source, &v4, sizeof(struct sockaddr_in)) == 0);
+
+    REQUIRE(reader.next(record));
+    CHECK(record.channel == "events");
+    CHECK(record.rx_ts_ns == 2000);
+    CHECK(std::string(record.data, record.len) == "event");
+    CHECK(memcmp(&record.source, &v6, sizeof(struct sockaddr_in6)) == 0);
+
+    REQUIRE(reader.next(record));
+    CHECK(record.channel == "sensors");
+    CHECK(record.len == 0);
+
+    CHECK_FALSE(reader.next(record));
+    CHECK_FALSE(reader.isCorrupt());
+
+    // 重新读取时通道定义同样重新读出
+    reader.rewind();
+    REQUIRE(reader.next(record));
+    CHECK(record.channel == "sensors");
+    CHECK(record.rx_ts_ns == 1000);
+
+    reader.close();
+    unlink(path.c_str());
+}
+
+/**
+ * 测试2: 最后一条记录被截断时读到前一条为止并报告损坏
+ */
+TEST_CASE("CaptureDetectsTruncatedRecord", "[capture]")
+{
+    std::string path = capturePath("truncated");
+    struct sockaddr_storage source = makeSourceV4("192.0.2.10", 5000);
+
+    {
+        CaptureWriter writer(path);
+        REQUIRE(writer.open());
+        uint16_t channel = writer.channel("default");
+        appendText(writer, channel, source, 1, "first");
+        appendText(writer, channel, source, 2, std::string(100, 'x'));
+    }
+    REQUIRE(truncate(path.c_str(), 16 + 40 + 8 + 40 + 8 + 40 + 50) == 0);
+
+    CaptureReader reader(path);
+    REQUIRE(reader.open());
+    CaptureReader::Record record;
+    REQUIRE(reader.next(record));
+    CHECK(std::string(record.data, record.len) == "first");
+    CHECK_FALSE(reader.next(record));
+    CHECK(reader.isCorrupt());
+
+    reader.close();
+    unlink(path.c_str());
+}
+
+/**
+ * 测试3: 未正常关闭的录制（末尾是预先扩展的全零区域）读到最后一条完整记录为止
+ */
+TEST_CASE("CaptureReadsUncleanRecording", "[capture]")
+{
+    std::string path = capturePath("unclean");
+    struct sockaddr_storage source = makeSourceV6("fd00::1", 7000);
+
+    CaptureWriter writer(path);
+    REQUIRE(writer.open());
+    uint16_t channel = writer.channel("default");
+    appendText(writer, channel, source, 10, "a");
+    appendText(writer, channel, source, 20, "b");
+
+    // 写入者仍在运行，文件还是预先扩展的长度
+    CaptureReader reader(path);
+    REQUIRE(reader.open());
+    CaptureReader::Record record;
+    REQUIRE(reader.next(record));
+    CHECK(std::string(record.data, record.len) == "a");
+    REQUIRE(reader.next(record));
+    CHECK(std::string(record.data, record.len) == "b");
+    CHECK_FALSE(reader.next(record));
+    CHECK_FALSE(reader.isCorrupt());
+
+    reader.close();
+    writer.close();
+    unlink(path.c_str());
+}
+
+/**
+ * 测试4: 不是抓包文件时打开失败
+ */
+TEST_CASE("CaptureRejectsForeignFile", "[capture]")
+{
+    std::string path = capturePath("foreign");
+    FILE *file = fopen(path.c_str(), "w");
+    REQUIRE(file != nullptr);
+    fputs("this is not a capture file", file);
+    fclose(file);
+
+    CaptureReader reader(path);
+    CHECK_FALSE(reader.open());
+    CHECK_FALSE(CaptureReader(capturePath("missing")).open());
+
+    unlink(path.c_str());
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
@@ -0,0 +1,129 @@
+#include "conflator.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Conflator的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 构造带传感器ID和数值的消息
+ */
+std::string sensorMessage(int id, int value)
+{
+    return R"({"sensor": {"id": ")" + std::to_string(id) +
+           R"("}, "value": )" + std::to_string(value) + "}";
+}
+
+/**
+ * 创建启用的合并配置
+ */
+Conflator::Config makeConfig()
+{
+    Conflator::Config config;
+    config.enabled = true;
+    config.key_field = "sensor.id";
+    config.max_keys = 8;
+    return config;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 同一键只发布最新值
+ */
+TEST_CASE("ConflatorKeepsLatestValuePerKey", "[conflation]")
+{
+    Conflator conflator(makeConfig());
+
+    for (int value = 0; value < 100; ++value)
+    {
+        REQUIRE(conflator.update(sensorMessage(1, value)));
+        REQUIRE(conflator.update(sensorMessage(2, value * 10)));
+    }
+
+    std::vector<std::string> published;
+    size_t count = conflator.flush(
+        [&published](const std::string &message)
+        { published.push_back(message); });
+
+    REQUIRE(count == 2);
+    REQUIRE(published.size() == 2);
+    CHECK(published[0] == sensorMessage(1, 99));
+    CHECK(published[1] == sensorMessage(2, 990));
+    CHECK(conflator.getConflatedCount() == 198);
+    CHECK(conflator.keyCount() == 2);
+
+    // 没有新更新时不会重复发布
+    CHECK(conflator.flush([](const std::string &) {}) == 0);
+}
+
+/**
+ * 测试2: 缺少键字段或表满时由调用者直接发布
+ */
+TEST_CASE("ConflatorRejectsUnkeyedAndOverflow", "[conflation]")
+{
+    Conflator::Config config = makeConfig();
+    config.max_keys = 2;
+    Conflator conflator(config);
+
+    CHECK_FALSE(conflator.update(R"({"command": "start-recording"})"));
+    CHECK(conflator.update(sensorMessage(1, 0)));
+    CHECK(conflator.update(sensorMessage(2, 0)));
+    CHECK_FALSE(conflator.update(sensorMessage(3, 0)));
+
+    // 已存在的键仍然可以更新
+    CHECK(conflator.update(sensorMessage(1, 5)));
+    CHECK(conflator.keyCount() == 2);
+}
+
+/**
+ * 测试3: 空闲发布模式下更新会被发布线程及时发出，停止时发布剩余值
+ */
+TEST_CASE("ConflatorPublishesFromThread", "[conflation][thread]")
+{
+    Conflator::Config config = makeConfig();
+    config.interval_ms = 1000;
+    config.publish_when_idle = true;
+    Conflator conflator(config);
+
+    std::mutex                 mutex;
+    std::map<std::string, int> received;
+
+    REQUIRE(conflator.start(
+        [&](const std::string &message)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            received[message]++;
+        }));
+
+    conflator.update(sensorMessage(1, 1));
+
+    // 远小于周期时间内应已发布
+    bool published = false;
+    for (int i = 0; i < 50 && !published; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<std::mutex> lock(mutex);
+        published = received.count(sensorMessage(1, 1)) > 0;
+    }
+    CHECK(published);
+
+    conflator.update(sensorMessage(2, 7));
+    conflator.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(received.count(sensorMessage(2, 7)) == 1);
+}
@@ -0,0 +1,140 @@
+#include "deduplicator.h"
+#include "json_field.h"
+#include "xxhash64.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+/**
+ * Deduplicator及其依赖的字段提取、哈希函数的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 以指定时间检查一条消息是否重复
+ */
+bool seen(Deduplicator &dedup, const std::string &message, uint64_t now_ms)
+{
+    return dedup.isDuplicate(message.data(), message.size(), now_ms);
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: XXH64与官方参考值一致
+ */
+TEST_CASE("XxHash64MatchesReferenceVectors", "[hash]")
+{
+    CHECK(xxhash64("", 0) == 0xEF46DB3751D8E999ULL);
+    CHECK(xxhash64("abc", 3) == 0x44BC2CF5AD770999ULL);
+
+    // 超过32字节走分块路径，结果应稳定且与短输入不同
+    std::string longInput(100, 'x');
+    CHECK(xxhash64(longInput.data(), longInput.size()) ==
+          xxhash64(longInput.data(), longInput.size()));
+    CHECK(xxhash64(longInput.data(), longInput.size()) !=
+          xxhash64(longInput.data(), longInput.size() - 1));
+}
+
+/**
+ * 测试2: 字段提取支持嵌套路径和各种值类型
+ */
+TEST_CASE("FindJsonFieldExtractsValues", "[json]")
+{
+    const std::string json =
+        R"({"command": "start", "list": [1, {"id": 9}], "id": 42,
+            "sensor": {"name": "a\"}b", "id": "0"}, "ok": true})";
+
+    std::string_view value;
+    REQUIRE(findJsonField(json, "id", value));
+    CHECK(value == "42");
+
+    REQUIRE(findJsonField(json, "sensor.id", value));
+    CHECK(value == "0");
+
+    REQUIRE(findJsonField(json, "command", value));
+    CHECK(value == "start");
+
+    REQUIRE(findJsonField(json, "ok", value));
+    CHECK(value == "true");
+
+    REQUIRE(findJsonField(json, "list", value));
+    CHECK(value == R"([1, {"id": 9}])");
+
+    CHECK_FALSE(findJsonField(json, "missing", value));
+    CHECK_FALSE(findJsonField(json, "command.id", value));
+    CHECK_FALSE(findJsonField("not json", "id", value));
+    CHECK_FALSE(findJsonField(R"({"id": )", "id", value));
+}
+
+/**
+ * 测试3: 窗口内重复消息被识别，窗口外重新放行
+ */
+TEST_CASE("DeduplicatorSuppressesWithinWindow", "[dedup]")
+{
+    Deduplicator::Config config;
+    config.enabled = true;
+    config.window_ms = 800;
+    Deduplicator dedup(config);
+
+    const std::string message = R"({"id": 1, "value": 3})";
+
+    CHECK_FALSE(seen(dedup, message, 1000));
+    CHECK(seen(dedup, message, 1001));
+    CHECK(seen(dedup, message, 1500));
+    CHECK_FALSE(seen(dedup, R"({"id": 2, "value": 3})", 1500));
+
+    // 超出窗口后视为新消息
+    CHECK_FALSE(seen(dedup, message, 3000));
+    CHECK(seen(dedup, message, 3001));
+}
+
+/**
+ * 测试4: 配置键字段时只比较该字段
+ */
+TEST_CASE("DeduplicatorUsesKeyField", "[dedup]")
+{
+    Deduplicator::Config config;
+    config.enabled = true;
+    config.key_field = "id";
+    Deduplicator dedup(config);
+
+    CHECK_FALSE(seen(dedup, R"({"id": 7, "timestamp": 1})", 0));
+    // 同一id的重传即使时间戳不同也应被过滤
+    CHECK(seen(dedup, R"({"id": 7, "timestamp": 2})", 10));
+    CHECK_FALSE(seen(dedup, R"({"id": 8, "timestamp": 2})", 10));
+
+    // 没有键字段的消息回退到整包哈希
+    CHECK_FALSE(seen(dedup, "plain text", 10));
+    CHECK(seen(dedup, "plain text", 20));
+}
+
+/**
+ * 测试5: 内存固定，超量输入时淘汰旧记录而不是增长
+ */
+TEST_CASE("DeduplicatorHasBoundedMemory", "[dedup]")
+{
+    Deduplicator::Config config;
+    config.enabled = true;
+    config.capacity = 100;
+    Deduplicator dedup(config);
+
+    REQUIRE(dedup.capacity() == 128);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        std::string message = "message-" + std::to_string(i);
+        CHECK_FALSE(seen(dedup, message, 0));
+    }
+
+    CHECK(dedup.capacity() == 128);
+    CHECK(dedup.getEvictionCount() > 0);
+
+    // 最近写入的消息仍能被识别
+    CHECK(seen(dedup, "message-9999", 1));
+}
@@ -0,0 +1,210 @@
+#include "metrics.h"
+#include "metrics_server.h"
+#include <arpa/inet.h>
+#include <catch2/catch_test_macros.hpp>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * 指标子系统（计数器、直方图、注册表、HTTP端点）的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 向本机端口发送一个HTTP请求并返回完整响应
+ */
+std::string httpRequest(int port, const std::string &request)
+{
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0)
+    {
+        return "";
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    if (connect(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        close(sock);
+        return "";
+    }
+
+    send(sock, request.data(), request.size(), 0);
+
+    std::string response;
+    char        buffer[4096];
+    ssize_t     n;
+    while ((n = recv(sock, buffer, sizeof(buffer), 0)) > 0)
+    {
+        response.append(buffer, n);
+    }
+    close(sock);
+    return response;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 多线程累加的计数器在抓取时汇总
+ */
+TEST_CASE("MetricsCounterAggregatesAcrossThreads", "[metrics]")
+{
+    Counter counter;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back(
+            [&counter]
+            {
+                for (int i = 0; i < 10000; ++i)
+                {
+                    counter.add(1);
+                }
+            });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(counter.value() == 80000);
+
+    counter.reset();
+    CHECK(counter.value() == 0);
+}
+
+/**
+ * 测试2: 直方图按桶边界计数，累计值单调
+ */
+TEST_CASE("MetricsHistogramBuckets", "[metrics]")
+{
+    Histogram histogram({1000, 2000, 3000});
+
+    histogram.observe(500);
+    histogram.observe(1000);
+    histogram.observe(2500);
+    histogram.observe(99999);
+
+    Histogram::Snapshot snap = histogram.snapshot();
+    REQUIRE(snap.cumulative.size() == 4);
+    CHECK(snap.cumulative[0] == 2);
+    CHECK(snap.cumulative[1] == 2);
+    CHECK(snap.cumulative[2] == 3);
+    CHECK(snap.cumulative[3] == 4);
+    CHECK(snap.count == 4);
+    CHECK(snap.sum_ns == 500 + 1000 + 2500 + 99999);
+}
+
+/**
+ * 测试3: 相同名称和标签返回同一指标，组件释放后序列从输出中移除
+ */
+TEST_CASE("MetricsRegistrySharesAndExpiresSeries", "[metrics]")
+{
+    MetricsRegistry registry;
+
+    auto first = registry.counter("test_total", "Test counter", {{"bridge", "a"}});
+    auto again = registry.counter("test_total", "Test counter", {{"bridge", "a"}});
+    CHECK(first == again);
+
+    auto other = registry.counter("test_total", "Test counter", {{"bridge", "b"}});
+    first->add(3);
+    other->add(5);
+
+    std::string text = registry.render();
+    CHECK(text.find("# TYPE test_total counter") != std::string::npos);
+    CHECK(text.find("test_total{bridge=\"a\"} 3") != std::string::npos);
+    CHECK(text.find("test_total{bridge=\"b\"} 5") != std::string::npos);
+
+    first.reset();
+    again.reset();
+    text = registry.render();
+    CHECK(text.find("bridge=\"a\"") == std::string::npos);
+    CHECK(text.find("test_total{bridge=\"b\"} 5") != std::string::npos);
+}
+
+/**
+ * 测试4: 直方图按Prometheus格式输出（秒为单位，含+Inf、_sum、_count）
+ */
+TEST_CASE("MetricsRegistryRendersHistogram", "[metrics]")
+{
+    MetricsRegistry registry;
+    auto latency = registry.histogram("test_latency_seconds", "Test latency", {{"client", "x"}});
+    latency->observe(300000); // 0.3ms
+
+    std::string text = registry.render();
+    CHECK(text.find("# TYPE test_latency_seconds histogram") != std::string::npos);
+    CHECK(text.find("test_latency_seconds_bucket{client=\"x\",le=\"0.00025\"} 0") != std::string::npos);
+    CHECK(text.find("test_latency_seconds_bucket{client=\"x\",le=\"0.0005\"} 1") != std::string::npos);
+    CHECK(text.find("test_latency_seconds_bucket{client=\"x\",le=\"+Inf\"} 1") != std::string::npos);
+    CHECK(text.find("test_latency_seconds_count{client=\"x\"} 1") != std::string::npos);
+}
+
+/**
+ * 测试5: HTTP端点在/metrics上返回指标，其他路径返回404
+ */
+TEST_CASE("MetricsServerServesPrometheusText", "[metrics][integration]")
+{
+    MetricsRegistry registry;
+    auto gauge = registry.gauge("test_queue_depth", "Test gauge");
+    gauge->set(7);
+
+    MetricsServer server(registry, 0);
+    REQUIRE(server.start());
+    REQUIRE(server.getPort() > 0);
+
+    std::string response = httpRequest(server.getPort(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    CHECK(response.find("HTTP/1.1 200 OK") == 0);
+    CHECK(response.find("version=0.0.4") != std::string::npos);
+    CHECK(response.find("test_queue_depth 7") != std::string::npos);
+
+    response = httpRequest(server.getPort(), "GET / HTTP/1.1\r\n\r\n");
+    CHECK(response.find("HTTP/1.1 404") == 0);
+
+    server.stop();
+    CHECK_FALSE(server.isRunning());
+}
+
+/**
+ * 测试6: 同一名称以不同类型注册时返回不导出的独立指标，原序列不受影响
+ */
+TEST_CASE("MetricsRegistryRejectsTypeMismatch", "[metrics]")
+{
+    MetricsRegistry registry;
+
+    auto counter = registry.counter("test_mixed", "Test counter");
+    counter->add(2);
+
+    auto gauge = registry.gauge("test_mixed", "Test gauge");
+    REQUIRE(gauge != nullptr);
+    gauge->set(9);
+
+    std::string text = registry.render();
+    CHECK(text.find("# TYPE test_mixed counter") != std::string::npos);
+    CHECK(text.find("test_mixed 2") != std::string::npos);
+    CHECK(text.find("test_mixed 9") == std::string::npos);
+
+    // 原指标释放后可以按新类型注册
+    counter.reset();
+    gauge = registry.gauge("test_mixed", "Test gauge");
+    gauge->set(4);
+    text = registry.render();
+    CHECK(text.find("# TYPE test_mixed gauge") != std::string::npos);
+    CHECK(text.find("test_mixed 4") != std::string::npos);
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
@@ -1,4 +1,5 @@
 #include "mqtt_client.h"
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
 #include <thread>
@@ -243,6 +244,234 @@ TEST_CASE("MqttClientPortBoundaries", "[constructor]")
     REQUIRE(true);
 }
 
+/**
+ * 测试18: 主题通配符匹配
+ */
+TEST_CASE("MqttClientTopicMatches", "[subscribe]")
+{
+    CHECK(MqttClient::topicMatches("command", "command"));
+    CHECK_FALSE(MqttClient::topicMatches("command", "command/x"));
+    CHECK(MqttClient::topicMatches("device/+/status", "device/cam1/status"));
+    CHECK_FALSE(MqttClient::topicMatches("device/+/status", "device/cam1/error"));
+    CHECK(MqttClient::topicMatches("device/#", "device"));
+    CHECK(MqttClient::topicMatches("device/#", "device/a/b"));
+    CHECK(MqttClient::topicMatches("#", "anything/at/all"));
+    CHECK_FALSE(MqttClient::topicMatches("device/+", "device"));
+    CHECK_FALSE(MqttClient::topicMatches("a/b", "a"));
+}
+
+/**
+ * 测试19: 未连接时订阅会被记录，不会失败
+ */
+TEST_CASE("MqttClientSubscribeBeforeConnect", "[subscribe]")
+{
+    MqttClient client("test_client_subscribe", "localhost", 1883);
+    client.setMessageCallback([](const std::string &, const std::string &) {});
+    REQUIRE(client.subscribe("command", 1));
+}
+
+/**
+ * 测试20: 反应器模式下由事件循环驱动连接并发布（假设有mosquitto运行）
+ */
+TEST_CASE("MqttClientReactorConnectAndPublish", "[reactor]")
+{
+    auto loop = std::make_shared<UdpEventLoop>();
+    REQUIRE(loop->start());
+
+    MqttClient client("test_client_reactor", "localhost", 1883);
+    client.setEventLoop(loop);
+    CHECK(client.getEventLoop() == loop);
+
+    bool connected = client.connect();
+    REQUIRE(connected);
+
+    bool published = client.publish("test/topic", "reactor message", 1);
+    REQUIRE(published);
+    waitMs(100);
+
+    // 断开后事件循环不再驱动该连接，可以安全停止
+    client.disconnect();
+    loop->stop();
+}
+
+/**
+ * 测试21: 反应器模式下连接到不存在的broker（应该失败）
+ */
+TEST_CASE("MqttClientReactorConnectToInvalidBroker", "[reactor]")
+{
+    auto loop = std::make_shared<UdpEventLoop>();
+    REQUIRE(loop->start());
+
+    MqttClient client("test_client_reactor", "invalid.broker.address", 1883);
+    client.setEventLoop(loop);
+    REQUIRE_FALSE(client.connect());
+
+    client.disconnect();
+    loop->stop();
+}
+
+/**
+ * 测试22: QoS0快速路径（可带retain）不计入在途消息（假设有mosquitto运行）
+ */
+TEST_CASE("MqttClientQos0FastPathSkipsInflight", "[publish]")
+{
+    MqttClient client("test_client_qos0", "localhost", 1883);
+    auto inflight = MetricsRegistry::global().gauge("mqtt_inflight_messages", "", {{"client", "test_client_qos0"}});
+
+    bool connected = client.connect();
+    REQUIRE(connected);
+
+    int64_t before = inflight->value();
+    CHECK(client.publish("test/telemetry", "fast 1", 0));
+    CHECK(client.publish("test/telemetry", "fast 2", 0, true));
+    CHECK(inflight->value() == before);
+
+    // 清除保留消息
+    CHECK(client.publish("test/telemetry", "", 0, true));
+
+    client.disconnect();
+}
+
+/**
+ * 测试23: 异步连接立即返回，CONNACK到达时通知连接回调（假设有mosquitto运行）
+ */
+TEST_CASE("MqttClientConnectAsyncNotifiesListener", "[connect]")
+{
+    MqttClient client("test_client_async", "localhost", 1883);
+    std::atomic<int> notified(0);
+    int listener = client.addConnectListener([&]()
+                                             { notified++; });
+
+    REQUIRE(client.connectAsync());
+    REQUIRE(client.waitConnected(std::chrono::milliseconds(MqttClient::CONNECT_TIMEOUT_MS)));
+    CHECK(client.isConnected());
+    CHECK(notified == 1);
+
+    // 移除后不再通知
+    client.removeConnectListener(listener);
+    client.disconnect();
+    CHECK_FALSE(client.isConnected());
+    CHECK(notified == 1);
+}
+
+/**
+ * 测试24: 未连接时waitConnected超时返回false
+ */
+TEST_CASE("MqttClientWaitConnectedTimesOut", "[connect]")
+{
+    MqttClient client("test_client_wait", "localhost", 1883);
+    CHECK_FALSE(client.isConnected());
+    CHECK_FALSE(client.waitConnected(std::chrono::milliseconds(10)));
+}
+
+/**
+ * 测试25: 没有在途消息时drain立即返回0
+ */
+TEST_CASE("MqttClientDrainWithoutInflight", "[drain]")
+{
+    MqttClient client("test_client_drain_idle", "localhost", 1883);
+    CHECK(client.getInflightCount() == 0);
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(client.drain(start + std::chrono::seconds(5)) == 0);
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+}
+
+/**
+ * 测试26: drain等待QoS1消息被确认后返回，之后正常断开（假设有mosquitto运行）
+ */
+TEST_CASE("MqttClientDrainWaitsForAcks", "[drain]")
+{
+    MqttClient client("test_client_drain", "localhost", 1883);
+    REQUIRE(client.connect());
+
+    for (int i = 0; i < 20; ++i)
+    {
+        REQUIRE(client.publish("test/drain", "message " + std::to_string(i), 1));
+    }
+
+    int64_t unacknowledged = client.drain(std::chrono::steady_clock::now() + std::chrono::seconds(5));
+    CHECK(unacknowledged == 0);
+    CHECK(client.getInflightCount() == 0);
+
+    client.disconnect();
+    CHECK_FALSE(client.isConnected());
+}
+
+/**
+ * 测试27: 在途消息超过延迟采样槽数时drain仍等到全部确认（假设有mosquitto运行）
+ */
+TEST_CASE("MqttClientDrainCountsBeyondLatencySlots", "[drain]")
+{
+    MqttClient client("test_client_drain_many", "localhost", 1883);
+    REQUIRE(client.connect());
+
+    const int total = 5000;
+    for (int i = 0; i < total; ++i)
+    {
+        REQUIRE(client.publish("test/drain/many", "message " + std::to_string(i), 1));
+    }
+    CHECK(client.getInflightCount() <= total);
+
+    int64_t unacknowledged = client.drain(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    CHECK(unacknowledged == 0);
+    CHECK(client.getInflightCount() == 0);
+
+    client.disconnect();
+}
+
+/**
+ * 测试28: 断开连接后未确认的消息不再计入在途（假设有mosquitto运行）
+ */
+TEST_CASE("MqttClientDisconnectClearsInflight", "[drain]")
+{
+    MqttClient client("test_client_drain_abandon", "localhost", 1883);
+    REQUIRE(client.connect());
+
+    for (int i = 0; i < 100; ++i)
+    {
+        REQUIRE(client.publish("test/drain/abandon", "message " + std::to_string(i), 1));
+    }
+
+    int64_t inflight = client.getInflightCount();
+    client.disconnect();
+    CHECK(client.getInflightCount() == 0);
+    // 断开时仍未确认的消息计入放弃数（断开前可能又确认了一部分）
+    CHECK(client.getAbandonedCount() <= inflight);
+}
+
+/**
+ * 测试29: 意外断开后未确认的消息仍计入在途，自动重连后drain等到它们被确认（假设有mosquitto运行）
+ */
+TEST_CASE("MqttClientDrainWaitsAcrossReconnect", "[drain]")
+{
+    MqttClient client("test_client_drain_reconnect", "localhost", 1883);
+    REQUIRE(client.connect());
+
+    // 同一客户端ID的第二个连接把它踢下线；一直发布到断开，断开时仍有未确认的消息
+    MqttClient intruder("test_client_drain_reconnect", "localhost", 1883);
+    std::thread kick([&]()
+                     { intruder.connect(); });
+    int published = 0;
+    while (published < 100000 && client.publish("test/drain/reconnect", "message " + std::to_string(published), 1))
+    {
+        published++;
+    }
+    kick.join();
+    intruder.disconnect();
+
+    REQUIRE_FALSE(client.isConnected());
+    CHECK(client.getInflightCount() > 0);
+
+    // libmosquitto自动重连并重发，drain等到全部确认
+    REQUIRE(client.waitConnected(std::chrono::seconds(5)));
+    int64_t unacknowledged = client.drain(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    CHECK(unacknowledged == 0);
+    CHECK(client.getInflightCount() == 0);
+
+    client.disconnect();
+}
+
 // ============================================================================
 // 主程序由Catch2提供
 // ============================================================================
\ No newline at end of file
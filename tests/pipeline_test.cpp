@@ -0,0 +1,211 @@
+#include "pipeline.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+/**
+ * 处理流水线的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 构造带接收信息的消息
+ */
+PipelineMessage makeMessage(const std::string &payload, uint64_t rx_ts_ns = 0, const std::string &source = "")
+{
+    PipelineMessage message;
+    message.payload = payload;
+    message.rx_ts_ns = rx_ts_ns;
+    message.source = source;
+    return message;
+}
+
+/**
+ * 构造字段过滤阶段的配置
+ */
+RuntimePipeline::Stage filterStage(RuntimePipeline::Stage::Type type, const std::string &field,
+                                   const std::string &equals = "")
+{
+    RuntimePipeline::Stage stage;
+    stage.type = type;
+    stage.field = field;
+    stage.compare_value = !equals.empty();
+    stage.equals = equals;
+    return stage;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 编译期组合的流水线按顺序执行，过滤阶段丢弃后不再执行后续阶段
+ */
+TEST_CASE("PipelineAppliesStagesInOrder", "[pipeline]")
+{
+    auto pipeline = makePipeline(DropIf<FieldMatch>{{"test", true, "true"}},
+                                 ProjectFields{{"id", "value"}},
+                                 EnrichFields{"_rx_ts_ns", "", {}});
+
+    PipelineMessage message = makeMessage("{\"id\": 7, \"noise\": [1, 2], \"value\": \"ok\"}", 1234);
+    REQUIRE(pipeline.apply(message));
+    CHECK(message.payload == "{\"id\":7,\"value\":\"ok\",\"_rx_ts_ns\":1234}");
+
+    PipelineMessage dropped = makeMessage("{\"id\": 8, \"test\": true}", 1234);
+    CHECK_FALSE(pipeline.apply(dropped));
+    CHECK(dropped.payload == "{\"id\": 8, \"test\": true}");
+}
+
+/**
+ * 测试2: 字段谓词支持存在判断、值比较和嵌套路径
+ */
+TEST_CASE("PipelineFiltersByField", "[pipeline]")
+{
+    KeepIf<FieldMatch> keep_sensor{{"sensor.type", true, "temp"}};
+    DropIf<FieldMatch> drop_debug{{"debug", false, ""}};
+
+    PipelineMessage temp = makeMessage("{\"sensor\": {\"type\": \"temp\"}}");
+    PipelineMessage pressure = makeMessage("{\"sensor\": {\"type\": \"pressure\"}}");
+    PipelineMessage not_json = makeMessage("plain text");
+    CHECK(keep_sensor(temp));
+    CHECK_FALSE(keep_sensor(pressure));
+    CHECK_FALSE(keep_sensor(not_json));
+
+    PipelineMessage debug = makeMessage("{\"debug\": false}");
+    PipelineMessage normal = makeMessage("{\"id\": 1}");
+    CHECK_FALSE(drop_debug(debug));
+    CHECK(drop_debug(normal));
+    CHECK(drop_debug(not_json));
+}
+
+/**
+ * 测试3: 投影按原文复制字段值，缺少的字段跳过，非对象消息原样通过
+ */
+TEST_CASE("PipelineProjectsFields", "[pipeline]")
+{
+    ProjectFields project{{"value", "sensor.id", "missing"}};
+
+    PipelineMessage message = makeMessage("{\"sensor\": {\"id\": \"a\\\"b\"}, \"value\": {\"x\": [1, 2]}, \"other\": 1}");
+    REQUIRE(project(message));
+    CHECK(message.payload == "{\"value\":{\"x\": [1, 2]},\"sensor.id\":\"a\\\"b\"}");
+
+    PipelineMessage none = makeMessage("{\"other\": 1}");
+    REQUIRE(project(none));
+    CHECK(none.payload == "{}");
+
+    PipelineMessage array = makeMessage("[1, 2, 3]");
+    REQUIRE(project(array));
+    CHECK(array.payload == "[1, 2, 3]");
+}
+
+/**
+ * 测试4: 注入的字段拼接在右括号之前，原有内容保持不变
+ */
+TEST_CASE("PipelineEnrichesBeforeClosingBrace", "[pipeline]")
+{
+    EnrichFields enrich{"_rx_ts_ns", "_src", {{"site", "\"plant-1\""}, {"line", "3"}}};
+
+    PipelineMessage message = makeMessage("{ \"id\" : 1 }\n", 42, "192.0.2.1:5000");
+    REQUIRE(enrich(message));
+    CHECK(message.payload == "{ \"id\" : 1 ,\"_rx_ts_ns\":42,\"_src\":\"192.0.2.1:5000\",\"site\":\"plant-1\",\"line\":3}\n");
+
+    // 空对象不需要逗号，发送者未知时不注入来源字段
+    PipelineMessage empty = makeMessage("{ }", 7);
+    REQUIRE(enrich(empty));
+    CHECK(empty.payload == "{ \"_rx_ts_ns\":7,\"site\":\"plant-1\",\"line\":3}");
+
+    PipelineMessage text = makeMessage("hello", 7);
+    REQUIRE(enrich(text));
+    CHECK(text.payload == "hello");
+
+    // 预留了空间时原有内容留在原处，不重新分配
+    PipelineMessage reserved;
+    reserved.payload.reserve(256);
+    reserved.payload = "{\"id\": 2}";
+    reserved.rx_ts_ns = 1700000000123456789ULL;
+    reserved.source = "[fd00::1]:6000";
+    const char *before = reserved.payload.data();
+    REQUIRE(enrich(reserved));
+    CHECK(reserved.payload.data() == before);
+    CHECK(reserved.payload == "{\"id\": 2,\"_rx_ts_ns\":1700000000123456789,\"_src\":\"[fd00::1]:6000\",\"site\":\"plant-1\",\"line\":3}");
+}
+
+/**
+ * 测试5: 按配置组合的流水线与编译期组合的结果一致
+ */
+TEST_CASE("RuntimePipelineMatchesCompiledPipeline", "[pipeline]")
+{
+    RuntimePipeline::Stage project;
+    project.type = RuntimePipeline::Stage::Type::Project;
+    project.fields = {"id", "value"};
+
+    RuntimePipeline::Stage enrich;
+    enrich.type = RuntimePipeline::Stage::Type::Enrich;
+    enrich.timestamp_field = "_rx_ts_ns";
+
+    RuntimePipeline::Config config;
+    config.stages = {filterStage(RuntimePipeline::Stage::Type::KeepIf, "value"),
+                     filterStage(RuntimePipeline::Stage::Type::DropIf, "test", "true"), project, enrich};
+    RuntimePipeline runtime(config);
+    CHECK(runtime.size() == 4);
+
+    auto compiled = makePipeline(KeepIf<FieldMatch>{{"value", false, ""}}, DropIf<FieldMatch>{{"test", true, "true"}},
+                                 ProjectFields{{"id", "value"}}, EnrichFields{"_rx_ts_ns", "", {}});
+
+    const char *payloads[] = {
+        "{\"id\": 1, \"value\": 2.5, \"unit\": \"C\"}",
+        "{\"id\": 2, \"value\": 3, \"test\": true}",
+        "{\"id\": 3}",
+        "{\"id\": 4, \"value\": null, \"test\": false}",
+    };
+    for (const char *payload : payloads)
+    {
+        PipelineMessage a = makeMessage(payload, 99);
+        PipelineMessage b = makeMessage(payload, 99);
+        CHECK(runtime.apply(a) == compiled.apply(b));
+        CHECK(a.payload == b.payload);
+    }
+
+    RuntimePipeline::Stage::Type type;
+    CHECK(RuntimePipeline::parseType("keep_if", type));
+    CHECK(type == RuntimePipeline::Stage::Type::KeepIf);
+    CHECK_FALSE(RuntimePipeline::parseType("map", type));
+
+    RuntimePipeline::Config other = config;
+    CHECK(other == config);
+    other.stages[1].equals = "false";
+    CHECK(other != config);
+}
+
+/**
+ * 测试6: 带arena时投影在arena中拼接，结果相同，复用容量后不再向堆申请块
+ */
+TEST_CASE("PipelineProjectsIntoArena", "[pipeline]")
+{
+    Arena arena(4096);
+    ProjectFields project{{"value", "sensor.id"}};
+    const std::string payload = "{\"sensor\": {\"id\": \"a\"}, \"value\": 3, \"unit\": \"C\"}";
+
+    PipelineMessage plain = makeMessage(payload);
+    REQUIRE(project(plain));
+
+    PipelineMessage staged;
+    staged.arena = &arena;
+    for (int i = 0; i < 100; ++i)
+    {
+        staged.payload.assign(payload);
+        REQUIRE(project(staged));
+        CHECK(staged.payload == plain.payload);
+        arena.reset();
+    }
+
+    CHECK(arena.statistics().allocations >= 100);
+    CHECK(arena.statistics().heap_blocks == 1);
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
@@ -0,0 +1,262 @@
+#include "priority_lanes.h"
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * PriorityLanes的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 创建通道配置；通道名带上前缀，各测试的指标互不影响
+ */
+PriorityLanes::Lane makeLane(const std::string &name, int weight = 1, size_t capacity = 100)
+{
+    PriorityLanes::Lane lane;
+    lane.name = name;
+    lane.weight = weight;
+    lane.capacity = capacity;
+    return lane;
+}
+
+/**
+ * 记录发布顺序的来源；第一条消息在回调中阻塞到release()，期间送入的消息都在通道中排队
+ */
+class GatedSink
+{
+public:
+    GatedSink() : released_(release_.get_future().share()) {}
+
+    PriorityLanes::PublishCallback callback()
+    {
+        return [this](const std::string &message)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                published_.push_back(message);
+                if (published_.size() == 1)
+                {
+                    first_.set_value();
+                }
+            }
+            released_.wait();
+        };
+    }
+
+    // 等待第一条消息进入回调
+    void waitFirst() { first_.get_future().wait(); }
+
+    void release() { release_.set_value(); }
+
+    std::vector<std::string> published()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return published_;
+    }
+
+private:
+    std::promise<void> first_;
+    std::promise<void> release_;
+    std::shared_future<void> released_;
+    std::mutex mutex_;
+    std::vector<std::string> published_;
+};
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: Strict策略下命令消息越过已排队的遥测消息，停止前发布完剩余消息
+ */
+TEST_CASE("PriorityLanesStrictCommandsBypassTelemetry", "[priority]")
+{
+    PriorityLanes::Config config;
+    config.enabled = true;
+    config.lanes = {makeLane("strict-command"), makeLane("strict-telemetry")};
+    config.lanes[0].topics = {"cmd"};
+    PriorityLanes lanes(config);
+
+    GatedSink sink;
+    int source = lanes.addSource(sink.callback());
+    REQUIRE(lanes.start());
+
+    REQUIRE(lanes.enqueue(source, "telemetry", "t0"));
+    sink.waitFirst();
+    for (int i = 1; i <= 3; ++i)
+    {
+        REQUIRE(lanes.enqueue(source, "telemetry", "t" + std::to_string(i)));
+    }
+    REQUIRE(lanes.enqueue(source, "cmd", "c1"));
+    REQUIRE(lanes.enqueue(source, "cmd", "c2"));
+    CHECK(lanes.getDepth(0) == 2);
+    CHECK(lanes.getDepth(1) == 3);
+
+    sink.release();
+    lanes.stop();
+
+    CHECK(sink.published() == std::vector<std::string>{"t0", "c1", "c2", "t1", "t2", "t3"});
+    CHECK(lanes.getDepth(0) == 0);
+    CHECK(lanes.getDepth(1) == 0);
+    CHECK(lanes.getAverageDelay(0) > 0);
+}
+
+/**
+ * 测试2: Weighted策略按权重轮流发布，低优先级通道不会饿死
+ */
+TEST_CASE("PriorityLanesWeightedShare", "[priority]")
+{
+    PriorityLanes::Config config;
+    config.enabled = true;
+    config.policy = PriorityLanes::Policy::Weighted;
+    config.lanes = {makeLane("weighted-command", 3), makeLane("weighted-telemetry", 1)};
+    config.lanes[0].topics = {"cmd"};
+    PriorityLanes lanes(config);
+
+    GatedSink sink;
+    int source = lanes.addSource(sink.callback());
+    REQUIRE(lanes.start());
+
+    // 第一条命令消息用掉本轮的一个配额
+    REQUIRE(lanes.enqueue(source, "cmd", "c"));
+    sink.waitFirst();
+    for (int i = 0; i < 6; ++i)
+    {
+        REQUIRE(lanes.enqueue(source, "cmd", "c"));
+        REQUIRE(lanes.enqueue(source, "telemetry", "t"));
+    }
+
+    sink.release();
+    lanes.stop();
+
+    std::string order;
+    for (const auto &message : sink.published())
+    {
+        order += message;
+    }
+    CHECK(order == "ccctccctctttt");
+}
+
+/**
+ * 测试3: 按主题、字段取值和字段是否存在分类，未匹配的进入最后一个通道
+ */
+TEST_CASE("PriorityLanesClassifyByTopicAndField", "[priority]")
+{
+    PriorityLanes::Config config;
+    config.lanes = {makeLane("classify-command"), makeLane("classify-alarm"), makeLane("classify-bulk")};
+    config.lanes[0].topics = {"plant/cmd"};
+    config.lanes[0].field = "type";
+    config.lanes[0].values = {"command", "ack"};
+    config.lanes[1].field = "alarm.level";
+    PriorityLanes lanes(config);
+
+    CHECK(lanes.classify("plant/cmd", R"({"value": 1})") == 0);
+    CHECK(lanes.classify("plant/data", R"({"type": "ack"})") == 0);
+    CHECK(lanes.classify("plant/data", R"({"type": "sample"})") == 2);
+    CHECK(lanes.classify("plant/data", R"({"alarm": {"level": 3}})") == 1);
+    CHECK(lanes.classify("plant/data", R"({"value": 1})") == 2);
+    CHECK(lanes.classify("plant/data", "not json") == 2);
+
+    // 没有配置通道时只有一个默认通道
+    PriorityLanes fallback(PriorityLanes::Config{});
+    CHECK(fallback.laneCount() == 1);
+    CHECK(fallback.laneName(0) == "default");
+}
+
+/**
+ * 测试4: 通道满时丢弃新消息并计数，其他通道不受影响
+ */
+TEST_CASE("PriorityLanesDropWhenFull", "[priority]")
+{
+    PriorityLanes::Config config;
+    config.lanes = {makeLane("full-command"), makeLane("full-telemetry", 1, 2)};
+    config.lanes[0].topics = {"cmd"};
+    PriorityLanes lanes(config);
+
+    GatedSink sink;
+    int source = lanes.addSource(sink.callback());
+    REQUIRE(lanes.start());
+
+    REQUIRE(lanes.enqueue(source, "telemetry", "t0"));
+    sink.waitFirst();
+    CHECK(lanes.enqueue(source, "telemetry", "t1"));
+    CHECK(lanes.enqueue(source, "telemetry", "t2"));
+    CHECK_FALSE(lanes.enqueue(source, "telemetry", "t3"));
+    CHECK(lanes.enqueue(source, "cmd", "c1"));
+    CHECK(lanes.getDroppedCount(1) == 1);
+    CHECK(lanes.getDroppedCount(0) == 0);
+
+    sink.release();
+    lanes.stop();
+    CHECK(sink.published() == std::vector<std::string>{"t0", "c1", "t1", "t2"});
+}
+
+/**
+ * 测试5: 停止后在调用线程中直接发布，已取消注册的来源的消息不再发布
+ */
+TEST_CASE("PriorityLanesAfterStopAndRemoveSource", "[priority]")
+{
+    PriorityLanes::Config config;
+    config.lanes = {makeLane("stopped-default")};
+    PriorityLanes lanes(config);
+
+    std::vector<std::string> first;
+    std::vector<std::string> second;
+    int a = lanes.addSource([&first](const std::string &message)
+                            { first.push_back(message); });
+    int b = lanes.addSource([&second](const std::string &message)
+                            { second.push_back(message); });
+    REQUIRE(a != b);
+
+    REQUIRE(lanes.start());
+    CHECK_FALSE(lanes.start());
+    lanes.stop();
+    CHECK_FALSE(lanes.isRunning());
+
+    CHECK(lanes.enqueue(a, "any", "direct"));
+    CHECK(first == std::vector<std::string>{"direct"});
+
+    lanes.removeSource(b);
+    CHECK(lanes.enqueue(b, "any", "gone"));
+    CHECK(second.empty());
+}
+
+/**
+ * 测试6: 策略名解析和配置检查
+ */
+TEST_CASE("PriorityLanesValidateConfig", "[priority]")
+{
+    PriorityLanes::Policy policy = PriorityLanes::Policy::Strict;
+    CHECK(PriorityLanes::parsePolicy("weighted", policy));
+    CHECK(policy == PriorityLanes::Policy::Weighted);
+    CHECK_FALSE(PriorityLanes::parsePolicy("fifo", policy));
+
+    PriorityLanes::Config config;
+    std::string error;
+    CHECK_FALSE(PriorityLanes::validate(config, error));
+
+    config.lanes = {makeLane("a"), makeLane("b")};
+    CHECK(PriorityLanes::validate(config, error));
+
+    config.lanes[1].name = "a";
+    CHECK_FALSE(PriorityLanes::validate(config, error));
+
+    config.lanes[1] = makeLane("b", 0);
+    CHECK_FALSE(PriorityLanes::validate(config, error));
+
+    PriorityLanes::Config other = config;
+    CHECK(other == config);
+    other.lanes[1].topics = {"x"};
+    CHECK(other != config);
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
@@ -0,0 +1,177 @@
+#include "rate_limiter.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * TokenBucket与RateLimiter的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+const uint64_t MS = 1000000ULL;
+
+/**
+ * 创建启用的限流配置
+ */
+RateLimiter::Config makeConfig(RateLimiter::Policy policy)
+{
+    RateLimiter::Config config;
+    config.enabled = true;
+    config.policy = policy;
+    return config;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 令牌桶允许突发，随后按速率补充
+ */
+TEST_CASE("TokenBucketAllowsBurstThenRate", "[bucket]")
+{
+    // 每秒100个（10ms一个），突发5个
+    TokenBucket bucket(100, 5);
+    uint64_t    now = 1000 * MS;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        CHECK(bucket.reserve(now, 0) == 0);
+    }
+    CHECK(bucket.reserve(now, 0) == -1);
+
+    // 10ms后补充一个
+    CHECK(bucket.reserve(now + 10 * MS, 0) == 0);
+    CHECK(bucket.reserve(now + 10 * MS, 0) == -1);
+
+    // 允许等待时返回需要等待的时间
+    CHECK(bucket.reserve(now + 10 * MS, 20 * MS) == static_cast<int64_t>(10 * MS));
+}
+
+/**
+ * 测试2: 归还令牌
+ */
+TEST_CASE("TokenBucketRefund", "[bucket]")
+{
+    TokenBucket bucket(10, 1);
+    uint64_t    now = 1000 * MS;
+
+    CHECK(bucket.reserve(now, 0) == 0);
+    CHECK(bucket.reserve(now, 0) == -1);
+    bucket.refund();
+    CHECK(bucket.reserve(now, 0) == 0);
+}
+
+/**
+ * 测试3: 路由桶和全局桶都要通过
+ */
+TEST_CASE("RateLimiterAppliesRouteAndGlobal", "[limiter]")
+{
+    RateLimiter::Config config = makeConfig(RateLimiter::Policy::Drop);
+    config.routes["telemetry"] = {1, 2};
+    config.routes["command"] = {1000, 1000};
+
+    auto global = RateLimiter::makeBucket({1, 3});
+    RateLimiter telemetry(config, "telemetry", global);
+    RateLimiter command(config, "command", global);
+
+    // telemetry受路由桶限制只能发2条
+    CHECK(telemetry.acquire("a") == RateLimiter::Result::Admitted);
+    CHECK(telemetry.acquire("b") == RateLimiter::Result::Admitted);
+    CHECK(telemetry.acquire("c") == RateLimiter::Result::Dropped);
+
+    // 全局桶还剩1个，被command用掉后也被拒绝
+    CHECK(command.acquire("d") == RateLimiter::Result::Admitted);
+    CHECK(command.acquire("e") == RateLimiter::Result::Dropped);
+
+    CHECK(telemetry.getDroppedCount() == 1);
+    CHECK(command.getDroppedCount() == 1);
+}
+
+/**
+ * 测试4: 未配置的路由和全局不限速
+ */
+TEST_CASE("RateLimiterUnlimitedWhenNotConfigured", "[limiter]")
+{
+    RateLimiter limiter(makeConfig(RateLimiter::Policy::Drop), "any");
+    for (int i = 0; i < 1000; ++i)
+    {
+        REQUIRE(limiter.acquire("x") == RateLimiter::Result::Admitted);
+    }
+}
+
+/**
+ * 测试5: Spool策略按原顺序发布超限消息
+ */
+TEST_CASE("RateLimiterSpoolsInOrder", "[limiter][thread]")
+{
+    RateLimiter::Config config = makeConfig(RateLimiter::Policy::Spool);
+    config.global = {200, 1};
+    config.spool_size = 3;
+    RateLimiter limiter(config, "topic");
+
+    std::mutex               mutex;
+    std::vector<std::string> published;
+    REQUIRE(limiter.start(
+        [&](const std::string &message)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            published.push_back(message);
+        }));
+
+    CHECK(limiter.acquire("1") == RateLimiter::Result::Admitted);
+    CHECK(limiter.acquire("2") == RateLimiter::Result::Spooled);
+    CHECK(limiter.acquire("3") == RateLimiter::Result::Spooled);
+    CHECK(limiter.acquire("4") == RateLimiter::Result::Spooled);
+    CHECK(limiter.acquire("5") == RateLimiter::Result::Dropped);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    limiter.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(published == std::vector<std::string>{"2", "3", "4"});
+    CHECK(limiter.getSpooledCount() == 3);
+    CHECK(limiter.getDroppedCount() == 1);
+}
+
+/**
+ * 测试6: Delay策略不在调用线程中等待，延迟的消息按预约时间依次发布
+ */
+TEST_CASE("RateLimiterDelaysWithoutBlockingCaller", "[limiter][thread]")
+{
+    RateLimiter::Config config = makeConfig(RateLimiter::Policy::Delay);
+    config.global = {100, 1};
+    config.max_delay_ms = 25;
+    RateLimiter limiter(config, "topic");
+
+    std::mutex               mutex;
+    std::vector<std::string> published;
+    REQUIRE(limiter.start(
+        [&](const std::string &message)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            published.push_back(message);
+        }));
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(limiter.acquire("1") == RateLimiter::Result::Admitted);
+    CHECK(limiter.acquire("2") == RateLimiter::Result::Spooled);
+    CHECK(limiter.acquire("3") == RateLimiter::Result::Spooled);
+    CHECK(limiter.acquire("4") == RateLimiter::Result::Dropped);
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(10));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    limiter.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(published == std::vector<std::string>{"2", "3"});
+    CHECK(limiter.getDelayedCount() == 2);
+    CHECK(limiter.getDroppedCount() == 1);
+}
@@ -0,0 +1,172 @@
+#include "readiness.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * Readiness的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 创建并绑定Unix数据报套接字，模拟服务管理器的通知套接字；'@'开头为抽象命名空间
+ */
+int bindNotifySocket(const std::string &path)
+{
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.data(), path.size());
+    if (path[0] == '@')
+    {
+        addr.sun_path[0] = '\0';
+    }
+    socklen_t len = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.size());
+    if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), len) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    struct timeval timeout = {1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+}
+
+/**
+ * 读取一条通知，超时返回空串
+ */
+std::string receiveNotification(int fd)
+{
+    char buffer[512];
+    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+    return n > 0 ? std::string(buffer, n) : std::string();
+}
+
+/**
+ * 检查文件是否存在
+ */
+bool fileExists(const std::string &path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 未设置NOTIFY_SOCKET时不发送，也不影响就绪文件
+ */
+TEST_CASE("ReadinessWithoutNotifySocket", "[readiness]")
+{
+    unsetenv("NOTIFY_SOCKET");
+    CHECK_FALSE(Readiness::notify("READY=1"));
+
+    Readiness readiness;
+    CHECK(readiness.ready("Forwarding"));
+    readiness.stopping();
+}
+
+/**
+ * 测试2: 就绪和停止状态按sd_notify格式发送到文件系统路径的套接字
+ */
+TEST_CASE("ReadinessNotifiesServiceManager", "[readiness]")
+{
+    std::string path = "/tmp/readiness_test_" + std::to_string(getpid()) + ".sock";
+    unlink(path.c_str());
+    int fd = bindNotifySocket(path);
+    REQUIRE(fd >= 0);
+    setenv("NOTIFY_SOCKET", path.c_str(), 1);
+
+    Readiness readiness;
+    CHECK(readiness.ready("Forwarding"));
+    std::string ready = receiveNotification(fd);
+    CHECK(ready.find("READY=1\n") == 0);
+    CHECK(ready.find("STATUS=Forwarding") != std::string::npos);
+    CHECK(ready.find("MAINPID=" + std::to_string(getpid())) != std::string::npos);
+
+    readiness.stopping();
+    CHECK(receiveNotification(fd) == "STOPPING=1");
+
+    // 停止之后不再报告就绪
+    readiness.ready("Forwarding");
+    CHECK(receiveNotification(fd).empty());
+
+    unsetenv("NOTIFY_SOCKET");
+    close(fd);
+    unlink(path.c_str());
+}
+
+/**
+ * 测试3: 抽象命名空间的通知套接字
+ */
+TEST_CASE("ReadinessAbstractNotifySocket", "[readiness]")
+{
+    std::string path = "@readiness_test_" + std::to_string(getpid());
+    int fd = bindNotifySocket(path);
+    REQUIRE(fd >= 0);
+    setenv("NOTIFY_SOCKET", path.c_str(), 1);
+
+    CHECK(Readiness::notify("READY=1"));
+    CHECK(receiveNotification(fd) == "READY=1");
+
+    unsetenv("NOTIFY_SOCKET");
+    close(fd);
+}
+
+/**
+ * 测试4: 就绪时写入进程号到就绪文件，停止时删除
+ */
+TEST_CASE("ReadinessFileLifecycle", "[readiness]")
+{
+    unsetenv("NOTIFY_SOCKET");
+    std::string path = "/tmp/readiness_test_" + std::to_string(getpid()) + ".ready";
+    unlink(path.c_str());
+
+    Readiness readiness(path);
+    CHECK_FALSE(fileExists(path));
+    REQUIRE(readiness.ready("Forwarding"));
+    REQUIRE(fileExists(path));
+    CHECK_FALSE(fileExists(path + ".tmp"));
+
+    std::ifstream file(path);
+    pid_t pid = 0;
+    file >> pid;
+    CHECK(pid == getpid());
+
+    readiness.stopping();
+    CHECK_FALSE(fileExists(path));
+}
+
+/**
+ * 测试5: 就绪文件所在目录不存在时报告失败
+ */
+TEST_CASE("ReadinessFileInMissingDirectory", "[readiness]")
+{
+    unsetenv("NOTIFY_SOCKET");
+    Readiness readiness("/nonexistent_readiness_dir/app.ready");
+    CHECK_FALSE(readiness.ready("Forwarding"));
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
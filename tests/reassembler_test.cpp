@@ -0,0 +1,193 @@
+#include "reassembler.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * 分片重组器的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 以指定时间处理一个报文
+ */
+Reassembler::Result feed(Reassembler &reassembler, uint64_t source, const std::string &datagram,
+                         std::string &message, uint64_t now_ms)
+{
+    return reassembler.add(source, datagram.data(), datagram.size(), message, now_ms);
+}
+
+/**
+ * 生成指定长度的测试消息
+ */
+std::string makeMessage(size_t size)
+{
+    std::string message;
+    message.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        message.push_back(static_cast<char>('a' + i % 26));
+    }
+    return message;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 乱序到达的分片组装成原消息，重复分片被忽略
+ */
+TEST_CASE("ReassemblerCompletesOutOfOrder", "[reassembler]")
+{
+    Reassembler::Config config;
+    config.enabled = true;
+    Reassembler reassembler(config);
+
+    std::string original = makeMessage(10000);
+    std::vector<std::string> fragments = Reassembler::fragment(7, original, 1400);
+    REQUIRE(fragments.size() == 8);
+    for (const auto &fragment : fragments)
+    {
+        CHECK(fragment.size() <= 1400);
+    }
+
+    std::string message;
+    for (size_t i = fragments.size() - 1; i > 0; --i)
+    {
+        CHECK(feed(reassembler, 1, fragments[i], message, 100) == Reassembler::Result::Pending);
+    }
+    CHECK(feed(reassembler, 1, fragments[3], message, 100) == Reassembler::Result::Pending);
+    CHECK(reassembler.pendingCount() == 1);
+
+    REQUIRE(feed(reassembler, 1, fragments[0], message, 100) == Reassembler::Result::Complete);
+    CHECK(message == original);
+    CHECK(reassembler.pendingCount() == 0);
+    CHECK(reassembler.getCompletedCount() == 1);
+    CHECK(reassembler.getDroppedCount() == 0);
+}
+
+/**
+ * 测试2: 不带分片头的报文原样通过，单分片消息直接完成
+ */
+TEST_CASE("ReassemblerPassesUnframedDatagrams", "[reassembler]")
+{
+    Reassembler::Config config;
+    config.enabled = true;
+    Reassembler reassembler(config);
+
+    std::string message;
+    CHECK(feed(reassembler, 1, "{\"id\": 1}", message, 0) == Reassembler::Result::Passthrough);
+
+    std::vector<std::string> single = Reassembler::fragment(1, "{\"id\": 2}", 1400);
+    REQUIRE(single.size() == 1);
+    REQUIRE(feed(reassembler, 1, single[0], message, 0) == Reassembler::Result::Complete);
+    CHECK(message == "{\"id\": 2}");
+    CHECK(reassembler.pendingCount() == 0);
+}
+
+/**
+ * 测试3: 不同发送者的相同消息ID分别组装
+ */
+TEST_CASE("ReassemblerSeparatesSources", "[reassembler]")
+{
+    Reassembler::Config config;
+    config.enabled = true;
+    Reassembler reassembler(config);
+
+    std::vector<std::string> a = Reassembler::fragment(5, "AAAAAAAAAA", 16);
+    std::vector<std::string> b = Reassembler::fragment(5, "BBBBBBBBBB", 16);
+    REQUIRE(a.size() == 3);
+
+    std::string message;
+    CHECK(feed(reassembler, 1, a[0], message, 0) == Reassembler::Result::Pending);
+    CHECK(feed(reassembler, 2, b[0], message, 0) == Reassembler::Result::Pending);
+    CHECK(feed(reassembler, 1, a[1], message, 0) == Reassembler::Result::Pending);
+    CHECK(feed(reassembler, 2, b[1], message, 0) == Reassembler::Result::Pending);
+    CHECK(reassembler.pendingCount() == 2);
+
+    REQUIRE(feed(reassembler, 2, b[2], message, 0) == Reassembler::Result::Complete);
+    CHECK(message == "BBBBBBBBBB");
+    REQUIRE(feed(reassembler, 1, a[2], message, 0) == Reassembler::Result::Complete);
+    CHECK(message == "AAAAAAAAAA");
+}
+
+/**
+ * 测试4: 超时未收齐的消息被丢弃，迟到的分片重新开始组装
+ */
+TEST_CASE("ReassemblerExpiresIncompleteMessages", "[reassembler]")
+{
+    Reassembler::Config config;
+    config.enabled = true;
+    config.timeout_ms = 500;
+    Reassembler reassembler(config);
+
+    std::vector<std::string> fragments = Reassembler::fragment(9, makeMessage(100), 40);
+    REQUIRE(fragments.size() == 4);
+
+    std::string message;
+    CHECK(feed(reassembler, 1, fragments[0], message, 1000) == Reassembler::Result::Pending);
+    CHECK(feed(reassembler, 1, fragments[1], message, 1400) == Reassembler::Result::Pending);
+
+    // 超过时限后到达的分片触发清理，自身作为新消息的第一个分片
+    CHECK(feed(reassembler, 1, fragments[2], message, 1600) == Reassembler::Result::Pending);
+    CHECK(reassembler.getDroppedCount() == 1);
+    CHECK(reassembler.pendingCount() == 1);
+}
+
+/**
+ * 测试5: 表满时淘汰最早的消息，超出大小上限和分片数不一致的消息被丢弃
+ */
+TEST_CASE("ReassemblerEnforcesBounds", "[reassembler]")
+{
+    Reassembler::Config config;
+    config.enabled = true;
+    config.max_messages = 2;
+    config.max_message_size = 64;
+    Reassembler reassembler(config);
+
+    std::string message;
+    for (uint32_t id = 1; id <= 3; ++id)
+    {
+        std::vector<std::string> fragments = Reassembler::fragment(id, makeMessage(30), 22);
+        CHECK(feed(reassembler, 1, fragments[0], message, 0) == Reassembler::Result::Pending);
+    }
+    CHECK(reassembler.pendingCount() == 2);
+    CHECK(reassembler.getDroppedCount() == 1);
+
+    // 组装后超过max_message_size
+    std::vector<std::string> large = Reassembler::fragment(10, makeMessage(100), 62);
+    REQUIRE(large.size() == 2);
+    CHECK(feed(reassembler, 1, large[0], message, 0) == Reassembler::Result::Pending);
+    CHECK(feed(reassembler, 1, large[1], message, 0) == Reassembler::Result::Dropped);
+
+    // 同一消息ID的分片总数不一致
+    std::vector<std::string> two = Reassembler::fragment(20, makeMessage(20), 22);
+    std::vector<std::string> three = Reassembler::fragment(20, makeMessage(30), 22);
+    REQUIRE(two.size() == 2);
+    REQUIRE(three.size() == 3);
+    CHECK(feed(reassembler, 1, two[0], message, 0) == Reassembler::Result::Pending);
+    CHECK(feed(reassembler, 1, three[1], message, 0) == Reassembler::Result::Dropped);
+
+    // 无效的分片头
+    std::string bad = two[0];
+    bad[11] = 0;
+    bad[10] = 0;
+    CHECK(feed(reassembler, 1, bad, message, 0) == Reassembler::Result::Dropped);
+
+    // 声明的分片总数超过大小上限（每个分片至少1字节），不为它建表
+    std::string bogus = two[0];
+    bogus[10] = static_cast<char>(0xFF);
+    bogus[11] = static_cast<char>(0xFF);
+    size_t pending = reassembler.pendingCount();
+    CHECK(feed(reassembler, 2, bogus, message, 0) == Reassembler::Result::Dropped);
+    CHECK(reassembler.pendingCount() == pending);
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
@@ -0,0 +1,275 @@
+#include "sequence_tracker.h"
+#include <arpa/inet.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <netinet/in.h>
+#include <string>
+#include <vector>
+
+/**
+ * 序号跟踪和重排缓冲的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 生成带序号的消息
+ */
+std::string seqMessage(uint64_t seq)
+{
+    return "{\"seq\": " + std::to_string(seq) + ", \"v\": 1}";
+}
+
+/**
+ * 记录一条带序号的消息并返回分类
+ */
+SequenceTracker::Result trackSeq(SequenceTracker &tracker, uint64_t source, uint64_t seq, uint64_t now_ms = 0)
+{
+    std::string message = seqMessage(seq);
+    return tracker.track(source, message.data(), message.size(), now_ms);
+}
+
+/**
+ * 生成IPv4来源地址
+ */
+struct sockaddr_storage sourceAddress(uint16_t port)
+{
+    struct sockaddr_storage addr;
+    memset(&addr, 0, sizeof(addr));
+    auto &sin = reinterpret_cast<struct sockaddr_in &>(addr);
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return addr;
+}
+
+/**
+ * 经重排缓冲处理一条消息，返回放行消息的序号列表
+ */
+std::vector<uint64_t> addSeq(SequenceTracker &tracker, uint64_t source, uint64_t seq, uint64_t now_ms)
+{
+    std::string                             message = seqMessage(seq);
+    std::vector<SequenceTracker::Released> release;
+    tracker.add(source, message.data(), message.size(), 0, sourceAddress(1000), now_ms, release);
+
+    std::vector<uint64_t> seqs;
+    for (const auto &released : release)
+    {
+        seqs.push_back(std::stoull(released.message.substr(8)));
+    }
+    return seqs;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 检测缺口、迟到、重复和发送者重启
+ */
+TEST_CASE("SequenceTrackerClassifiesMessages", "[sequence]")
+{
+    SequenceTracker::Config config;
+    config.enabled = true;
+    SequenceTracker tracker(config);
+
+    using R = SequenceTracker::Result;
+    CHECK(trackSeq(tracker, 1, 5000) == R::InOrder);
+    CHECK(trackSeq(tracker, 1, 5001) == R::InOrder);
+    CHECK(trackSeq(tracker, 1, 5005) == R::Gap);
+    CHECK(trackSeq(tracker, 1, 5003) == R::Reordered);
+    CHECK(trackSeq(tracker, 1, 5003) == R::Duplicate);
+    CHECK(trackSeq(tracker, 1, 5005) == R::Duplicate);
+
+    // 超出位图范围的迟到消息按迟到计，大幅回退视为重启
+    CHECK(trackSeq(tracker, 1, 4900) == R::Reordered);
+    CHECK(trackSeq(tracker, 1, 3) == R::Reset);
+    CHECK(trackSeq(tracker, 1, 4) == R::InOrder);
+
+    // 不同发送者互不影响
+    CHECK(trackSeq(tracker, 2, 7) == R::InOrder);
+    CHECK(trackSeq(tracker, 2, 8) == R::InOrder);
+
+    std::string untracked = "{\"v\": 1}";
+    CHECK(tracker.track(1, untracked.data(), untracked.size(), 0) == R::Untracked);
+
+    const SequenceTracker::Statistics &stats = tracker.statistics();
+    CHECK(stats.tracked == 11);
+    CHECK(stats.missing == 3);
+    CHECK(stats.reordered == 2);
+    CHECK(stats.duplicates == 2);
+    CHECK(stats.resets == 1);
+}
+
+/**
+ * 测试2: 发送者数量超过容量时表大小不变，旧发送者被淘汰后重新计为首条消息
+ */
+TEST_CASE("SequenceTrackerTableIsBounded", "[sequence]")
+{
+    SequenceTracker::Config config;
+    config.enabled = true;
+    config.max_sources = 16;
+    SequenceTracker tracker(config);
+
+    for (uint64_t source = 0; source < 1000; ++source)
+    {
+        CHECK(trackSeq(tracker, source, 1, source) == SequenceTracker::Result::InOrder);
+    }
+    CHECK(tracker.statistics().missing == 0);
+    CHECK(tracker.statistics().duplicates == 0);
+}
+
+/**
+ * 测试3: 重排缓冲补齐缺口后按序放行，重复消息被丢弃
+ */
+TEST_CASE("SequenceTrackerReordersWithinWindow", "[sequence]")
+{
+    SequenceTracker::Config config;
+    config.enabled = true;
+    config.reorder_window_ms = 50;
+    SequenceTracker tracker(config);
+
+    CHECK(addSeq(tracker, 1, 1, 0) == std::vector<uint64_t>{1});
+    CHECK(addSeq(tracker, 1, 3, 1).empty());
+    CHECK(addSeq(tracker, 1, 4, 2).empty());
+    CHECK(tracker.heldCount() == 2);
+    CHECK(tracker.nextDeadline() == 51);
+
+    CHECK(addSeq(tracker, 1, 2, 3) == std::vector<uint64_t>{2, 3, 4});
+    CHECK(tracker.heldCount() == 0);
+    CHECK(tracker.nextDeadline() == 0);
+
+    CHECK(addSeq(tracker, 1, 4, 4).empty());
+    CHECK(addSeq(tracker, 1, 5, 5) == std::vector<uint64_t>{5});
+}
+
+/**
+ * 测试4: 超过重排窗口后跳过缺口，之后迟到的消息直接放行
+ */
+TEST_CASE("SequenceTrackerSkipsGapAfterWindow", "[sequence]")
+{
+    SequenceTracker::Config config;
+    config.enabled = true;
+    config.reorder_window_ms = 50;
+    SequenceTracker tracker(config);
+
+    addSeq(tracker, 1, 10, 0);
+    CHECK(addSeq(tracker, 1, 12, 10).empty());
+    CHECK(addSeq(tracker, 1, 13, 20).empty());
+
+    std::vector<SequenceTracker::Released> release;
+    tracker.flush(59, release);
+    CHECK(release.empty());
+
+    tracker.flush(60, release);
+    CHECK(release.size() == 2);
+    CHECK(tracker.heldCount() == 0);
+
+    CHECK(addSeq(tracker, 1, 11, 70) == std::vector<uint64_t>{11});
+    CHECK(addSeq(tracker, 1, 14, 71) == std::vector<uint64_t>{14});
+}
+
+/**
+ * 测试5: 暂存超过上限时提前跳过缺口
+ */
+TEST_CASE("SequenceTrackerBoundsHeldMessages", "[sequence]")
+{
+    SequenceTracker::Config config;
+    config.enabled = true;
+    config.reorder_window_ms = 1000;
+    config.reorder_max_messages = 3;
+    SequenceTracker tracker(config);
+
+    addSeq(tracker, 1, 1, 0);
+    CHECK(addSeq(tracker, 1, 3, 0).empty());
+    CHECK(addSeq(tracker, 1, 4, 0).empty());
+    CHECK(addSeq(tracker, 1, 5, 0).empty());
+    CHECK(addSeq(tracker, 1, 6, 0) == std::vector<uint64_t>{3, 4, 5, 6});
+    CHECK(tracker.heldCount() == 0);
+}
+
+/**
+ * 测试6: 截止时间跟随仍在暂存的最早消息，提前补齐的发送者不再影响截止时间
+ */
+TEST_CASE("SequenceTrackerDeadlineFollowsOldestHeld", "[sequence]")
+{
+    SequenceTracker::Config config;
+    config.enabled = true;
+    config.reorder_window_ms = 100;
+    SequenceTracker tracker(config);
+
+    addSeq(tracker, 1, 1, 0);
+    addSeq(tracker, 2, 1, 0);
+    CHECK(tracker.nextDeadline() == 0);
+
+    CHECK(addSeq(tracker, 1, 3, 10).empty());
+    CHECK(addSeq(tracker, 2, 3, 20).empty());
+    CHECK(addSeq(tracker, 2, 4, 30).empty());
+    CHECK(tracker.nextDeadline() == 110);
+
+    // 发送者1的缺口补齐，最早的暂存消息变为发送者2在20时收到的消息
+    CHECK(addSeq(tracker, 1, 2, 40) == std::vector<uint64_t>{2, 3});
+    CHECK(tracker.nextDeadline() == 120);
+
+    std::vector<SequenceTracker::Released> release;
+    tracker.flush(119, release);
+    CHECK(release.empty());
+    tracker.flush(120, release);
+    CHECK(release.size() == 2);
+    CHECK(tracker.heldCount() == 0);
+    CHECK(tracker.nextDeadline() == 0);
+}
+
+/**
+ * 测试7: 放行的暂存消息带着各自的接收时间和来源地址（补齐缺口和超时放行）
+ */
+TEST_CASE("SequenceTrackerKeepsMessageOrigin", "[sequence]")
+{
+    SequenceTracker::Config config;
+    config.enabled = true;
+    config.reorder_window_ms = 100;
+    SequenceTracker tracker(config);
+
+    std::vector<SequenceTracker::Released> release;
+    auto add = [&](uint64_t seq, uint64_t now_ms)
+    {
+        std::string message = seqMessage(seq);
+        tracker.add(1, message.data(), message.size(), 1000 + seq, sourceAddress(static_cast<uint16_t>(2000 + seq)),
+                    now_ms, release);
+    };
+    auto checkOrigin = [](const SequenceTracker::Released &released)
+    {
+        uint64_t seq = std::stoull(released.message.substr(8));
+        const auto &sin = reinterpret_cast<const struct sockaddr_in &>(released.src_addr);
+        CHECK(released.rx_ts_ns == 1000 + seq);
+        CHECK(sin.sin_family == AF_INET);
+        CHECK(ntohs(sin.sin_port) == 2000 + seq);
+    };
+
+    add(1, 0);
+    add(3, 10);
+    add(4, 20);
+    add(2, 30);
+    REQUIRE(release.size() == 4);
+    for (const auto &released : release)
+    {
+        checkOrigin(released);
+    }
+
+    release.clear();
+    add(6, 40);
+    add(7, 50);
+    tracker.flush(140, release);
+    REQUIRE(release.size() == 2);
+    for (const auto &released : release)
+    {
+        checkOrigin(released);
+    }
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
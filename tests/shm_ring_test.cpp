@@ -0,0 +1,272 @@
+#include "shm_ring.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * ShmRing和ShmRingReader的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 创建测试用的环配置，文件放在/tmp下并按进程号区分
+ */
+ShmRing::Config createTestConfig(const std::string &name, size_t slots = 16, size_t slot_size = 128)
+{
+    ShmRing::Config config;
+    config.enabled = true;
+    config.path = "/tmp/shm_ring_test_" + std::to_string(getpid()) + "_" + name;
+    config.slots = slots;
+    config.slot_size = slot_size;
+    return config;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 写入的消息按序号被读取端原样读出，读取端从打开时的最新消息之后开始
+ */
+TEST_CASE("ShmRingRoundTrip", "[shm_ring]")
+{
+    ShmRing::Config config = createTestConfig("roundtrip");
+    ShmRing ring(config);
+    REQUIRE(ring.open());
+    CHECK(ring.write("sensors/old", "before reader", 1));
+
+    ShmRingReader reader(config.path);
+    REQUIRE(reader.open());
+    ShmRingReader::Message message;
+    CHECK_FALSE(reader.poll(message));
+
+    CHECK(ring.write("sensors/a", "{\"value\": 1}", 100));
+    CHECK(ring.write("sensors/b", "", 200));
+
+    REQUIRE(reader.poll(message));
+    CHECK(message.sequence == 2);
+    CHECK(message.ts_ns == 100);
+    CHECK(message.topic == "sensors/a");
+    CHECK(message.payload == "{\"value\": 1}");
+
+    REQUIRE(reader.poll(message));
+    CHECK(message.sequence == 3);
+    CHECK(message.topic == "sensors/b");
+    CHECK(message.payload.empty());
+
+    CHECK_FALSE(reader.poll(message));
+    CHECK(reader.getLostCount() == 0);
+    CHECK(ring.getWrittenCount() == 3);
+
+    ring.close();
+    unlink(config.path.c_str());
+}
+
+/**
+ * 测试2: 多个读取端各自读到完整的消息流，互不影响
+ */
+TEST_CASE("ShmRingMultipleReaders", "[shm_ring]")
+{
+    ShmRing::Config config = createTestConfig("readers");
+    ShmRing ring(config);
+    REQUIRE(ring.open());
+
+    ShmRingReader first(config.path);
+    ShmRingReader second(config.path);
+    REQUIRE(first.open());
+    REQUIRE(second.open());
+
+    for (int i = 0; i < 5; ++i)
+    {
+        ring.write("topic", std::to_string(i), i);
+    }
+
+    ShmRingReader::Message message;
+    for (int i = 0; i < 5; ++i)
+    {
+        REQUIRE(first.poll(message));
+        CHECK(message.payload == std::to_string(i));
+    }
+    for (int i = 0; i < 5; ++i)
+    {
+        REQUIRE(second.poll(message));
+        CHECK(message.payload == std::to_string(i));
+    }
+    CHECK_FALSE(first.poll(message));
+    CHECK_FALSE(second.poll(message));
+
+    ring.close();
+    unlink(config.path.c_str());
+}
+
+/**
+ * 测试3: 读取端落后超过一圈时跳到仍保留的最早消息，并计入丢失数
+ */
+TEST_CASE("ShmRingSlowReaderLosesOverwritten", "[shm_ring]")
+{
+    ShmRing::Config config = createTestConfig("overrun", 8);
+    ShmRing ring(config);
+    REQUIRE(ring.open());
+
+    ShmRingReader reader(config.path);
+    REQUIRE(reader.open());
+
+    for (int i = 1; i <= 20; ++i)
+    {
+        ring.write("topic", std::to_string(i), i);
+    }
+
+    ShmRingReader::Message message;
+    REQUIRE(reader.poll(message));
+    CHECK(message.sequence == 13);
+    CHECK(message.payload == "13");
+    CHECK(reader.getLostCount() == 12);
+
+    int remaining = 0;
+    while (reader.poll(message))
+    {
+        remaining++;
+    }
+    CHECK(remaining == 7);
+    CHECK(message.payload == "20");
+
+    ring.close();
+    unlink(config.path.c_str());
+}
+
+/**
+ * 测试4: 超过槽位容量的消息不写入，计入丢弃数
+ */
+TEST_CASE("ShmRingDropsOversizedMessages", "[shm_ring]")
+{
+    ShmRing::Config config = createTestConfig("oversized", 4, 64);
+    ShmRing ring(config);
+    REQUIRE(ring.open());
+    CHECK(ring.capacity() == 32);
+
+    ShmRingReader reader(config.path);
+    REQUIRE(reader.open());
+
+    CHECK(ring.write("t", std::string(31, 'x'), 0));
+    CHECK_FALSE(ring.write("t", std::string(32, 'x'), 0));
+    CHECK(ring.getWrittenCount() == 1);
+    CHECK(ring.getDroppedCount() == 1);
+
+    ShmRingReader::Message message;
+    REQUIRE(reader.poll(message));
+    CHECK(message.payload.size() == 31);
+    CHECK_FALSE(reader.poll(message));
+
+    ring.close();
+    unlink(config.path.c_str());
+}
+
+/**
+ * 测试5: 写入端关闭或用新文件重新打开后，已打开的读取端能发现
+ */
+TEST_CASE("ShmRingReaderDetectsClose", "[shm_ring]")
+{
+    ShmRing::Config config = createTestConfig("closed");
+    {
+        ShmRing ring(config);
+        REQUIRE(ring.open());
+
+        ShmRingReader reader(config.path);
+        REQUIRE(reader.open());
+        CHECK_FALSE(reader.isClosed());
+
+        ring.close();
+        CHECK(reader.isClosed());
+    }
+
+    // 写入端未关闭就被新的实例替换（例如进程崩溃后重启）
+    ShmRing old_ring(config);
+    REQUIRE(old_ring.open());
+    ShmRingReader reader(config.path);
+    REQUIRE(reader.open());
+
+    ShmRing new_ring(config);
+    REQUIRE(new_ring.open());
+    CHECK(reader.isClosed());
+
+    REQUIRE(reader.open());
+    CHECK_FALSE(reader.isClosed());
+    new_ring.write("topic", "fresh", 0);
+    ShmRingReader::Message message;
+    REQUIRE(reader.poll(message));
+    CHECK(message.sequence == 1);
+    CHECK(message.payload == "fresh");
+
+    new_ring.close();
+    unlink(config.path.c_str());
+}
+
+/**
+ * 测试6: 写入与读取并发时，读到的每条消息都完整，序号递增，读到的加丢失的等于写入的
+ */
+TEST_CASE("ShmRingConcurrentReadsAreConsistent", "[shm_ring]")
+{
+    ShmRing::Config config = createTestConfig("concurrent", 64);
+    ShmRing ring(config);
+    REQUIRE(ring.open());
+
+    ShmRingReader reader(config.path);
+    REQUIRE(reader.open());
+
+    const int total = 200000;
+    std::thread writer([&ring]()
+                       {
+        for (int i = 1; i <= total; ++i)
+        {
+            // 负载由序号重复组成，读到被撕裂的内容时能发现
+            std::string value = std::to_string(i);
+            std::string payload;
+            for (int r = 0; r < 4; ++r)
+            {
+                payload += value + ";";
+            }
+            ring.write("topic/" + value, payload, i);
+        } });
+
+    uint64_t received = 0;
+    uint64_t last_sequence = 0;
+    bool consistent = true;
+    ShmRingReader::Message message;
+    while (last_sequence < static_cast<uint64_t>(total))
+    {
+        if (!reader.poll(message))
+        {
+            continue;
+        }
+        std::string value = std::to_string(message.ts_ns);
+        std::string expected;
+        for (int r = 0; r < 4; ++r)
+        {
+            expected += value + ";";
+        }
+        if (message.sequence <= last_sequence || message.sequence != message.ts_ns ||
+            message.topic != "topic/" + value || message.payload != expected)
+        {
+            consistent = false;
+        }
+        last_sequence = message.sequence;
+        received++;
+    }
+    writer.join();
+
+    CHECK(consistent);
+    CHECK(received + reader.getLostCount() == static_cast<uint64_t>(total));
+
+    ring.close();
+    unlink(config.path.c_str());
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
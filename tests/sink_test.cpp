@@ -0,0 +1,344 @@
+#include "sink.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * PacketBufferPool、Sink和FanOut的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 等待指定的毫秒数
+ */
+void waitMs(int milliseconds)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+/**
+ * 创建127.0.0.1:port的发送方地址
+ */
+struct sockaddr_storage createSource(int port)
+{
+    struct sockaddr_storage source;
+    memset(&source, 0, sizeof(source));
+    auto &sin = reinterpret_cast<struct sockaddr_in &>(source);
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return source;
+}
+
+/**
+ * 测试用输出端：记录投递的缓冲地址和内容；gate关闭时投递线程等待，用于填满队列
+ */
+class TestSink : public Sink
+{
+public:
+    TestSink(const Config &config) : Sink(config, "test"), gate(true) {}
+    ~TestSink() override
+    {
+        gate = true;
+        stop();
+    }
+
+    std::atomic<bool> gate;
+    std::mutex mutex;
+    std::vector<const PacketBuffer *> buffers;
+    std::vector<std::string> payloads;
+
+protected:
+    bool open() override { return true; }
+    void close() override {}
+
+    size_t deliver(const PacketRef *packets, size_t count) override
+    {
+        while (!gate)
+        {
+            waitMs(1);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < count; ++i)
+        {
+            buffers.push_back(packets[i].get());
+            payloads.push_back(packets[i]->data);
+        }
+        return count;
+    }
+};
+
+/**
+ * 创建测试用输出端配置
+ */
+Sink::Config createSinkConfig(const std::string &name, size_t capacity, Sink::Policy policy)
+{
+    Sink::Config config;
+    config.name = name;
+    config.capacity = capacity;
+    config.policy = policy;
+    return config;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 复制引用只增加计数，最后一个引用释放后缓冲回到池中并被复用
+ */
+TEST_CASE("PacketBufferPoolRecyclesAfterLastRelease", "[sink]")
+{
+    PacketBufferPool pool;
+    struct sockaddr_storage source = createSource(1000);
+
+    const PacketBuffer *first = nullptr;
+    {
+        PacketRef packet = pool.acquire("hello", 5, source, 42);
+        first = packet.get();
+        CHECK(packet.useCount() == 1);
+        CHECK(packet->data == "hello");
+        CHECK(packet->rx_ts_ns == 42);
+
+        PacketRef copy = packet;
+        PacketRef moved = std::move(copy);
+        CHECK(packet.useCount() == 2);
+        CHECK_FALSE(copy);
+
+        packet.reset();
+        CHECK(pool.getFreeCount() == 0);
+    }
+    CHECK(pool.getFreeCount() == 1);
+
+    PacketRef again = pool.acquire("world", 5, source, 43);
+    CHECK(again.get() == first);
+    CHECK(again->data == "world");
+    CHECK(pool.getAllocatedCount() == 1);
+    CHECK(pool.getReusedCount() == 1);
+}
+
+/**
+ * 测试2: 多个输出端收到同一个缓冲，全部投递完成后缓冲才回到池中
+ */
+TEST_CASE("SinksShareOneBuffer", "[sink]")
+{
+    PacketBufferPool pool;
+    TestSink fast(createSinkConfig("fast", 100, Sink::Policy::DropNewest));
+    TestSink slow(createSinkConfig("slow", 100, Sink::Policy::DropNewest));
+    slow.gate = false;
+    REQUIRE(fast.start());
+    REQUIRE(slow.start());
+
+    for (int i = 0; i < 10; ++i)
+    {
+        PacketRef packet = pool.acquire(std::to_string(i).data(), std::to_string(i).size(), createSource(1000), i);
+        fast.offer(packet);
+        slow.offer(packet);
+    }
+
+    // 慢的输出端还持有引用，缓冲不能复用
+    waitMs(50);
+    CHECK(pool.getAllocatedCount() == 10);
+    CHECK(pool.getFreeCount() == 0);
+
+    slow.gate = true;
+    fast.stop();
+    slow.stop();
+
+    CHECK(fast.buffers == slow.buffers);
+    CHECK(fast.payloads == slow.payloads);
+    CHECK(fast.payloads.size() == 10);
+    CHECK(fast.getDeliveredCount() == 10);
+    CHECK(pool.getFreeCount() == 10);
+}
+
+/**
+ * 测试3: 队列满时按策略丢弃新报文或最早的报文
+ */
+TEST_CASE("SinkDropPolicies", "[sink]")
+{
+    PacketBufferPool pool;
+    TestSink newest(createSinkConfig("newest", 3, Sink::Policy::DropNewest));
+    TestSink oldest(createSinkConfig("oldest", 3, Sink::Policy::DropOldest));
+    newest.gate = false;
+    oldest.gate = false;
+    REQUIRE(newest.start());
+    REQUIRE(oldest.start());
+
+    // 第一条被投递线程取出后阻塞在gate上，之后的报文留在队列中
+    PacketRef first = pool.acquire("0", 1, createSource(1000), 0);
+    newest.offer(first);
+    oldest.offer(first);
+    waitMs(50);
+
+    for (int i = 1; i <= 5; ++i)
+    {
+        PacketRef packet = pool.acquire(std::to_string(i).data(), 1, createSource(1000), i);
+        newest.offer(packet);
+        oldest.offer(packet);
+    }
+    CHECK(newest.getDepth() == 3);
+    CHECK(newest.getDroppedCount() == 2);
+    CHECK(oldest.getDroppedCount() == 2);
+
+    newest.gate = true;
+    oldest.gate = true;
+    newest.stop();
+    oldest.stop();
+
+    CHECK(newest.payloads == std::vector<std::string>{"0", "1", "2", "3"});
+    CHECK(oldest.payloads == std::vector<std::string>{"0", "3", "4", "5"});
+}
+
+/**
+ * 测试4: Block策略下队列满时等待投递线程腾出空位，不丢弃
+ */
+TEST_CASE("SinkBlockPolicyWaits", "[sink]")
+{
+    PacketBufferPool pool;
+    TestSink sink(createSinkConfig("block", 2, Sink::Policy::Block));
+    sink.gate = false;
+    REQUIRE(sink.start());
+
+    std::atomic<int> offered(0);
+    std::thread producer([&]()
+                         {
+        for (int i = 0; i < 10; ++i)
+        {
+            sink.offer(pool.acquire("x", 1, createSource(1000), i));
+            offered++;
+        } });
+
+    waitMs(50);
+    CHECK(offered < 10);
+
+    sink.gate = true;
+    producer.join();
+    sink.stop();
+
+    CHECK(offered == 10);
+    CHECK(sink.payloads.size() == 10);
+    CHECK(sink.getDroppedCount() == 0);
+}
+
+/**
+ * 测试5: FanOut把同一报文写入录制文件并镜像到UDP端口
+ */
+TEST_CASE("FanOutRecordsAndMirrors", "[sink]")
+{
+    // 镜像目标：本机回环上的接收套接字
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    REQUIRE(receiver >= 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(bind(receiver, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+    socklen_t len = sizeof(addr);
+    REQUIRE(getsockname(receiver, reinterpret_cast<struct sockaddr *>(&addr), &len) == 0);
+    struct timeval timeout = {1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string path = "/tmp/sink_test_" + std::to_string(getpid()) + ".cap";
+    Sink::Config record;
+    record.type = Sink::Type::Record;
+    record.path = path;
+    Sink::Config mirror;
+    mirror.type = Sink::Type::Mirror;
+    mirror.host = "127.0.0.1";
+    mirror.port = ntohs(addr.sin_port);
+
+    FanOut fan_out({record, mirror}, "feed");
+    REQUIRE(fan_out.start());
+    CHECK(fan_out.sinkCount() == 2);
+    CHECK(fan_out.sink(0).name() == "record");
+    CHECK(fan_out.sink(1).name() == "mirror");
+
+    const int total = 20;
+    for (int i = 0; i < total; ++i)
+    {
+        fan_out.dispatch("{\"id\": " + std::to_string(i) + "}", createSource(2000 + i), 1000 + i);
+    }
+
+    std::vector<std::string> mirrored;
+    char buffer[256];
+    while (mirrored.size() < static_cast<size_t>(total))
+    {
+        ssize_t n = recv(receiver, buffer, sizeof(buffer), 0);
+        if (n < 0)
+        {
+            break;
+        }
+        mirrored.emplace_back(buffer, n);
+    }
+    fan_out.stop();
+    close(receiver);
+
+    REQUIRE(mirrored.size() == static_cast<size_t>(total));
+    CHECK(mirrored.front() == "{\"id\": 0}");
+    CHECK(fan_out.sink(0).getDeliveredCount() == total);
+    CHECK(fan_out.sink(1).getDeliveredCount() == total);
+    CHECK(fan_out.pool().getFreeCount() == fan_out.pool().getAllocatedCount());
+
+    CaptureReader reader(path);
+    REQUIRE(reader.open());
+    CaptureReader::Record entry;
+    int recorded = 0;
+    while (reader.next(entry))
+    {
+        CHECK(entry.channel == "feed");
+        CHECK(std::string(entry.data, entry.len) == "{\"id\": " + std::to_string(recorded) + "}");
+        CHECK(entry.rx_ts_ns == static_cast<uint64_t>(1000 + recorded));
+        CHECK(ntohs(reinterpret_cast<struct sockaddr_in &>(entry.source).sin_port) == 2000 + recorded);
+        recorded++;
+    }
+    CHECK(recorded == total);
+    unlink(path.c_str());
+}
+
+/**
+ * 测试6: 解析类型和策略名，检查不完整的配置
+ */
+TEST_CASE("SinkConfigValidation", "[sink]")
+{
+    Sink::Type type;
+    CHECK(Sink::parseType("mirror", type));
+    CHECK(type == Sink::Type::Mirror);
+    CHECK_FALSE(Sink::parseType("kafka", type));
+
+    Sink::Policy policy;
+    CHECK(Sink::parsePolicy("drop_oldest", policy));
+    CHECK(policy == Sink::Policy::DropOldest);
+    CHECK_FALSE(Sink::parsePolicy("drop", policy));
+
+    std::string error;
+    Sink::Config config;
+    CHECK_FALSE(Sink::validate(config, error));
+    config.path = "/tmp/out.cap";
+    CHECK(Sink::validate(config, error));
+    config.capacity = 0;
+    CHECK_FALSE(Sink::validate(config, error));
+
+    Sink::Config mirror;
+    mirror.type = Sink::Type::Mirror;
+    mirror.host = "127.0.0.1";
+    CHECK_FALSE(Sink::validate(mirror, error));
+    mirror.port = 7000;
+    CHECK(Sink::validate(mirror, error));
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
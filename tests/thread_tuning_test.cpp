@@ -0,0 +1,120 @@
+#include "thread_tuning.h"
+#include <catch2/catch_test_macros.hpp>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <thread>
+
+/**
+ * 线程调整的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 当前进程允许使用的第一个CPU
+ */
+int firstAllowedCpu()
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+    {
+        return -1;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &set))
+        {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 按角色把新线程绑定到配置的CPU，并设置线程名
+ */
+TEST_CASE("ThreadTuningPinsThreadByRole", "[threads]")
+{
+    int cpu = firstAllowedCpu();
+    REQUIRE(cpu >= 0);
+
+    ThreadTuning::Config config;
+    config.receive.cpus = {cpu};
+    ThreadTuning::configure(config);
+
+    bool applied = false;
+    cpu_set_t affinity;
+    CPU_ZERO(&affinity);
+    char name[16] = "";
+    std::thread worker([&]()
+                       {
+        applied = ThreadTuning::apply(ThreadTuning::Role::Receive, "udp-rx-test-long-name");
+        pthread_getaffinity_np(pthread_self(), sizeof(affinity), &affinity);
+        pthread_getname_np(pthread_self(), name, sizeof(name)); });
+    worker.join();
+
+    CHECK(applied);
+    CHECK(CPU_COUNT(&affinity) == 1);
+    CHECK(CPU_ISSET(cpu, &affinity));
+    CHECK(std::string(name) == "udp-rx-test-lon");
+
+    // 没有配置的角色只设置线程名
+    bool publish_applied = false;
+    std::thread publisher([&]()
+                          { publish_applied = ThreadTuning::apply(ThreadTuning::Role::Publish, "publish"); });
+    publisher.join();
+    CHECK(publish_applied);
+
+    ThreadTuning::configure(ThreadTuning::Config());
+}
+
+/**
+ * 测试2: 无效的CPU编号和优先级被拒绝
+ */
+TEST_CASE("ThreadTuningValidatesSettings", "[threads]")
+{
+    std::string error;
+    ThreadTuning::Settings settings;
+    CHECK_FALSE(settings.enabled());
+    CHECK(ThreadTuning::validate(settings, error));
+
+    settings.cpus = {0, -1};
+    CHECK(settings.enabled());
+    CHECK_FALSE(ThreadTuning::validate(settings, error));
+    CHECK(error.find("-1") != std::string::npos);
+
+    settings.cpus = {0};
+    settings.priority = 100;
+    CHECK_FALSE(ThreadTuning::validate(settings, error));
+
+    settings.priority = 50;
+    CHECK(ThreadTuning::validate(settings, error));
+
+    // 无效设置不会应用到线程
+    ThreadTuning::Settings invalid;
+    invalid.cpus = {CPU_SETSIZE};
+    bool applied = true;
+    std::thread worker([&]()
+                       { applied = ThreadTuning::apply(invalid, "invalid"); });
+    worker.join();
+    CHECK_FALSE(applied);
+
+    ThreadTuning::Config a;
+    ThreadTuning::Config b;
+    CHECK(a == b);
+    b.network.priority = 10;
+    CHECK(a != b);
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
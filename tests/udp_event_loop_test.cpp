@@ -0,0 +1,271 @@
+#include "udp_event_loop.h"
+#include "udp_receiver.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <mutex>
+#include <netinet/in.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * UdpEventLoop的集成测试（多个接收器共用一个事件循环）
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 等待指定的毫秒数
+ */
+void waitMs(int milliseconds)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+/**
+ * 发送UDP组播消息（开启回环以便本机接收）
+ */
+bool sendUdpMulticastMessage(const std::string &message,
+                             const std::string &address, int port)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        return false;
+    }
+
+    int loop = 1;
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+    addr.sin_port = htons(port);
+
+    ssize_t sent = sendto(sock, message.data(), message.size(), 0,
+                          reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+
+    close(sock);
+    return sent == static_cast<ssize_t>(message.size());
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 未启动的事件循环不能注册接收器
+ */
+TEST_CASE("UdpEventLoopRejectsReceiverWhenStopped", "[event_loop]")
+{
+    UdpEventLoop loop;
+    REQUIRE_FALSE(loop.isRunning());
+
+    UdpReceiver receiver("224.0.0.1", 5670);
+    CHECK_FALSE(receiver.start(loop));
+    CHECK_FALSE(receiver.isRunning());
+}
+
+/**
+ * 测试2: 两个接收器共用一个事件循环，各自只收到自己端口的报文
+ */
+TEST_CASE("UdpEventLoopDispatchesToEachReceiver", "[event_loop][integration]")
+{
+    const std::string address = "224.0.0.1";
+
+    UdpEventLoop loop;
+    REQUIRE(loop.start());
+
+    std::mutex               mutex;
+    std::vector<std::string> first;
+    std::vector<std::string> second;
+
+    UdpReceiver firstReceiver(address, 5671);
+    UdpReceiver secondReceiver(address, 5672);
+    REQUIRE(firstReceiver.start(loop,
+                                [&](const std::string &message)
+                                {
+                                    std::lock_guard<std::mutex> lock(mutex);
+                                    first.push_back(message);
+                                }));
+    REQUIRE(secondReceiver.start(loop,
+                                 [&](const std::string &message)
+                                 {
+                                     std::lock_guard<std::mutex> lock(mutex);
+                                     second.push_back(message);
+                                 }));
+
+    REQUIRE(sendUdpMulticastMessage("one", address, 5671));
+    REQUIRE(sendUdpMulticastMessage("two", address, 5672));
+    REQUIRE(sendUdpMulticastMessage("three", address, 5671));
+
+    for (int i = 0; i < 50; ++i)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (first.size() == 2 && second.size() == 1)
+            {
+                break;
+            }
+        }
+        waitMs(20);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(first == std::vector<std::string>{"one", "three"});
+        CHECK(second == std::vector<std::string>{"two"});
+    }
+
+    // 停止一个接收器后，另一个仍能接收
+    firstReceiver.stop();
+    REQUIRE(sendUdpMulticastMessage("four", address, 5672));
+    for (int i = 0; i < 50; ++i)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (second.size() == 2)
+            {
+                break;
+            }
+        }
+        waitMs(20);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(second.size() == 2);
+        CHECK(first.size() == 2);
+    }
+
+    secondReceiver.stop();
+    loop.stop();
+    CHECK_FALSE(loop.isRunning());
+}
+
+/**
+ * 测试3: 低延迟模式（轮询事件循环、SO_BUSY_POLL）收到的报文与普通模式相同，空闲后可正常停止
+ */
+TEST_CASE("UdpEventLoopSpinModeDelivers", "[event_loop][integration]")
+{
+    const std::string address = "224.0.0.1";
+
+    std::mutex               mutex;
+    std::vector<std::string> received;
+
+    UdpEventLoop loop(200);
+    REQUIRE(loop.start());
+
+    UdpReceiver::ReceiveOptions options;
+    options.busy_poll_us = 50;
+    UdpReceiver receiver(address, 5673);
+    receiver.setReceiveOptions(options);
+    REQUIRE(receiver.start(loop, [&](const std::string &msg)
+                           {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(msg); }));
+    waitMs(50);
+
+    // 第一条在阻塞等待中到达，第二条在轮询期间到达
+    REQUIRE(sendUdpMulticastMessage("first", address, 5673));
+    REQUIRE(sendUdpMulticastMessage("second", address, 5673));
+    waitMs(100);
+    REQUIRE(sendUdpMulticastMessage("third", address, 5673));
+
+    for (int i = 0; i < 50; ++i)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received.size() == 3)
+            {
+                break;
+            }
+        }
+        waitMs(20);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(received == std::vector<std::string>{"first", "second", "third"});
+    }
+
+    receiver.stop();
+    loop.stop();
+    CHECK_FALSE(loop.isRunning());
+}
+
+/**
+ * 测试4: 按事件掩码注册、修改关注的事件，回调内部取消注册自身，每轮事件后执行tick
+ */
+TEST_CASE("UdpEventLoopEventMaskAndTicks", "[event_loop]")
+{
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+
+    UdpEventLoop loop;
+    REQUIRE(loop.start());
+
+    std::atomic<int> writable{0};
+    std::atomic<int> readable{0};
+    std::atomic<int> ticks{0};
+
+    // 先关注可写（立即就绪），第一次回调后改为只关注可读；收到数据后在回调内取消注册
+    REQUIRE(loop.add(fds[0], EPOLLOUT, [&](uint32_t events)
+                     {
+        if (events & EPOLLOUT)
+        {
+            writable++;
+            loop.modify(fds[0], EPOLLIN);
+        }
+        if (events & EPOLLIN)
+        {
+            char buffer[16];
+            while (read(fds[0], buffer, sizeof(buffer)) > 0)
+            {
+            }
+            readable++;
+            loop.remove(fds[0]);
+        } }));
+    int tick_id = loop.addTick([&]()
+                               { ticks++; });
+    waitMs(100);
+    CHECK(writable == 1);
+    CHECK(readable == 0);
+
+    REQUIRE(write(fds[1], "x", 1) == 1);
+    waitMs(100);
+    CHECK(readable == 1);
+
+    // 已取消注册，不再回调
+    REQUIRE(write(fds[1], "y", 1) == 1);
+    waitMs(100);
+    CHECK(readable == 1);
+    CHECK(ticks >= 2);
+
+    // wake()使tick在阻塞等待中也能执行；取消后不再执行
+    int before = ticks;
+    loop.wake();
+    waitMs(50);
+    CHECK(ticks > before);
+    loop.removeTick(tick_id);
+    before = ticks;
+    loop.wake();
+    waitMs(50);
+    CHECK(ticks == before);
+
+    loop.stop();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================
@@ -1,12 +1,18 @@
+#include "udp_event_loop.h"
 #include "udp_receiver.h"
 #include <arpa/inet.h>
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
 #include <cstring>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <mutex>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 /**
  * UDP接收器的集成测试
@@ -52,6 +58,118 @@ bool sendUdpMessage(const std::string &message,
     }
 }
 
+/**
+ * 从同一个套接字（同一源端口）依次发送多个报文
+ */
+bool sendUdpMessages(const std::vector<std::string> &messages, const std::string &address, int port)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        return false;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+    addr.sin_port = htons(port);
+
+    bool ok = true;
+    for (const auto &message : messages)
+    {
+        ok = sendto(sock, message.data(), message.size(), 0,
+                    (struct sockaddr *)&addr, sizeof(addr)) > 0 && ok;
+    }
+    close(sock);
+    return ok;
+}
+
+/**
+ * 从指定网卡发送一条IPv6组播报文
+ */
+bool sendUdp6Message(const std::string &message, const std::string &address,
+                     int port, const std::string &ifname)
+{
+    int sock = socket(AF_INET6, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        return false;
+    }
+
+    unsigned int ifindex = if_nametoindex(ifname.c_str());
+    setsockopt(sock, IPPROTO_IPV6, IPV6_MULTICAST_IF, &ifindex, sizeof(ifindex));
+
+    struct sockaddr_in6 addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_port = htons(port);
+    addr.sin6_scope_id = ifindex;
+    inet_pton(AF_INET6, address.c_str(), &addr.sin6_addr);
+
+    ssize_t sent = sendto(sock, message.c_str(), message.length(), 0,
+                          (struct sockaddr *)&addr, sizeof(addr));
+    close(sock);
+    return sent > 0;
+}
+
+/**
+ * 获取本机从指定网卡发往IPv6组播地址时使用的源地址
+ */
+std::string localSourceAddress6(const std::string &group, int port, const std::string &ifname)
+{
+    int sock = socket(AF_INET6, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        return "";
+    }
+
+    struct sockaddr_in6 addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_port = htons(port);
+    addr.sin6_scope_id = if_nametoindex(ifname.c_str());
+    inet_pton(AF_INET6, group.c_str(), &addr.sin6_addr);
+
+    std::string result;
+    char        host[INET6_ADDRSTRLEN];
+    socklen_t   len = sizeof(addr);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+        getsockname(sock, (struct sockaddr *)&addr, &len) == 0 &&
+        inet_ntop(AF_INET6, &addr.sin6_addr, host, sizeof(host)))
+    {
+        result = host;
+    }
+    close(sock);
+    return result;
+}
+
+/**
+ * 查找一个支持组播且配置了IPv6地址的非回环网卡，没有时返回空
+ */
+std::string findIpv6MulticastInterface()
+{
+    struct ifaddrs *list = nullptr;
+    if (getifaddrs(&list) != 0)
+    {
+        return "";
+    }
+
+    std::string result;
+    for (struct ifaddrs *ifa = list; ifa; ifa = ifa->ifa_next)
+    {
+        if (ifa->ifa_addr && ifa->ifa_addr->sa_family == AF_INET6 &&
+            (ifa->ifa_flags & IFF_MULTICAST) && (ifa->ifa_flags & IFF_UP) &&
+            !(ifa->ifa_flags & IFF_LOOPBACK))
+        {
+            result = ifa->ifa_name;
+            break;
+        }
+    }
+    freeifaddrs(list);
+    return result;
+}
+
 /**
  * 等待指定的毫秒数
  */
@@ -60,6 +178,57 @@ void waitMs(int milliseconds)
     std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
 }
 
+/**
+ * 获取本机发往指定组播地址时使用的源地址
+ */
+std::string localSourceAddress(const std::string &group, int port)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        return "";
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr(group.c_str());
+    addr.sin_port = htons(port);
+
+    std::string result;
+    socklen_t   len = sizeof(addr);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+        getsockname(sock, (struct sockaddr *)&addr, &len) == 0)
+    {
+        result = inet_ntoa(addr.sin_addr);
+    }
+    close(sock);
+    return result;
+}
+
+/**
+ * 按给定加入方式启动接收器，发送一条组播报文，返回收到的报文数
+ */
+int receiveWithJoinOptions(const UdpReceiver::JoinOptions &options,
+                           const std::string &address, int port)
+{
+    std::atomic<int> received{0};
+    UdpReceiver      receiver(address, port);
+    receiver.setJoinOptions(options);
+    if (!receiver.start([&received](const std::string &)
+                        { received++; }))
+    {
+        return -1;
+    }
+
+    waitMs(100);
+    sendUdpMessage("{\"ssm\": true}", address, port);
+    waitMs(300);
+
+    receiver.stop();
+    return received;
+}
+
 // ============================================================================
 // 测试用例
 // ============================================================================
@@ -371,6 +540,543 @@ TEST_CASE("JsonMessageParsingArray", "[json]")
     REQUIRE_FALSE(receiver.isRunning());
 }
 
+/**
+ * 测试18: 源包含列表和排除列表不能同时使用
+ */
+TEST_CASE("JoinOptionsRejectIncludeAndExclude", "[join]")
+{
+    UdpReceiver::JoinOptions options;
+    options.sources = {"10.0.0.1"};
+    options.exclude_sources = {"10.0.0.2"};
+
+    UdpReceiver receiver("232.1.1.1", 5623);
+    receiver.setJoinOptions(options);
+    REQUIRE_FALSE(receiver.start());
+    REQUIRE_FALSE(receiver.isRunning());
+}
+
+/**
+ * 测试19: 源特定组播只接收包含列表中的发送者
+ */
+TEST_CASE("SourceSpecificJoinFiltersSenders", "[join][integration]")
+{
+    const std::string group = "232.1.1.2";
+    const int         port = 5624;
+    std::string       local = localSourceAddress(group, port);
+    REQUIRE_FALSE(local.empty());
+
+    UdpReceiver::JoinOptions allowed;
+    allowed.sources = {local};
+    CHECK(receiveWithJoinOptions(allowed, group, port) == 1);
+
+    UdpReceiver::JoinOptions other;
+    other.sources = {"198.51.100.7"};
+    CHECK(receiveWithJoinOptions(other, group, port) == 0);
+}
+
+/**
+ * 测试20: 排除列表中的发送者在内核中被过滤
+ */
+TEST_CASE("ExcludedSourceIsBlocked", "[join][integration]")
+{
+    const std::string group = "239.1.1.3";
+    const int         port = 5625;
+    std::string       local = localSourceAddress(group, port);
+    REQUIRE_FALSE(local.empty());
+
+    UdpReceiver::JoinOptions blocked;
+    blocked.exclude_sources = {local};
+    CHECK(receiveWithJoinOptions(blocked, group, port) == 0);
+
+    UdpReceiver::JoinOptions unrelated;
+    unrelated.exclude_sources = {"198.51.100.7"};
+    CHECK(receiveWithJoinOptions(unrelated, group, port) == 1);
+}
+
+/**
+ * 测试21: 绑定组地址后不再收到发往该端口的单播
+ */
+TEST_CASE("GroupBindIgnoresUnicast", "[join][integration]")
+{
+    const int        port = 5626;
+    std::atomic<int> received{0};
+
+    UdpReceiver receiver("239.1.1.4", port);
+    REQUIRE(receiver.start([&received](const std::string &)
+                           { received++; }));
+    waitMs(100);
+
+    sendUdpMessage("unicast", "127.0.0.1", port);
+    sendUdpMessage("multicast", "239.1.1.4", port);
+    waitMs(300);
+
+    receiver.stop();
+    CHECK(received == 1);
+}
+
+/**
+ * 测试22: 在多个网卡上加入同一组
+ */
+TEST_CASE("JoinOnMultipleInterfaces", "[join][integration]")
+{
+    const std::string group = "239.1.1.5";
+    const int         port = 5627;
+    std::string       local = localSourceAddress(group, port);
+    REQUIRE_FALSE(local.empty());
+
+    UdpReceiver::JoinOptions options;
+    options.interfaces = {local, "127.0.0.1"};
+    CHECK(receiveWithJoinOptions(options, group, port) == 1);
+
+    UdpReceiver::JoinOptions invalid;
+    invalid.interfaces = {local, "not-an-address"};
+    CHECK(receiveWithJoinOptions(invalid, group, port) == -1);
+}
+
+/**
+ * 测试23: 按网卡名和索引加入IPv6组播组
+ */
+TEST_CASE("ReceiveIpv6Multicast", "[ipv6][integration]")
+{
+    std::string ifname = findIpv6MulticastInterface();
+    if (ifname.empty())
+    {
+        WARN("No IPv6 multicast interface available, skipping");
+        return;
+    }
+
+    const std::string group = "ff15::1:23";
+    const int         port = 5628;
+
+    std::atomic<int> received{0};
+    std::string      last_message;
+    UdpReceiver      by_name(group, port, ifname);
+    REQUIRE(by_name.start([&](const std::string &msg)
+                          {
+        last_message = msg;
+        received++; }));
+    waitMs(100);
+    REQUIRE(sendUdp6Message("{\"v6\": 1}", group, port, ifname));
+    waitMs(300);
+    by_name.stop();
+    CHECK(received == 1);
+    CHECK(last_message == "{\"v6\": 1}");
+
+    UdpReceiver::JoinOptions options;
+    options.interfaces = {std::to_string(if_nametoindex(ifname.c_str()))};
+    received = 0;
+    UdpReceiver by_index(group, port);
+    by_index.setJoinOptions(options);
+    REQUIRE(by_index.start([&received](const std::string &)
+                           { received++; }));
+    waitMs(100);
+    REQUIRE(sendUdp6Message("{\"v6\": 2}", group, port, ifname));
+    waitMs(300);
+    by_index.stop();
+    CHECK(received == 1);
+}
+
+/**
+ * 测试24: IPv6源特定组播按发送者过滤
+ */
+TEST_CASE("Ipv6SourceSpecificJoin", "[ipv6][join][integration]")
+{
+    std::string ifname = findIpv6MulticastInterface();
+    if (ifname.empty())
+    {
+        WARN("No IPv6 multicast interface available, skipping");
+        return;
+    }
+
+    const std::string group = "ff35::1:24";
+    const int         port = 5629;
+
+    std::string local = localSourceAddress6(group, port, ifname);
+    REQUIRE_FALSE(local.empty());
+
+    for (const auto &source : {local, std::string("2001:db8::7")})
+    {
+        UdpReceiver::JoinOptions options;
+        options.interfaces = {ifname};
+        options.sources = {source};
+
+        std::atomic<int> received{0};
+        UdpReceiver      receiver(group, port);
+        receiver.setJoinOptions(options);
+        REQUIRE(receiver.start([&received](const std::string &)
+                               { received++; }));
+        waitMs(100);
+        sendUdp6Message("{\"ssm\": true}", group, port, ifname);
+        waitMs(300);
+        receiver.stop();
+        CHECK(received == (source == local ? 1 : 0));
+    }
+}
+
+/**
+ * 测试25: 无效的IPv6网卡名启动失败
+ */
+TEST_CASE("Ipv6InvalidInterfaceFails", "[ipv6]")
+{
+    UdpReceiver receiver("ff15::1:25", 5630, "no-such-if0");
+    REQUIRE_FALSE(receiver.start());
+    REQUIRE_FALSE(receiver.isRunning());
+
+    UdpReceiver not_an_address("ff15::zz", 5630);
+    REQUIRE_FALSE(not_an_address.start());
+}
+
+/**
+ * 测试26: 超过4KB的报文完整接收
+ */
+TEST_CASE("ReceiveLargeDatagram", "[large][integration]")
+{
+    const int   port = 5631;
+    std::string payload = "{\"data\": \"" + std::string(30000, 'x') + "\"}";
+
+    std::string      received;
+    std::atomic<int> count{0};
+    UdpReceiver      receiver("239.1.1.6", port);
+    REQUIRE(receiver.start([&](const std::string &msg)
+                           {
+        received = msg;
+        count++; }));
+    waitMs(100);
+    REQUIRE(sendUdpMessage(payload, "239.1.1.6", port));
+    waitMs(300);
+    receiver.stop();
+
+    CHECK(count == 1);
+    CHECK(received == payload);
+}
+
+/**
+ * 测试27: 超过max_datagram_size的报文被丢弃并计数，不转发截断的内容
+ */
+TEST_CASE("TruncatedDatagramIsDropped", "[large][integration]")
+{
+    const int port = 5632;
+
+    UdpReceiver::ReceiveOptions options;
+    options.max_datagram_size = 1000;
+    UdpReceiver::Metrics metrics;
+    metrics.truncated = std::make_shared<Counter>();
+
+    std::atomic<int> count{0};
+    UdpReceiver      receiver("239.1.1.7", port);
+    receiver.setReceiveOptions(options);
+    receiver.setMetrics(metrics);
+    REQUIRE(receiver.start([&count](const std::string &)
+                           { count++; }));
+    waitMs(100);
+    sendUdpMessage(std::string(2000, 'y'), "239.1.1.7", port);
+    sendUdpMessage(std::string(1000, 'z'), "239.1.1.7", port);
+    waitMs(300);
+    receiver.stop();
+
+    CHECK(count == 1);
+    CHECK(metrics.truncated->value() == 1);
+}
+
+/**
+ * 测试28: 分片模式下多个报文组装成一条消息回调，启用GRO不影响接收
+ */
+TEST_CASE("FramedMessageIsReassembled", "[framing][integration]")
+{
+    const int   port = 5633;
+    std::string payload = "{\"blob\": \"" + std::string(5000, 'f') + "\"}";
+
+    UdpReceiver::ReceiveOptions options;
+    options.gro = true;
+    options.framing.enabled = true;
+    UdpReceiver::Metrics metrics;
+    metrics.reassembled = std::make_shared<Counter>();
+
+    std::string      received;
+    std::atomic<int> count{0};
+    UdpReceiver      receiver("239.1.1.8", port);
+    receiver.setReceiveOptions(options);
+    receiver.setMetrics(metrics);
+    REQUIRE(receiver.start([&](const std::string &msg)
+                           {
+        received = msg;
+        count++; }));
+    waitMs(100);
+
+    std::vector<std::string> fragments = Reassembler::fragment(42, payload, 1200);
+    REQUIRE(fragments.size() == 5);
+    REQUIRE(sendUdpMessages(fragments, "239.1.1.8", port));
+    sendUdpMessage("{\"plain\": 1}", "239.1.1.8", port);
+    waitMs(300);
+    receiver.stop();
+
+    CHECK(count == 2);
+    CHECK(received == "{\"plain\": 1}");
+    CHECK(metrics.reassembled->value() == 1);
+}
+
+/**
+ * 测试29: 按发送者统计序号缺口、乱序和重复
+ */
+TEST_CASE("SequenceTrackingCountsGaps", "[sequence][integration]")
+{
+    const int port = 5634;
+
+    UdpReceiver::ReceiveOptions options;
+    options.sequence.enabled = true;
+    UdpReceiver::Metrics metrics;
+    metrics.seq_missing = std::make_shared<Counter>();
+    metrics.seq_reordered = std::make_shared<Counter>();
+    metrics.seq_duplicates = std::make_shared<Counter>();
+
+    std::atomic<int> count{0};
+    UdpReceiver      receiver("239.1.1.9", port);
+    receiver.setReceiveOptions(options);
+    receiver.setMetrics(metrics);
+    REQUIRE(receiver.start([&count](const std::string &)
+                           { count++; }));
+    waitMs(100);
+
+    REQUIRE(sendUdpMessages({"{\"seq\": 1}", "{\"seq\": 2}", "{\"seq\": 5}", "{\"seq\": 4}",
+                             "{\"seq\": 4}", "{\"no_seq\": true}"},
+                            "239.1.1.9", port));
+    waitMs(300);
+    receiver.stop();
+
+    // 未启用重排时所有消息照常转发
+    CHECK(count == 6);
+    CHECK(metrics.seq_missing->value() == 2);
+    CHECK(metrics.seq_reordered->value() == 1);
+    CHECK(metrics.seq_duplicates->value() == 1);
+}
+
+/**
+ * 测试30: 重排缓冲按序号放行，缺口超时后由定时器放行（共享事件循环）
+ */
+TEST_CASE("ReorderBufferReleasesInOrder", "[sequence][integration]")
+{
+    const int port = 5635;
+
+    UdpReceiver::ReceiveOptions options;
+    options.sequence.enabled = true;
+    options.sequence.reorder_window_ms = 200;
+
+    std::mutex               mutex;
+    std::vector<std::string> received;
+    UdpEventLoop             loop;
+    REQUIRE(loop.start());
+
+    UdpReceiver receiver("239.1.1.10", port);
+    receiver.setReceiveOptions(options);
+    REQUIRE(receiver.start(loop, [&](const std::string &msg)
+                           {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(msg); }));
+    waitMs(100);
+
+    REQUIRE(sendUdpMessages({"{\"seq\": 1}", "{\"seq\": 3}", "{\"seq\": 2}", "{\"seq\": 5}"},
+                            "239.1.1.10", port));
+    waitMs(100);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(received == std::vector<std::string>{"{\"seq\": 1}", "{\"seq\": 2}", "{\"seq\": 3}"});
+    }
+
+    // 序号4一直没有到达，窗口到期后跳过缺口放行5
+    waitMs(300);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(received.size() == 4);
+        CHECK(received[3] == "{\"seq\": 5}");
+    }
+
+    receiver.stop();
+    loop.stop();
+}
+
+/**
+ * 测试31: 带接收信息的回调得到发送者地址和内核接收时间
+ */
+TEST_CASE("CallbackReceivesSourceAndTimestamp", "[info][integration]")
+{
+    const int port = 5636;
+
+    std::mutex  mutex;
+    std::string source;
+    uint64_t    rx_ts_ns = 0;
+    UdpReceiver receiver("239.1.1.11", port);
+    REQUIRE(receiver.start([&](const std::string &, const UdpReceiver::MessageInfo &info)
+                           {
+        std::lock_guard<std::mutex> lock(mutex);
+        source = UdpReceiver::formatSource(*info.source);
+        rx_ts_ns = info.rx_ts_ns; }));
+    waitMs(100);
+
+    auto now_ns = []()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
+    };
+    uint64_t before = now_ns();
+    REQUIRE(sendUdpMessage("{\"id\": 1}", "239.1.1.11", port));
+    waitMs(200);
+    uint64_t after = now_ns();
+    receiver.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(source.rfind(localSourceAddress("239.1.1.11", port) + ":", 0) == 0);
+    CHECK(rx_ts_ns >= before);
+    CHECK(rx_ts_ns <= after);
+}
+
+/**
+ * 测试32: 录制的报文回放时经过同样的处理，得到相同的消息、来源和接收时间
+ */
+TEST_CASE("CaptureRecordsAndReplays", "[capture][integration]")
+{
+    const int port = 5637;
+    std::string path = "/tmp/udp_receiver_test_" + std::to_string(getpid()) + ".cap";
+
+    UdpReceiver::ReceiveOptions options;
+    options.sequence.enabled = true;
+    options.sequence.reorder_window_ms = 200;
+
+    auto capture = std::make_shared<CaptureWriter>(path);
+    REQUIRE(capture->open());
+
+    std::mutex               mutex;
+    std::vector<std::string> live;
+    std::vector<std::string> live_sources;
+    std::vector<uint64_t>    live_ts;
+    UdpReceiver              receiver("239.1.1.12", port);
+    receiver.setReceiveOptions(options);
+    receiver.setCapture(capture, capture->channel("live"));
+    REQUIRE(receiver.start([&](const std::string &msg, const UdpReceiver::MessageInfo &info)
+                           {
+        std::lock_guard<std::mutex> lock(mutex);
+        live.push_back(msg);
+        live_sources.push_back(UdpReceiver::formatSource(*info.source));
+        live_ts.push_back(info.rx_ts_ns); }));
+    waitMs(100);
+
+    REQUIRE(sendUdpMessages({"{\"seq\": 1}", "{\"seq\": 3}", "{\"seq\": 2}"}, "239.1.1.12", port));
+    waitMs(200);
+    receiver.stop();
+    capture->close();
+    CHECK(capture->getRecordCount() == 3);
+
+    // 回放接收器不创建套接字，按录制顺序送入
+    std::vector<std::string> replayed;
+    std::vector<std::string> replayed_sources;
+    std::vector<uint64_t>    replayed_ts;
+    UdpReceiver              replayer("239.1.1.12", port);
+    replayer.setReceiveOptions(options);
+    REQUIRE(replayer.startReplay([&](const std::string &msg, const UdpReceiver::MessageInfo &info)
+                                 {
+        replayed.push_back(msg);
+        replayed_sources.push_back(UdpReceiver::formatSource(*info.source));
+        replayed_ts.push_back(info.rx_ts_ns); }));
+
+    CaptureReader reader(path);
+    REQUIRE(reader.open());
+    CaptureReader::Record record;
+    while (reader.next(record))
+    {
+        CHECK(record.channel == "live");
+        replayer.inject(record.data, static_cast<int>(record.len), record.source, record.rx_ts_ns);
+    }
+    replayer.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(live == std::vector<std::string>{"{\"seq\": 1}", "{\"seq\": 2}", "{\"seq\": 3}"});
+    CHECK(replayed == live);
+    CHECK(replayed_sources == live_sources);
+    // 重排缓冲放行的消息保留各自的接收时间：序号3先于序号2到达
+    REQUIRE(live_ts.size() == 3);
+    CHECK(replayed_ts == live_ts);
+    CHECK(live_ts[2] <= live_ts[1]);
+
+    reader.close();
+    unlink(path.c_str());
+}
+
+/**
+ * 测试33: 环形缓冲区接收方式经回环网卡收到报文，经过同样的处理并按排除列表过滤发送者
+ */
+TEST_CASE("PacketRingBackendReceives", "[packet_ring][integration]")
+{
+    const int port = 5638;
+    int probe = socket(AF_PACKET, SOCK_DGRAM, 0);
+    if (probe < 0)
+    {
+        WARN("AF_PACKET not available (needs CAP_NET_RAW), skipping");
+        return;
+    }
+    close(probe);
+
+    auto sendLoopback = [port](const std::string &message)
+    {
+        int sock = socket(AF_INET, SOCK_DGRAM, 0);
+        struct in_addr loopback;
+        inet_pton(AF_INET, "127.0.0.1", &loopback);
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &loopback, sizeof(loopback));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "239.1.1.13", &addr.sin_addr);
+        sendto(sock, message.data(), message.size(), 0, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        close(sock);
+    };
+
+    UdpReceiver::ReceiveOptions options;
+    options.backend = UdpReceiver::ReceiveOptions::Backend::PacketRing;
+    options.ring.block_size = 1 << 16;
+    options.ring.block_count = 4;
+    options.ring.block_timeout_ms = 5;
+
+    std::mutex               mutex;
+    std::vector<std::string> received;
+    std::string              source;
+    UdpEventLoop             loop;
+    REQUIRE(loop.start());
+
+    UdpReceiver receiver("239.1.1.13", port, "127.0.0.1");
+    receiver.setReceiveOptions(options);
+    REQUIRE(receiver.start(loop, [&](const std::string &msg, const UdpReceiver::MessageInfo &info)
+                           {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(msg);
+        source = UdpReceiver::formatSource(*info.source); }));
+
+    sendLoopback("{\"id\": 1}");
+    sendLoopback("{\"id\": 2}");
+    waitMs(200);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(received == std::vector<std::string>{"{\"id\": 1}", "{\"id\": 2}"});
+        CHECK(source.rfind("127.0.0.1:", 0) == 0);
+    }
+    receiver.stop();
+
+    // 排除列表在用户态对环形缓冲区读到的报文生效
+    UdpReceiver::JoinOptions join;
+    join.exclude_sources = {"127.0.0.1"};
+    UdpReceiver excluding("239.1.1.13", port, "127.0.0.1");
+    excluding.setReceiveOptions(options);
+    excluding.setJoinOptions(join);
+    std::atomic<int> excluded_count{0};
+    REQUIRE(excluding.start([&](const std::string &)
+                            { excluded_count++; }));
+    waitMs(50);
+    sendLoopback("{\"id\": 3}");
+    waitMs(200);
+    excluding.stop();
+    CHECK(excluded_count == 0);
+
+    loop.stop();
+}
+
 // ============================================================================
 // 主程序由Catch2提供
 // ============================================================================
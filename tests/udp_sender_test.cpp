@@ -0,0 +1,105 @@
+#include "udp_receiver.h"
+#include "udp_sender.h"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * UdpSender的集成测试（通过本机组播回环接收验证）
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 等待指定的毫秒数
+ */
+void waitMs(int milliseconds)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 未打开时发送失败
+ */
+TEST_CASE("UdpSenderSendWithoutOpen", "[sender]")
+{
+    UdpSender sender("224.0.0.1", 5661);
+    REQUIRE_FALSE(sender.isOpen());
+
+    std::vector<std::string> messages = {"a", "b"};
+    CHECK(sender.sendBatch(messages, messages.size()) == 0);
+    CHECK(sender.getFailedCount() == 2);
+}
+
+/**
+ * 测试2: 无效地址打开失败
+ */
+TEST_CASE("UdpSenderInvalidAddress", "[sender]")
+{
+    UdpSender sender("not.an.address", 5662);
+    CHECK_FALSE(sender.open());
+
+    UdpSender badInterface("224.0.0.1", 5662, "bad-interface");
+    CHECK_FALSE(badInterface.open());
+}
+
+/**
+ * 测试3: 批量发送的报文全部到达，且按MAX_BATCH分批调用sendmmsg
+ */
+TEST_CASE("UdpSenderBatchesWithSendmmsg", "[sender][integration]")
+{
+    const std::string address = "224.0.0.1";
+    const int         port = 5660;
+
+    std::mutex            mutex;
+    std::set<std::string> received;
+    UdpReceiver           receiver(address, port);
+    REQUIRE(receiver.start(
+        [&](const std::string &message)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            received.insert(message);
+        }));
+
+    UdpSender sender(address, port, "", 1, true);
+    REQUIRE(sender.open());
+
+    std::vector<std::string> messages;
+    for (int i = 0; i < 100; ++i)
+    {
+        messages.push_back(R"({"id": )" + std::to_string(i) + "}");
+    }
+
+    CHECK(sender.sendBatch(messages, messages.size()) == 100);
+    CHECK(sender.getSentCount() == 100);
+    CHECK(sender.getSyscallCount() == 2);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received.size() == messages.size())
+            {
+                break;
+            }
+        }
+        waitMs(20);
+    }
+
+    receiver.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(received.size() == messages.size());
+}
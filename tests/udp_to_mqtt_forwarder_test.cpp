@@ -348,6 +348,74 @@ TEST_CASE("UdpToMqttForwarderForwardsJsonToMosquitto", "[integration][json]")
     CHECK(forwarder.getFailedMessageCount() == 0);
 }
 
+/**
+ * 测试13: 重载配置更新主题和去重设置，合并设置保持不变
+ */
+TEST_CASE("UdpToMqttForwarderReloadAppliesConfig", "[reload]")
+{
+    UdpToMqttForwarder::Config config;
+    config.mqtt_client_id = "forwarder_reload_test_client";
+    config.mqtt_broker = "localhost";
+    config.mqtt_topic = "test/reload/before";
+    config.multicast_addr = "224.0.0.1";
+    config.multicast_port = 5651;
+
+    UdpToMqttForwarder forwarder(config);
+
+    UdpToMqttForwarder::Config next = config;
+    next.mqtt_topic = "test/reload/after";
+    next.mqtt_qos = 0;
+    next.mqtt_retain = true;
+    next.dedup.enabled = true;
+    next.dedup.window_ms = 500;
+    next.conflation.enabled = true;
+
+    REQUIRE(forwarder.reload(next));
+
+    UdpToMqttForwarder::Config applied = forwarder.getConfig();
+    CHECK(applied.mqtt_topic == "test/reload/after");
+    CHECK(applied.mqtt_qos == 0);
+    CHECK(applied.mqtt_retain);
+    CHECK(applied.dedup == next.dedup);
+    CHECK(applied.conflation == config.conflation);
+    CHECK_FALSE(forwarder.isRunning());
+}
+
+/**
+ * 测试14: 新的组播设置无法启动接收器时重载失败，保持原接收器和原配置
+ */
+TEST_CASE("UdpToMqttForwarderReloadKeepsReceiverOnFailure", "[reload]")
+{
+    UdpToMqttForwarder::Config config;
+    config.mqtt_client_id = "forwarder_reload_fail_test_client";
+    config.mqtt_broker = "localhost";
+    config.mqtt_topic = "test/reload/keep";
+    config.multicast_addr = "224.0.0.1";
+    config.multicast_port = 5652;
+
+    UdpToMqttForwarder forwarder(config);
+    bool started = forwarder.start();
+    if (!started)
+    {
+        WARN("Forwarder failed to start. Ensure local mosquitto broker is "
+             "running.");
+        return;
+    }
+
+    UdpToMqttForwarder::Config next = config;
+    next.mqtt_topic = "test/reload/changed";
+    next.multicast_addr = "not-a-group";
+
+    CHECK_FALSE(forwarder.reload(next));
+
+    UdpToMqttForwarder::Config applied = forwarder.getConfig();
+    CHECK(applied.multicast_addr == "224.0.0.1");
+    CHECK(applied.mqtt_topic == "test/reload/keep");
+    CHECK(forwarder.isRunning());
+
+    forwarder.stop();
+}
+
 // ============================================================================
 // 主程序由Catch2提供
 // ============================================================================
\ No newline at end of file
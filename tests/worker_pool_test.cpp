@@ -0,0 +1,260 @@
+#include "key_sequencer.h"
+#include "worker_pool.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkerPool和KeySequencer的单元测试
+ * 使用Catch2测试框架
+ */
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * 创建工作线程池配置
+ */
+WorkerPool::Config makeConfig(size_t threads)
+{
+    WorkerPool::Config config;
+    config.enabled = true;
+    config.threads = threads;
+    return config;
+}
+
+/**
+ * 等待条件成立，超时返回false
+ */
+template <typename Predicate>
+bool waitFor(Predicate predicate, int timeout_ms = 2000)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!predicate())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// ============================================================================
+// 测试用例
+// ============================================================================
+
+/**
+ * 测试1: 提交的任务全部执行，停止前执行完剩余任务
+ */
+TEST_CASE("WorkerPoolRunsAllTasks", "[workers]")
+{
+    WorkerPool pool(makeConfig(4));
+    REQUIRE(pool.threadCount() == 4);
+    uint64_t executed_before = pool.getExecutedCount();
+    REQUIRE(pool.start());
+    CHECK_FALSE(pool.start());
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 1000; ++i)
+    {
+        pool.submit([&count]()
+                    { count++; });
+    }
+    pool.stop();
+
+    CHECK(count == 1000);
+    CHECK(pool.getExecutedCount() - executed_before == 1000);
+    CHECK_FALSE(pool.isRunning());
+}
+
+/**
+ * 测试2: 工作线程提交的任务进入自己的队列，该线程忙时由其他线程偷取
+ */
+TEST_CASE("WorkerPoolStealsFromBusyWorker", "[workers]")
+{
+    WorkerPool pool(makeConfig(2));
+    uint64_t stolen_before = pool.getStolenCount();
+    REQUIRE(pool.start());
+
+    std::atomic<int> done{0};
+    std::atomic<bool> finished{false};
+    pool.submit([&]()
+                {
+        for (int i = 0; i < 10; ++i)
+        {
+            pool.submit([&done]() { done++; });
+        }
+        // 占住本线程，子任务只能被另一个线程偷走
+        finished = waitFor([&done]() { return done == 10; });
+    });
+
+    REQUIRE(waitFor([&finished]()
+                    { return finished.load(); }));
+    pool.stop();
+    CHECK(done == 10);
+    CHECK(pool.getStolenCount() - stolen_before == 10);
+}
+
+/**
+ * 测试3: 停止后在调用线程中直接执行
+ */
+TEST_CASE("WorkerPoolRunsInlineWhenStopped", "[workers]")
+{
+    WorkerPool pool(makeConfig(1));
+    std::thread::id ran_on;
+    pool.submit([&ran_on]()
+                { ran_on = std::this_thread::get_id(); });
+    CHECK(ran_on == std::this_thread::get_id());
+
+    WorkerPool::Config other = makeConfig(1);
+    CHECK(other == pool.getConfig());
+    other.key_field = "sensor.id";
+    CHECK(other != pool.getConfig());
+}
+
+/**
+ * 测试4: 同一键按begin()顺序放行，不同键互不等待
+ */
+TEST_CASE("KeySequencerRestoresPerKeyOrder", "[workers]")
+{
+    KeySequencer sequencer;
+    std::vector<std::string> released;
+    auto record = [&released](const std::string &name)
+    {
+        return [&released, name]()
+        { released.push_back(name); };
+    };
+
+    KeySequencer::Ticket a0 = sequencer.begin("a");
+    KeySequencer::Ticket b0 = sequencer.begin("b");
+    KeySequencer::Ticket a1 = sequencer.begin("a");
+    KeySequencer::Ticket a2 = sequencer.begin("a");
+    CHECK(sequencer.pending() == 4);
+
+    // a的后两条先完成，暂存等待a0
+    sequencer.complete(a2, record("a2"));
+    sequencer.complete(a1, record("a1"));
+    CHECK(released.empty());
+
+    // b不等待a
+    sequencer.complete(b0, record("b0"));
+    CHECK(released == std::vector<std::string>{"b0"});
+
+    sequencer.complete(a0, record("a0"));
+    CHECK(released == std::vector<std::string>{"b0", "a0", "a1", "a2"});
+    CHECK(sequencer.pending() == 0);
+
+    // 全部放行后键保留，再次使用时序号继续递增
+    CHECK(sequencer.begin("a").sequence == 3);
+}
+
+/**
+ * 测试5: 工作线程乱序完成时，每个键的消息仍按提交顺序放行
+ */
+TEST_CASE("KeySequencerWithWorkerPool", "[workers]")
+{
+    WorkerPool pool(makeConfig(4));
+    KeySequencer sequencer;
+    REQUIRE(pool.start());
+
+    std::mutex mutex;
+    std::map<std::string, std::vector<int>> released;
+    const std::vector<std::string> keys = {"sensor-1", "sensor-2", "sensor-3"};
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        std::string key = keys[i % keys.size()];
+        KeySequencer::Ticket ticket = sequencer.begin(key);
+        pool.submit([&, ticket, key, i]()
+                    {
+            // 处理时长不同，完成顺序与提交顺序不一致
+            if (i % 7 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            sequencer.complete(ticket, [&, key, i]()
+                               {
+                std::lock_guard<std::mutex> lock(mutex);
+                released[key].push_back(i); }); });
+    }
+
+    sequencer.waitIdle();
+    pool.stop();
+
+    REQUIRE(released.size() == keys.size());
+    for (const auto &entry : released)
+    {
+        CHECK(entry.second.size() == 1000);
+        CHECK(std::is_sorted(entry.second.begin(), entry.second.end()));
+    }
+    CHECK(sequencer.pending() == 0);
+}
+
+/**
+ * 测试6: 大量消息倒序完成时暂存槽扩容，仍按begin()顺序放行
+ */
+TEST_CASE("KeySequencerGrowsForLongGaps", "[workers]")
+{
+    KeySequencer sequencer;
+    std::vector<int> released;
+
+    std::vector<KeySequencer::Ticket> tickets;
+    for (int i = 0; i < 100; ++i)
+    {
+        tickets.push_back(sequencer.begin("sensor-1"));
+    }
+    for (int i = 99; i >= 0; --i)
+    {
+        sequencer.complete(tickets[i], [&released, i]()
+                           { released.push_back(i); });
+        CHECK(released.size() == (i == 0 ? 100u : 0u));
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        CHECK(released[i] == i);
+    }
+    CHECK(sequencer.pending() == 0);
+}
+
+/**
+ * 测试7: 多个线程同时提交，停止后所有任务都已执行
+ */
+TEST_CASE("WorkerPoolConcurrentSubmitters", "[workers]")
+{
+    WorkerPool pool(makeConfig(3));
+    REQUIRE(pool.start());
+
+    std::atomic<int> done{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p)
+    {
+        producers.emplace_back([&pool, &done]()
+                               {
+            for (int i = 0; i < 5000; ++i)
+            {
+                pool.submit([&done]()
+                            { done++; });
+            } });
+    }
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+
+    pool.stop();
+    CHECK(done == 20000);
+}
+
+// ============================================================================
+// 主程序由Catch2提供
+// ============================================================================